@@ -0,0 +1,228 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#if defined(__clang__)
+# pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__ICC)
+# pragma intel optimization_parameter target_arch=AVX2
+#elif defined(__ICL)
+# pragma [intel] optimization_parameter target_arch=AVX2
+#elif (__GNUC__ >= 5)
+# pragma GCC target("avx2")
+#endif
+
+#include <assert.h>
+#include <string.h>
+#include "blake2b_mb.h"
+#include "memcpy_inline.h"
+#include "endian_helper.h"
+
+#ifdef _MSC_VER
+# include <intrin.h>
+# define inline __inline
+#endif
+
+#ifdef HAVE_AS_KNOWS_AVX512
+
+static BLAKE2B_HASH_CTX *blake2b_ctx_mgr_resubmit(BLAKE2B_HASH_CTX_MGR * mgr, BLAKE2B_HASH_CTX * ctx);
+
+void blake2b_ctx_mgr_init_avx512(BLAKE2B_HASH_CTX_MGR * mgr)
+{
+	blake2b_mb_mgr_init_avx512(&mgr->mgr);
+}
+
+BLAKE2B_HASH_CTX *blake2b_ctx_mgr_submit_avx512(BLAKE2B_HASH_CTX_MGR * mgr, BLAKE2B_HASH_CTX * ctx,
+					const void *buffer, uint32_t len, HASH_CTX_FLAG flags)
+{
+	if (flags & (~HASH_ENTIRE)) {
+		// User should not pass anything other than FIRST, UPDATE, or LAST
+		ctx->error = HASH_CTX_ERROR_INVALID_FLAGS;
+		return ctx;
+	}
+
+	if (ctx->status & HASH_CTX_STS_PROCESSING) {
+		// Cannot submit to a currently processing job.
+		ctx->error = HASH_CTX_ERROR_ALREADY_PROCESSING;
+		return ctx;
+	}
+
+	if ((ctx->status & HASH_CTX_STS_COMPLETE) && !(flags & HASH_FIRST)) {
+		// Cannot update a finished job.
+		ctx->error = HASH_CTX_ERROR_ALREADY_COMPLETED;
+		return ctx;
+	}
+
+	if (flags & HASH_FIRST) {
+		// Init digest from the parameter block
+		memcpy_fixedlen(ctx->job.result_digest, ctx->initial_digest,
+				sizeof(ctx->initial_digest));
+
+		// Reset byte counters
+		ctx->total_length = 0;
+		ctx->job.counter = 0;
+
+		// A keyed hash starts with the key padded to a whole block
+		ctx->partial_block_buffer_length = 0;
+		if (ctx->key_len) {
+			memclr_fixedlen(ctx->partial_block_buffer, BLAKE2B_BLOCK_SIZE);
+			memcpy_varlen(ctx->partial_block_buffer, ctx->key, ctx->key_len);
+			ctx->partial_block_buffer_length = BLAKE2B_BLOCK_SIZE;
+			ctx->total_length = BLAKE2B_BLOCK_SIZE;
+		}
+	}
+	// If we made it here, there were no errors during this call to submit
+	ctx->error = HASH_CTX_ERROR_NONE;
+
+	// Store buffer ptr info from user
+	ctx->incoming_buffer = buffer;
+	ctx->incoming_buffer_length = len;
+
+	// Store the user's request flags and mark this ctx as currently being processed.
+	ctx->status = (flags & HASH_LAST) ?
+	    (HASH_CTX_STS) (HASH_CTX_STS_PROCESSING | HASH_CTX_STS_LAST) :
+	    HASH_CTX_STS_PROCESSING;
+
+	// Advance byte counter
+	ctx->total_length += len;
+
+	return blake2b_ctx_mgr_resubmit(mgr, ctx);
+}
+
+BLAKE2B_HASH_CTX *blake2b_ctx_mgr_flush_avx512(BLAKE2B_HASH_CTX_MGR * mgr)
+{
+	BLAKE2B_HASH_CTX *ctx;
+
+	while (1) {
+		ctx = (BLAKE2B_HASH_CTX *) blake2b_mb_mgr_flush_avx512(&mgr->mgr);
+
+		// If flush returned 0, there are no more jobs in flight.
+		if (!ctx)
+			return NULL;
+
+		// If flush returned a job, verify that it is safe to return to the user.
+		// If it is not ready, resubmit the job to finish processing.
+		ctx = blake2b_ctx_mgr_resubmit(mgr, ctx);
+
+		// If blake2b_ctx_mgr_resubmit returned a job, it is ready to be returned.
+		if (ctx)
+			return ctx;
+
+		// Otherwise, all jobs currently being managed by the BLAKE2B_HASH_CTX_MGR still need processing. Loop.
+	}
+}
+
+static BLAKE2B_HASH_CTX *blake2b_ctx_mgr_resubmit(BLAKE2B_HASH_CTX_MGR * mgr, BLAKE2B_HASH_CTX * ctx)
+{
+	while (ctx) {
+		if (ctx->status & HASH_CTX_STS_COMPLETE) {
+			ctx->status = HASH_CTX_STS_COMPLETE;	// Clear PROCESSING bit
+			return ctx;
+		}
+		// The buffered block is not the last one once more input is waiting
+		if (ctx->partial_block_buffer_length == BLAKE2B_BLOCK_SIZE
+		    && ctx->incoming_buffer_length) {
+			ctx->partial_block_buffer_length = 0;
+
+			ctx->job.buffer = ctx->partial_block_buffer;
+			ctx->job.len = 1;
+			ctx->job.last = 0;
+			ctx = (BLAKE2B_HASH_CTX *) blake2b_mb_mgr_submit_avx512(&mgr->mgr, &ctx->job);
+			continue;
+		}
+		// Hash the user's buffer in place, keeping back at least one byte
+		if (ctx->partial_block_buffer_length == 0
+		    && ctx->incoming_buffer_length > BLAKE2B_BLOCK_SIZE) {
+			uint32_t len = (ctx->incoming_buffer_length - 1) >> BLAKE2B_LOG2_BLOCK_SIZE;
+
+			ctx->job.buffer = (uint8_t *) ctx->incoming_buffer;
+			ctx->job.len = len;
+			ctx->job.last = 0;
+			len <<= BLAKE2B_LOG2_BLOCK_SIZE;
+			ctx->incoming_buffer = (const void *)((const char *)ctx->incoming_buffer + len);
+			ctx->incoming_buffer_length -= len;
+			ctx = (BLAKE2B_HASH_CTX *) blake2b_mb_mgr_submit_avx512(&mgr->mgr, &ctx->job);
+			continue;
+		}
+		// Buffer what is left, at most one block
+		if (ctx->incoming_buffer_length) {
+			uint32_t copy_len = BLAKE2B_BLOCK_SIZE - ctx->partial_block_buffer_length;
+
+			if (ctx->incoming_buffer_length < copy_len)
+				copy_len = ctx->incoming_buffer_length;
+
+			memcpy_varlen(&ctx->partial_block_buffer[ctx->partial_block_buffer_length],
+				      ctx->incoming_buffer, copy_len);
+			ctx->partial_block_buffer_length += copy_len;
+			ctx->incoming_buffer = (const void *)((const char *)ctx->incoming_buffer +
+							      copy_len);
+			ctx->incoming_buffer_length -= copy_len;
+			continue;
+		}
+		// The buffered bytes are the last block, zero padded and counted as they are
+		if (ctx->status & HASH_CTX_STS_LAST) {
+			memclr_varlen(&ctx->partial_block_buffer[ctx->partial_block_buffer_length],
+				      BLAKE2B_BLOCK_SIZE - ctx->partial_block_buffer_length);
+
+			ctx->status =
+			    (HASH_CTX_STS) (HASH_CTX_STS_PROCESSING | HASH_CTX_STS_COMPLETE);
+			ctx->job.buffer = ctx->partial_block_buffer;
+			ctx->job.len = 1;
+			ctx->job.last = 1;
+			ctx->job.counter = ctx->total_length;
+			ctx = (BLAKE2B_HASH_CTX *) blake2b_mb_mgr_submit_avx512(&mgr->mgr, &ctx->job);
+			continue;
+		}
+
+		if (ctx)
+			ctx->status = HASH_CTX_STS_IDLE;
+		return ctx;
+	}
+
+	return NULL;
+}
+
+struct slver {
+	uint16_t snum;
+	uint8_t ver;
+	uint8_t core;
+};
+struct slver blake2b_ctx_mgr_init_avx512_slver_0000;
+struct slver blake2b_ctx_mgr_init_avx512_slver = { 0x2509, 0x00, 0x00 };
+
+struct slver blake2b_ctx_mgr_submit_avx512_slver_0000;
+struct slver blake2b_ctx_mgr_submit_avx512_slver = { 0x250a, 0x00, 0x00 };
+
+struct slver blake2b_ctx_mgr_flush_avx512_slver_0000;
+struct slver blake2b_ctx_mgr_flush_avx512_slver = { 0x250b, 0x00, 0x00 };
+
+#endif // HAVE_AS_KNOWS_AVX512
+
+#if defined(__clang__)
+# pragma clang attribute pop
+#endif
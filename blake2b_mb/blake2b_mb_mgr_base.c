@@ -0,0 +1,127 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <string.h>
+#include "blake2b_mb.h"
+#include "endian_helper.h"
+
+static const uint8_t blake2b_sigma[10][16] = {
+	{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+	{14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+	{11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+	{7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+	{9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+	{2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+	{12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+	{13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+	{6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+	{10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0}
+};
+
+static inline BLAKE2B_WORD_T load_le(const uint8_t * p)
+{
+	BLAKE2B_WORD_T x;
+
+	memcpy(&x, p, sizeof(x));
+	return to_le64(x);
+}
+
+#define ror(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+#define G(a, b, c, d, x, y) \
+	do { \
+		a = a + b + (x); \
+		d = ror(d ^ a, 32); \
+		c = c + d; \
+		b = ror(b ^ c, 24); \
+		a = a + b + (y); \
+		d = ror(d ^ a, 16); \
+		c = c + d; \
+		b = ror(b ^ c, 63); \
+	} while (0)
+
+static void blake2b_compress(BLAKE2B_WORD_T h[BLAKE2B_DIGEST_NWORDS], const uint8_t * block,
+			 uint64_t counter, uint32_t last)
+{
+	static const BLAKE2B_WORD_T iv[BLAKE2B_DIGEST_NWORDS] = { BLAKE2B_INITIAL_DIGEST };
+	BLAKE2B_WORD_T m[16], v[16];
+	const uint8_t *s;
+	int i, r;
+
+	for (i = 0; i < 16; i++)
+		m[i] = load_le(block + i * sizeof(BLAKE2B_WORD_T));
+	for (i = 0; i < 8; i++) {
+		v[i] = h[i];
+		v[i + 8] = iv[i];
+	}
+	v[12] ^= (BLAKE2B_WORD_T) counter;
+	v[13] ^= 0;
+	if (last)
+		v[14] = ~v[14];
+
+	for (r = 0; r < 12; r++) {
+		s = blake2b_sigma[r % 10];
+		G(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+		G(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+		G(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+		G(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+		G(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+		G(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+		G(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+		G(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+	}
+
+	for (i = 0; i < 8; i++)
+		h[i] ^= v[i] ^ v[i + 8];
+}
+
+void blake2b_mb_mgr_init_base(BLAKE2B_MB_JOB_MGR * state)
+{
+}
+
+BLAKE2B_JOB *blake2b_mb_mgr_submit_base(BLAKE2B_MB_JOB_MGR * state, BLAKE2B_JOB * job)
+{
+	uint64_t blk;
+
+	// A single lane, the job is done before it is handed back
+	for (blk = 0; blk < job->len; blk++) {
+		if (!job->last)
+			job->counter += BLAKE2B_BLOCK_SIZE;
+		blake2b_compress(job->result_digest, job->buffer, job->counter, job->last);
+		job->buffer += BLAKE2B_BLOCK_SIZE;
+	}
+	job->len = 0;
+	job->status = STS_COMPLETED;
+	return job;
+}
+
+BLAKE2B_JOB *blake2b_mb_mgr_flush_base(BLAKE2B_MB_JOB_MGR * state)
+{
+	return NULL;
+}
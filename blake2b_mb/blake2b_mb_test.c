@@ -0,0 +1,252 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "blake2b_mb.h"
+
+#define MSGS		20
+#define MAX_MSG_LEN	1000
+
+static uint8_t msg_buf[MAX_MSG_LEN];
+static uint8_t key_buf[BLAKE2B_MAX_KEY_SIZE];
+static uint8_t salt_buf[BLAKE2B_SALT_SIZE];
+static uint8_t personal_buf[BLAKE2B_PERSONAL_SIZE];
+
+// Message bytes are i % 251, key bytes i, salt 0x40 + i, personalization 0x60 + i
+static const struct {
+	uint32_t len;
+	uint32_t key_len;
+	int salt;
+	int personal;
+	uint32_t digest_len;
+	const char *digest;
+} vectors[MSGS] = {
+	{0, 0, 0, 0, 64,
+	 "786a02f742015903c6c6fd852552d272912f4740e15847618a86e217f71f5419"
+	 "d25e1031afee585313896444934eb04b903a685b1448b755d56f701afe9be2ce"},
+	{3, 0, 0, 0, 64,
+	 "ba80a53f981c4d0d6a2797b69f12f6e94c212f14685ac4b74b12bb6fdbffa2d1"
+	 "7d87c5392aab792dc252d5de4533cc9518d38aa8dbf1925ab92386edd4009923"},
+	{1, 0, 0, 0, 64,
+	 "2fa3f686df876995167e7c2e5d74c4c7b6e48f8068fe0e44208344d480f7904c"
+	 "36963e44115fe3eb2a3ac8694c28bcb4f5a0f3276f2e79487d8219057a506e4b"},
+	{63, 0, 0, 0, 64,
+	 "d10bf9a15b1c9fc8d41f89bb140bf0be08d2f3666176d13baac4d381358ad074"
+	 "c9d4748c300520eb026daeaea7c5b158892fde4e8ec17dc998dcd507df26eb63"},
+	{64, 0, 0, 0, 64,
+	 "2fc6e69fa26a89a5ed269092cb9b2a449a4409a7a44011eecad13d7c4b045660"
+	 "2d402fa5844f1a7a758136ce3d5d8d0e8b86921ffff4f692dd95bdc8e5ff0052"},
+	{65, 0, 0, 0, 64,
+	 "fcbe8be7dcb49a32dbdf239459e26308b84dff1ea480df8d104eeff34b46fae9"
+	 "8627b450c2267d48c0946a697c5b59531452ac0484f1c84e3a33d0c339bb2e28"},
+	{127, 0, 0, 0, 64,
+	 "b6292669ccd38d5f01caae96ba272c76a879a45743afa0725d83b9ebb26665b7"
+	 "31f1848c52f11972b6644f554c064fa90780dbbbf3a89d4fc31f67df3e5857ef"},
+	{128, 0, 0, 0, 64,
+	 "2319e3789c47e2daa5fe807f61bec2a1a6537fa03f19ff32e87eecbfd64b7e0e"
+	 "8ccff439ac333b040f19b0c4ddd11a61e24ac1fe0f10a039806c5dcc0da3d115"},
+	{129, 0, 0, 0, 64,
+	 "f59711d44a031d5f97a9413c065d1e614c417ede998590325f49bad2fd444d3e"
+	 "4418be19aec4e11449ac1a57207898bc57d76a1bcf3566292c20c683a5c4648f"},
+	{1000, 0, 0, 0, 64,
+	 "c11e1c0340bd7e5a1b275f1230c962fad215ecb1391486e74e31b960a2f29963"
+	 "81a5fad092da06841d5f26e38f6ecfeaf441acbcd1c2de61aef121e7927175f5"},
+	{0, 64, 0, 0, 64,
+	 "10ebb67700b1868efb4417987acf4690ae9d972fb7a590c2f02871799aaa4786"
+	 "b5e996e8f0f4eb981fc214b005f42d2ff4233499391653df7aefcbc13fc51568"},
+	{1, 64, 0, 0, 64,
+	 "961f6dd1e4dd30f63901690c512e78e4b45e4742ed197c3c5e45c549fd25f2e4"
+	 "187b0bc9fe30492b16b0d0bc4ef9b0f34c7003fac09a5ef1532e69430234cebd"},
+	{64, 64, 0, 0, 64,
+	 "65676d800617972fbd87e4b9514e1c67402b7a331096d3bfac22f1abb95374ab"
+	 "c942f16e9ab0ead33b87c91968a6e509e119ff07787b3ef483e1dcdccf6e3022"},
+	{128, 64, 0, 0, 64,
+	 "72065ee4dd91c2d8509fa1fc28a37c7fc9fa7d5b3f8ad3d0d7a25626b57b1b44"
+	 "788d4caf806290425f9890a3a2a35a905ab4b37acfd0da6e4517b2525c9651e4"},
+	{255, 64, 0, 0, 64,
+	 "8e1e2c579262b7c01966c3133c2bb704a165be2308ff8925a2f070dec7275740"
+	 "fa9fe004ee25c8e1a3dd57317065ee744f0821c4e911eee8e484e770f21dd958"},
+	{200, 7, 0, 0, 20,
+	 "cc7c9216074b85a57bb7556bd6ef63a9ae741466"},
+	{200, 0, 1, 0, 64,
+	 "e90ced3006bef0ccf03e164f5d91cad56e7d114d112117e6ae45d55f1b65eeb1"
+	 "09a08418cdae244ded563300df7a9f41289d672b2ce6929a55a7bc248bb0230f"},
+	{200, 0, 0, 1, 64,
+	 "cbbd8e2bca6b5b1d8078d5daa295d99fc749ffaf2874c50ba8514327788305e2"
+	 "bfc0be811d68c92a3991e636b8b6436655acc351a8d99b5be027364b02c5838e"},
+	{300, 32, 1, 1, 35,
+	 "92464836083684e08ac2b0055d2a96e376fb6cd2f93ad05761c25b215e162186"
+	 "45cb00"},
+	{5, 0, 1, 1, 1,
+	 "7d"}
+};
+
+static const uint8_t *vector_msg(int t)
+{
+	// The 3 byte message is "abc" as in RFC 7693
+	return vectors[t].len == 3 ? (const uint8_t *)"abc" : msg_buf;
+}
+
+static int vector_init(BLAKE2B_HASH_CTX * ctx, int t)
+{
+	return blake2b_ctx_init(ctx, vectors[t].digest_len, key_buf, vectors[t].key_len,
+			    vectors[t].salt ? salt_buf : NULL,
+			    vectors[t].personal ? personal_buf : NULL);
+}
+
+static int check_digest(int t, BLAKE2B_HASH_CTX * ctx)
+{
+	char hex[2 * BLAKE2B_MAX_DIGEST_SIZE + 1];
+	uint32_t i;
+
+	// Digest bytes are the words of result_digest in little-endian order
+	for (i = 0; i < vectors[t].digest_len; i++)
+		sprintf(&hex[2 * i], "%02x",
+			(uint8_t) (ctx->job.result_digest[i / sizeof(BLAKE2B_WORD_T)] >>
+				   (8 * (i % sizeof(BLAKE2B_WORD_T)))));
+
+	if (strcmp(hex, vectors[t].digest)) {
+		printf("\nblake2b vector %d mismatch\n  got %s\n  exp %s\n", t, hex,
+		       vectors[t].digest);
+		return 1;
+	}
+	return 0;
+}
+
+// Feeds a vector in pieces of chunk bytes, one context at a time
+static int chunked_test(BLAKE2B_HASH_CTX_MGR * mgr, BLAKE2B_HASH_CTX * ctxpool, uint32_t chunk)
+{
+	BLAKE2B_HASH_CTX *ctx;
+	HASH_CTX_FLAG flags;
+	uint32_t off, len;
+	int t, fail = 0;
+
+	for (t = 0; t < MSGS; t++) {
+		vector_init(&ctxpool[t], t);
+		off = 0;
+		flags = HASH_FIRST;
+		do {
+			len = vectors[t].len - off < chunk ? vectors[t].len - off : chunk;
+			if (off + len == vectors[t].len)
+				flags |= HASH_LAST;
+			ctx = blake2b_ctx_mgr_submit(mgr, &ctxpool[t], vector_msg(t) + off, len, flags);
+			if (ctx == NULL)
+				ctx = blake2b_ctx_mgr_flush(mgr);
+			if (ctx == NULL || ctx->error) {
+				printf("update error on vector %d\n", t);
+				return 1;
+			}
+			off += len;
+			flags = HASH_UPDATE;
+		} while (off < vectors[t].len);
+
+		if (!hash_ctx_complete(&ctxpool[t])) {
+			printf("vector %d not complete\n", t);
+			return 1;
+		}
+		fail += check_digest(t, &ctxpool[t]);
+	}
+	return fail;
+}
+
+int main(void)
+{
+	BLAKE2B_HASH_CTX_MGR *mgr = NULL;
+	BLAKE2B_HASH_CTX ctxpool[MSGS], *ctx = NULL;
+	uint32_t i, fail = 0, checked = 0;
+	int ret;
+
+	printf("multibinary_blake2b test: ");
+
+	ret = posix_memalign((void *)&mgr, 64, sizeof(BLAKE2B_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+	for (i = 0; i < MAX_MSG_LEN; i++)
+		msg_buf[i] = i % 251;
+	for (i = 0; i < BLAKE2B_MAX_KEY_SIZE; i++)
+		key_buf[i] = i;
+	for (i = 0; i < BLAKE2B_SALT_SIZE; i++)
+		salt_buf[i] = 0x40 + i;
+	for (i = 0; i < BLAKE2B_PERSONAL_SIZE; i++)
+		personal_buf[i] = 0x60 + i;
+
+	blake2b_ctx_mgr_init(mgr);
+
+	// Whole messages, all sharing the one manager
+	for (i = 0; i < MSGS; i++) {
+		if (vector_init(&ctxpool[i], i)) {
+			printf("blake2b_ctx_init failed on vector %d\n", i);
+			return 1;
+		}
+		ctx = blake2b_ctx_mgr_submit(mgr, &ctxpool[i], vector_msg(i), vectors[i].len,
+					 HASH_ENTIRE);
+		if (ctx) {
+			if (ctx->error) {
+				printf("submit error %d on vector %d\n", ctx->error, i);
+				return 1;
+			}
+			fail += check_digest((int)(ctx - ctxpool), ctx);
+			checked++;
+		}
+	}
+	while ((ctx = blake2b_ctx_mgr_flush(mgr)) != NULL) {
+		fail += check_digest((int)(ctx - ctxpool), ctx);
+		checked++;
+	}
+	if (checked != MSGS) {
+		printf("only %d of %d contexts returned\n", checked, MSGS);
+		fail++;
+	}
+
+	// Odd sized pieces, then whole blocks so the held back block is a full one
+	fail += chunked_test(mgr, ctxpool, 7);
+	fail += chunked_test(mgr, ctxpool, BLAKE2B_BLOCK_SIZE);
+
+	// Out of range parameters are refused
+	if (!blake2b_ctx_init(&ctxpool[0], 0, NULL, 0, NULL, NULL) ||
+	    !blake2b_ctx_init(&ctxpool[0], BLAKE2B_MAX_DIGEST_SIZE + 1, NULL, 0, NULL, NULL) ||
+	    !blake2b_ctx_init(&ctxpool[0], BLAKE2B_MAX_DIGEST_SIZE, key_buf, BLAKE2B_MAX_KEY_SIZE + 1,
+			   NULL, NULL)) {
+		printf("bad parameters accepted\n");
+		fail++;
+	}
+
+	aligned_free(mgr);
+
+	if (fail)
+		printf("Test failed function check %d\n", fail);
+	else
+		printf(" multibinary_blake2b test: Pass\n");
+
+	return fail;
+}
@@ -0,0 +1,171 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#if defined(__clang__)
+# pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__ICC)
+# pragma intel optimization_parameter target_arch=AVX2
+#elif defined(__ICL)
+# pragma [intel] optimization_parameter target_arch=AVX2
+#elif (__GNUC__ >= 5)
+# pragma GCC target("avx2")
+#endif
+
+#include <string.h>
+#include <immintrin.h>
+#include "blake2b_mb.h"
+#include "endian_helper.h"
+
+typedef __m256i VEC;
+
+#define LOAD(p)		_mm256_load_si256((const __m256i *)(p))
+#define STORE(p, a)	_mm256_store_si256((__m256i *)(p), a)
+#define SET1(x)		_mm256_set1_epi64x(x)
+#define ADD(a, b)	_mm256_add_epi64(a, b)
+#define XOR(a, b)	_mm256_xor_si256(a, b)
+#define ROR(a, n)	_mm256_or_si256(_mm256_srli_epi64(a, n), _mm256_slli_epi64(a, 64 - (n)))
+
+static const uint8_t blake2b_sigma[10][16] = {
+	{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+	{14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+	{11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+	{7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+	{9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+	{2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+	{12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+	{13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+	{6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+	{10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0}
+};
+
+static inline BLAKE2B_WORD_T load_le(const uint8_t * p)
+{
+	BLAKE2B_WORD_T x;
+
+	memcpy(&x, p, sizeof(x));
+	return to_le64(x);
+}
+
+#define G(a, b, c, d, x, y) \
+	do { \
+		a = ADD(ADD(a, b), x); \
+		d = ROR(XOR(d, a), 32); \
+		c = ADD(c, d); \
+		b = ROR(XOR(b, c), 24); \
+		a = ADD(ADD(a, b), y); \
+		d = ROR(XOR(d, a), 16); \
+		c = ADD(c, d); \
+		b = ROR(XOR(b, c), 63); \
+	} while (0)
+
+// One message per 64-bit element
+void blake2b_mb_x4_avx2(BLAKE2B_JOB * jobs[BLAKE2B_X4_LANES], uint64_t len)
+{
+	static const BLAKE2B_WORD_T iv[BLAKE2B_DIGEST_NWORDS] = { BLAKE2B_INITIAL_DIGEST };
+	DECLARE_ALIGNED(BLAKE2B_WORD_T words[16][BLAKE2B_X4_LANES], 64);
+	DECLARE_ALIGNED(BLAKE2B_WORD_T t0[BLAKE2B_X4_LANES], 64);
+	DECLARE_ALIGNED(BLAKE2B_WORD_T t1[BLAKE2B_X4_LANES], 64);
+	DECLARE_ALIGNED(BLAKE2B_WORD_T f0[BLAKE2B_X4_LANES], 64);
+	VEC h[BLAKE2B_DIGEST_NWORDS], v[16], m[16];
+	const uint8_t *p[BLAKE2B_X4_LANES];
+	uint64_t counter[BLAKE2B_X4_LANES];
+	const uint8_t *s;
+	uint64_t blk;
+	int i, w, r;
+
+	// Gather the digests, an empty lane runs on zeros
+	for (i = 0; i < BLAKE2B_X4_LANES; i++) {
+		p[i] = jobs[i] ? jobs[i]->buffer : NULL;
+		counter[i] = jobs[i] ? jobs[i]->counter : 0;
+		f0[i] = (jobs[i] && jobs[i]->last) ? (BLAKE2B_WORD_T) ~ 0 : 0;
+		for (w = 0; w < BLAKE2B_DIGEST_NWORDS; w++)
+			words[w][i] = jobs[i] ? jobs[i]->result_digest[w] : 0;
+	}
+	for (w = 0; w < BLAKE2B_DIGEST_NWORDS; w++)
+		h[w] = LOAD(words[w]);
+
+	for (blk = 0; blk < len; blk++) {
+		for (i = 0; i < BLAKE2B_X4_LANES; i++) {
+			if (p[i] == NULL) {
+				for (w = 0; w < 16; w++)
+					words[w][i] = 0;
+				t0[i] = t1[i] = 0;
+				continue;
+			}
+			for (w = 0; w < 16; w++)
+				words[w][i] = load_le(p[i] + w * sizeof(BLAKE2B_WORD_T));
+			p[i] += BLAKE2B_BLOCK_SIZE;
+			if (!f0[i])
+				counter[i] += BLAKE2B_BLOCK_SIZE;
+			t0[i] = (BLAKE2B_WORD_T) counter[i];
+			t1[i] = 0;
+		}
+		for (w = 0; w < 16; w++)
+			m[w] = LOAD(words[w]);
+
+		for (w = 0; w < 8; w++) {
+			v[w] = h[w];
+			v[w + 8] = SET1(iv[w]);
+		}
+		v[12] = XOR(v[12], LOAD(t0));
+		v[13] = XOR(v[13], LOAD(t1));
+		v[14] = XOR(v[14], LOAD(f0));
+
+		for (r = 0; r < 12; r++) {
+			s = blake2b_sigma[r % 10];
+			G(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+			G(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+			G(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+			G(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+			G(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+			G(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+			G(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+			G(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+		}
+
+		for (w = 0; w < 8; w++)
+			h[w] = XOR(h[w], XOR(v[w], v[w + 8]));
+	}
+
+	// Scatter the digests back to the jobs
+	for (w = 0; w < BLAKE2B_DIGEST_NWORDS; w++)
+		STORE(words[w], h[w]);
+	for (i = 0; i < BLAKE2B_X4_LANES; i++) {
+		if (jobs[i] == NULL)
+			continue;
+		jobs[i]->counter = counter[i];
+		for (w = 0; w < BLAKE2B_DIGEST_NWORDS; w++)
+			jobs[i]->result_digest[w] = words[w][i];
+	}
+}
+
+
+#if defined(__clang__)
+# pragma clang attribute pop
+#endif
@@ -0,0 +1,133 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stddef.h>
+#include <assert.h>
+#include "blake2s_mb.h"
+
+#define BLAKE2S_MB_LANES	BLAKE2S_X8_LANES
+
+void blake2s_mb_mgr_init_avx2(BLAKE2S_MB_JOB_MGR * state)
+{
+	unsigned int i;
+
+	state->unused_lanes = 0xf;
+	state->num_lanes_inuse = 0;
+	for (i = 0; i < BLAKE2S_MB_LANES; i++) {
+		state->unused_lanes <<= 4;
+		state->unused_lanes |= BLAKE2S_MB_LANES - 1 - i;
+		state->lens[i] = i;
+		state->ldata[i].job_in_lane = NULL;
+	}
+
+	//lanes > BLAKE2S_MB_LANES is invalid lane
+	for (; i < BLAKE2S_MAX_LANES; i++) {
+		state->lens[i] = 0xf;
+		state->ldata[i].job_in_lane = NULL;
+	}
+}
+
+static void blake2s_mb_mgr_do_jobs(BLAKE2S_MB_JOB_MGR * state)
+{
+	BLAKE2S_JOB *jobs[BLAKE2S_MB_LANES];
+	uint64_t len = UINT64_MAX;
+	int i;
+
+	// Run every lane in use for as many blocks as the shortest job has left
+	for (i = 0; i < BLAKE2S_MB_LANES; i++) {
+		jobs[i] = state->ldata[i].job_in_lane;
+		if (jobs[i] != NULL && (state->lens[i] >> 4) < len)
+			len = state->lens[i] >> 4;
+	}
+	if (len == UINT64_MAX || len == 0)
+		return;
+
+	blake2s_mb_x8_avx2(jobs, len);
+
+	for (i = 0; i < BLAKE2S_MB_LANES; i++) {
+		if (jobs[i] == NULL)
+			continue;
+		state->lens[i] -= len << 4;
+		jobs[i]->len -= len;
+		jobs[i]->buffer += len << BLAKE2S_LOG2_BLOCK_SIZE;
+	}
+}
+
+static BLAKE2S_JOB *blake2s_mb_mgr_free_lane(BLAKE2S_MB_JOB_MGR * state)
+{
+	BLAKE2S_JOB *ret;
+	int i;
+
+	for (i = 0; i < BLAKE2S_MB_LANES; i++) {
+		ret = state->ldata[i].job_in_lane;
+		if (ret != NULL && (state->lens[i] >> 4) == 0) {
+			state->unused_lanes <<= 4;
+			state->unused_lanes |= i;
+			state->num_lanes_inuse--;
+			state->ldata[i].job_in_lane = NULL;
+			ret->status = STS_COMPLETED;
+			return ret;
+		}
+	}
+	return NULL;
+}
+
+BLAKE2S_JOB *blake2s_mb_mgr_submit_avx2(BLAKE2S_MB_JOB_MGR * state, BLAKE2S_JOB * job)
+{
+	int lane_idx;
+
+	//add job into lanes
+	lane_idx = state->unused_lanes & 0xf;
+	//fatal error
+	assert(lane_idx < BLAKE2S_MB_LANES);
+	state->lens[lane_idx] = (job->len << 4) | lane_idx;
+	state->ldata[lane_idx].job_in_lane = job;
+	state->unused_lanes >>= 4;
+	state->num_lanes_inuse++;
+	job->status = STS_BEING_PROCESSED;
+
+	//submit will wait all lane has data
+	if (state->num_lanes_inuse < BLAKE2S_MB_LANES)
+		return NULL;
+
+	blake2s_mb_mgr_do_jobs(state);
+	return blake2s_mb_mgr_free_lane(state);
+}
+
+BLAKE2S_JOB *blake2s_mb_mgr_flush_avx2(BLAKE2S_MB_JOB_MGR * state)
+{
+	BLAKE2S_JOB *ret;
+
+	ret = blake2s_mb_mgr_free_lane(state);
+	if (ret)
+		return ret;
+
+	blake2s_mb_mgr_do_jobs(state);
+	return blake2s_mb_mgr_free_lane(state);
+}
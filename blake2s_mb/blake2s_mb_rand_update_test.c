@@ -0,0 +1,189 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "blake2s_mb.h"
+
+#define TEST_LEN  (16*1024)
+#define TEST_BUFS 40
+#ifndef RANDOMS
+# define RANDOMS  10
+#endif
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+
+#define MAX_UPDATE	(3 * BLAKE2S_BLOCK_SIZE)
+
+/* Reference digest global to reduce stack usage */
+static uint8_t digest_ref[TEST_BUFS][BLAKE2S_MAX_DIGEST_SIZE];
+static uint8_t digest_mb[BLAKE2S_MAX_DIGEST_SIZE];
+static uint8_t keys[TEST_BUFS][BLAKE2S_MAX_KEY_SIZE];
+static uint8_t salt[BLAKE2S_SALT_SIZE], personal[BLAKE2S_PERSONAL_SIZE];
+static unsigned char *bufs[TEST_BUFS];
+static uint32_t lens[TEST_BUFS], done[TEST_BUFS], started[TEST_BUFS];
+
+extern void blake2s_ref(const uint8_t * input_data, uint64_t len, const uint8_t * key,
+		     uint32_t key_len, const uint8_t * salt, const uint8_t * personal,
+		     uint8_t * digest, uint32_t digest_len);
+
+// Generates pseudo-random data
+
+void rand_buffer(unsigned char *buf, const long buffer_size)
+{
+	long i;
+	for (i = 0; i < buffer_size; i++)
+		buf[i] = rand();
+}
+
+// Submits the next random sized piece of a job
+static BLAKE2S_HASH_CTX *submit_next(BLAKE2S_HASH_CTX_MGR * mgr, BLAKE2S_HASH_CTX * ctx)
+{
+	uint32_t i = (uint32_t) (uint64_t) ctx->user_data;
+	uint32_t len = rand() % (MAX_UPDATE + 1);
+	HASH_CTX_FLAG flags = started[i] ? HASH_UPDATE : HASH_FIRST;
+
+	if (len > lens[i] - done[i])
+		len = lens[i] - done[i];
+	if (done[i] + len == lens[i])
+		flags |= HASH_LAST;
+
+	started[i] = 1;
+	ctx = blake2s_ctx_mgr_submit(mgr, ctx, bufs[i] + done[i], len, flags);
+	done[i] += len;
+
+	if (ctx && ctx->error) {
+		printf("submit error %d test aborted\n", ctx->error);
+		exit(1);
+	}
+	return ctx;
+}
+
+int main(void)
+{
+	BLAKE2S_HASH_CTX_MGR *mgr = NULL;
+	BLAKE2S_HASH_CTX ctxpool[TEST_BUFS], *ctx = NULL;
+	uint32_t i, j, t, fail = 0;
+	uint32_t digest_lens[TEST_BUFS], key_lens[TEST_BUFS];
+	const uint8_t *salts[TEST_BUFS], *personals[TEST_BUFS];
+	int ret;
+
+	printf("multibinary_blake2s_update test, %d sets of %dx%d max: ", RANDOMS, TEST_BUFS,
+	       TEST_LEN);
+
+	srand(TEST_SEED);
+
+	ret = posix_memalign((void *)&mgr, 64, sizeof(BLAKE2S_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	blake2s_ctx_mgr_init(mgr);
+
+	for (i = 0; i < TEST_BUFS; i++) {
+		// Allocte and fill buffer
+		bufs[i] = (unsigned char *)malloc(TEST_LEN);
+		if (bufs[i] == NULL) {
+			printf("malloc failed test aborted\n");
+			return 1;
+		}
+		rand_buffer(bufs[i], TEST_LEN);
+	}
+	rand_buffer(salt, BLAKE2S_SALT_SIZE);
+	rand_buffer(personal, BLAKE2S_PERSONAL_SIZE);
+
+	for (t = 0; t < RANDOMS; t++) {
+		// Mix message, key and digest lengths with and without salt and personalization
+		for (i = 0; i < TEST_BUFS; i++) {
+			lens[i] = rand() % (TEST_LEN + 1);
+			if (i % 4 == 0)
+				lens[i] &= ~(BLAKE2S_BLOCK_SIZE - 1);	// whole blocks
+			key_lens[i] = (i + t) % 3 ? 0 : rand() % (BLAKE2S_MAX_KEY_SIZE + 1);
+			digest_lens[i] = 1 + rand() % BLAKE2S_MAX_DIGEST_SIZE;
+			salts[i] = (i + t) % 2 ? salt : NULL;
+			personals[i] = (i + t) % 5 < 2 ? personal : NULL;
+			rand_buffer(keys[i], BLAKE2S_MAX_KEY_SIZE);
+			done[i] = 0;
+			started[i] = 0;
+
+			if (blake2s_ctx_init(&ctxpool[i], digest_lens[i], keys[i], key_lens[i], salts[i],
+					 personals[i])) {
+				printf("blake2s_ctx_init failed test aborted\n");
+				return 1;
+			}
+			ctxpool[i].user_data = (void *)((uint64_t) i);
+
+			// Run reference test
+			blake2s_ref(bufs[i], lens[i], keys[i], key_lens[i], salts[i], personals[i],
+				digest_ref[i], digest_lens[i]);
+		}
+
+		// Feed every job in random sized updates, resubmitting whatever comes back
+		for (i = 0; i < TEST_BUFS; i++) {
+			ctx = submit_next(mgr, &ctxpool[i]);
+			while (ctx && !hash_ctx_complete(ctx))
+				ctx = submit_next(mgr, ctx);
+		}
+		while ((ctx = blake2s_ctx_mgr_flush(mgr)) != NULL)
+			while (ctx && !hash_ctx_complete(ctx))
+				ctx = submit_next(mgr, ctx);
+
+		for (i = 0; i < TEST_BUFS; i++) {
+			for (j = 0; j < digest_lens[i]; j++)
+				digest_mb[j] = (uint8_t) (ctxpool[i].job.result_digest
+							  [j / sizeof(BLAKE2S_WORD_T)] >>
+							  (8 * (j % sizeof(BLAKE2S_WORD_T))));
+			if (!hash_ctx_complete(&ctxpool[i]) ||
+			    memcmp(digest_mb, digest_ref[i], digest_lens[i])) {
+				fail++;
+				printf("Test%d, len %d, key len %d, digest len %d fail\n", i,
+				       lens[i], key_lens[i], digest_lens[i]);
+			}
+		}
+
+		if (fail)
+			break;
+		putchar('.');
+		fflush(0);
+	}
+
+	for (i = 0; i < TEST_BUFS; i++)
+		free(bufs[i]);
+	aligned_free(mgr);
+
+	if (fail)
+		printf("Test failed function check %d\n", fail);
+	else
+		printf(" multibinary_blake2s_update rand: Pass\n");
+
+	return fail;
+}
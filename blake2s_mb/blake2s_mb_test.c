@@ -0,0 +1,234 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "blake2s_mb.h"
+
+#define MSGS		20
+#define MAX_MSG_LEN	1000
+
+static uint8_t msg_buf[MAX_MSG_LEN];
+static uint8_t key_buf[BLAKE2S_MAX_KEY_SIZE];
+static uint8_t salt_buf[BLAKE2S_SALT_SIZE];
+static uint8_t personal_buf[BLAKE2S_PERSONAL_SIZE];
+
+// Message bytes are i % 251, key bytes i, salt 0x40 + i, personalization 0x60 + i
+static const struct {
+	uint32_t len;
+	uint32_t key_len;
+	int salt;
+	int personal;
+	uint32_t digest_len;
+	const char *digest;
+} vectors[MSGS] = {
+	{0, 0, 0, 0, 32,
+	 "69217a3079908094e11121d042354a7c1f55b6482ca1a51e1b250dfd1ed0eef9"},
+	{3, 0, 0, 0, 32,
+	 "508c5e8c327c14e2e1a72ba34eeb452f37458b209ed63a294d999b4c86675982"},
+	{1, 0, 0, 0, 32,
+	 "e34d74dbaf4ff4c6abd871cc220451d2ea2648846c7757fbaac82fe51ad64bea"},
+	{63, 0, 0, 0, 32,
+	 "e57cb79487dd57902432b250733813bd96a84efce59f650fac26e6696aefafc3"},
+	{64, 0, 0, 0, 32,
+	 "56f34e8b96557e90c1f24b52d0c89d51086acf1b00f634cf1dde9233b8eaaa3e"},
+	{65, 0, 0, 0, 32,
+	 "1b53ee94aaf34e4b159d48de352c7f0661d0a40edff95a0b1639b4090e974472"},
+	{127, 0, 0, 0, 32,
+	 "f18417b39d617ab1c18fdf91ebd0fc6d5516bb34cf39364037bce81fa04cecb1"},
+	{128, 0, 0, 0, 32,
+	 "1fa877de67259d19863a2a34bcc6962a2b25fcbf5cbecd7ede8f1fa36688a796"},
+	{129, 0, 0, 0, 32,
+	 "5bd169e67c82c2c2e98ef7008bdf261f2ddf30b1c00f9e7f275bb3e8a28dc9a2"},
+	{1000, 0, 0, 0, 32,
+	 "1c067a5e746fb0f6734efac9a8cdb0e11061f0077f255184365c690115392501"},
+	{0, 32, 0, 0, 32,
+	 "48a8997da407876b3d79c0d92325ad3b89cbb754d86ab71aee047ad345fd2c49"},
+	{1, 32, 0, 0, 32,
+	 "40d15fee7c328830166ac3f918650f807e7e01e177258cdc0a39b11f598066f1"},
+	{64, 32, 0, 0, 32,
+	 "8975b0577fd35566d750b362b0897a26c399136df07bababbde6203ff2954ed4"},
+	{128, 32, 0, 0, 32,
+	 "0c311f38c35a4fb90d651c289d486856cd1413df9b0677f53ece2cd9e477c60a"},
+	{255, 32, 0, 0, 32,
+	 "1198d1da21a1ef3056099ef664dd9c6b06c482674dc334dbafd1627be358bfb5"},
+	{200, 7, 0, 0, 20,
+	 "966ad7ae6a83603c37cff69b021468ed8ff16016"},
+	{200, 0, 1, 0, 32,
+	 "493952c37da07f031af7fa00223fb6823720f35f847d5290b22b10ada2f74b90"},
+	{200, 0, 0, 1, 32,
+	 "2616f49781908c3702e5fc6ce88c1dc9dec50fe55082bbf333f84c987236a4da"},
+	{300, 16, 1, 1, 19,
+	 "1a7d7614d1328c917923cd2d612b2f0a8a624d"},
+	{5, 0, 1, 1, 1,
+	 "9a"}
+};
+
+static const uint8_t *vector_msg(int t)
+{
+	// The 3 byte message is "abc" as in RFC 7693
+	return vectors[t].len == 3 ? (const uint8_t *)"abc" : msg_buf;
+}
+
+static int vector_init(BLAKE2S_HASH_CTX * ctx, int t)
+{
+	return blake2s_ctx_init(ctx, vectors[t].digest_len, key_buf, vectors[t].key_len,
+			    vectors[t].salt ? salt_buf : NULL,
+			    vectors[t].personal ? personal_buf : NULL);
+}
+
+static int check_digest(int t, BLAKE2S_HASH_CTX * ctx)
+{
+	char hex[2 * BLAKE2S_MAX_DIGEST_SIZE + 1];
+	uint32_t i;
+
+	// Digest bytes are the words of result_digest in little-endian order
+	for (i = 0; i < vectors[t].digest_len; i++)
+		sprintf(&hex[2 * i], "%02x",
+			(uint8_t) (ctx->job.result_digest[i / sizeof(BLAKE2S_WORD_T)] >>
+				   (8 * (i % sizeof(BLAKE2S_WORD_T)))));
+
+	if (strcmp(hex, vectors[t].digest)) {
+		printf("\nblake2s vector %d mismatch\n  got %s\n  exp %s\n", t, hex,
+		       vectors[t].digest);
+		return 1;
+	}
+	return 0;
+}
+
+// Feeds a vector in pieces of chunk bytes, one context at a time
+static int chunked_test(BLAKE2S_HASH_CTX_MGR * mgr, BLAKE2S_HASH_CTX * ctxpool, uint32_t chunk)
+{
+	BLAKE2S_HASH_CTX *ctx;
+	HASH_CTX_FLAG flags;
+	uint32_t off, len;
+	int t, fail = 0;
+
+	for (t = 0; t < MSGS; t++) {
+		vector_init(&ctxpool[t], t);
+		off = 0;
+		flags = HASH_FIRST;
+		do {
+			len = vectors[t].len - off < chunk ? vectors[t].len - off : chunk;
+			if (off + len == vectors[t].len)
+				flags |= HASH_LAST;
+			ctx = blake2s_ctx_mgr_submit(mgr, &ctxpool[t], vector_msg(t) + off, len, flags);
+			if (ctx == NULL)
+				ctx = blake2s_ctx_mgr_flush(mgr);
+			if (ctx == NULL || ctx->error) {
+				printf("update error on vector %d\n", t);
+				return 1;
+			}
+			off += len;
+			flags = HASH_UPDATE;
+		} while (off < vectors[t].len);
+
+		if (!hash_ctx_complete(&ctxpool[t])) {
+			printf("vector %d not complete\n", t);
+			return 1;
+		}
+		fail += check_digest(t, &ctxpool[t]);
+	}
+	return fail;
+}
+
+int main(void)
+{
+	BLAKE2S_HASH_CTX_MGR *mgr = NULL;
+	BLAKE2S_HASH_CTX ctxpool[MSGS], *ctx = NULL;
+	uint32_t i, fail = 0, checked = 0;
+	int ret;
+
+	printf("multibinary_blake2s test: ");
+
+	ret = posix_memalign((void *)&mgr, 64, sizeof(BLAKE2S_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+	for (i = 0; i < MAX_MSG_LEN; i++)
+		msg_buf[i] = i % 251;
+	for (i = 0; i < BLAKE2S_MAX_KEY_SIZE; i++)
+		key_buf[i] = i;
+	for (i = 0; i < BLAKE2S_SALT_SIZE; i++)
+		salt_buf[i] = 0x40 + i;
+	for (i = 0; i < BLAKE2S_PERSONAL_SIZE; i++)
+		personal_buf[i] = 0x60 + i;
+
+	blake2s_ctx_mgr_init(mgr);
+
+	// Whole messages, all sharing the one manager
+	for (i = 0; i < MSGS; i++) {
+		if (vector_init(&ctxpool[i], i)) {
+			printf("blake2s_ctx_init failed on vector %d\n", i);
+			return 1;
+		}
+		ctx = blake2s_ctx_mgr_submit(mgr, &ctxpool[i], vector_msg(i), vectors[i].len,
+					 HASH_ENTIRE);
+		if (ctx) {
+			if (ctx->error) {
+				printf("submit error %d on vector %d\n", ctx->error, i);
+				return 1;
+			}
+			fail += check_digest((int)(ctx - ctxpool), ctx);
+			checked++;
+		}
+	}
+	while ((ctx = blake2s_ctx_mgr_flush(mgr)) != NULL) {
+		fail += check_digest((int)(ctx - ctxpool), ctx);
+		checked++;
+	}
+	if (checked != MSGS) {
+		printf("only %d of %d contexts returned\n", checked, MSGS);
+		fail++;
+	}
+
+	// Odd sized pieces, then whole blocks so the held back block is a full one
+	fail += chunked_test(mgr, ctxpool, 7);
+	fail += chunked_test(mgr, ctxpool, BLAKE2S_BLOCK_SIZE);
+
+	// Out of range parameters are refused
+	if (!blake2s_ctx_init(&ctxpool[0], 0, NULL, 0, NULL, NULL) ||
+	    !blake2s_ctx_init(&ctxpool[0], BLAKE2S_MAX_DIGEST_SIZE + 1, NULL, 0, NULL, NULL) ||
+	    !blake2s_ctx_init(&ctxpool[0], BLAKE2S_MAX_DIGEST_SIZE, key_buf, BLAKE2S_MAX_KEY_SIZE + 1,
+			   NULL, NULL)) {
+		printf("bad parameters accepted\n");
+		fail++;
+	}
+
+	aligned_free(mgr);
+
+	if (fail)
+		printf("Test failed function check %d\n", fail);
+	else
+		printf(" multibinary_blake2s test: Pass\n");
+
+	return fail;
+}
@@ -0,0 +1,153 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <string.h>
+#include "blake2s_mb.h"
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+// Reference BLAKE2s Functions
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#define ror(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static const BLAKE2S_WORD_T ref_iv[8] = { BLAKE2S_INITIAL_DIGEST };
+
+static const uint8_t ref_sigma[10][16] = {
+	{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+	{14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+	{11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+	{7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+	{9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+	{2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+	{12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+	{13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+	{6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+	{10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0}
+};
+
+static BLAKE2S_WORD_T ref_load(const uint8_t * p)
+{
+	BLAKE2S_WORD_T x = 0;
+	int i;
+
+	for (i = sizeof(x) - 1; i >= 0; i--)
+		x = (x << 8) | p[i];
+	return x;
+}
+
+static void ref_g(BLAKE2S_WORD_T v[16], int a, int b, int c, int d, BLAKE2S_WORD_T x, BLAKE2S_WORD_T y)
+{
+	v[a] = v[a] + v[b] + x;
+	v[d] = ror(v[d] ^ v[a], 16);
+	v[c] = v[c] + v[d];
+	v[b] = ror(v[b] ^ v[c], 12);
+	v[a] = v[a] + v[b] + y;
+	v[d] = ror(v[d] ^ v[a], 8);
+	v[c] = v[c] + v[d];
+	v[b] = ror(v[b] ^ v[c], 7);
+}
+
+static void ref_compress(BLAKE2S_WORD_T h[8], const uint8_t block[BLAKE2S_BLOCK_SIZE], uint64_t t,
+			 int last)
+{
+	BLAKE2S_WORD_T v[16], m[16];
+	const uint8_t *s;
+	int i, r;
+
+	for (i = 0; i < 16; i++)
+		m[i] = ref_load(&block[i * sizeof(BLAKE2S_WORD_T)]);
+	for (i = 0; i < 8; i++) {
+		v[i] = h[i];
+		v[i + 8] = ref_iv[i];
+	}
+	v[12] ^= (BLAKE2S_WORD_T) t;
+	v[13] ^= (BLAKE2S_WORD_T) (t >> 32 >> (32 - 32));
+	if (last)
+		v[14] = ~v[14];
+
+	for (r = 0; r < 10; r++) {
+		s = ref_sigma[r % 10];
+		ref_g(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+		ref_g(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+		ref_g(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+		ref_g(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+		ref_g(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+		ref_g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+		ref_g(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+		ref_g(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+	}
+	for (i = 0; i < 8; i++)
+		h[i] ^= v[i] ^ v[i + 8];
+}
+
+void blake2s_ref(const uint8_t * input_data, uint64_t len, const uint8_t * key, uint32_t key_len,
+	     const uint8_t * salt, const uint8_t * personal, uint8_t * digest,
+	     uint32_t digest_len)
+{
+	uint8_t block[BLAKE2S_BLOCK_SIZE], param[8 * sizeof(BLAKE2S_WORD_T)];
+	BLAKE2S_WORD_T h[8];
+	uint64_t t = 0;
+	uint32_t fill = 0, i;
+
+	memset(param, 0, sizeof(param));
+	param[0] = digest_len;
+	param[1] = key_len;
+	param[2] = 1;
+	param[3] = 1;
+	if (salt)
+		memcpy(&param[4 * sizeof(BLAKE2S_WORD_T)], salt, BLAKE2S_SALT_SIZE);
+	if (personal)
+		memcpy(&param[6 * sizeof(BLAKE2S_WORD_T)], personal, BLAKE2S_PERSONAL_SIZE);
+	for (i = 0; i < 8; i++)
+		h[i] = ref_iv[i] ^ ref_load(&param[i * sizeof(BLAKE2S_WORD_T)]);
+
+	memset(block, 0, sizeof(block));
+	if (key_len) {
+		memcpy(block, key, key_len);
+		fill = BLAKE2S_BLOCK_SIZE;
+	}
+
+	while (len--) {
+		if (fill == BLAKE2S_BLOCK_SIZE) {
+			t += BLAKE2S_BLOCK_SIZE;
+			ref_compress(h, block, t, 0);
+			fill = 0;
+		}
+		block[fill++] = *input_data++;
+	}
+
+	t += fill;
+	memset(&block[fill], 0, BLAKE2S_BLOCK_SIZE - fill);
+	ref_compress(h, block, t, 1);
+
+	for (i = 0; i < digest_len; i++)
+		digest[i] = (uint8_t) (h[i / sizeof(BLAKE2S_WORD_T)] >> (8 * (i % sizeof(BLAKE2S_WORD_T))));
+}
@@ -0,0 +1,172 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stddef.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#include "isal_crypto_dispatch.h"
+#include "dispatch_table.h"
+
+/*
+ * State of an interface made by mbin_interface in aarch64_multibinary.h and
+ * its DEFINE_INTERFACE_DISPATCHER() function.
+ */
+struct aarch64_dispatch {
+	void **dispatcher_info;		// call pointer, *_mbinit until selected
+	void *(*dispatcher)(void);
+	const char **variant;		// set by PROVIDER_INFO()
+};
+
+#define DISPATCH_INTERFACES(X) \
+	X(sha1_ctx_mgr_init) X(sha1_ctx_mgr_submit) X(sha1_ctx_mgr_flush) \
+	X(sha256_ctx_mgr_init) X(sha256_ctx_mgr_submit) X(sha256_ctx_mgr_flush) \
+	X(sha512_ctx_mgr_init) X(sha512_ctx_mgr_submit) X(sha512_ctx_mgr_flush) \
+	X(md5_ctx_mgr_init) X(md5_ctx_mgr_submit) X(md5_ctx_mgr_flush) \
+	X(sm3_ctx_mgr_init) X(sm3_ctx_mgr_submit) X(sm3_ctx_mgr_flush) \
+	X(mh_sha1_update) X(mh_sha1_finalize) \
+	X(mh_sha256_update) X(mh_sha256_finalize) \
+	X(mh_sha1_murmur3_x64_128_update) X(mh_sha1_murmur3_x64_128_finalize) \
+	X(rolling_hash2_run_until) \
+	X(aes_gcm_init_128) X(aes_gcm_enc_128) X(aes_gcm_enc_128_update) \
+	X(aes_gcm_enc_128_finalize) X(aes_gcm_dec_128) X(aes_gcm_dec_128_update) \
+	X(aes_gcm_dec_128_finalize) X(aes_gcm_precomp_128) \
+	X(aes_gcm_init_256) X(aes_gcm_enc_256) X(aes_gcm_enc_256_update) \
+	X(aes_gcm_enc_256_finalize) X(aes_gcm_dec_256) X(aes_gcm_dec_256_update) \
+	X(aes_gcm_dec_256_finalize) X(aes_gcm_precomp_256) \
+	X(aes_gcm_enc_128_nt) X(aes_gcm_enc_128_update_nt) \
+	X(aes_gcm_dec_128_nt) X(aes_gcm_dec_128_update_nt) \
+	X(aes_gcm_enc_256_nt) X(aes_gcm_enc_256_update_nt) \
+	X(aes_gcm_dec_256_nt) X(aes_gcm_dec_256_update_nt) \
+	X(XTS_AES_128_enc) X(XTS_AES_128_enc_expanded_key) \
+	X(XTS_AES_128_dec) X(XTS_AES_128_dec_expanded_key) \
+	X(XTS_AES_256_enc) X(XTS_AES_256_enc_expanded_key) \
+	X(XTS_AES_256_dec) X(XTS_AES_256_dec_expanded_key) \
+	X(aes_keyexp_128) X(aes_keyexp_128_enc) X(aes_keyexp_192) X(aes_keyexp_256) \
+	X(aes_cbc_dec_128) X(aes_cbc_dec_192) X(aes_cbc_dec_256) \
+	X(aes_cbc_enc_128) X(aes_cbc_enc_192) X(aes_cbc_enc_256)
+
+// Interfaces built from base aliases on aarch64
+#define DISPATCH_FIXED_INTERFACES(X) \
+	X(sha3_ctx_mgr_init) X(sha3_ctx_mgr_submit) X(sha3_ctx_mgr_flush) \
+	X(blake2s_ctx_mgr_init) X(blake2s_ctx_mgr_submit) X(blake2s_ctx_mgr_flush) \
+	X(blake2b_ctx_mgr_init) X(blake2b_ctx_mgr_submit) X(blake2b_ctx_mgr_flush)
+
+#define DISPATCH_DECLARE(name) \
+	extern void *name##_dispatcher_info; \
+	extern void *name##_dispatcher(void); \
+	extern const char *name##_dispatched_variant ISAL_HIDDEN; \
+	static struct aarch64_dispatch name##_dispatch = { \
+		&name##_dispatcher_info, name##_dispatcher, &name##_dispatched_variant \
+	};
+#define DISPATCH_ENTRY(name) { #name, &name##_dispatch, NULL },
+#define DISPATCH_FIXED_ENTRY(name) DISPATCH_FIXED(name, name##_base)
+
+DISPATCH_INTERFACES(DISPATCH_DECLARE)
+
+const struct dispatch_table_entry dispatch_table[] = {
+	DISPATCH_INTERFACES(DISPATCH_ENTRY)
+	DISPATCH_FIXED_INTERFACES(DISPATCH_FIXED_ENTRY)
+};
+
+const int dispatch_table_size = sizeof(dispatch_table) / sizeof(dispatch_table[0]);
+
+const char dispatch_arch[] = "aarch64";
+
+// Select as *_mbinit does, unless the interface was already called
+static void *aarch64_dispatch_select(struct aarch64_dispatch *d)
+{
+	if (*d->variant == NULL)
+		*d->dispatcher_info = d->dispatcher();
+
+	return *d->dispatcher_info;
+}
+
+const char *dispatch_variant(const struct dispatch_table_entry *entry)
+{
+	struct aarch64_dispatch *d = entry->ref;
+
+	aarch64_dispatch_select(d);
+
+	return *d->variant;
+}
+
+#define DISPATCH_TARGET(name) \
+	void *name##_dispatch_target(void) \
+	{ \
+		return aarch64_dispatch_select(&name##_dispatch); \
+	}
+
+DISPATCH_TARGETS(DISPATCH_TARGET)
+
+// The aarch64 dispatchers have no ISA limit, their choice does not change
+void dispatch_reset(void)
+{
+}
+
+uint64_t dispatch_cpu_features(void)
+{
+	unsigned long hwcap = getauxval(AT_HWCAP);
+	uint64_t f = 0;
+
+	if (hwcap & HWCAP_ASIMD)
+		f |= ISAL_CPU_ARM_ASIMD;
+	if (hwcap & HWCAP_AES)
+		f |= ISAL_CPU_ARM_AES;
+	if (hwcap & HWCAP_PMULL)
+		f |= ISAL_CPU_ARM_PMULL;
+	if (hwcap & HWCAP_SHA1)
+		f |= ISAL_CPU_ARM_SHA1;
+	if (hwcap & HWCAP_SHA2)
+		f |= ISAL_CPU_ARM_SHA2;
+#ifdef HWCAP_SHA3
+	if (hwcap & HWCAP_SHA3)
+		f |= ISAL_CPU_ARM_SHA3;
+#endif
+#ifdef HWCAP_SHA512
+	if (hwcap & HWCAP_SHA512)
+		f |= ISAL_CPU_ARM_SHA512;
+#endif
+#ifdef HWCAP_SM3
+	if (hwcap & HWCAP_SM3)
+		f |= ISAL_CPU_ARM_SM3;
+#endif
+#ifdef HWCAP_SM4
+	if (hwcap & HWCAP_SM4)
+		f |= ISAL_CPU_ARM_SM4;
+#endif
+#ifdef HWCAP_SVE
+	if (hwcap & HWCAP_SVE)
+		f |= ISAL_CPU_ARM_SVE;
+#endif
+#if defined(AT_HWCAP2) && defined(HWCAP2_SVE2)
+	if (getauxval(AT_HWCAP2) & HWCAP2_SVE2)
+		f |= ISAL_CPU_ARM_SVE2;
+#endif
+	return f;
+}
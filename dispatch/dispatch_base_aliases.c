@@ -0,0 +1,84 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stddef.h>
+#include "md5_mb.h"
+#include "sha1_mb.h"
+#include "sha256_mb.h"
+#include "sha512_mb.h"
+#include "sm3_mb.h"
+#include "dispatch_table.h"
+
+// Without multibinary support every interface calls its base version
+#define DISPATCH_INTERFACES(X) \
+	X(sha1_ctx_mgr_init) X(sha1_ctx_mgr_submit) X(sha1_ctx_mgr_flush) \
+	X(sha256_ctx_mgr_init) X(sha256_ctx_mgr_submit) X(sha256_ctx_mgr_flush) \
+	X(sha512_ctx_mgr_init) X(sha512_ctx_mgr_submit) X(sha512_ctx_mgr_flush) \
+	X(md5_ctx_mgr_init) X(md5_ctx_mgr_submit) X(md5_ctx_mgr_flush) \
+	X(sm3_ctx_mgr_init) X(sm3_ctx_mgr_submit) X(sm3_ctx_mgr_flush) \
+	X(sha3_ctx_mgr_init) X(sha3_ctx_mgr_submit) X(sha3_ctx_mgr_flush) \
+	X(blake2s_ctx_mgr_init) X(blake2s_ctx_mgr_submit) X(blake2s_ctx_mgr_flush) \
+	X(blake2b_ctx_mgr_init) X(blake2b_ctx_mgr_submit) X(blake2b_ctx_mgr_flush) \
+	X(mh_sha1_update) X(mh_sha1_finalize) \
+	X(mh_sha256_update) X(mh_sha256_finalize) \
+	X(mh_sha1_murmur3_x64_128_update) X(mh_sha1_murmur3_x64_128_finalize) \
+	X(rolling_hash2_run_until)
+
+#define DISPATCH_ENTRY(name) DISPATCH_FIXED(name, name##_base)
+
+const struct dispatch_table_entry dispatch_table[] = {
+	DISPATCH_INTERFACES(DISPATCH_ENTRY)
+};
+
+const int dispatch_table_size = sizeof(dispatch_table) / sizeof(dispatch_table[0]);
+
+const char dispatch_arch[] = "noarch";
+
+const char *dispatch_variant(const struct dispatch_table_entry *entry)
+{
+	return entry->fixed;
+}
+
+// The interfaces are the plain functions calling their base versions
+#define DISPATCH_TARGET(name) \
+	void *name##_dispatch_target(void) \
+	{ \
+		return (void *)name; \
+	}
+
+DISPATCH_TARGETS(DISPATCH_TARGET)
+
+void dispatch_reset(void)
+{
+}
+
+uint64_t dispatch_cpu_features(void)
+{
+	return 0;
+}
@@ -0,0 +1,224 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "isal_crypto_dispatch.h"
+#include "dispatch_table.h"
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#else
+# include <cpuid.h>
+#endif
+
+/*
+ * Layout of the *_dispatch_info block emitted by mbin_interface in
+ * multibinary.asm. The first word is the *_dispatched call pointer.
+ */
+struct mbin_dispatch_info {
+	void *dispatched;		// current target, *_mbinit until selected
+	void *mbinit;			// initial target
+	void (*dispatch_init)(void);	// selects and stores the target
+	const char *variants;		// NUL separated candidate names
+	int32_t variant;		// index of the selected candidate or -1
+	int32_t reserved;
+};
+
+// Every mbin_interface of the x86 build, grouped as in the *_multibinary.asm files
+#define DISPATCH_INTERFACES(X) \
+	X(sha1_ctx_mgr_init) X(sha1_ctx_mgr_submit) X(sha1_ctx_mgr_flush) \
+	X(sha256_ctx_mgr_init) X(sha256_ctx_mgr_submit) X(sha256_ctx_mgr_flush) \
+	X(sha512_ctx_mgr_init) X(sha512_ctx_mgr_submit) X(sha512_ctx_mgr_flush) \
+	X(md5_ctx_mgr_init) X(md5_ctx_mgr_submit) X(md5_ctx_mgr_flush) \
+	X(sm3_ctx_mgr_init) X(sm3_ctx_mgr_submit) X(sm3_ctx_mgr_flush) \
+	X(sha3_ctx_mgr_init) X(sha3_ctx_mgr_submit) X(sha3_ctx_mgr_flush) \
+	X(blake2s_ctx_mgr_init) X(blake2s_ctx_mgr_submit) X(blake2s_ctx_mgr_flush) \
+	X(blake2b_ctx_mgr_init) X(blake2b_ctx_mgr_submit) X(blake2b_ctx_mgr_flush) \
+	X(mh_sha1_update) X(mh_sha1_finalize) \
+	X(mh_sha256_update) X(mh_sha256_finalize) \
+	X(mh_sha1_murmur3_x64_128_update) X(mh_sha1_murmur3_x64_128_finalize) \
+	X(rolling_hash2_run_until) \
+	X(aes_gcm_init_128) X(aes_gcm_enc_128) X(aes_gcm_enc_128_update) \
+	X(aes_gcm_enc_128_finalize) X(aes_gcm_dec_128) X(aes_gcm_dec_128_update) \
+	X(aes_gcm_dec_128_finalize) X(aes_gcm_precomp_128) \
+	X(aes_gcm_init_256) X(aes_gcm_enc_256) X(aes_gcm_enc_256_update) \
+	X(aes_gcm_enc_256_finalize) X(aes_gcm_dec_256) X(aes_gcm_dec_256_update) \
+	X(aes_gcm_dec_256_finalize) X(aes_gcm_precomp_256) \
+	X(aes_gcm_enc_128_nt) X(aes_gcm_enc_128_update_nt) \
+	X(aes_gcm_dec_128_nt) X(aes_gcm_dec_128_update_nt) \
+	X(aes_gcm_enc_256_nt) X(aes_gcm_enc_256_update_nt) \
+	X(aes_gcm_dec_256_nt) X(aes_gcm_dec_256_update_nt) \
+	X(XTS_AES_128_enc) X(XTS_AES_128_enc_expanded_key) \
+	X(XTS_AES_128_dec) X(XTS_AES_128_dec_expanded_key) \
+	X(XTS_AES_256_enc) X(XTS_AES_256_enc_expanded_key) \
+	X(XTS_AES_256_dec) X(XTS_AES_256_dec_expanded_key) \
+	X(aes_keyexp_128) X(aes_keyexp_128_enc) X(aes_keyexp_192) X(aes_keyexp_256) \
+	X(aes_cbc_dec_128) X(aes_cbc_dec_192) X(aes_cbc_dec_256) \
+	X(aes_cbc_enc_128) X(aes_cbc_enc_192) X(aes_cbc_enc_256)
+
+#define DISPATCH_DECLARE(name) extern struct mbin_dispatch_info name##_dispatch_info ISAL_HIDDEN;
+#define DISPATCH_ENTRY(name) { #name, &name##_dispatch_info, NULL },
+
+DISPATCH_INTERFACES(DISPATCH_DECLARE)
+
+const struct dispatch_table_entry dispatch_table[] = {
+	DISPATCH_INTERFACES(DISPATCH_ENTRY)
+};
+
+const int dispatch_table_size = sizeof(dispatch_table) / sizeof(dispatch_table[0]);
+
+#if defined(__x86_64__) || defined(_M_X64)
+const char dispatch_arch[] = "x86_64";
+#else
+const char dispatch_arch[] = "x86_32";
+#endif
+
+const char *dispatch_variant(const struct dispatch_table_entry *entry)
+{
+	struct mbin_dispatch_info *info = entry->ref;
+	const char *name;
+	int i;
+
+	if (info->dispatched == info->mbinit || info->variant < 0)
+		info->dispatch_init();
+
+	if (info->variants == NULL || info->variant < 0)
+		return NULL;
+
+	name = info->variants;
+	for (i = 0; i < info->variant && *name; i++)
+		name += strlen(name) + 1;
+
+	return *name ? name : NULL;
+}
+
+// Select as *_mbinit does, unless the interface was already called
+#define DISPATCH_TARGET(name) \
+	void *name##_dispatch_target(void) \
+	{ \
+		if (name##_dispatch_info.dispatched == name##_dispatch_info.mbinit) \
+			name##_dispatch_info.dispatch_init(); \
+		return name##_dispatch_info.dispatched; \
+	}
+
+DISPATCH_TARGETS(DISPATCH_TARGET)
+
+void dispatch_reset(void)
+{
+	int i;
+
+	for (i = 0; i < dispatch_table_size; i++) {
+		struct mbin_dispatch_info *info = dispatch_table[i].ref;
+
+		info->dispatched = info->mbinit;
+		info->variant = -1;
+	}
+}
+
+static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t r[4])
+{
+#if defined(_MSC_VER)
+	__cpuidex((int *)r, (int)leaf, (int)subleaf);
+#else
+	__cpuid_count(leaf, subleaf, r[0], r[1], r[2], r[3]);
+#endif
+}
+
+static uint32_t xgetbv0(void)
+{
+#if defined(_MSC_VER)
+	return (uint32_t) _xgetbv(0);
+#else
+	uint32_t eax, edx;
+
+	__asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return eax;
+#endif
+}
+
+// Same tests as the mbin_dispatch_* macros, FLAG_* values from reg_sizes.asm
+uint64_t dispatch_cpu_features(void)
+{
+	const uint32_t avx512_g1 = (1u << 16) | (1u << 17) | (1u << 28) | (1u << 30) | (1u << 31);
+	const uint32_t avx512_g2 = (1u << 6) | (1u << 8) | (1u << 9) | (1u << 10) |
+	    (1u << 11) | (1u << 12) | (1u << 14);
+	uint32_t r1[4], r7[4] = { 0 }, r7_1[4] = { 0 }, max_leaf, xcr0 = 0;
+	uint64_t f = 0;
+
+	cpuid(0, 0, r1);
+	max_leaf = r1[0];
+	cpuid(1, 0, r1);
+	if (max_leaf >= 7) {
+		cpuid(7, 0, r7);
+		if (r7[0] >= 1)
+			cpuid(7, 1, r7_1);
+	}
+	if (r1[2] & (1u << 27))	// OSXSAVE
+		xcr0 = xgetbv0();
+
+	if (r1[2] & (1u << 19))
+		f |= ISAL_CPU_X86_SSE4_1;
+	if (r1[2] & (1u << 20))
+		f |= ISAL_CPU_X86_SSE4_2;
+	if (r1[2] & (1u << 25))
+		f |= ISAL_CPU_X86_AESNI;
+	if (r1[2] & (1u << 1))
+		f |= ISAL_CPU_X86_PCLMULQDQ;
+	if (r7[1] & (1u << 29))
+		f |= ISAL_CPU_X86_SHANI;
+	if (r7[2] & (1u << 8))
+		f |= ISAL_CPU_X86_GFNI;
+
+	if ((xcr0 & 0x6) != 0x6)
+		return f;
+
+	if (r1[2] & (1u << 28))
+		f |= ISAL_CPU_X86_AVX;
+	if (r7[1] & (1u << 5))
+		f |= ISAL_CPU_X86_AVX2;
+	if (r7[2] & (1u << 9))
+		f |= ISAL_CPU_X86_VAES;
+	if (r7[2] & (1u << 10))
+		f |= ISAL_CPU_X86_VPCLMULQDQ;
+	if (r7_1[0] & (1u << 0))
+		f |= ISAL_CPU_X86_SHA512;
+	if (r7_1[0] & (1u << 1))
+		f |= ISAL_CPU_X86_SM3;
+
+	if ((xcr0 & 0xe0) != 0xe0)
+		return f;
+
+	if ((r7[1] & avx512_g1) == avx512_g1)
+		f |= ISAL_CPU_X86_AVX512;
+	if ((r7[2] & avx512_g2) == avx512_g2)
+		f |= ISAL_CPU_X86_AVX512_G2;
+
+	return f;
+}
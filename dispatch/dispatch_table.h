@@ -0,0 +1,81 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#ifndef _DISPATCH_TABLE_H_
+#define _DISPATCH_TABLE_H_
+
+#include <stdint.h>
+
+#if defined(__GNUC__) && !defined(_WIN32) && !defined(__CYGWIN__)
+# define ISAL_HIDDEN __attribute__((visibility("hidden")))
+#else
+# define ISAL_HIDDEN
+#endif
+
+/*
+ * One table per architecture lists every public interface of the build,
+ * dispatch_multibinary.c for x86, aarch64/dispatch_aarch64.c and
+ * dispatch_base_aliases.c for the builds without multibinary support.
+ */
+struct dispatch_table_entry {
+	const char *interface;
+	void *ref;		// arch specific dispatch state, NULL when fixed
+	const char *fixed;	// name of the only implementation
+};
+
+extern const struct dispatch_table_entry dispatch_table[] ISAL_HIDDEN;
+extern const int dispatch_table_size ISAL_HIDDEN;
+extern const char dispatch_arch[] ISAL_HIDDEN;
+
+// Selected implementation of an entry with a ref, selecting it if needed
+const char *dispatch_variant(const struct dispatch_table_entry *entry) ISAL_HIDDEN;
+
+// Make every interface select again on its next call
+void dispatch_reset(void) ISAL_HIDDEN;
+
+// ISAL_CPU_* features of the running CPU and OS
+uint64_t dispatch_cpu_features(void) ISAL_HIDDEN;
+
+// Read by the x86 *_dispatch_init functions
+extern uint32_t isal_crypto_max_isa_level ISAL_HIDDEN;
+
+// Interfaces that C code inside the library can resolve once and call directly
+#define DISPATCH_TARGETS(X) \
+	X(sha1_ctx_mgr_submit) X(sha256_ctx_mgr_submit) X(sha512_ctx_mgr_submit) \
+	X(md5_ctx_mgr_submit) X(sm3_ctx_mgr_submit)
+
+// Implementation the interface calls now, selecting it if needed
+#define DISPATCH_TARGET_DECLARE(name) void *name##_dispatch_target(void) ISAL_HIDDEN;
+
+DISPATCH_TARGETS(DISPATCH_TARGET_DECLARE)
+
+#define DISPATCH_FIXED(name, impl) \
+	{ #name, NULL, #impl },
+
+#endif // _DISPATCH_TABLE_H_
@@ -0,0 +1,187 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "isal_crypto_dispatch.h"
+#include "dispatch_table.h"
+
+uint32_t isal_crypto_max_isa_level = ISAL_ISA_MAX;
+
+static int isa_from_string(const char *s)
+{
+	static const char *const names[] = { "base", "sse", "avx", "avx2", "avx512" };
+	int i;
+
+	if (s[0] >= '0' && s[0] <= '0' + ISAL_ISA_MAX && s[1] == '\0')
+		return s[0] - '0';
+
+	for (i = 0; i <= ISAL_ISA_MAX; i++) {
+		const char *a = s, *b = names[i];
+
+		while (*a && (*a | 0x20) == *b)
+			a++, b++;
+		if (*a == '\0' && *b == '\0')
+			return i;
+	}
+	return -1;
+}
+
+static void isal_crypto_dispatch_env(void)
+{
+	const char *s = getenv("ISAL_CRYPTO_MAX_ISA");
+	int isa;
+
+	if (s == NULL)
+		return;
+
+	isa = isa_from_string(s);
+	if (isa >= 0)
+		isal_crypto_max_isa_level = (uint32_t) isa;
+}
+
+// Apply the environment before any interface can be dispatched
+#if defined(_MSC_VER)
+# pragma section(".CRT$XCU", read)
+__declspec(allocate(".CRT$XCU"))
+static void (*isal_crypto_dispatch_env_init)(void) = isal_crypto_dispatch_env;
+#else
+static void __attribute__((constructor)) isal_crypto_dispatch_env_init(void)
+{
+	isal_crypto_dispatch_env();
+}
+#endif
+
+static const struct dispatch_table_entry *dispatch_lookup(const char *interface)
+{
+	int i;
+
+	if (interface == NULL)
+		return NULL;
+
+	for (i = 0; i < dispatch_table_size; i++)
+		if (strcmp(dispatch_table[i].interface, interface) == 0)
+			return &dispatch_table[i];
+
+	return NULL;
+}
+
+static const char *dispatch_entry_variant(const struct dispatch_table_entry *entry)
+{
+	return entry->ref ? dispatch_variant(entry) : entry->fixed;
+}
+
+int isal_crypto_set_max_isa(int isa)
+{
+	if (isa < ISAL_ISA_BASE || isa > ISAL_ISA_MAX)
+		return -1;
+
+	isal_crypto_max_isa_level = (uint32_t) isa;
+	dispatch_reset();
+	return 0;
+}
+
+int isal_crypto_get_max_isa(void)
+{
+	return (int)isal_crypto_max_isa_level;
+}
+
+const char *isal_crypto_dispatched_variant(const char *interface)
+{
+	const struct dispatch_table_entry *entry = dispatch_lookup(interface);
+
+	if (entry == NULL)
+		return NULL;
+
+	return dispatch_entry_variant(entry);
+}
+
+int isal_crypto_dispatch_info(struct isal_crypto_dispatch_info *info,
+			      struct isal_crypto_dispatch_entry *entries, int max_entries)
+{
+	int i;
+
+	if (max_entries < 0 || (entries == NULL && max_entries != 0))
+		return -1;
+
+	if (info != NULL) {
+		info->arch = dispatch_arch;
+		info->cpu_features = dispatch_cpu_features();
+		info->max_isa = isal_crypto_get_max_isa();
+		info->num_interfaces = dispatch_table_size;
+	}
+
+	for (i = 0; i < dispatch_table_size && i < max_entries; i++) {
+		entries[i].interface = dispatch_table[i].interface;
+		entries[i].variant = dispatch_entry_variant(&dispatch_table[i]);
+	}
+
+	return dispatch_table_size;
+}
+
+const char *isal_crypto_cpu_feature_name(uint64_t feature)
+{
+	static const struct {
+		uint64_t feature;
+		const char *name;
+	} names[] = {
+		{ ISAL_CPU_X86_SSE4_1, "sse4_1" },
+		{ ISAL_CPU_X86_SSE4_2, "sse4_2" },
+		{ ISAL_CPU_X86_AESNI, "aesni" },
+		{ ISAL_CPU_X86_PCLMULQDQ, "pclmulqdq" },
+		{ ISAL_CPU_X86_SHANI, "shani" },
+		{ ISAL_CPU_X86_AVX, "avx" },
+		{ ISAL_CPU_X86_AVX2, "avx2" },
+		{ ISAL_CPU_X86_AVX512, "avx512" },
+		{ ISAL_CPU_X86_AVX512_G2, "avx512_g2" },
+		{ ISAL_CPU_X86_GFNI, "gfni" },
+		{ ISAL_CPU_X86_VAES, "vaes" },
+		{ ISAL_CPU_X86_VPCLMULQDQ, "vpclmulqdq" },
+		{ ISAL_CPU_X86_SHA512, "sha512" },
+		{ ISAL_CPU_X86_SM3, "sm3" },
+		{ ISAL_CPU_ARM_ASIMD, "asimd" },
+		{ ISAL_CPU_ARM_AES, "aes" },
+		{ ISAL_CPU_ARM_PMULL, "pmull" },
+		{ ISAL_CPU_ARM_SHA1, "sha1" },
+		{ ISAL_CPU_ARM_SHA2, "sha2" },
+		{ ISAL_CPU_ARM_SHA3, "sha3" },
+		{ ISAL_CPU_ARM_SHA512, "sha512" },
+		{ ISAL_CPU_ARM_SM3, "sm3" },
+		{ ISAL_CPU_ARM_SM4, "sm4" },
+		{ ISAL_CPU_ARM_SVE, "sve" },
+		{ ISAL_CPU_ARM_SVE2, "sve2" },
+	};
+	size_t i;
+
+	for (i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+		if (names[i].feature == feature)
+			return names[i].name;
+
+	return NULL;
+}
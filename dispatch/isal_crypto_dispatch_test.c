@@ -0,0 +1,227 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "isal_crypto_dispatch.h"
+#include "sha256_mb.h"
+
+static const char *const interfaces[] = {
+	"sha1_ctx_mgr_submit", "sha256_ctx_mgr_init", "sha256_ctx_mgr_submit",
+	"sha256_ctx_mgr_flush", "sha512_ctx_mgr_submit", "md5_ctx_mgr_submit",
+	"sm3_ctx_mgr_submit", "sha3_ctx_mgr_submit", "mh_sha256_update",
+	"rolling_hash2_run_until", "aes_gcm_enc_128", "XTS_AES_256_enc",
+	"aes_cbc_dec_128"
+};
+
+#define NUM_INTERFACES (sizeof(interfaces) / sizeof(interfaces[0]))
+
+// Lowest ISA level a variant name needs, from its suffix
+static int variant_isa(const char *name)
+{
+	if (strstr(name, "avx512") || strstr(name, "vaes"))
+		return ISAL_ISA_AVX512;
+	if (strstr(name, "avx2") || strstr(name, "gen4"))
+		return ISAL_ISA_AVX2;
+	if (strstr(name, "avx"))
+		return ISAL_ISA_AVX;
+	if (strstr(name, "sse") || strstr(name, "_x4"))
+		return ISAL_ISA_SSE;
+	return ISAL_ISA_BASE;
+}
+
+// Suffix after the interface name, to compare the variants of related functions
+static const char *variant_suffix(const char *interface)
+{
+	const char *name = isal_crypto_dispatched_variant(interface);
+
+	if (name == NULL)
+		return NULL;
+	return name + strlen(interface);
+}
+
+static int sha256_abc_test(void)
+{
+	static const uint32_t exp[SHA256_DIGEST_NWORDS] = {
+		0xBA7816BF, 0x8F01CFEA, 0x414140DE, 0x5DAE2223,
+		0xB00361A3, 0x96177A9C, 0xB410FF61, 0xF20015AD
+	};
+	SHA256_HASH_CTX_MGR *mgr = NULL;
+	SHA256_HASH_CTX ctx, *p;
+	int ret;
+
+	ret = posix_memalign((void *)&mgr, 64, sizeof(SHA256_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	sha256_ctx_mgr_init(mgr);
+	hash_ctx_init(&ctx);
+	p = sha256_ctx_mgr_submit(mgr, &ctx, "abc", 3, HASH_ENTIRE);
+	while (p == NULL && (p = sha256_ctx_mgr_flush(mgr)) != NULL) ;
+
+	ret = memcmp(ctx.job.result_digest, exp, sizeof(exp)) != 0;
+	free(mgr);
+	return ret;
+}
+
+static int dispatch_info_test(void)
+{
+	struct isal_crypto_dispatch_info info;
+	struct isal_crypto_dispatch_entry *entries;
+	int i, n, found = 0, fail = 0;
+
+	n = isal_crypto_dispatch_info(NULL, NULL, 0);
+	if (n <= 0 || isal_crypto_dispatch_info(&info, NULL, 1) != -1 ||
+	    isal_crypto_dispatch_info(&info, NULL, -1) != -1) {
+		printf("dispatch_info arguments not checked\n");
+		return 1;
+	}
+
+	entries = malloc(n * sizeof(*entries));
+	if (entries == NULL) {
+		printf("malloc failed test aborted\n");
+		return 1;
+	}
+
+	if (isal_crypto_dispatch_info(&info, entries, n) != n || info.num_interfaces != n ||
+	    info.arch == NULL || info.max_isa != isal_crypto_get_max_isa()) {
+		printf("dispatch_info summary wrong\n");
+		fail++;
+	}
+
+	for (i = 0; i < 64; i++) {
+		uint64_t feature = 1ULL << i;
+
+		if ((info.cpu_features & feature) && isal_crypto_cpu_feature_name(feature) == NULL) {
+			printf("no name for cpu feature bit %d\n", i);
+			fail++;
+		}
+	}
+
+	for (i = 0; i < n; i++) {
+		const char *variant = isal_crypto_dispatched_variant(entries[i].interface);
+
+		if (entries[i].variant != variant) {
+			printf("%s reported as %s and %s\n", entries[i].interface,
+			       entries[i].variant, variant);
+			fail++;
+		}
+		if (variant && strstr(variant, "avx512") &&
+		    !(info.cpu_features & ISAL_CPU_X86_AVX512)) {
+			printf("%s -> %s without avx512\n", entries[i].interface, variant);
+			fail++;
+		}
+		if (strcmp(entries[i].interface, "sha256_ctx_mgr_submit") == 0)
+			found = 1;
+	}
+
+	if (!found) {
+		printf("sha256_ctx_mgr_submit not listed\n");
+		fail++;
+	}
+
+	free(entries);
+	return fail;
+}
+
+int main(void)
+{
+	int isa, fail = 0;
+	size_t i;
+
+	printf("isal_crypto_dispatch_test: ");
+
+	if (isal_crypto_set_max_isa(-1) != -1 || isal_crypto_set_max_isa(ISAL_ISA_MAX + 1) != -1) {
+		printf("invalid level accepted\n");
+		return -1;
+	}
+
+	if (isal_crypto_dispatched_variant("no_such_interface") != NULL ||
+	    isal_crypto_dispatched_variant(NULL) != NULL) {
+		printf("unknown interface reported\n");
+		return -1;
+	}
+
+	for (isa = ISAL_ISA_MAX; isa >= ISAL_ISA_BASE; isa--) {
+		const char *init, *submit, *flush;
+
+		if (isal_crypto_set_max_isa(isa) != 0 || isal_crypto_get_max_isa() != isa) {
+			printf("level %d not set\n", isa);
+			fail++;
+			continue;
+		}
+
+		if (isal_crypto_dispatched_variant("sha256_ctx_mgr_submit") == NULL) {
+			printf("no variant for sha256_ctx_mgr_submit\n");
+			fail++;
+		}
+
+		for (i = 0; i < NUM_INTERFACES; i++) {
+			const char *name = isal_crypto_dispatched_variant(interfaces[i]);
+
+			if (name == NULL)
+				continue;
+			// Some interfaces start at SSE, there is no lower choice for them
+			if (strncmp(name, interfaces[i], strlen(interfaces[i])) != 0 ||
+			    (variant_isa(name) > isa && variant_isa(name) > ISAL_ISA_SSE)) {
+				printf("%s -> %s over level %d\n", interfaces[i], name, isa);
+				fail++;
+			}
+		}
+
+		// A manager is only usable when its init, submit and flush match
+		init = variant_suffix("sha256_ctx_mgr_init");
+		submit = variant_suffix("sha256_ctx_mgr_submit");
+		flush = variant_suffix("sha256_ctx_mgr_flush");
+		if (init && submit && flush && (strcmp(init, submit) || strcmp(init, flush))) {
+			printf("sha256 manager split over %s %s %s\n", init, submit, flush);
+			fail++;
+		}
+
+		if (sha256_abc_test()) {
+			printf("sha256 digest wrong at level %d\n", isa);
+			fail++;
+		}
+	}
+
+	isal_crypto_set_max_isa(ISAL_ISA_MAX);
+
+	fail += dispatch_info_test();
+
+	if (fail) {
+		printf("Fail\n");
+		return -1;
+	}
+
+	printf("Pass\n");
+	return 0;
+}
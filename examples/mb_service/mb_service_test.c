@@ -0,0 +1,169 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sha256_mb_service.h"
+
+#define MAX_LEN (16 * 1024)
+
+static uint32_t nproducers = 8;
+static uint32_t njobs = 4096;	/* per producer */
+static uint32_t nworkers = 0;
+
+struct producer {
+	sha256_mb_service *svc;
+	sha256_mb_svc_job *jobs;
+	uint32_t id;
+};
+
+static uint32_t callbacks;
+
+static void job_done(sha256_mb_svc_job * job, void *arg)
+{
+	__atomic_add_fetch((uint32_t *) arg, 1, __ATOMIC_RELAXED);
+}
+
+static void *producer_main(void *arg)
+{
+	struct producer *p = (struct producer *)arg;
+	uint32_t i;
+
+	for (i = 0; i < njobs; i++)
+		sha256_mb_service_submit(p->svc, &p->jobs[i]);
+
+	return NULL;
+}
+
+/* Single threaded reference through a plain ctx manager */
+static int digest_ref(const void *buf, uint32_t len, uint32_t * digest)
+{
+	SHA256_HASH_CTX_MGR *mgr = NULL;
+	SHA256_HASH_CTX ctx;
+
+	if (posix_memalign((void *)&mgr, 16, sizeof(*mgr)))
+		return -1;
+
+	sha256_ctx_mgr_init(mgr);
+	hash_ctx_init(&ctx);
+	if (!sha256_ctx_mgr_submit(mgr, &ctx, buf, len, HASH_ENTIRE))
+		sha256_ctx_mgr_flush(mgr);
+
+	memcpy(digest, ctx.job.result_digest, sizeof(ctx.job.result_digest));
+	free(mgr);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	sha256_mb_service *svc;
+	struct producer *prod;
+	pthread_t *threads;
+	uint8_t *data;
+	uint32_t i, j, polled = 0, fail = 0, expect_cb = 0;
+	uint32_t digest[SHA256_DIGEST_NWORDS];
+	int opt;
+
+	while ((opt = getopt(argc, argv, "p:j:n:")) != -1) {
+		switch (opt) {
+		case 'p':
+			nproducers = atoi(optarg);
+			break;
+		case 'j':
+			njobs = atoi(optarg);
+			break;
+		case 'n':
+			nworkers = atoi(optarg);
+			break;
+		default:
+			printf("Usage: %s [-p producers] [-j jobs per producer] [-n workers]\n",
+			       argv[0]);
+			return 1;
+		}
+	}
+
+	data = malloc(MAX_LEN + nproducers);
+	prod = calloc(nproducers, sizeof(*prod));
+	threads = calloc(nproducers, sizeof(*threads));
+	if (data == NULL || prod == NULL || threads == NULL) {
+		printf("alloc failed test aborted\n");
+		return 1;
+	}
+	for (i = 0; i < MAX_LEN + nproducers; i++)
+		data[i] = rand();
+
+	svc = sha256_mb_service_create(nworkers);
+	if (svc == NULL) {
+		printf("service create failed test aborted\n");
+		return 1;
+	}
+
+	for (i = 0; i < nproducers; i++) {
+		prod[i].svc = svc;
+		prod[i].id = i;
+		prod[i].jobs = calloc(njobs, sizeof(sha256_mb_svc_job));
+		if (prod[i].jobs == NULL) {
+			printf("alloc failed test aborted\n");
+			return 1;
+		}
+		for (j = 0; j < njobs; j++) {
+			sha256_mb_svc_job *job = &prod[i].jobs[j];
+			job->buffer = data + i;
+			job->len = rand() % MAX_LEN;
+			// Alternate callbacks and the completion queue
+			if (j & 1) {
+				job->done = job_done;
+				job->arg = &callbacks;
+				expect_cb++;
+			}
+		}
+	}
+
+	printf("sha256_mb_service: %d producers x %d jobs\n", nproducers, njobs);
+
+	for (i = 0; i < nproducers; i++)
+		pthread_create(&threads[i], NULL, producer_main, &prod[i]);
+
+	// Drain the completion queue while the producers run
+	while (polled < nproducers * njobs - expect_cb) {
+		if (sha256_mb_service_poll(svc))
+			polled++;
+		else
+			sched_yield();
+	}
+
+	for (i = 0; i < nproducers; i++)
+		pthread_join(threads[i], NULL);
+
+	sha256_mb_service_destroy(svc);
+
+	if (callbacks != expect_cb) {
+		printf("Test failed, %d of %d callbacks\n", callbacks, expect_cb);
+		return 1;
+	}
+
+	for (i = 0; i < nproducers; i++) {
+		for (j = 0; j < njobs; j++) {
+			sha256_mb_svc_job *job = &prod[i].jobs[j];
+
+			if (digest_ref(job->buffer, job->len, digest)) {
+				printf("alloc failed test aborted\n");
+				return 1;
+			}
+			if (job->ctx.error || !hash_ctx_complete(&job->ctx)
+			    || memcmp(digest, job->ctx.job.result_digest, sizeof(digest))) {
+				printf("Test failed, producer %d job %d\n", i, j);
+				fail++;
+			}
+		}
+		free(prod[i].jobs);
+	}
+
+	free(threads);
+	free(prod);
+	free(data);
+
+	printf("sha256_mb_service: %s\n", fail ? "Fail" : "Pass");
+	return fail;
+}
@@ -0,0 +1,314 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sha256_mb_service.h"
+
+#define CACHELINE 64
+
+/*
+ * Intrusive MPSC queue. Push is lock-free from any thread. Pop is only safe
+ * for one consumer at a time, so the owner and any thief take the consumer
+ * lock with a try-lock first; a thief never waits on a busy queue.
+ */
+struct mpsc_queue {
+	sha256_mb_svc_job *head;	/* last pushed, shared by producers */
+	char pad[CACHELINE - sizeof(void *)];
+	sha256_mb_svc_job *tail;	/* next to pop, consumer only */
+	int lock;
+	sha256_mb_svc_job stub;
+} __attribute__ ((aligned(CACHELINE)));
+
+struct worker {
+	struct mpsc_queue q;
+	sha256_mb_service *svc;
+	SHA256_HASH_CTX_MGR *mgr;
+	pthread_t thread;
+	uint32_t id;
+} __attribute__ ((aligned(CACHELINE)));
+
+struct sha256_mb_service {
+	struct mpsc_queue done;	/* completions without a callback */
+	struct worker *workers;
+	uint32_t nworkers;
+	uint32_t next;		/* round robin placement of new jobs */
+	int64_t queued;		/* jobs submitted but not yet taken by a worker */
+	uint32_t sleepers;
+	int stop;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+};
+
+static void mpsc_init(struct mpsc_queue *q)
+{
+	q->stub.next = NULL;
+	q->head = &q->stub;
+	q->tail = &q->stub;
+	q->lock = 0;
+}
+
+static void mpsc_push(struct mpsc_queue *q, sha256_mb_svc_job * job)
+{
+	sha256_mb_svc_job *prev;
+
+	job->next = NULL;
+	prev = __atomic_exchange_n(&q->head, job, __ATOMIC_ACQ_REL);
+	__atomic_store_n(&prev->next, job, __ATOMIC_RELEASE);
+}
+
+/* Caller holds the consumer lock */
+static sha256_mb_svc_job *mpsc_pop(struct mpsc_queue *q)
+{
+	sha256_mb_svc_job *tail = q->tail;
+	sha256_mb_svc_job *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+
+	if (tail == &q->stub) {
+		if (next == NULL)
+			return NULL;
+		q->tail = next;
+		tail = next;
+		next = __atomic_load_n(&next->next, __ATOMIC_ACQUIRE);
+	}
+
+	if (next) {
+		q->tail = next;
+		return tail;
+	}
+
+	// A producer is between the exchange and the link, try again later
+	if (tail != __atomic_load_n(&q->head, __ATOMIC_ACQUIRE))
+		return NULL;
+
+	// tail is the last job, put the stub behind it so it can be unlinked
+	mpsc_push(q, &q->stub);
+	next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+	if (next) {
+		q->tail = next;
+		return tail;
+	}
+
+	return NULL;
+}
+
+static sha256_mb_svc_job *mpsc_trypop(struct mpsc_queue *q)
+{
+	sha256_mb_svc_job *job;
+
+	if (__atomic_exchange_n(&q->lock, 1, __ATOMIC_ACQUIRE))
+		return NULL;
+
+	job = mpsc_pop(q);
+	__atomic_store_n(&q->lock, 0, __ATOMIC_RELEASE);
+
+	return job;
+}
+
+static void pin_to_core(uint32_t id)
+{
+#ifdef __linux__
+	cpu_set_t set;
+	long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (ncpus <= 0)
+		return;
+
+	CPU_ZERO(&set);
+	CPU_SET(id % ncpus, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+/* Own queue first, then steal from the neighbours in order */
+static sha256_mb_svc_job *service_take(sha256_mb_service * svc, struct worker *w)
+{
+	sha256_mb_svc_job *job;
+	uint32_t i;
+
+	for (i = 0; i < svc->nworkers; i++) {
+		if (__atomic_load_n(&svc->queued, __ATOMIC_ACQUIRE) <= 0)
+			return NULL;
+
+		job = mpsc_trypop(&svc->workers[(w->id + i) % svc->nworkers].q);
+		if (job) {
+			__atomic_sub_fetch(&svc->queued, 1, __ATOMIC_ACQ_REL);
+			return job;
+		}
+	}
+
+	return NULL;
+}
+
+static void service_complete(sha256_mb_service * svc, SHA256_HASH_CTX * ctx)
+{
+	// ctx is the first member of the job
+	sha256_mb_svc_job *job = (sha256_mb_svc_job *) ctx;
+
+	if (job->done)
+		job->done(job, job->arg);
+	else
+		mpsc_push(&svc->done, job);
+}
+
+/* Sleep until work is queued, returns 0 once the service is stopping and drained */
+static int service_wait(sha256_mb_service * svc)
+{
+	int run;
+
+	pthread_mutex_lock(&svc->lock);
+	__atomic_add_fetch(&svc->sleepers, 1, __ATOMIC_SEQ_CST);
+
+	while (__atomic_load_n(&svc->queued, __ATOMIC_SEQ_CST) <= 0 && !svc->stop)
+		pthread_cond_wait(&svc->cond, &svc->lock);
+
+	__atomic_sub_fetch(&svc->sleepers, 1, __ATOMIC_SEQ_CST);
+	run = !svc->stop || __atomic_load_n(&svc->queued, __ATOMIC_SEQ_CST) > 0;
+	pthread_mutex_unlock(&svc->lock);
+
+	return run;
+}
+
+static void *worker_main(void *arg)
+{
+	struct worker *w = (struct worker *)arg;
+	sha256_mb_service *svc = w->svc;
+	sha256_mb_svc_job *job;
+	SHA256_HASH_CTX *ctx;
+	uint32_t inflight = 0;
+
+	pin_to_core(w->id);
+
+	while (1) {
+		// Keep the lanes fed while there is queued work anywhere
+		while (inflight < SHA256_MAX_LANES && (job = service_take(svc, w)) != NULL) {
+			inflight++;
+			ctx = sha256_ctx_mgr_submit(w->mgr, &job->ctx, job->buffer, job->len,
+						    HASH_ENTIRE);
+			if (ctx) {
+				inflight--;
+				service_complete(svc, ctx);
+			}
+		}
+
+		if (inflight) {
+			// Nothing left to add, advance the lanes in use by one job
+			ctx = sha256_ctx_mgr_flush(w->mgr);
+			if (ctx) {
+				inflight--;
+				service_complete(svc, ctx);
+			}
+			continue;
+		}
+
+		if (__atomic_load_n(&svc->queued, __ATOMIC_ACQUIRE) > 0) {
+			// A push is half way through, let the producer finish it
+			sched_yield();
+			continue;
+		}
+
+		if (!service_wait(svc))
+			break;
+	}
+
+	return NULL;
+}
+
+static void service_stop(sha256_mb_service * svc, uint32_t started)
+{
+	uint32_t i;
+
+	pthread_mutex_lock(&svc->lock);
+	svc->stop = 1;
+	pthread_cond_broadcast(&svc->cond);
+	pthread_mutex_unlock(&svc->lock);
+
+	for (i = 0; i < started; i++)
+		pthread_join(svc->workers[i].thread, NULL);
+
+	for (i = 0; i < svc->nworkers; i++)
+		free(svc->workers[i].mgr);
+
+	pthread_cond_destroy(&svc->cond);
+	pthread_mutex_destroy(&svc->lock);
+	free(svc->workers);
+	free(svc);
+}
+
+sha256_mb_service *sha256_mb_service_create(uint32_t nthreads)
+{
+	sha256_mb_service *svc = NULL;
+	struct worker *w;
+	uint32_t i;
+
+	if (nthreads == 0) {
+		long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+		nthreads = ncpus > 0 ? (uint32_t) ncpus : 1;
+	}
+
+	if (posix_memalign((void **)&svc, CACHELINE, sizeof(*svc)))
+		return NULL;
+	memset(svc, 0, sizeof(*svc));
+
+	if (posix_memalign((void **)&svc->workers, CACHELINE, nthreads * sizeof(*w))) {
+		free(svc);
+		return NULL;
+	}
+	memset(svc->workers, 0, nthreads * sizeof(*w));
+
+	mpsc_init(&svc->done);
+	svc->nworkers = nthreads;
+	pthread_mutex_init(&svc->lock, NULL);
+	pthread_cond_init(&svc->cond, NULL);
+
+	for (i = 0; i < nthreads; i++) {
+		w = &svc->workers[i];
+		mpsc_init(&w->q);
+		w->svc = svc;
+		w->id = i;
+		if (posix_memalign((void **)&w->mgr, 16, sizeof(SHA256_HASH_CTX_MGR))) {
+			w->mgr = NULL;
+			service_stop(svc, 0);
+			return NULL;
+		}
+		sha256_ctx_mgr_init(w->mgr);
+	}
+
+	for (i = 0; i < nthreads; i++) {
+		if (pthread_create(&svc->workers[i].thread, NULL, worker_main, &svc->workers[i])) {
+			service_stop(svc, i);
+			return NULL;
+		}
+	}
+
+	return svc;
+}
+
+void sha256_mb_service_destroy(sha256_mb_service * svc)
+{
+	if (svc)
+		service_stop(svc, svc->nworkers);
+}
+
+void sha256_mb_service_submit(sha256_mb_service * svc, sha256_mb_svc_job * job)
+{
+	uint32_t i = __atomic_fetch_add(&svc->next, 1, __ATOMIC_RELAXED) % svc->nworkers;
+
+	hash_ctx_init(&job->ctx);
+
+	// Count the job before it becomes visible so a worker never sees it uncounted
+	__atomic_add_fetch(&svc->queued, 1, __ATOMIC_SEQ_CST);
+	mpsc_push(&svc->workers[i].q, job);
+
+	if (__atomic_load_n(&svc->sleepers, __ATOMIC_SEQ_CST)) {
+		pthread_mutex_lock(&svc->lock);
+		pthread_cond_signal(&svc->cond);
+		pthread_mutex_unlock(&svc->lock);
+	}
+}
+
+sha256_mb_svc_job *sha256_mb_service_poll(sha256_mb_service * svc)
+{
+	return mpsc_trypop(&svc->done);
+}
@@ -0,0 +1,47 @@
+#ifndef SHA256_MB_SERVICE_H_
+#define SHA256_MB_SERVICE_H_
+
+#include <stdint.h>
+#include "sha256_mb.h"
+
+/*
+ * Sharded multi-buffer SHA256 service.
+ *
+ * Each worker thread owns one SHA256_HASH_CTX_MGR and is pinned to a core.
+ * Any number of producer threads hand jobs to the workers through lock-free
+ * MPSC queues; an idle worker steals queued jobs from its neighbours so all
+ * managers keep their lanes full. Jobs are caller owned and never copied,
+ * so the service does no allocation per job.
+ */
+
+typedef struct sha256_mb_svc_job sha256_mb_svc_job;
+
+typedef void (*sha256_mb_svc_cb) (sha256_mb_svc_job * job, void *arg);
+
+struct sha256_mb_svc_job {
+	SHA256_HASH_CTX ctx;	/* digest is in ctx.job.result_digest, ctx.error is set on failure */
+	const void *buffer;
+	uint32_t len;
+	sha256_mb_svc_cb done;	/* called on the worker thread, NULL for the completion queue */
+	void *arg;
+	sha256_mb_svc_job *next;	/* owned by the service */
+};
+
+typedef struct sha256_mb_service sha256_mb_service;
+
+/* Start nthreads workers (0 picks one per online core). NULL on failure. */
+sha256_mb_service *sha256_mb_service_create(uint32_t nthreads);
+
+/* Finish all submitted jobs, stop the workers and free the service. */
+void sha256_mb_service_destroy(sha256_mb_service * svc);
+
+/* Queue a job from any thread. The job must stay valid until completed. */
+void sha256_mb_service_submit(sha256_mb_service * svc, sha256_mb_svc_job * job);
+
+/*
+ * Pop one job completed without a callback, NULL if none is ready.
+ * Only one thread may poll a given service at a time.
+ */
+sha256_mb_svc_job *sha256_mb_service_poll(sha256_mb_service * svc);
+
+#endif /* SHA256_MB_SERVICE_H_ */
@@ -196,8 +196,19 @@
 
 
 
+/**
+ * The dispatcher body returns PROVIDER_INFO(func), which also records the
+ * name of func in name##_dispatched_variant for isal_crypto_dispatch_info().
+ */
 #define DEFINE_INTERFACE_DISPATCHER(name)                               \
-	void * name##_dispatcher(void)
+	static void * name##_dispatcher_select(const char **mbin_variant); \
+	const char * name##_dispatched_variant                         \
+		__attribute__((visibility("hidden")));                  \
+	void * name##_dispatcher(void)                                  \
+	{                                                               \
+		return name##_dispatcher_select(&name##_dispatched_variant); \
+	}                                                               \
+	static void * name##_dispatcher_select(const char **mbin_variant)
 
 #define PROVIDER_BASIC(name)                                            \
 	PROVIDER_INFO(name##_base)
@@ -214,6 +225,7 @@
 		DIGNOSTIC_IGNORE(-Wnested-externs)			\
 		extern void  _func_entry(void);				\
 		DIGNOSTIC_POP()						\
+		*mbin_variant = #_func_entry;				\
 		_func_entry;						\
 	})
 
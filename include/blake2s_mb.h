@@ -0,0 +1,305 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#ifndef _BLAKE2S_MB_H_
+#define _BLAKE2S_MB_H_
+
+/**
+ *  @file blake2s_mb.h
+ *  @brief Multi-buffer CTX API BLAKE2s function prototypes and structures
+ *
+ * Interface for multi-buffer BLAKE2s functions
+ *
+ * <b> Multi-buffer BLAKE2s  Entire or First-Update..Update-Last </b>
+ *
+ * The interface follows the other multi-buffer hashes: a BLAKE2S_HASH_CTX_MGR schedules
+ * BLAKE2S_HASH_CTX objects given to it with blake2s_ctx_mgr_submit() and hands them back,
+ * in general out of order, from a later submit or blake2s_ctx_mgr_flush().
+ *
+ * Each BLAKE2S_HASH_CTX must be set up with blake2s_ctx_init() before first use, which takes
+ * the digest length and the optional key, salt and personalization of the hash. They
+ * are kept for every later HASH_FIRST submit of the ctx. Once a ctx is returned with
+ * HASH_CTX_STS_COMPLETE, the digest is the first digest_len bytes of
+ * job.result_digest with the words stored in little-endian byte order.
+ *
+ * BLAKE2s compresses the last block of a message differently from the others, so the
+ * ctx always keeps the last bytes it was given back until it is submitted with
+ * HASH_LAST.
+ *
+ * The BLAKE2s CTX interface functions are available in a base version and, on x86_64,
+ * AVX2 and AVX512 versions processing 8 and 16 messages at a time. A multibinary
+ * interface selects the appropriate version at runtime.
+ */
+
+#include <stdint.h>
+#include "multi_buffer.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hash Constants and Typedefs
+#define BLAKE2S_DIGEST_NWORDS		8
+#define BLAKE2S_MAX_LANES		16
+#define BLAKE2S_X8_LANES		8
+#define BLAKE2S_X16_LANES		16
+#define BLAKE2S_BLOCK_SIZE		64
+#define BLAKE2S_LOG2_BLOCK_SIZE		6
+#define BLAKE2S_MAX_DIGEST_SIZE		32
+#define BLAKE2S_MAX_KEY_SIZE		32
+#define BLAKE2S_SALT_SIZE		8
+#define BLAKE2S_PERSONAL_SIZE		8
+#define BLAKE2S_INITIAL_DIGEST		\
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, \
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+
+typedef uint32_t BLAKE2S_WORD_T;
+
+/** @brief Scheduler layer - Holds info describing a single BLAKE2s job for the multi-buffer manager */
+
+typedef struct {
+	uint8_t *buffer;	//!< pointer to data buffer for this job
+	uint64_t len;	//!< length of buffer for this job in blocks.
+	DECLARE_ALIGNED(BLAKE2S_WORD_T result_digest[BLAKE2S_DIGEST_NWORDS], 64);
+	uint64_t counter;	//!< bytes compressed so far, the message length for the last block
+	uint32_t last;	//!< set if the job is the last block of the message
+	JOB_STS status;	//!< output job status
+	void *user_data;	//!< pointer for user's job-related data
+} BLAKE2S_JOB;
+
+/** @brief Scheduler layer - Lane data */
+
+typedef struct {
+	BLAKE2S_JOB *job_in_lane;
+} BLAKE2S_LANE_DATA;
+
+/** @brief Scheduler layer - Holds state for multi-buffer BLAKE2s jobs */
+
+typedef struct {
+	uint64_t lens[BLAKE2S_MAX_LANES];	//!< blocks left in each lane shifted by 4, or'ed with the lane index
+	uint64_t unused_lanes;	//!< each nibble is index of an unused lane
+	BLAKE2S_LANE_DATA ldata[BLAKE2S_MAX_LANES];
+	uint32_t num_lanes_inuse;
+} BLAKE2S_MB_JOB_MGR;
+
+/** @brief Context layer - Holds state for multi-buffer BLAKE2s jobs */
+
+typedef struct {
+	BLAKE2S_MB_JOB_MGR mgr;
+} BLAKE2S_HASH_CTX_MGR;
+
+/** @brief Context layer - Holds info describing a single BLAKE2s job for the multi-buffer CTX manager */
+
+typedef struct {
+	BLAKE2S_JOB job;	// Must be at struct offset 0.
+	HASH_CTX_STS status;	//!< Context status flag
+	HASH_CTX_ERROR error;	//!< Context error flag
+	uint64_t total_length;	//!< Running counter of length processed for this CTX's job
+	const void *incoming_buffer;	//!< pointer to data input buffer for this CTX's job
+	uint32_t incoming_buffer_length;	//!< length of buffer for this job in bytes.
+	uint8_t partial_block_buffer[BLAKE2S_BLOCK_SIZE];	//!< CTX partial block, never empty once data is given
+	uint32_t partial_block_buffer_length;
+	void *user_data;	//!< pointer for user to keep any job-related data
+	BLAKE2S_WORD_T initial_digest[BLAKE2S_DIGEST_NWORDS];	//!< IV xor'ed with the parameter block
+	uint8_t key[BLAKE2S_MAX_KEY_SIZE];	//!< key set by blake2s_ctx_init()
+	uint32_t key_len;	//!< length of key in bytes, 0 for an unkeyed hash
+	uint32_t digest_len;	//!< length of the digest in bytes
+} BLAKE2S_HASH_CTX;
+
+/******************** multibinary function prototypes **********************/
+
+/**
+* @brief Initialize the BLAKE2s multi-buffer manager structure.
+*
+* @param mgr	Structure holding context level state info
+* @returns void
+*/
+void blake2s_ctx_mgr_init(BLAKE2S_HASH_CTX_MGR * mgr);
+
+/**
+* @brief  Submit a new BLAKE2s job to the multi-buffer manager.
+*
+* @param  mgr Structure holding context level state info
+* @param  ctx Structure holding ctx job info
+* @param  buffer Pointer to buffer to be processed
+* @param  len Length of buffer (in bytes) to be processed
+* @param  flags Input flag specifying job type (first, update, last or entire)
+* @returns NULL if no jobs complete or pointer to jobs structure.
+*/
+BLAKE2S_HASH_CTX *blake2s_ctx_mgr_submit(BLAKE2S_HASH_CTX_MGR * mgr, BLAKE2S_HASH_CTX * ctx,
+				 const void *buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+* @brief Finish all submitted BLAKE2s jobs and return when complete.
+*
+* @param mgr	Structure holding context level state info
+* @returns NULL if no jobs to complete or pointer to jobs structure.
+*/
+BLAKE2S_HASH_CTX *blake2s_ctx_mgr_flush(BLAKE2S_HASH_CTX_MGR * mgr);
+
+/**
+* @brief  Set up a BLAKE2s ctx for a digest length, key, salt and personalization.
+*
+* Does what hash_ctx_init does for the other hashes, so the ctx is ready for a
+* HASH_FIRST submit.
+*
+* @param  ctx Structure holding ctx job info
+* @param  digest_len Length of the digest (in bytes), 1 to BLAKE2S_MAX_DIGEST_SIZE
+* @param  key Key of a keyed hash, or NULL
+* @param  key_len Length of key (in bytes), 0 to BLAKE2S_MAX_KEY_SIZE
+* @param  salt BLAKE2S_SALT_SIZE bytes of salt, or NULL for none
+* @param  personal BLAKE2S_PERSONAL_SIZE bytes of personalization, or NULL for none
+* @returns 0 on success, -1 on bad digest or key length
+*/
+int blake2s_ctx_init(BLAKE2S_HASH_CTX * ctx, uint32_t digest_len, const void *key, uint32_t key_len,
+		 const uint8_t * salt, const uint8_t * personal);
+
+/*******************************************************************
+ * CTX level API function prototypes
+ ******************************************************************/
+
+/**
+ * @brief Initialize the BLAKE2S multi-buffer manager structure.
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns void
+ */
+void blake2s_ctx_mgr_init_base(BLAKE2S_HASH_CTX_MGR * mgr);
+
+/**
+ * @brief  Submit a new BLAKE2S job to the multi-buffer manager.
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+BLAKE2S_HASH_CTX *blake2s_ctx_mgr_submit_base(BLAKE2S_HASH_CTX_MGR * mgr, BLAKE2S_HASH_CTX * ctx,
+					const void *buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all submitted BLAKE2S jobs and return when complete.
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+BLAKE2S_HASH_CTX *blake2s_ctx_mgr_flush_base(BLAKE2S_HASH_CTX_MGR * mgr);
+
+/**
+ * @brief Initialize the BLAKE2S multi-buffer manager structure.
+ * @requires AVX2
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns void
+ */
+void blake2s_ctx_mgr_init_avx2(BLAKE2S_HASH_CTX_MGR * mgr);
+
+/**
+ * @brief  Submit a new BLAKE2S job to the multi-buffer manager.
+ * @requires AVX2
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+BLAKE2S_HASH_CTX *blake2s_ctx_mgr_submit_avx2(BLAKE2S_HASH_CTX_MGR * mgr, BLAKE2S_HASH_CTX * ctx,
+					const void *buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all submitted BLAKE2S jobs and return when complete.
+ * @requires AVX2
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+BLAKE2S_HASH_CTX *blake2s_ctx_mgr_flush_avx2(BLAKE2S_HASH_CTX_MGR * mgr);
+
+/**
+ * @brief Initialize the BLAKE2S multi-buffer manager structure.
+ * @requires AVX512
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns void
+ */
+void blake2s_ctx_mgr_init_avx512(BLAKE2S_HASH_CTX_MGR * mgr);
+
+/**
+ * @brief  Submit a new BLAKE2S job to the multi-buffer manager.
+ * @requires AVX512
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+BLAKE2S_HASH_CTX *blake2s_ctx_mgr_submit_avx512(BLAKE2S_HASH_CTX_MGR * mgr, BLAKE2S_HASH_CTX * ctx,
+					  const void *buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all submitted BLAKE2S jobs and return when complete.
+ * @requires AVX512
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+BLAKE2S_HASH_CTX *blake2s_ctx_mgr_flush_avx512(BLAKE2S_HASH_CTX_MGR * mgr);
+
+
+/*******************************************************************
+ * Scheduler (internal) level out-of-order function prototypes
+ ******************************************************************/
+
+void blake2s_mb_mgr_init_base(BLAKE2S_MB_JOB_MGR * state);
+BLAKE2S_JOB *blake2s_mb_mgr_submit_base(BLAKE2S_MB_JOB_MGR * state, BLAKE2S_JOB * job);
+BLAKE2S_JOB *blake2s_mb_mgr_flush_base(BLAKE2S_MB_JOB_MGR * state);
+
+void blake2s_mb_mgr_init_avx2(BLAKE2S_MB_JOB_MGR * state);
+BLAKE2S_JOB *blake2s_mb_mgr_submit_avx2(BLAKE2S_MB_JOB_MGR * state, BLAKE2S_JOB * job);
+BLAKE2S_JOB *blake2s_mb_mgr_flush_avx2(BLAKE2S_MB_JOB_MGR * state);
+
+void blake2s_mb_mgr_init_avx512(BLAKE2S_MB_JOB_MGR * state);
+BLAKE2S_JOB *blake2s_mb_mgr_submit_avx512(BLAKE2S_MB_JOB_MGR * state, BLAKE2S_JOB * job);
+BLAKE2S_JOB *blake2s_mb_mgr_flush_avx512(BLAKE2S_MB_JOB_MGR * state);
+
+void blake2s_mb_x8_avx2(BLAKE2S_JOB * jobs[BLAKE2S_X8_LANES], uint64_t len);
+void blake2s_mb_x16_avx512(BLAKE2S_JOB * jobs[BLAKE2S_X16_LANES], uint64_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _BLAKE2S_MB_H_
@@ -0,0 +1,195 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+/**
+ *  @file  isal_crypto_dispatch.h
+ *  @brief Control and report the multibinary dispatch
+ *
+ *  Every multibinary interface (sha256_ctx_mgr_submit, aes_gcm_enc_128,
+ *  XTS_AES_256_enc, ...) binds itself on its first call to the widest
+ *  implementation the CPU supports. The functions here put a process wide
+ *  limit on that choice and report the implementation each interface uses.
+ *
+ *  The limit can also be given with the ISAL_CRYPTO_MAX_ISA environment
+ *  variable, read once when the library is loaded. It accepts one of
+ *  "base", "sse", "avx", "avx2" or "avx512", or the matching ISAL_ISA_*
+ *  number. With ISAL_CRYPTO_MAX_ISA=avx2 no 512-bit kernel is ever selected,
+ *  which avoids the frequency drop of the AVX512 license on hosts shared with
+ *  latency sensitive work.
+ *
+ *  isal_crypto_dispatch_info() lists every interface of the build with the
+ *  implementation it uses, together with the CPU features that were found,
+ *  so that throughput numbers can be tied to the code path that produced
+ *  them.
+ *
+ *  The limit is only honoured by the x86 dispatchers. An interface never goes
+ *  below its own lowest implementation, so a limit of ISAL_ISA_BASE still
+ *  runs the SSE code of interfaces that have no base version (the AES
+ *  functions).
+ */
+
+#ifndef _ISAL_CRYPTO_DISPATCH_H_
+#define _ISAL_CRYPTO_DISPATCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @brief ISA levels for isal_crypto_set_max_isa()
+ *
+ * A level allows the implementations that only need the instructions of that
+ * level or lower ones.
+ */
+enum {
+	ISAL_ISA_BASE = 0,  //!< Portable C code only
+	ISAL_ISA_SSE = 1,   //!< SSE4.x, AES-NI and SHA-NI on xmm registers
+	ISAL_ISA_AVX = 2,   //!< AVX on xmm registers
+	ISAL_ISA_AVX2 = 3,  //!< AVX2 on ymm registers
+	ISAL_ISA_AVX512 = 4, //!< AVX512, VAES and GFNI on zmm registers
+	ISAL_ISA_MAX = ISAL_ISA_AVX512
+};
+
+/**
+ * @brief Limit the ISA level the multibinary interfaces can dispatch to.
+ *
+ * Interfaces already bound to an implementation are reset and select again,
+ * under the new limit, on their next call. Call this before any other thread
+ * uses the library and before initializing any hash manager: a manager set
+ * up by one implementation can not be used by the submit and flush of
+ * another.
+ *
+ * @param isa   ISAL_ISA_BASE to ISAL_ISA_MAX
+ * @returns 0 - success, -1 - invalid level
+ */
+int isal_crypto_set_max_isa(int isa);
+
+/**
+ * @brief Get the current ISA limit of the multibinary interfaces.
+ *
+ * @returns ISAL_ISA_* level, ISAL_ISA_MAX when no limit was set
+ */
+int isal_crypto_get_max_isa(void);
+
+/**
+ * @brief Get the implementation a multibinary interface is bound to.
+ *
+ * Runs the selection of the interface if it was not called yet, so the
+ * answer is what its next call will run.
+ *
+ * @param interface  Name of the public function, e.g. "sha256_ctx_mgr_submit"
+ * @returns Name of the selected function, e.g. "sha256_ctx_mgr_submit_avx2",
+ *          or NULL if interface is unknown to this build or has no
+ *          implementation for this CPU
+ */
+const char *isal_crypto_dispatched_variant(const char *interface);
+
+/**
+ * @brief CPU features reported by isal_crypto_dispatch_info()
+ *
+ * Only reported when the OS also enables the matching register state.
+ */
+#define ISAL_CPU_X86_SSE4_1		(1ULL << 0)  //!< SSE4.1
+#define ISAL_CPU_X86_SSE4_2		(1ULL << 1)  //!< SSE4.2
+#define ISAL_CPU_X86_AESNI		(1ULL << 2)  //!< AES-NI
+#define ISAL_CPU_X86_PCLMULQDQ		(1ULL << 3)  //!< PCLMULQDQ
+#define ISAL_CPU_X86_SHANI		(1ULL << 4)  //!< SHA1 and SHA256 extensions
+#define ISAL_CPU_X86_AVX		(1ULL << 5)  //!< AVX
+#define ISAL_CPU_X86_AVX2		(1ULL << 6)  //!< AVX2
+#define ISAL_CPU_X86_AVX512		(1ULL << 7)  //!< AVX512 F, VL, BW, CD and DQ
+#define ISAL_CPU_X86_AVX512_G2		(1ULL << 8)  //!< AVX512 VBMI2, GFNI, VAES, VPCLMULQDQ, VNNI, BITALG and VPOPCNTDQ
+#define ISAL_CPU_X86_GFNI		(1ULL << 9)  //!< GFNI
+#define ISAL_CPU_X86_VAES		(1ULL << 10) //!< VAES
+#define ISAL_CPU_X86_VPCLMULQDQ		(1ULL << 11) //!< VPCLMULQDQ
+#define ISAL_CPU_X86_SHA512		(1ULL << 12) //!< SHA512 extension
+#define ISAL_CPU_X86_SM3		(1ULL << 13) //!< SM3 extension
+
+#define ISAL_CPU_ARM_ASIMD		(1ULL << 32) //!< Advanced SIMD
+#define ISAL_CPU_ARM_AES		(1ULL << 33) //!< AES crypto extension
+#define ISAL_CPU_ARM_PMULL		(1ULL << 34) //!< 64-bit polynomial multiply
+#define ISAL_CPU_ARM_SHA1		(1ULL << 35) //!< SHA1 crypto extension
+#define ISAL_CPU_ARM_SHA2		(1ULL << 36) //!< SHA256 crypto extension
+#define ISAL_CPU_ARM_SHA3		(1ULL << 37) //!< SHA3 crypto extension
+#define ISAL_CPU_ARM_SHA512		(1ULL << 38) //!< SHA512 crypto extension
+#define ISAL_CPU_ARM_SM3		(1ULL << 39) //!< SM3 crypto extension
+#define ISAL_CPU_ARM_SM4		(1ULL << 40) //!< SM4 crypto extension
+#define ISAL_CPU_ARM_SVE		(1ULL << 41) //!< Scalable Vector Extension
+#define ISAL_CPU_ARM_SVE2		(1ULL << 42) //!< Scalable Vector Extension 2
+
+/**
+ * @brief Implementation selected for one interface
+ */
+struct isal_crypto_dispatch_entry {
+	const char *interface;	//!< Public function, e.g. "aes_gcm_enc_128"
+	const char *variant;	//!< Function it runs, e.g. "aes_gcm_enc_128_vaes_avx512", or NULL if none
+};
+
+/**
+ * @brief Summary of the dispatch of this process
+ */
+struct isal_crypto_dispatch_info {
+	const char *arch;	//!< "x86_64", "x86_32", "aarch64" or "noarch"
+	uint64_t cpu_features;	//!< ISAL_CPU_* features of the running CPU
+	int max_isa;		//!< Current isal_crypto_set_max_isa() limit
+	int num_interfaces;	//!< Number of interfaces of this build
+};
+
+/**
+ * @brief Report the detected CPU features and the implementation of every
+ * interface.
+ *
+ * Like isal_crypto_dispatched_variant(), this selects the implementation of
+ * the interfaces that were not called yet. The strings are static and stay
+ * valid for the life of the process.
+ *
+ * @param info         Filled with the summary, may be NULL
+ * @param entries      Filled with up to max_entries interfaces, may be NULL
+ *                     when max_entries is 0
+ * @param max_entries  Size of entries
+ * @returns Number of interfaces of this build, which may be more than
+ *          max_entries, or -1 on invalid arguments
+ */
+int isal_crypto_dispatch_info(struct isal_crypto_dispatch_info *info,
+			      struct isal_crypto_dispatch_entry *entries, int max_entries);
+
+/**
+ * @brief Get the name of a CPU feature.
+ *
+ * @param feature  One ISAL_CPU_* bit
+ * @returns Lower case name, e.g. "avx512" or "sve", or NULL if unknown
+ */
+const char *isal_crypto_cpu_feature_name(uint64_t feature);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _ISAL_CRYPTO_DISPATCH_H_
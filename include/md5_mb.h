@@ -59,10 +59,11 @@
  *
  * <b>Usage:</b> The application creates a MD5_HASH_CTX_MGR object and initializes it
  * with a call to md5_ctx_mgr_init*() function, where henceforth "*" stands for the
- * relevant suffix for each architecture; _sse, _avx, _avx2, _avx512 (or no suffix for the
- * multibinary version). The MD5_HASH_CTX_MGR object will be used to schedule processor
- * resources, with up to 8 MD5_HASH_CTX objects (or 16 in AVX2 case, 32 in AVX512 case)
- * being processed at a time.
+ * relevant suffix for each architecture; _sse, _avx, _avx2, _avx512, _avx512vl (or no
+ * suffix for the multibinary version). The MD5_HASH_CTX_MGR object will be used to
+ * schedule processor resources, with up to 8 MD5_HASH_CTX objects (or 16 in AVX2 and
+ * AVX512VL case, 32 in AVX512 case) being processed at a time. The experimental
+ * md5_ctx_mgr_*_avx512_x64() functions take a MD5_HASH_CTX_MGR_X64 with up to 64.
  *
  * Each MD5_HASH_CTX must be initialized before first use by the hash_ctx_init macro
  * defined in multi_buffer.h. After initialization, the application may begin computing
@@ -116,9 +117,12 @@ extern "C" {
 #define MD5_DIGEST_NWORDS	4
 #define MD5_MAX_LANES		32
 #define MD5_MIN_LANES		8
+#define MD5_X16_LANES		16	//!< lanes in one zmm group of the x16x4 kernel
+#define MD5_X64_MAX_LANES	64	//!< lanes of the experimental x16x4 manager
 #define MD5_BLOCK_SIZE		64
 #define MD5_LOG2_BLOCK_SIZE	6
 #define MD5_PADLENGTHFIELD_SIZE	8
+#define MD5_HASH_SHORT_MAX_LEN	(2 * MD5_BLOCK_SIZE - 1 - MD5_PADLENGTHFIELD_SIZE)	//!< longest message of md5_mb_hash_short()
 #define MD5_INITIAL_DIGEST	\
 	0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476
 
@@ -164,6 +168,21 @@ typedef struct {
 	MD5_MB_JOB_MGR mgr;
 } MD5_HASH_CTX_MGR;
 
+/** @brief Scheduler layer - Holds state for the experimental 64-lane MD5 manager */
+
+typedef struct {
+    uint32_t lens[MD5_X64_MAX_LANES];	//!< blocks left in each lane
+    MD5_LANE_DATA ldata[MD5_X64_MAX_LANES];
+    uint32_t num_lanes;	//!< lanes run by the kernel, 16, 32, 48 or 64
+    uint32_t num_lanes_inuse;
+} MD5_MB_JOB_MGR_X64;
+
+/** @brief Context layer - Holds state for the experimental 64-lane MD5 manager */
+
+typedef struct {
+	MD5_MB_JOB_MGR_X64 mgr;
+} MD5_HASH_CTX_MGR_X64;
+
 /** @brief Context layer - Holds info describing a single MD5 job for the multi-buffer CTX manager */
 
 typedef struct {
@@ -176,8 +195,39 @@ typedef struct {
 	uint8_t        partial_block_buffer[MD5_BLOCK_SIZE * 2]; //!< CTX partial blocks
 	uint32_t       partial_block_buffer_length;
 	void*          user_data;	//!< pointer for user to keep any job-related data
+	const void*    pending_buffer;	//!< rest of a md5_ctx_mgr_submit_64() buffer not yet handed to the manager
+	uint64_t       pending_length;	//!< length of pending_buffer in bytes
+	HASH_CTX_FLAG  pending_flags;	//!< flags for the last piece of pending_buffer
 } MD5_HASH_CTX;
 
+/** @brief Context layer - Holds a MD5 ctx snapshot taken on a block boundary */
+
+typedef struct {
+	MD5_WORD_T     digest[MD5_DIGEST_NWORDS];	//!< hash state after total_length bytes
+	uint64_t       total_length;	//!< bytes hashed so far, a whole number of blocks
+} MD5_MIDSTATE;
+
+/** @brief Context layer - Holds a job kept back by the length-aware scheduler */
+
+typedef struct {
+	MD5_HASH_CTX*	ctx;	//!< ctx of the held back job
+	const void*	buffer;	//!< buffer passed to the scheduler submit
+	uint32_t	len;	//!< length of buffer in bytes
+	HASH_CTX_FLAG	flags;	//!< flags passed to the scheduler submit
+	HASH_CTX_STS	status;	//!< ctx status before the job was held back
+} MD5_SCHED_ENTRY;
+
+#define MD5_SCHED_QUEUE_MAX		(2 * MD5_MAX_LANES)
+
+/** @brief Context layer - MD5 manager with a length sorted submission queue */
+
+typedef struct {
+	MD5_HASH_CTX_MGR	mgr;
+	MD5_SCHED_ENTRY	queue[MD5_SCHED_QUEUE_MAX]; //!< pending jobs, sorted by length
+	uint32_t	queue_len;	//!< number of pending jobs
+	uint32_t	queue_depth;	//!< jobs held back before the longest is released
+} MD5_HASH_CTX_SCHED;
+
 /*******************************************************************
  * CTX level API function prototypes
  ******************************************************************/
@@ -310,6 +360,80 @@ MD5_HASH_CTX* md5_ctx_mgr_submit_avx512 (MD5_HASH_CTX_MGR* mgr, MD5_HASH_CTX* ct
  */
 MD5_HASH_CTX* md5_ctx_mgr_flush_avx512  (MD5_HASH_CTX_MGR* mgr);
 
+/**
+ * @brief Initialize the MD5 multi-buffer manager structure for 256-bit AVX512 code.
+ * @requires AVX512VL
+ *
+ * Same 16 lanes as the AVX2 manager but with the AVX512 rotate and ternary
+ * logic instructions on ymm registers, so the core stays out of the 512-bit
+ * frequency license.
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns void
+ */
+void      md5_ctx_mgr_init_avx512vl   (MD5_HASH_CTX_MGR* mgr);
+
+/**
+ * @brief  Submit a new MD5 job to the 256-bit AVX512 multi-buffer manager.
+ * @requires AVX512VL
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+MD5_HASH_CTX* md5_ctx_mgr_submit_avx512vl (MD5_HASH_CTX_MGR* mgr, MD5_HASH_CTX* ctx,
+				const void* buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all submitted MD5 jobs on the 256-bit AVX512 manager and return when complete.
+ * @requires AVX512VL
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+MD5_HASH_CTX* md5_ctx_mgr_flush_avx512vl  (MD5_HASH_CTX_MGR* mgr);
+
+/**
+ * @brief Initialize the experimental 64-lane MD5 multi-buffer manager.
+ * @requires AVX512
+ *
+ * Up to four groups of 16 lanes are hashed interleaved by one kernel call,
+ * which hides the latency of the dependent MD5 steps. num_lanes is rounded
+ * up to a multiple of 16 and clamped to 16...MD5_X64_MAX_LANES; submit only
+ * runs the kernel once that many jobs are in flight.
+ *
+ * @param mgr	Structure holding context level state info
+ * @param num_lanes	Number of lanes to fill before hashing
+ * @returns void
+ */
+void      md5_ctx_mgr_init_avx512_x64   (MD5_HASH_CTX_MGR_X64* mgr, uint32_t num_lanes);
+
+/**
+ * @brief  Submit a new MD5 job to the experimental 64-lane multi-buffer manager.
+ * @requires AVX512
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+MD5_HASH_CTX* md5_ctx_mgr_submit_avx512_x64 (MD5_HASH_CTX_MGR_X64* mgr, MD5_HASH_CTX* ctx,
+				const void* buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all MD5 jobs submitted to the 64-lane manager and return when complete.
+ * @requires AVX512
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+MD5_HASH_CTX* md5_ctx_mgr_flush_avx512_x64  (MD5_HASH_CTX_MGR_X64* mgr);
+
 /******************** multibinary function prototypes **********************/
 
 /**
@@ -344,6 +468,170 @@ MD5_HASH_CTX* md5_ctx_mgr_submit (MD5_HASH_CTX_MGR* mgr, MD5_HASH_CTX* ctx,
  */
 MD5_HASH_CTX* md5_ctx_mgr_flush  (MD5_HASH_CTX_MGR* mgr);
 
+/******************** batch submit **********************/
+
+/**
+ * @brief  Submit an array of MD5 jobs to the multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Equivalent to calling md5_ctx_mgr_submit() on each ctx[i] in turn with
+ * buffer[i] and len[i], but every ctx handed back by the manager is collected
+ * in the completed array instead of being returned one by one. Contexts that
+ * were rejected are returned there as well with their error member set.
+ *
+ * The flags are checked and the selected submit is looked up once per
+ * batch rather than per job. Invalid flags reject the whole batch: every
+ * ctx is returned in completed with HASH_CTX_ERROR_INVALID_FLAGS set.
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Array of num structures holding ctx job info
+ * @param  buffer Array of num pointers to buffers to be processed
+ * @param  len Array of num buffer lengths (in bytes)
+ * @param  num Number of jobs to submit
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @param  completed Array of at least num entries that receives returned jobs
+ * @param  num_completed Number of entries written to completed
+ * @returns void
+ */
+void md5_ctx_mgr_submit_batch(MD5_HASH_CTX_MGR* mgr, MD5_HASH_CTX* ctx[],
+			      const void* buffer[], const uint32_t len[], uint32_t num,
+			      HASH_CTX_FLAG flags, MD5_HASH_CTX* completed[],
+			      uint32_t* num_completed);
+
+/******************** hashing of many buffers **********************/
+
+/**
+ * @brief  Hash a set of independent buffers with MD5 in one call.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Stateless helper that owns a MD5_HASH_CTX_MGR and a pool of contexts and
+ * drives submit and flush until every buffer is hashed. Jobs are started
+ * longest first so lanes stay busy until the end. Buffers larger than 4GB are
+ * accepted and fed to the manager in several updates.
+ *
+ * @param  bufs Array of n pointers to buffers to be hashed
+ * @param  lens Array of n buffer lengths (in bytes)
+ * @param  n Number of buffers
+ * @param  digests Array of n digests receiving the result of each buffer
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int md5_mb_hash_many(const void* bufs[], const uint64_t lens[], uint32_t n,
+		     uint8_t (*digests)[MD5_DIGEST_NWORDS * 4]);
+
+/******************** length-aware scheduler **********************/
+
+/**
+ * @brief Initialize the length-aware MD5 scheduler.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * The scheduler holds up to depth submitted jobs in a queue sorted by length
+ * and only hands the longest of them to the multi-buffer manager once the
+ * queue is full (longest-processing-time-first). Long jobs then start early
+ * and the jobs left for the flush tail are the short ones, so fewer lanes sit
+ * idle while the last long job runs. A depth of 0 disables the queue.
+ *
+ * @param sched	Structure holding scheduler and context level state info
+ * @param depth	Number of jobs to hold back, at most MD5_SCHED_QUEUE_MAX
+ * @returns void
+ */
+void md5_ctx_sched_init(MD5_HASH_CTX_SCHED* sched, uint32_t depth);
+
+/**
+ * @brief  Submit a new MD5 job through the length-aware scheduler.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Same semantics as md5_ctx_mgr_submit(). A held back ctx is marked as
+ * processing until it is returned by a later submit or flush.
+ *
+ * @param  sched Structure holding scheduler and context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+MD5_HASH_CTX* md5_ctx_sched_submit(MD5_HASH_CTX_SCHED* sched, MD5_HASH_CTX* ctx,
+				   const void* buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all jobs held by the MD5 scheduler and return when complete.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * @param sched	Structure holding scheduler and context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+MD5_HASH_CTX* md5_ctx_sched_flush(MD5_HASH_CTX_SCHED* sched);
+
+/******************** jobs larger than 4GB **********************/
+
+/**
+ * @brief Submit a MD5 job of up to 2^64 - 1 bytes to the multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Same as md5_ctx_mgr_submit() with a 64-bit length. Buffers too long for
+ * one lane scheduling round are handed to the manager in pieces as earlier
+ * pieces complete, so the ctx is only returned once all of buffer has been
+ * processed. Jobs are finished with md5_ctx_mgr_flush() and can share mgr
+ * with jobs from md5_ctx_mgr_submit().
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+MD5_HASH_CTX* md5_ctx_mgr_submit_64(MD5_HASH_CTX_MGR* mgr, MD5_HASH_CTX* ctx,
+				    const void* buffer, uint64_t len, HASH_CTX_FLAG flags);
+
+/******************** saved midstates **********************/
+
+/**
+ * @brief Save the state of a MD5 ctx for md5_ctx_midstate_restore().
+ *
+ * ctx must be idle on a block boundary, i.e. returned from HASH_FIRST or
+ * HASH_UPDATE submits whose lengths add up to a whole number of blocks. A
+ * midstate is only valid with the library build and CPU that produced it.
+ *
+ * @param ctx	Structure holding ctx job info
+ * @param ms	Structure receiving the midstate
+ * @returns 0 on success, -1 if ctx is busy, complete or has a partial block
+ */
+int md5_ctx_midstate_save(const MD5_HASH_CTX* ctx, MD5_MIDSTATE* ms);
+
+/**
+ * @brief Start a MD5 ctx from a saved midstate instead of the initial digest.
+ *
+ * ctx is left idle as if the prefix the midstate was taken after had just
+ * been submitted to it. Continue the job with HASH_UPDATE or HASH_LAST, not
+ * HASH_FIRST. Any number of contexts can be started from the same midstate.
+ *
+ * @param ctx	Structure holding ctx job info
+ * @param ms	Midstate from md5_ctx_midstate_save()
+ * @returns 0 on success, -1 if ctx is being processed
+ */
+int md5_ctx_midstate_restore(MD5_HASH_CTX* ctx, const MD5_MIDSTATE* ms);
+
+/******************** short messages **********************/
+
+/**
+ * @brief  Hash a set of short messages of one fixed length with MD5 in one call.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * For keys and fingerprints of up to MD5_HASH_SHORT_MAX_LEN bytes, which
+ * fit in one or two blocks once padded. The padding is laid out once per lane
+ * and each message is hashed as whole blocks, bypassing the copy into
+ * partial_block_buffer and the padding step of the ctx manager.
+ *
+ * @param  msgs Array of n pointers to messages of len bytes
+ * @param  len Length of every message (in bytes), at most MD5_HASH_SHORT_MAX_LEN
+ * @param  n Number of messages
+ * @param  digests Array of n digests receiving the result of each message
+ * @returns 0 on success, -1 on message too long or job error
+ */
+int md5_mb_hash_short(const void* msgs[], uint32_t len, uint32_t n,
+		      uint8_t (*digests)[MD5_DIGEST_NWORDS * 4]);
+
 
 /*******************************************************************
  * Scheduler (internal) level out-of-order function prototypes
@@ -365,6 +653,17 @@ void  md5_mb_mgr_init_avx512            (MD5_MB_JOB_MGR *state);
 MD5_JOB* md5_mb_mgr_submit_avx512       (MD5_MB_JOB_MGR *state, MD5_JOB* job);
 MD5_JOB* md5_mb_mgr_flush_avx512        (MD5_MB_JOB_MGR *state);
 
+void  md5_mb_mgr_init_avx512vl          (MD5_MB_JOB_MGR *state);
+MD5_JOB* md5_mb_mgr_submit_avx512vl     (MD5_MB_JOB_MGR *state, MD5_JOB* job);
+MD5_JOB* md5_mb_mgr_flush_avx512vl      (MD5_MB_JOB_MGR *state);
+void  md5_mb_x8x2_avx512vl              (MD5_JOB *jobs[16], uint64_t len);
+
+void  md5_mb_mgr_init_avx512_x64        (MD5_MB_JOB_MGR_X64 *state, uint32_t num_lanes);
+MD5_JOB* md5_mb_mgr_submit_avx512_x64   (MD5_MB_JOB_MGR_X64 *state, MD5_JOB* job);
+MD5_JOB* md5_mb_mgr_flush_avx512_x64    (MD5_MB_JOB_MGR_X64 *state);
+void  md5_mb_x16x4_avx512               (MD5_JOB *jobs[MD5_X64_MAX_LANES], uint64_t len,
+					 uint32_t num_groups);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,6 +33,7 @@
 %ifidn __OUTPUT_FORMAT__, elf32
  %define mbin_def_ptr	dd
  %define mbin_ptr_sz	dword
+ %define mbin_ptr_bytes	4
  %define mbin_rdi	edi
  %define mbin_rsi	esi
  %define mbin_rax	eax
@@ -42,6 +43,7 @@
 %else
  %define mbin_def_ptr	dq
  %define mbin_ptr_sz	qword
+ %define mbin_ptr_bytes	8
  %define mbin_rdi	rdi
  %define mbin_rsi	rsi
  %define mbin_rax	rax
@@ -54,19 +56,39 @@
 %define AS_FEATURE_LEVEL 4
 %endif
 
+;;;;
+; ISA levels, must match ISAL_ISA_* in isal_crypto_dispatch.h
+;;;;
+%define ISAL_ISA_BASE	0
+%define ISAL_ISA_SSE	1
+%define ISAL_ISA_AVX	2
+%define ISAL_ISA_AVX2	3
+%define ISAL_ISA_AVX512	4
+
+extern isal_crypto_max_isa_level
+
 ;;;;
 ; multibinary macro:
 ;   creates the visable entry point that uses HW optimized call pointer
 ;   creates the init of the HW optimized call pointer
+;   creates *_dispatch_info, the layout of struct mbin_dispatch_info
 ;;;;
 %macro mbin_interface 1
 	;;;;
 	; *_dispatched is defaulted to *_mbinit and replaced on first call.
 	; Therefore, *_dispatch_init is only executed on first call.
+	; isal_crypto_set_max_isa() re-arms it by copying back the second word.
 	;;;;
 	section .data
+	align	8
+	mk_global %1_dispatch_info, data, hidden
+	%1_dispatch_info:
 	%1_dispatched:
-		mbin_def_ptr	%1_mbinit
+		mbin_def_ptr	%1_mbinit	; current target
+		mbin_def_ptr	%1_mbinit	; initial target
+		mbin_def_ptr	%1_dispatch_init
+		mbin_def_ptr	0		; candidate names, set by *_dispatch_init
+		dd		-1, 0		; selected candidate
 
 	section .text
 	mk_global %1, function
@@ -78,6 +100,54 @@
 		jmp	mbin_ptr_sz [%1_dispatched]
 %endmacro
 
+;;;;;
+; mbin_isa_cap parameters
+;  Stop the search at the current choice when the process wide ISA limit
+;  (isal_crypto_set_max_isa / ISAL_CRYPTO_MAX_ISA) is below a level.
+;  Clobbers flags only.
+; 1-> ISAL_ISA_* level needed by the next step
+; 2-> label to continue at when the level is not allowed
+;;;;;
+%macro mbin_isa_cap 2
+		cmp	dword [isal_crypto_max_isa_level], %1
+		jb	%2
+%endmacro
+
+;;;;;
+; mbin_dispatch_record parameters
+;  Records in *_dispatch_info the list of candidates and the index of the
+;  one in mbin_rsi. Expects mbin_rax and mbin_rbx to be free.
+; 1-> function name
+; 2...-> candidate functions, in the order of the dispatch macro
+;;;;;
+%macro mbin_dispatch_record 2-*
+	section .data
+	%%variants:
+	%rep %0 - 1
+		%rotate 1
+		%defstr %%variant %1
+		db	%%variant, 0
+	%endrep
+	db	0
+	%rotate 1
+
+	section .text
+		lea	mbin_rax, [%%variants]
+		mov	[%1_dispatch_info + 3 * mbin_ptr_bytes], mbin_rax
+		mov	eax, -1
+	%assign %%i 0
+	%rep %0 - 1
+		%rotate 1
+		lea	mbin_rbx, [%1 WRT_OPT]
+		cmp	mbin_rsi, mbin_rbx
+		mov	ebx, %%i
+		cmove	eax, ebx
+		%assign %%i %%i + 1
+	%endrep
+	%rotate 1
+		mov	[%1_dispatch_info + 4 * mbin_ptr_bytes], eax
+%endmacro
+
 ;;;;;
 ; mbin_dispatch_init parameters
 ; Use this function when SSE/00/01 is a minimum requirement
@@ -89,6 +159,7 @@
 %macro mbin_dispatch_init 4
 	section .text
 	%1_dispatch_init:
+		endbranch
 		push	mbin_rsi
 		push	mbin_rax
 		push	mbin_rbx
@@ -96,6 +167,7 @@
 		push	mbin_rdx
 		lea	mbin_rsi, [%2 WRT_OPT] ; Default to SSE 00/01
 
+		mbin_isa_cap ISAL_ISA_AVX, _%1_init_done
 		mov	eax, 1
 		cpuid
 		and	ecx, (FLAG_CPUID1_ECX_AVX | FLAG_CPUID1_ECX_OSXSAVE)
@@ -104,6 +176,7 @@
 		jne	_%1_init_done ; AVX is not available so end
 		mov	mbin_rsi, mbin_rbx
 
+		mbin_isa_cap ISAL_ISA_AVX2, _%1_ymm_check
 		;; Try for AVX2
 		xor	ecx, ecx
 		mov	eax, 7
@@ -112,6 +185,7 @@
 		lea	mbin_rbx, [%4 WRT_OPT] ; AVX (gen4) opt func
 		cmovne	mbin_rsi, mbin_rbx
 
+	_%1_ymm_check:
 		;; Does it have xmm and ymm support
 		xor	ecx, ecx
 		xgetbv
@@ -121,6 +195,7 @@
 		lea	mbin_rsi, [%2 WRT_OPT]
 
 	_%1_init_done:
+		mbin_dispatch_record %1, %2, %3, %4
 		pop	mbin_rdx
 		pop	mbin_rcx
 		pop	mbin_rbx
@@ -139,8 +214,14 @@
 %macro mbin_dispatch_init2 2
 	section .text
 	%1_dispatch_init:
+		endbranch
 		push	mbin_rsi
+		push	mbin_rax
+		push	mbin_rbx
 		lea	mbin_rsi, [%2 WRT_OPT] ; Default
+		mbin_dispatch_record %1, %2
+		pop	mbin_rbx
+		pop	mbin_rax
 		mov	[%1_dispatched], mbin_rsi
 		pop	mbin_rsi
 		ret
@@ -157,6 +238,7 @@
 %macro mbin_dispatch_init5 5
 	section .text
 	%1_dispatch_init:
+		endbranch
 		push	mbin_rsi
 		push	mbin_rax
 		push	mbin_rbx
@@ -164,6 +246,7 @@
 		push	mbin_rdx
 		lea	mbin_rsi, [%2 WRT_OPT] ; Default - use base function
 
+		mbin_isa_cap ISAL_ISA_SSE, _%1_init_done
 		mov	eax, 1
 		cpuid
 		; Test for SSE4.1
@@ -171,12 +254,14 @@
 		lea	mbin_rbx, [%3 WRT_OPT] ; SSE opt func
 		cmovne	mbin_rsi, mbin_rbx
 
+		mbin_isa_cap ISAL_ISA_AVX, _%1_init_done
 		and	ecx, (FLAG_CPUID1_ECX_AVX | FLAG_CPUID1_ECX_OSXSAVE)
 		cmp	ecx, (FLAG_CPUID1_ECX_AVX | FLAG_CPUID1_ECX_OSXSAVE)
 		lea	mbin_rbx, [%4 WRT_OPT] ; AVX (gen2) opt func
 		jne	_%1_init_done ; AVX is not available so end
 		mov	mbin_rsi, mbin_rbx
 
+		mbin_isa_cap ISAL_ISA_AVX2, _%1_ymm_check
 		;; Try for AVX2
 		xor	ecx, ecx
 		mov	eax, 7
@@ -185,6 +270,7 @@
 		lea	mbin_rbx, [%5 WRT_OPT] ; AVX (gen4) opt func
 		cmovne	mbin_rsi, mbin_rbx
 
+	_%1_ymm_check:
 		;; Does it have xmm and ymm support
 		xor	ecx, ecx
 		xgetbv
@@ -194,6 +280,7 @@
 		lea	mbin_rsi, [%3 WRT_OPT]
 
 	_%1_init_done:
+		mbin_dispatch_record %1, %2, %3, %4, %5
 		pop	mbin_rdx
 		pop	mbin_rcx
 		pop	mbin_rbx
@@ -216,6 +303,7 @@
 %macro mbin_dispatch_init6 6
 	section .text
 	%1_dispatch_init:
+		endbranch
 		push	mbin_rsi
 		push	mbin_rax
 		push	mbin_rbx
@@ -224,6 +312,7 @@
 		push	mbin_rdi
 		lea	mbin_rsi, [%2 WRT_OPT] ; Default - use base function
 
+		mbin_isa_cap ISAL_ISA_SSE, _%1_init_done
 		mov	eax, 1
 		cpuid
 		mov	ebx, ecx ; save cpuid1.ecx
@@ -231,6 +320,7 @@
 		je	_%1_init_done	  ; Use base function if no SSE4_1
 		lea	mbin_rsi, [%3 WRT_OPT] ; SSE possible so use 00/01 opt
 
+		mbin_isa_cap ISAL_ISA_AVX, _%1_init_done
 		;; Test for XMM_YMM support/AVX
 		test	ecx, FLAG_CPUID1_ECX_OSXSAVE
 		je	_%1_init_done
@@ -245,6 +335,7 @@
 		je	_%1_init_done
 		lea	mbin_rsi, [%4 WRT_OPT] ; AVX/02 opt
 
+		mbin_isa_cap ISAL_ISA_AVX2, _%1_init_done
 		;; Test for AVX2
 		xor	ecx, ecx
 		mov	eax, 7
@@ -253,6 +344,7 @@
 		je	_%1_init_done		; No AVX2 possible
 		lea	mbin_rsi, [%5 WRT_OPT] 	; AVX2/04 opt func
 
+		mbin_isa_cap ISAL_ISA_AVX512, _%1_init_done
 		;; Test for AVX512
 		and	edi, FLAG_XGETBV_EAX_ZMM_OPM
 		cmp	edi, FLAG_XGETBV_EAX_ZMM_OPM
@@ -263,6 +355,7 @@
 		cmove	mbin_rsi, mbin_rbx
 
 	_%1_init_done:
+		mbin_dispatch_record %1, %2, %3, %4, %5, %6
 		pop	mbin_rdi
 		pop	mbin_rdx
 		pop	mbin_rcx
@@ -293,6 +386,7 @@
 %macro mbin_dispatch_init7 7
 	section .text
 	%1_dispatch_init:
+		endbranch
 		push	mbin_rsi
 		push	mbin_rax
 		push	mbin_rbx
@@ -301,6 +395,7 @@
 		push	mbin_rdi
 		lea	mbin_rsi, [%2 WRT_OPT] ; Default - use base function
 
+		mbin_isa_cap ISAL_ISA_SSE, _%1_init_done
 		mov	eax, 1
 		cpuid
 		mov	ebx, ecx ; save cpuid1.ecx
@@ -308,6 +403,7 @@
 		je	_%1_init_done	  ; Use base function if no SSE4_2
 		lea	mbin_rsi, [%3 WRT_OPT] ; SSE possible so use 00/01 opt
 
+		mbin_isa_cap ISAL_ISA_AVX, _%1_init_done
 		;; Test for XMM_YMM support/AVX
 		test	ecx, FLAG_CPUID1_ECX_OSXSAVE
 		je	_%1_init_done
@@ -322,6 +418,7 @@
 		je	_%1_init_done
 		lea	mbin_rsi, [%4 WRT_OPT] ; AVX/02 opt
 
+		mbin_isa_cap ISAL_ISA_AVX2, _%1_init_done
 		;; Test for AVX2
 		xor	ecx, ecx
 		mov	eax, 7
@@ -330,6 +427,7 @@
 		je	_%1_init_done		; No AVX2 possible
 		lea	mbin_rsi, [%5 WRT_OPT] 	; AVX2/04 opt func
 
+		mbin_isa_cap ISAL_ISA_AVX512, _%1_init_done
 		;; Test for AVX512
 		and	edi, FLAG_XGETBV_EAX_ZMM_OPM
 		cmp	edi, FLAG_XGETBV_EAX_ZMM_OPM
@@ -345,6 +443,7 @@
 		cmove	mbin_rsi, mbin_rbx
 
 	_%1_init_done:
+		mbin_dispatch_record %1, %2, %3, %4, %5, %6, %7
 		pop	mbin_rdi
 		pop	mbin_rdx
 		pop	mbin_rcx
@@ -373,6 +472,7 @@
 %macro mbin_dispatch_sse_to_avx2_shani 5
 	section .text
 	%1_dispatch_init:
+		endbranch
 		push	mbin_rsi
 		push	mbin_rax
 		push	mbin_rbx
@@ -380,6 +480,8 @@
 		push	mbin_rdx
 		lea	mbin_rsi, [%2 WRT_OPT] ; Default to SSE 00/01
 
+		mbin_isa_cap ISAL_ISA_SSE, _%1_init_done
+		mbin_isa_cap ISAL_ISA_AVX, _%1_shani_check
 		mov	eax, 1
 		cpuid
 		and	ecx, (FLAG_CPUID1_ECX_AVX | FLAG_CPUID1_ECX_OSXSAVE)
@@ -388,6 +490,7 @@
 		jne	_%1_shani_check ; AVX is not available so check shani
 		mov	mbin_rsi, mbin_rbx
 
+		mbin_isa_cap ISAL_ISA_AVX2, _%1_ymm_check
 		;; Try for AVX2
 		xor	ecx, ecx
 		mov	eax, 7
@@ -396,6 +499,7 @@
 		lea	mbin_rbx, [%4 WRT_OPT] ; AVX (gen4) opt func
 		cmovne	mbin_rsi, mbin_rbx
 
+	_%1_ymm_check:
 		;; Does it have xmm and ymm support
 		xor	ecx, ecx
 		xgetbv
@@ -405,6 +509,7 @@
 		lea	mbin_rsi, [%2 WRT_OPT]
 
 	_%1_init_done:
+		mbin_dispatch_record %1, %2, %3, %4, %5
 		pop	mbin_rdx
 		pop	mbin_rcx
 		pop	mbin_rbx
@@ -438,6 +543,7 @@
 %macro mbin_dispatch_base_to_avx512_shani 8
 	section .text
 	%1_dispatch_init:
+		endbranch
 		push	mbin_rsi
 		push	mbin_rax
 		push	mbin_rbx
@@ -446,6 +552,7 @@
 		push	mbin_rdi
 		lea	mbin_rsi, [%2 WRT_OPT] ; Default - use base function
 
+		mbin_isa_cap ISAL_ISA_SSE, _%1_init_done
 		mov	eax, 1
 		cpuid
 		mov	ebx, ecx ; save cpuid1.ecx
@@ -453,6 +560,7 @@
 		je	_%1_init_done	  ; Use base function if no SSE4_2
 		lea	mbin_rsi, [%3 WRT_OPT] ; SSE possible so use 00/01 opt
 
+		mbin_isa_cap ISAL_ISA_AVX, _%1_shani_check
 		;; Test for XMM_YMM support/AVX
 		test	ecx, FLAG_CPUID1_ECX_OSXSAVE
 		je	_%1_shani_check
@@ -467,6 +575,7 @@
 		je	_%1_shani_check
 		lea	mbin_rsi, [%4 WRT_OPT] ; AVX/02 opt
 
+		mbin_isa_cap ISAL_ISA_AVX2, _%1_init_done
 		;; Test for AVX2
 		xor	ecx, ecx
 		mov	eax, 7
@@ -475,6 +584,7 @@
 		je	_%1_init_done		; No AVX2 possible
 		lea	mbin_rsi, [%5 WRT_OPT] 	; AVX2/04 opt func
 
+		mbin_isa_cap ISAL_ISA_AVX512, _%1_init_done
 		;; Test for AVX512
 		and	edi, FLAG_XGETBV_EAX_ZMM_OPM
 		cmp	edi, FLAG_XGETBV_EAX_ZMM_OPM
@@ -493,6 +603,7 @@
 		cmovne	mbin_rsi, mbin_rbx
 
 	_%1_init_done:
+		mbin_dispatch_record %1, %2, %3, %4, %5, %6, %7, %8
 		pop	mbin_rdi
 		pop	mbin_rdx
 		pop	mbin_rcx
@@ -66,6 +66,9 @@
 %define FLAG_CPUID7_ECX_BITALG         (1 << 12)
 %define FLAG_CPUID7_ECX_VPOPCNTDQ      (1 << 14)
 
+%define FLAG_CPUID7_1_EAX_SHA512       (1 << 0)
+%define FLAG_CPUID7_1_EAX_SM3          (1 << 1)
+
 %define FLAGS_CPUID7_EBX_AVX512_G1 (FLAG_CPUID7_EBX_AVX512F | FLAG_CPUID7_EBX_AVX512VL | FLAG_CPUID7_EBX_AVX512BW | FLAG_CPUID7_EBX_AVX512CD | FLAG_CPUID7_EBX_AVX512DQ)
 %define FLAGS_CPUID7_ECX_AVX512_G2 (FLAG_CPUID7_ECX_AVX512VBMI2 | FLAG_CPUID7_ECX_GFNI | FLAG_CPUID7_ECX_VAES | FLAG_CPUID7_ECX_VPCLMULQDQ | FLAG_CPUID7_ECX_VNNI | FLAG_CPUID7_ECX_BITALG | FLAG_CPUID7_ECX_VPOPCNTDQ)
 
@@ -75,6 +78,8 @@
 %define FLAG_XGETBV_EAX_ZMM_OPM        0xe0
 
 %define FLAG_CPUID1_EAX_AVOTON     0x000406d0
+%define FLAG_CPUID1_EAX_ALDERLAKE_N  0x000b06e0
+%define FLAG_CPUID1_EAX_SIERRAFOREST 0x000a06f0
 %define FLAG_CPUID1_EAX_STEP_MASK  0xfffffff0
 
 ; define d and w variants for registers
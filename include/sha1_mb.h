@@ -124,6 +124,10 @@ extern "C" {
 #define SHA1_BLOCK_SIZE			64
 #define SHA1_LOG2_BLOCK_SIZE		6
 #define SHA1_PADLENGTHFIELD_SIZE	8
+#define SHA1_HASH_SHORT_MAX_LEN		(2 * SHA1_BLOCK_SIZE - 1 - SHA1_PADLENGTHFIELD_SIZE)	//!< longest message of sha1_mb_hash_short()
+#define SHA1_SB_THRESHOLD		1	//!< default single-buffer switch point for the mb managers
+#define SHA1_NI_SB_THRESHOLD_SSE	4	//!< SHA-NI beats the 4-lane SSE mb code at any occupancy
+#define SHA1_NI_SB_THRESHOLD_AVX512	6
 #define SHA1_INITIAL_DIGEST		\
 	0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
 
@@ -161,6 +165,7 @@ typedef struct {
 	uint64_t unused_lanes; //!< each nibble is index (0...3 or 0...7 or 0...15) of unused lanes, nibble 4 or 8 is set to F as a flag
 	SHA1_LANE_DATA ldata[SHA1_MAX_LANES];
 	uint32_t num_lanes_inuse;
+	uint32_t sb_threshold;	//!< hash on single-buffer code when num_lanes_inuse <= sb_threshold
 } SHA1_MB_JOB_MGR;
 
 /** @brief Context layer - Holds state for multi-buffer SHA1 jobs */
@@ -181,8 +186,70 @@ typedef struct {
 	uint8_t        partial_block_buffer[SHA1_BLOCK_SIZE * 2]; //!< CTX partial blocks
 	uint32_t       partial_block_buffer_length;
 	void*          user_data;	//!< pointer for user to keep any job-related data
+	const void*    pending_buffer;	//!< rest of a sha1_ctx_mgr_submit_64() buffer not yet handed to the manager
+	uint64_t       pending_length;	//!< length of pending_buffer in bytes
+	HASH_CTX_FLAG  pending_flags;	//!< flags for the last piece of pending_buffer
 } SHA1_HASH_CTX;
 
+/** @brief Context layer - Holds a SHA1 ctx snapshot taken on a block boundary */
+
+typedef struct {
+	SHA1_WORD_T    digest[SHA1_DIGEST_NWORDS];	//!< hash state after total_length bytes
+	uint64_t       total_length;	//!< bytes hashed so far, a whole number of blocks
+} SHA1_MIDSTATE;
+
+/** @brief Context layer - Holds the ipad and opad midstates of one HMAC-SHA1 key */
+
+typedef struct {
+	SHA1_MIDSTATE  ipad;	//!< state after hashing the key xor ipad block
+	SHA1_MIDSTATE  opad;	//!< state after hashing the key xor opad block
+} HMAC_SHA1_KEY;
+
+/** @brief Context layer - Holds info describing a single HMAC-SHA1 job */
+
+typedef struct {
+	SHA1_HASH_CTX  ctx;	//!< hash state, holds the MAC in ctx.job.result_digest once complete
+	const HMAC_SHA1_KEY* key;	//!< key of the job, set by the HASH_FIRST submit
+	SHA1_WORD_T    inner_digest[SHA1_DIGEST_NWORDS];	//!< inner hash in message byte order
+	int            outer;	//!< set once the outer hash is submitted
+} HMAC_SHA1_HASH_CTX;
+
+/** @brief Context layer - Holds state for multi-buffer HMAC-SHA1 jobs */
+
+typedef struct {
+	SHA1_HASH_CTX_MGR mgr;
+} HMAC_SHA1_HASH_CTX_MGR;
+
+#define MERKLE_SHA1_MAX_HEIGHT	64
+
+/** @brief Merkle tree - Pending subtrees of a SHA1 Merkle tree built by appending leaves */
+
+typedef struct {
+	uint8_t        frontier[MERKLE_SHA1_MAX_HEIGHT][SHA1_DIGEST_NWORDS * 4];	//!< root of the pending perfect subtree of each height
+	uint64_t       nleaves;	//!< number of leaves appended so far
+} MERKLE_SHA1_STATE;
+
+/** @brief Context layer - Holds a job kept back by the length-aware scheduler */
+
+typedef struct {
+	SHA1_HASH_CTX*	ctx;	//!< ctx of the held back job
+	const void*	buffer;	//!< buffer passed to the scheduler submit
+	uint32_t	len;	//!< length of buffer in bytes
+	HASH_CTX_FLAG	flags;	//!< flags passed to the scheduler submit
+	HASH_CTX_STS	status;	//!< ctx status before the job was held back
+} SHA1_SCHED_ENTRY;
+
+#define SHA1_SCHED_QUEUE_MAX		(2 * SHA1_MAX_LANES)
+
+/** @brief Context layer - SHA1 manager with a length sorted submission queue */
+
+typedef struct {
+	SHA1_HASH_CTX_MGR	mgr;
+	SHA1_SCHED_ENTRY	queue[SHA1_SCHED_QUEUE_MAX]; //!< pending jobs, sorted by length
+	uint32_t	queue_len;	//!< number of pending jobs
+	uint32_t	queue_depth;	//!< jobs held back before the longest is released
+} SHA1_HASH_CTX_SCHED;
+
 /******************** multibinary function prototypes **********************/
 
 /**
@@ -217,6 +284,383 @@ SHA1_HASH_CTX* sha1_ctx_mgr_submit (SHA1_HASH_CTX_MGR* mgr, SHA1_HASH_CTX* ctx,
  */
 SHA1_HASH_CTX* sha1_ctx_mgr_flush (SHA1_HASH_CTX_MGR* mgr);
 
+/******************** batch submit **********************/
+
+/**
+ * @brief  Submit an array of SHA1 jobs to the multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Equivalent to calling sha1_ctx_mgr_submit() on each ctx[i] in turn with
+ * buffer[i] and len[i], but every ctx handed back by the manager is collected
+ * in the completed array instead of being returned one by one. Contexts that
+ * were rejected are returned there as well with their error member set.
+ *
+ * The flags are checked and the selected submit is looked up once per
+ * batch rather than per job. Invalid flags reject the whole batch: every
+ * ctx is returned in completed with HASH_CTX_ERROR_INVALID_FLAGS set.
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Array of num structures holding ctx job info
+ * @param  buffer Array of num pointers to buffers to be processed
+ * @param  len Array of num buffer lengths (in bytes)
+ * @param  num Number of jobs to submit
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @param  completed Array of at least num entries that receives returned jobs
+ * @param  num_completed Number of entries written to completed
+ * @returns void
+ */
+void sha1_ctx_mgr_submit_batch(SHA1_HASH_CTX_MGR* mgr, SHA1_HASH_CTX* ctx[],
+			       const void* buffer[], const uint32_t len[], uint32_t num,
+			       HASH_CTX_FLAG flags, SHA1_HASH_CTX* completed[],
+			       uint32_t* num_completed);
+
+/******************** hashing of many buffers **********************/
+
+/**
+ * @brief  Hash a set of independent buffers with SHA1 in one call.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Stateless helper that owns a SHA1_HASH_CTX_MGR and a pool of contexts and
+ * drives submit and flush until every buffer is hashed. Jobs are started
+ * longest first so lanes stay busy until the end. Buffers larger than 4GB are
+ * accepted and fed to the manager in several updates.
+ *
+ * @param  bufs Array of n pointers to buffers to be hashed
+ * @param  lens Array of n buffer lengths (in bytes)
+ * @param  n Number of buffers
+ * @param  digests Array of n digests receiving the result of each buffer
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int sha1_mb_hash_many(const void* bufs[], const uint64_t lens[], uint32_t n,
+		      uint8_t (*digests)[SHA1_DIGEST_NWORDS * 4]);
+
+/******************** length-aware scheduler **********************/
+
+/**
+ * @brief Initialize the length-aware SHA1 scheduler.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * The scheduler holds up to depth submitted jobs in a queue sorted by length
+ * and only hands the longest of them to the multi-buffer manager once the
+ * queue is full (longest-processing-time-first). Long jobs then start early
+ * and the jobs left for the flush tail are the short ones, so fewer lanes sit
+ * idle while the last long job runs. A depth of 0 disables the queue.
+ *
+ * @param sched	Structure holding scheduler and context level state info
+ * @param depth	Number of jobs to hold back, at most SHA1_SCHED_QUEUE_MAX
+ * @returns void
+ */
+void sha1_ctx_sched_init(SHA1_HASH_CTX_SCHED* sched, uint32_t depth);
+
+/**
+ * @brief  Submit a new SHA1 job through the length-aware scheduler.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Same semantics as sha1_ctx_mgr_submit(). A held back ctx is marked as
+ * processing until it is returned by a later submit or flush.
+ *
+ * @param  sched Structure holding scheduler and context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA1_HASH_CTX* sha1_ctx_sched_submit(SHA1_HASH_CTX_SCHED* sched, SHA1_HASH_CTX* ctx,
+				     const void* buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all jobs held by the SHA1 scheduler and return when complete.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * @param sched	Structure holding scheduler and context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+SHA1_HASH_CTX* sha1_ctx_sched_flush(SHA1_HASH_CTX_SCHED* sched);
+
+/******************** single-buffer switch point **********************/
+
+/**
+ * @brief Set the single-buffer switch point of a SHA1 multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Whenever no more than threshold jobs are in flight, flush hashes the
+ * shortest one with the single-buffer (SHA-NI if available) code instead
+ * of the multi-buffer kernel. On the SSE SHA-NI manager a threshold of 4 or
+ * more also makes submit hash jobs in pairs with the SHA-NI x2 code rather
+ * than waiting for all 4 lanes to fill. The AVX512 SHA-NI manager only
+ * applies the threshold on flush. A threshold of 0 always uses the
+ * multi-buffer kernel. The default is set by sha1_ctx_mgr_init() for the
+ * selected architecture. Has no effect on the base and aarch64 managers.
+ *
+ * @param mgr	Structure holding context level state info
+ * @param threshold Number of jobs in flight at or below which single-buffer code is used
+ * @returns void
+ */
+void sha1_ctx_mgr_set_sb_threshold(SHA1_HASH_CTX_MGR* mgr, uint32_t threshold);
+
+/**
+ * @brief Get the single-buffer switch point of a SHA1 multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns Current single-buffer threshold
+ */
+uint32_t sha1_ctx_mgr_get_sb_threshold(SHA1_HASH_CTX_MGR* mgr);
+
+/******************** jobs larger than 4GB **********************/
+
+/**
+ * @brief Submit a SHA1 job of up to 2^64 - 1 bytes to the multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Same as sha1_ctx_mgr_submit() with a 64-bit length. Buffers too long for
+ * one lane scheduling round are handed to the manager in pieces as earlier
+ * pieces complete, so the ctx is only returned once all of buffer has been
+ * processed. Jobs are finished with sha1_ctx_mgr_flush() and can share mgr
+ * with jobs from sha1_ctx_mgr_submit().
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA1_HASH_CTX* sha1_ctx_mgr_submit_64(SHA1_HASH_CTX_MGR* mgr, SHA1_HASH_CTX* ctx,
+				      const void* buffer, uint64_t len, HASH_CTX_FLAG flags);
+
+/******************** HMAC **********************/
+
+/**
+ * @brief Precompute the HMAC-SHA1 ipad and opad midstates of a key.
+ *
+ * Done once per key. Jobs using the key then start one block into the
+ * message instead of hashing the padded key each time.
+ *
+ * @param key	Structure receiving the midstates
+ * @param k	Pointer to the key
+ * @param len	Length of the key in bytes
+ * @returns void
+ */
+void hmac_sha1_key_init(HMAC_SHA1_KEY* key, const void* k, uint32_t len);
+
+/**
+ * @brief Initialize the HMAC-SHA1 multi-buffer manager structure.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns void
+ */
+void hmac_sha1_ctx_mgr_init(HMAC_SHA1_HASH_CTX_MGR* mgr);
+
+/**
+ * @brief Submit a new HMAC-SHA1 job to the multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Works like sha1_ctx_mgr_submit() on the message. A job started with
+ * HASH_FIRST begins from the ipad midstate of key; key is ignored for other
+ * flags and must stay valid until the job completes. Once the message is
+ * done, the outer hash over the inner digest is submitted to the same lanes,
+ * so the ctx is only returned with the MAC in ctx.job.result_digest.
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  hctx Structure holding ctx job info
+ * @param  key Key midstates from hmac_sha1_key_init()
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+HMAC_SHA1_HASH_CTX* hmac_sha1_ctx_mgr_submit(HMAC_SHA1_HASH_CTX_MGR* mgr,
+					     HMAC_SHA1_HASH_CTX* hctx,
+					     const HMAC_SHA1_KEY* key, const void* buffer,
+					     uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all submitted HMAC-SHA1 jobs and return when complete.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+HMAC_SHA1_HASH_CTX* hmac_sha1_ctx_mgr_flush(HMAC_SHA1_HASH_CTX_MGR* mgr);
+
+/******************** saved midstates **********************/
+
+/**
+ * @brief Save the state of a SHA1 ctx for sha1_ctx_midstate_restore().
+ *
+ * ctx must be idle on a block boundary, i.e. returned from HASH_FIRST or
+ * HASH_UPDATE submits whose lengths add up to a whole number of blocks. A
+ * midstate is only valid with the library build and CPU that produced it.
+ *
+ * @param ctx	Structure holding ctx job info
+ * @param ms	Structure receiving the midstate
+ * @returns 0 on success, -1 if ctx is busy, complete or has a partial block
+ */
+int sha1_ctx_midstate_save(const SHA1_HASH_CTX* ctx, SHA1_MIDSTATE* ms);
+
+/**
+ * @brief Start a SHA1 ctx from a saved midstate instead of the initial digest.
+ *
+ * ctx is left idle as if the prefix the midstate was taken after had just
+ * been submitted to it. Continue the job with HASH_UPDATE or HASH_LAST, not
+ * HASH_FIRST. Any number of contexts can be started from the same midstate.
+ *
+ * @param ctx	Structure holding ctx job info
+ * @param ms	Midstate from sha1_ctx_midstate_save()
+ * @returns 0 on success, -1 if ctx is being processed
+ */
+int sha1_ctx_midstate_restore(SHA1_HASH_CTX* ctx, const SHA1_MIDSTATE* ms);
+
+/******************** PBKDF2 **********************/
+
+/**
+ * @brief  Derive keys with PBKDF2-HMAC-SHA1 for a set of passwords in one call.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Every dk_len-byte output block of every password is an independent chain
+ * of iter HMACs, and all chains are kept in flight in the multi-buffer
+ * manager at once. After the first HMAC of a chain, each hash is a single
+ * pre-padded block resumed from the HMAC key midstates, so the iteration
+ * loop costs two block compressions per iteration and no buffering.
+ *
+ * @param  pass Array of n pointers to passwords
+ * @param  pass_lens Array of n password lengths (in bytes)
+ * @param  salt Array of n pointers to salts
+ * @param  salt_lens Array of n salt lengths (in bytes)
+ * @param  iter Iteration count, at least 1
+ * @param  dk Array of n buffers of dk_len bytes receiving the derived keys
+ * @param  dk_len Length of each derived key (in bytes)
+ * @param  n Number of keys to derive
+ * @returns 0 on success, -1 on invalid iteration count, memory allocation failure or job error
+ */
+int pbkdf2_hmac_sha1_mb(const void* pass[], const uint32_t pass_lens[],
+			const void* salt[], const uint32_t salt_lens[], uint32_t iter,
+			uint8_t* dk[], uint32_t dk_len, uint32_t n);
+
+/******************** short messages **********************/
+
+/**
+ * @brief  Hash a set of short messages of one fixed length with SHA1 in one call.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * For keys and fingerprints of up to SHA1_HASH_SHORT_MAX_LEN bytes, which
+ * fit in one or two blocks once padded. The padding is laid out once per lane
+ * and each message is hashed as whole blocks, bypassing the copy into
+ * partial_block_buffer and the padding step of the ctx manager.
+ *
+ * @param  msgs Array of n pointers to messages of len bytes
+ * @param  len Length of every message (in bytes), at most SHA1_HASH_SHORT_MAX_LEN
+ * @param  n Number of messages
+ * @param  digests Array of n digests receiving the result of each message
+ * @returns 0 on success, -1 on message too long or job error
+ */
+int sha1_mb_hash_short(const void* msgs[], uint32_t len, uint32_t n,
+		       uint8_t (*digests)[SHA1_DIGEST_NWORDS * 4]);
+
+/******************** Merkle trees **********************/
+
+/**
+ * @brief  Number of nodes in a SHA1 Merkle tree of nleaves leaves.
+ *
+ * @param  nleaves Number of leaves
+ * @returns Number of digests written by merkle_sha1_build()
+ */
+uint64_t merkle_sha1_tree_nodes(uint32_t nleaves);
+
+/**
+ * @brief  Build a whole SHA1 Merkle tree over a set of fixed size leaves.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Leaves are hashed as 0x00 | leaf and interior nodes as 0x01 | left | right
+ * as in RFC 6962, a node with no right sibling being promoted unchanged. The
+ * hashes of each level are submitted to the multi-buffer manager as one batch.
+ * The tree is stored level by level starting with the leaf hashes, so the
+ * root is the last node. A tree of no leaves is the hash of the empty string.
+ *
+ * @param  leaves Buffer of nleaves leaves stored back to back
+ * @param  nleaves Number of leaves
+ * @param  leaf_size Size of each leaf (in bytes)
+ * @param  tree Array of merkle_sha1_tree_nodes(nleaves) digests receiving the tree
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int merkle_sha1_build(const void* leaves, uint32_t nleaves, uint32_t leaf_size,
+		      uint8_t (*tree)[SHA1_DIGEST_NWORDS * 4]);
+
+/**
+ * @brief  Recompute the paths of changed leaves in a tree from merkle_sha1_build().
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * The changed leaves, and then the changed nodes of each level, are hashed as
+ * one batch per level. Nodes shared by several paths are hashed once.
+ *
+ * @param  tree Tree of nleaves leaves to update in place
+ * @param  nleaves Number of leaves of the tree
+ * @param  leaves Buffer of nleaves leaves holding the new contents
+ * @param  leaf_size Size of each leaf (in bytes)
+ * @param  idx Array of nidx indexes of changed leaves, in any order
+ * @param  nidx Number of changed leaves
+ * @returns 0 on success, -1 on index out of range, memory allocation failure or job error
+ */
+int merkle_sha1_update(uint8_t (*tree)[SHA1_DIGEST_NWORDS * 4], uint32_t nleaves,
+		       const void* leaves, uint32_t leaf_size, const uint32_t idx[],
+		       uint32_t nidx);
+
+/**
+ * @brief  Start a SHA1 Merkle tree to be built by appending leaves.
+ *
+ * @param  state Structure holding the pending subtrees
+ * @returns void
+ */
+void merkle_sha1_init(MERKLE_SHA1_STATE* state);
+
+/**
+ * @brief  Append leaves to a SHA1 Merkle tree and fold them into its pending subtrees.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Only the root of each pending perfect subtree is kept, so memory does not
+ * grow with the tree. Leaves are hashed and paired up level by level in
+ * batches of up to a thousand, and may be appended in any number of calls.
+ *
+ * @param  state Structure holding the pending subtrees
+ * @param  leaves Buffer of nleaves leaves stored back to back
+ * @param  nleaves Number of leaves to append
+ * @param  leaf_size Size of each leaf (in bytes)
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int merkle_sha1_append(MERKLE_SHA1_STATE* state, const void* leaves, uint32_t nleaves,
+		       uint32_t leaf_size);
+
+/**
+ * @brief  Compute the root of the leaves appended so far to a SHA1 Merkle tree.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * The state is left unchanged, more leaves can be appended afterwards.
+ *
+ * @param  state Structure holding the pending subtrees
+ * @param  root Digest receiving the root, as merkle_sha1_build() would give
+ * @returns 0 on success, -1 on job error
+ */
+int merkle_sha1_final(const MERKLE_SHA1_STATE* state,
+		      uint8_t root[SHA1_DIGEST_NWORDS * 4]);
+
+/**
+ * @brief  Compute the root of a SHA1 Merkle tree without storing the tree.
+ * @requires SSE4.1 or AVX or AVX2 or AVX512
+ *
+ * Same as merkle_sha1_init(), merkle_sha1_append() and merkle_sha1_final().
+ *
+ * @param  leaves Buffer of nleaves leaves stored back to back
+ * @param  nleaves Number of leaves
+ * @param  leaf_size Size of each leaf (in bytes)
+ * @param  root Digest receiving the root
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int merkle_sha1_root(const void* leaves, uint32_t nleaves, uint32_t leaf_size,
+		     uint8_t root[SHA1_DIGEST_NWORDS * 4]);
+
 
 /*******************************************************************
  * Context level API function prototypes
@@ -124,9 +124,18 @@ extern "C" {
 #define SHA256_BLOCK_SIZE		64
 #define SHA256_LOG2_BLOCK_SIZE		6
 #define SHA256_PADLENGTHFIELD_SIZE	8
+#define SHA256_HASH_SHORT_MAX_LEN	(2 * SHA256_BLOCK_SIZE - 1 - SHA256_PADLENGTHFIELD_SIZE)	//!< longest message of sha256_mb_hash_short()
+#define SHA256_TREE_HASH_CHUNK_SIZE	(1024 * 1024)	//!< leaf size of sha256_mb_tree_hash(), as in the Amazon Glacier tree hash
+#define SHA256_SB_THRESHOLD		1	//!< default single-buffer switch point for the mb managers
+#define SHA256_NI_SB_THRESHOLD_SSE	4	//!< SHA-NI beats the 4-lane SSE mb code at any occupancy
+#define SHA256_NI_SB_THRESHOLD_AVX512	6
 #define SHA256_INITIAL_DIGEST		\
 	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, \
 	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+#define SHA224_DIGEST_NWORDS		7	//!< SHA-224 result is the first 7 words of result_digest
+#define SHA224_INITIAL_DIGEST		\
+	0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, \
+	0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
 
 typedef uint32_t sha256_digest_array[SHA256_DIGEST_NWORDS][SHA256_MAX_LANES];
 typedef uint32_t SHA256_WORD_T;
@@ -162,12 +171,25 @@ typedef struct {
 	uint64_t unused_lanes; //!< each nibble is index (0...3 or 0...7) of unused lanes, nibble 4 or 8 is set to F as a flag
 	SHA256_LANE_DATA ldata[SHA256_MAX_LANES];
 	uint32_t num_lanes_inuse;
+	uint32_t sb_threshold;	//!< hash on single-buffer code when num_lanes_inuse <= sb_threshold
 } SHA256_MB_JOB_MGR;
 
+/** @brief Context layer - Bounds how long jobs may wait for the lanes to fill */
+
+typedef struct {
+	uint64_t max_bytes;	//!< advance lanes once this many bytes wait, 0 disables
+	uint64_t max_cycles;	//!< advance lanes once work has waited this many TSC cycles, 0 disables
+	uint32_t max_jobs;	//!< advance lanes once this many jobs are in flight, 0 disables
+	uint32_t jobs;		//!< jobs in flight
+	uint64_t bytes;		//!< bytes submitted since the last completion
+	uint64_t tsc;		//!< TSC of the last completion, or first submit to an empty manager
+} SHA256_DEADLINE;
+
 /** @brief Context layer - Holds state for multi-buffer SHA256 jobs */
 
 typedef struct {
 	SHA256_MB_JOB_MGR mgr;
+	SHA256_DEADLINE deadline;
 } SHA256_HASH_CTX_MGR;
 
 /** @brief Context layer - Holds info describing a single SHA256 job for the multi-buffer CTX manager */
@@ -182,8 +204,126 @@ typedef struct {
 	uint8_t		partial_block_buffer[SHA256_BLOCK_SIZE * 2]; //!< CTX partial blocks
 	uint32_t	partial_block_buffer_length;
 	void*		user_data;	//!< pointer for user to keep any job-related data
+	const void*	pending_buffer;	//!< rest of a sha256_ctx_mgr_submit_64() buffer not yet handed to the manager
+	uint64_t	pending_length;	//!< length of pending_buffer in bytes
+	HASH_CTX_FLAG	pending_flags;	//!< flags for the last piece of pending_buffer
 } SHA256_HASH_CTX;
 
+/** @brief Context layer - Holds a SHA256 ctx snapshot taken on a block boundary */
+
+typedef struct {
+	SHA256_WORD_T	digest[SHA256_DIGEST_NWORDS];	//!< hash state after total_length bytes
+	uint64_t	total_length;	//!< bytes hashed so far, a whole number of blocks
+} SHA256_MIDSTATE;
+
+/** @brief Context layer - Holds the ipad and opad midstates of one HMAC-SHA256 key */
+
+typedef struct {
+	SHA256_MIDSTATE	ipad;	//!< state after hashing the key xor ipad block
+	SHA256_MIDSTATE	opad;	//!< state after hashing the key xor opad block
+} HMAC_SHA256_KEY;
+
+/** @brief Context layer - Holds info describing a single HMAC-SHA256 job */
+
+typedef struct {
+	SHA256_HASH_CTX	ctx;	//!< hash state, holds the MAC in ctx.job.result_digest once complete
+	const HMAC_SHA256_KEY*	key;	//!< key of the job, set by the HASH_FIRST submit
+	SHA256_WORD_T	inner_digest[SHA256_DIGEST_NWORDS];	//!< inner hash in message byte order
+	int	outer;	//!< set once the outer hash is submitted
+} HMAC_SHA256_HASH_CTX;
+
+/** @brief Context layer - Holds state for multi-buffer HMAC-SHA256 jobs */
+
+typedef struct {
+	SHA256_HASH_CTX_MGR	mgr;
+} HMAC_SHA256_HASH_CTX_MGR;
+
+/** @brief Context layer - Checksum computed in the same pass as SHA256 */
+
+typedef enum {
+	SHA256_CSUM_CRC32C = 0,	//!< CRC32C (Castagnoli), seed is the CRC of any preceding data
+	SHA256_CSUM_XXH64 = 1,	//!< xxHash64, seed is the xxHash seed
+} SHA256_CSUM_ALG;
+
+#define SHA256_CSUM_SLICE		4096	//!< bytes handed to a lane at a time
+#define SHA256_CSUM_XXH64_STRIPE	32
+
+/** @brief Context layer - Holds info describing a single SHA256 plus checksum job */
+
+typedef struct {
+	SHA256_HASH_CTX	ctx;	//!< hash state, holds the SHA256 digest in ctx.job.result_digest once complete
+	SHA256_CSUM_ALG	alg;	//!< checksum type, set by sha256_csum_ctx_init()
+	uint64_t	seed;	//!< checksum seed, set by sha256_csum_ctx_init()
+	uint64_t	csum;	//!< checksum of the message, final once the ctx is complete
+	uint64_t	csum_length;	//!< bytes checksummed so far
+	uint64_t	acc[4];	//!< xxHash64 accumulators
+	uint8_t		tail[SHA256_CSUM_XXH64_STRIPE];	//!< xxHash64 bytes short of a stripe
+	uint32_t	tail_len;	//!< length of tail in bytes
+	const uint8_t*	slice;	//!< slice in the lanes, checksummed once they return it
+	uint32_t	slice_len;	//!< length of slice in bytes
+	const uint8_t*	rest;	//!< rest of the submission not yet handed to the lanes
+	uint32_t	rest_len;	//!< length of rest in bytes
+	HASH_CTX_FLAG	flags;	//!< flags of the submission, HASH_LAST goes with its final slice
+} SHA256_CSUM_HASH_CTX;
+
+/** @brief Context layer - Holds state for multi-buffer SHA256 plus checksum jobs */
+
+typedef struct {
+	SHA256_HASH_CTX_MGR	mgr;
+} SHA256_CSUM_HASH_CTX_MGR;
+
+#define MERKLE_SHA256_MAX_HEIGHT	64
+
+/** @brief Merkle tree - Pending subtrees of a SHA256 Merkle tree built by appending leaves */
+
+typedef struct {
+	uint8_t	frontier[MERKLE_SHA256_MAX_HEIGHT][SHA256_DIGEST_NWORDS * 4];	//!< root of the pending perfect subtree of each height
+	uint64_t	nleaves;	//!< number of leaves appended so far
+} MERKLE_SHA256_STATE;
+
+/** @brief Context layer - Holds a job kept back by the length-aware scheduler */
+
+typedef struct {
+	SHA256_HASH_CTX*	ctx;	//!< ctx of the held back job
+	const void*	buffer;	//!< buffer passed to the scheduler submit
+	uint32_t	len;	//!< length of buffer in bytes
+	HASH_CTX_FLAG	flags;	//!< flags passed to the scheduler submit
+	HASH_CTX_STS	status;	//!< ctx status before the job was held back
+} SHA256_SCHED_ENTRY;
+
+#define SHA256_SCHED_QUEUE_MAX		(2 * SHA256_MAX_LANES)
+
+/** @brief Context layer - SHA256 manager with a length sorted submission queue */
+
+typedef struct {
+	SHA256_HASH_CTX_MGR	mgr;
+	SHA256_SCHED_ENTRY	queue[SHA256_SCHED_QUEUE_MAX]; //!< pending jobs, sorted by length
+	uint32_t	queue_len;	//!< number of pending jobs
+	uint32_t	queue_depth;	//!< jobs held back before the longest is released
+} SHA256_HASH_CTX_SCHED;
+
+/** @brief Context layer - Submission ring entry for the ring interface */
+
+typedef struct {
+	SHA256_HASH_CTX*	ctx;	//!< ctx to submit
+	const void*	buffer;	//!< buffer to be processed
+	uint32_t	len;	//!< length of buffer in bytes
+	HASH_CTX_FLAG	flags;	//!< job type (first, update, last or entire)
+} SHA256_RING_SQE;
+
+/** @brief Context layer - SHA256 manager fed from a submission ring into a completion ring */
+
+typedef struct {
+	SHA256_HASH_CTX_MGR	mgr;
+	SHA256_RING_SQE*	sq;	//!< caller owned submission ring
+	SHA256_HASH_CTX**	cq;	//!< caller owned completion ring
+	uint32_t	mask;	//!< ring entries - 1, entries is a power of 2
+	uint32_t	sq_head;	//!< next entry consumed by sha256_ctx_mgr_process()
+	uint32_t	sq_tail;	//!< next entry filled by the caller
+	uint32_t	cq_head;	//!< next entry reaped by the caller
+	uint32_t	cq_tail;	//!< next entry filled by sha256_ctx_mgr_process()
+} SHA256_HASH_CTX_RING;
+
 /******************** multibinary function prototypes **********************/
 
 /**
@@ -218,6 +358,644 @@ SHA256_HASH_CTX* sha256_ctx_mgr_submit (SHA256_HASH_CTX_MGR* mgr, SHA256_HASH_CT
  */
 SHA256_HASH_CTX* sha256_ctx_mgr_flush  (SHA256_HASH_CTX_MGR* mgr);
 
+/******************** batch submit **********************/
+
+/**
+ * @brief  Submit an array of SHA256 jobs to the multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Equivalent to calling sha256_ctx_mgr_submit() on each ctx[i] in turn with
+ * buffer[i] and len[i], but every ctx handed back by the manager is collected
+ * in the completed array instead of being returned one by one. Contexts that
+ * were rejected are returned there as well with their error member set.
+ *
+ * The flags are checked and the selected submit is looked up once per
+ * batch rather than per job. Invalid flags reject the whole batch: every
+ * ctx is returned in completed with HASH_CTX_ERROR_INVALID_FLAGS set.
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Array of num structures holding ctx job info
+ * @param  buffer Array of num pointers to buffers to be processed
+ * @param  len Array of num buffer lengths (in bytes)
+ * @param  num Number of jobs to submit
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @param  completed Array of at least num entries that receives returned jobs
+ * @param  num_completed Number of entries written to completed
+ * @returns void
+ */
+void sha256_ctx_mgr_submit_batch(SHA256_HASH_CTX_MGR* mgr, SHA256_HASH_CTX* ctx[],
+				 const void* buffer[], const uint32_t len[], uint32_t num,
+				 HASH_CTX_FLAG flags, SHA256_HASH_CTX* completed[],
+				 uint32_t* num_completed);
+
+/******************** hashing of many buffers **********************/
+
+/**
+ * @brief  Hash a set of independent buffers with SHA256 in one call.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Stateless helper that owns a SHA256_HASH_CTX_MGR and a pool of contexts and
+ * drives submit and flush until every buffer is hashed. Jobs are started
+ * longest first so lanes stay busy until the end. Buffers larger than 4GB are
+ * accepted and fed to the manager in several updates.
+ *
+ * @param  bufs Array of n pointers to buffers to be hashed
+ * @param  lens Array of n buffer lengths (in bytes)
+ * @param  n Number of buffers
+ * @param  digests Array of n digests receiving the result of each buffer
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int sha256_mb_hash_many(const void* bufs[], const uint64_t lens[], uint32_t n,
+			uint8_t (*digests)[SHA256_DIGEST_NWORDS * 4]);
+
+/******************** length-aware scheduler **********************/
+
+/**
+ * @brief Initialize the length-aware SHA256 scheduler.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * The scheduler holds up to depth submitted jobs in a queue sorted by length
+ * and only hands the longest of them to the multi-buffer manager once the
+ * queue is full (longest-processing-time-first). Long jobs then start early
+ * and the jobs left for the flush tail are the short ones, so fewer lanes sit
+ * idle while the last long job runs. A depth of 0 disables the queue.
+ *
+ * @param sched	Structure holding scheduler and context level state info
+ * @param depth	Number of jobs to hold back, at most SHA256_SCHED_QUEUE_MAX
+ * @returns void
+ */
+void sha256_ctx_sched_init(SHA256_HASH_CTX_SCHED* sched, uint32_t depth);
+
+/**
+ * @brief  Submit a new SHA256 job through the length-aware scheduler.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Same semantics as sha256_ctx_mgr_submit(). A held back ctx is marked as
+ * processing until it is returned by a later submit or flush.
+ *
+ * @param  sched Structure holding scheduler and context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA256_HASH_CTX* sha256_ctx_sched_submit(SHA256_HASH_CTX_SCHED* sched, SHA256_HASH_CTX* ctx,
+					 const void* buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all jobs held by the SHA256 scheduler and return when complete.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * @param sched	Structure holding scheduler and context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+SHA256_HASH_CTX* sha256_ctx_sched_flush(SHA256_HASH_CTX_SCHED* sched);
+
+/******************** single-buffer switch point **********************/
+
+/**
+ * @brief Set the single-buffer switch point of a SHA256 multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Whenever no more than threshold jobs are in flight, flush hashes the
+ * shortest one with the single-buffer (SHA-NI if available) code instead
+ * of the multi-buffer kernel. On the SSE SHA-NI manager a threshold of 4 or
+ * more also makes submit hash jobs in pairs with the SHA-NI x2 code rather
+ * than waiting for all 4 lanes to fill. The AVX512 SHA-NI manager only
+ * applies the threshold on flush. A threshold of 0 always uses the
+ * multi-buffer kernel. The default is set by sha256_ctx_mgr_init() for the
+ * selected architecture. Has no effect on the base and aarch64 managers.
+ *
+ * @param mgr	Structure holding context level state info
+ * @param threshold Number of jobs in flight at or below which single-buffer code is used
+ * @returns void
+ */
+void sha256_ctx_mgr_set_sb_threshold(SHA256_HASH_CTX_MGR* mgr, uint32_t threshold);
+
+/**
+ * @brief Get the single-buffer switch point of a SHA256 multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns Current single-buffer threshold
+ */
+uint32_t sha256_ctx_mgr_get_sb_threshold(SHA256_HASH_CTX_MGR* mgr);
+
+/******************** deadline flush **********************/
+
+/**
+ * @brief Bound the time jobs may wait in a SHA256 multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Once any enabled limit is reached and a submit has nothing to return,
+ * sha256_ctx_mgr_submit() advances the partially filled lanes as a flush
+ * would and returns the job that completes first. The limits count from the
+ * last job returned, so a loaded manager that keeps completing jobs on its
+ * own is never forced. Cycles are read with rdtsc on x86 and the virtual
+ * counter on aarch64. A limit of 0 disables it, which is the default after
+ * sha256_ctx_mgr_init(). The base manager completes every job in submit and
+ * ignores these limits.
+ *
+ * @param mgr	Structure holding context level state info
+ * @param max_bytes Bytes submitted without a completion before lanes are advanced
+ * @param max_jobs Jobs in flight at which lanes are advanced
+ * @param max_cycles Cycles without a completion before lanes are advanced
+ * @returns void
+ */
+void sha256_ctx_mgr_set_deadline(SHA256_HASH_CTX_MGR* mgr, uint64_t max_bytes,
+				 uint32_t max_jobs, uint64_t max_cycles);
+
+/******************** completion rings **********************/
+
+/**
+ * @brief Initialize a SHA256 manager driven through submission and completion rings.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Both rings are supplied by the caller and hold entries elements, which must
+ * be a power of 2. The caller fills the submission ring with
+ * sha256_ctx_ring_submit() and reaps finished ctxs with
+ * sha256_ctx_ring_complete(); nothing is allocated per job.
+ *
+ * @param ring	Structure holding ring and context level state info
+ * @param sq	Submission ring of entries elements
+ * @param cq	Completion ring of entries elements
+ * @param entries Number of elements in each ring, a power of 2
+ * @returns 0 on success, -1 if entries is not a power of 2
+ */
+int sha256_ctx_ring_init(SHA256_HASH_CTX_RING* ring, SHA256_RING_SQE* sq, SHA256_HASH_CTX** cq,
+			 uint32_t entries);
+
+/**
+ * @brief Queue a SHA256 job on the submission ring.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * @param  ring Structure holding ring and context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns 0 on success, -1 if the submission ring is full
+ */
+int sha256_ctx_ring_submit(SHA256_HASH_CTX_RING* ring, SHA256_HASH_CTX* ctx,
+			   const void* buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Reap one ctx from the completion ring.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * A reaped ctx is either done with the submitted buffer or carries an error
+ * code, exactly as if it had been returned by sha256_ctx_mgr_submit().
+ *
+ * @param ring	Structure holding ring and context level state info
+ * @returns NULL if the completion ring is empty or pointer to jobs structure.
+ */
+SHA256_HASH_CTX* sha256_ctx_ring_complete(SHA256_HASH_CTX_RING* ring);
+
+/**
+ * @brief Move jobs from the submission ring through the manager into the completion ring.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Consumes up to budget submission entries. Whenever the submission ring is
+ * left empty, jobs still in the lanes are flushed so every consumed entry
+ * eventually reaches the completion ring. Processing stops early rather than
+ * overflow the completion ring; call again once completions are reaped.
+ *
+ * @param ring	Structure holding ring and context level state info
+ * @param budget Maximum number of submission entries to consume
+ * @returns Number of submission entries consumed
+ */
+uint32_t sha256_ctx_mgr_process(SHA256_HASH_CTX_RING* ring, uint32_t budget);
+
+/******************** jobs larger than 4GB **********************/
+
+/**
+ * @brief Submit a SHA256 job of up to 2^64 - 1 bytes to the multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Same as sha256_ctx_mgr_submit() with a 64-bit length. Buffers too long for
+ * one lane scheduling round are handed to the manager in pieces as earlier
+ * pieces complete, so the ctx is only returned once all of buffer has been
+ * processed. Jobs are finished with sha256_ctx_mgr_flush() and can share mgr
+ * with jobs from sha256_ctx_mgr_submit().
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA256_HASH_CTX* sha256_ctx_mgr_submit_64(SHA256_HASH_CTX_MGR* mgr, SHA256_HASH_CTX* ctx,
+					  const void* buffer, uint64_t len, HASH_CTX_FLAG flags);
+
+/******************** digest variants **********************/
+
+/**
+ * @brief  Submit a new SHA224 job to a SHA256 multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Same as sha256_ctx_mgr_submit() but a job started with HASH_FIRST uses the
+ * SHA-224 initial digest. SHA224 and SHA256 jobs can be mixed on one manager,
+ * which is initialized and flushed with the sha256_ctx_mgr_* functions. The
+ * digest is the first SHA224_DIGEST_NWORDS words of result_digest.
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA256_HASH_CTX* sha224_ctx_mgr_submit (SHA256_HASH_CTX_MGR* mgr, SHA256_HASH_CTX* ctx,
+					const void* buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/******************** HMAC **********************/
+
+/**
+ * @brief Precompute the HMAC-SHA256 ipad and opad midstates of a key.
+ *
+ * Done once per key. Jobs using the key then start one block into the
+ * message instead of hashing the padded key each time.
+ *
+ * @param key	Structure receiving the midstates
+ * @param k	Pointer to the key
+ * @param len	Length of the key in bytes
+ * @returns void
+ */
+void hmac_sha256_key_init(HMAC_SHA256_KEY* key, const void* k, uint32_t len);
+
+/**
+ * @brief Initialize the HMAC-SHA256 multi-buffer manager structure.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns void
+ */
+void hmac_sha256_ctx_mgr_init(HMAC_SHA256_HASH_CTX_MGR* mgr);
+
+/**
+ * @brief Submit a new HMAC-SHA256 job to the multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Works like sha256_ctx_mgr_submit() on the message. A job started with
+ * HASH_FIRST begins from the ipad midstate of key; key is ignored for other
+ * flags and must stay valid until the job completes. Once the message is
+ * done, the outer hash over the inner digest is submitted to the same lanes,
+ * so the ctx is only returned with the MAC in ctx.job.result_digest.
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  hctx Structure holding ctx job info
+ * @param  key Key midstates from hmac_sha256_key_init()
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+HMAC_SHA256_HASH_CTX* hmac_sha256_ctx_mgr_submit(HMAC_SHA256_HASH_CTX_MGR* mgr,
+						 HMAC_SHA256_HASH_CTX* hctx,
+						 const HMAC_SHA256_KEY* key, const void* buffer,
+						 uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all submitted HMAC-SHA256 jobs and return when complete.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+HMAC_SHA256_HASH_CTX* hmac_sha256_ctx_mgr_flush(HMAC_SHA256_HASH_CTX_MGR* mgr);
+
+/******************** saved midstates **********************/
+
+/**
+ * @brief Save the state of a SHA256 ctx for sha256_ctx_midstate_restore().
+ *
+ * ctx must be idle on a block boundary, i.e. returned from HASH_FIRST or
+ * HASH_UPDATE submits whose lengths add up to a whole number of blocks. A
+ * midstate is only valid with the library build and CPU that produced it.
+ *
+ * @param ctx	Structure holding ctx job info
+ * @param ms	Structure receiving the midstate
+ * @returns 0 on success, -1 if ctx is busy, complete or has a partial block
+ */
+int sha256_ctx_midstate_save(const SHA256_HASH_CTX* ctx, SHA256_MIDSTATE* ms);
+
+/**
+ * @brief Start a SHA256 ctx from a saved midstate instead of the initial digest.
+ *
+ * ctx is left idle as if the prefix the midstate was taken after had just
+ * been submitted to it. Continue the job with HASH_UPDATE or HASH_LAST, not
+ * HASH_FIRST. Any number of contexts can be started from the same midstate.
+ *
+ * @param ctx	Structure holding ctx job info
+ * @param ms	Midstate from sha256_ctx_midstate_save()
+ * @returns 0 on success, -1 if ctx is being processed
+ */
+int sha256_ctx_midstate_restore(SHA256_HASH_CTX* ctx, const SHA256_MIDSTATE* ms);
+
+/******************** PBKDF2 **********************/
+
+/**
+ * @brief  Derive keys with PBKDF2-HMAC-SHA256 for a set of passwords in one call.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Every dk_len-byte output block of every password is an independent chain
+ * of iter HMACs, and all chains are kept in flight in the multi-buffer
+ * manager at once. After the first HMAC of a chain, each hash is a single
+ * pre-padded block resumed from the HMAC key midstates, so the iteration
+ * loop costs two block compressions per iteration and no buffering.
+ *
+ * @param  pass Array of n pointers to passwords
+ * @param  pass_lens Array of n password lengths (in bytes)
+ * @param  salt Array of n pointers to salts
+ * @param  salt_lens Array of n salt lengths (in bytes)
+ * @param  iter Iteration count, at least 1
+ * @param  dk Array of n buffers of dk_len bytes receiving the derived keys
+ * @param  dk_len Length of each derived key (in bytes)
+ * @param  n Number of keys to derive
+ * @returns 0 on success, -1 on invalid iteration count, memory allocation failure or job error
+ */
+int pbkdf2_hmac_sha256_mb(const void* pass[], const uint32_t pass_lens[],
+			  const void* salt[], const uint32_t salt_lens[], uint32_t iter,
+			  uint8_t* dk[], uint32_t dk_len, uint32_t n);
+
+/******************** HKDF **********************/
+
+/**
+ * @brief  HKDF-Extract with HMAC-SHA256 for a set of connections in one call.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Computes PRK = HMAC-SHA256(salt, IKM) (RFC 5869) for n independent
+ * inputs, with all of them in flight in the multi-buffer manager at once.
+ *
+ * @param  salt Array of n pointers to salts, an empty salt stands for HashLen zeros
+ * @param  salt_lens Array of n salt lengths (in bytes)
+ * @param  ikm Array of n pointers to input keying material
+ * @param  ikm_lens Array of n input keying material lengths (in bytes)
+ * @param  prk Array of n buffers of SHA256_DIGEST_NWORDS * 4 bytes receiving the PRKs
+ * @param  n Number of extract steps
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int hkdf_sha256_mb_extract(const void* salt[], const uint32_t salt_lens[],
+			   const void* ikm[], const uint32_t ikm_lens[], uint8_t* prk[], uint32_t n);
+
+/**
+ * @brief  HKDF-Expand with HMAC-SHA256 for a set of connections in one call.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Computes okm_lens[i] bytes of OKM = T(1) | T(2) | ... (RFC 5869) for n
+ * independent PRK and info pairs. The blocks T(i) of one output chain from
+ * each other, so batching comes from running many connections side by side,
+ * as with the many short HKDF-Expand-Label steps of a TLS 1.3 key schedule.
+ *
+ * @param  prk Array of n pointers to pseudorandom keys
+ * @param  prk_lens Array of n PRK lengths (in bytes)
+ * @param  info Array of n pointers to context and application specific info
+ * @param  info_lens Array of n info lengths (in bytes)
+ * @param  okm Array of n buffers receiving the output keying material
+ * @param  okm_lens Array of n output lengths, each at most 255 * HashLen bytes
+ * @param  n Number of expand steps
+ * @returns 0 on success, -1 on output length too long, memory allocation failure or job error
+ */
+int hkdf_sha256_mb_expand(const void* prk[], const uint32_t prk_lens[],
+			  const void* info[], const uint32_t info_lens[],
+			  uint8_t* okm[], const uint32_t okm_lens[], uint32_t n);
+
+/******************** short messages **********************/
+
+/**
+ * @brief  Hash a set of short messages of one fixed length with SHA256 in one call.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * For keys and fingerprints of up to SHA256_HASH_SHORT_MAX_LEN bytes, which
+ * fit in one or two blocks once padded. The padding is laid out once per lane
+ * and each message is hashed as whole blocks, bypassing the copy into
+ * partial_block_buffer and the padding step of the ctx manager.
+ *
+ * @param  msgs Array of n pointers to messages of len bytes
+ * @param  len Length of every message (in bytes), at most SHA256_HASH_SHORT_MAX_LEN
+ * @param  n Number of messages
+ * @param  digests Array of n digests receiving the result of each message
+ * @returns 0 on success, -1 on message too long or job error
+ */
+int sha256_mb_hash_short(const void* msgs[], uint32_t len, uint32_t n,
+			 uint8_t (*digests)[SHA256_DIGEST_NWORDS * 4]);
+
+/******************** Merkle trees **********************/
+
+/**
+ * @brief  Number of nodes in a SHA256 Merkle tree of nleaves leaves.
+ *
+ * @param  nleaves Number of leaves
+ * @returns Number of digests written by merkle_sha256_build()
+ */
+uint64_t merkle_sha256_tree_nodes(uint32_t nleaves);
+
+/**
+ * @brief  Build a whole SHA256 Merkle tree over a set of fixed size leaves.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Leaves are hashed as 0x00 | leaf and interior nodes as 0x01 | left | right
+ * as in RFC 6962, a node with no right sibling being promoted unchanged. The
+ * hashes of each level are submitted to the multi-buffer manager as one batch.
+ * The tree is stored level by level starting with the leaf hashes, so the
+ * root is the last node. A tree of no leaves is the hash of the empty string.
+ *
+ * @param  leaves Buffer of nleaves leaves stored back to back
+ * @param  nleaves Number of leaves
+ * @param  leaf_size Size of each leaf (in bytes)
+ * @param  tree Array of merkle_sha256_tree_nodes(nleaves) digests receiving the tree
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int merkle_sha256_build(const void* leaves, uint32_t nleaves, uint32_t leaf_size,
+			uint8_t (*tree)[SHA256_DIGEST_NWORDS * 4]);
+
+/**
+ * @brief  Recompute the paths of changed leaves in a tree from merkle_sha256_build().
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * The changed leaves, and then the changed nodes of each level, are hashed as
+ * one batch per level. Nodes shared by several paths are hashed once.
+ *
+ * @param  tree Tree of nleaves leaves to update in place
+ * @param  nleaves Number of leaves of the tree
+ * @param  leaves Buffer of nleaves leaves holding the new contents
+ * @param  leaf_size Size of each leaf (in bytes)
+ * @param  idx Array of nidx indexes of changed leaves, in any order
+ * @param  nidx Number of changed leaves
+ * @returns 0 on success, -1 on index out of range, memory allocation failure or job error
+ */
+int merkle_sha256_update(uint8_t (*tree)[SHA256_DIGEST_NWORDS * 4], uint32_t nleaves,
+			 const void* leaves, uint32_t leaf_size, const uint32_t idx[],
+			 uint32_t nidx);
+
+/**
+ * @brief  Start a SHA256 Merkle tree to be built by appending leaves.
+ *
+ * @param  state Structure holding the pending subtrees
+ * @returns void
+ */
+void merkle_sha256_init(MERKLE_SHA256_STATE* state);
+
+/**
+ * @brief  Append leaves to a SHA256 Merkle tree and fold them into its pending subtrees.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Only the root of each pending perfect subtree is kept, so memory does not
+ * grow with the tree. Leaves are hashed and paired up level by level in
+ * batches of up to a thousand, and may be appended in any number of calls.
+ *
+ * @param  state Structure holding the pending subtrees
+ * @param  leaves Buffer of nleaves leaves stored back to back
+ * @param  nleaves Number of leaves to append
+ * @param  leaf_size Size of each leaf (in bytes)
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int merkle_sha256_append(MERKLE_SHA256_STATE* state, const void* leaves, uint32_t nleaves,
+			 uint32_t leaf_size);
+
+/**
+ * @brief  Compute the root of the leaves appended so far to a SHA256 Merkle tree.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * The state is left unchanged, more leaves can be appended afterwards.
+ *
+ * @param  state Structure holding the pending subtrees
+ * @param  root Digest receiving the root, as merkle_sha256_build() would give
+ * @returns 0 on success, -1 on job error
+ */
+int merkle_sha256_final(const MERKLE_SHA256_STATE* state,
+			uint8_t root[SHA256_DIGEST_NWORDS * 4]);
+
+/**
+ * @brief  Compute the root of a SHA256 Merkle tree without storing the tree.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Same as merkle_sha256_init(), merkle_sha256_append() and merkle_sha256_final().
+ *
+ * @param  leaves Buffer of nleaves leaves stored back to back
+ * @param  nleaves Number of leaves
+ * @param  leaf_size Size of each leaf (in bytes)
+ * @param  root Digest receiving the root
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int merkle_sha256_root(const void* leaves, uint32_t nleaves, uint32_t leaf_size,
+		       uint8_t root[SHA256_DIGEST_NWORDS * 4]);
+
+/******************** tree hash **********************/
+
+/**
+ * @brief  Number of leaves of the SHA256 tree hash of a message of len bytes.
+ *
+ * @param  len Length of the message (in bytes)
+ * @returns Number of SHA256_TREE_HASH_CHUNK_SIZE leaves, at least one
+ */
+uint64_t sha256_mb_tree_hash_nleaves(uint64_t len);
+
+/**
+ * @brief  Hash the leaves of a message for the SHA256 tree hash.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Every SHA256_TREE_HASH_CHUNK_SIZE chunk of the message is one leaf, and all
+ * leaves are hashed side by side in the lanes of one manager. To spread a
+ * large message over several threads, give each thread a slice starting on a
+ * chunk boundary, with the matching offset into digests, then combine the
+ * leaf digests of all slices with sha256_mb_tree_hash_combine().
+ *
+ * @param  buf Message or slice of a message to be hashed
+ * @param  len Length of buf (in bytes)
+ * @param  digests Array of sha256_mb_tree_hash_nleaves(len) digests receiving the leaves
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int sha256_mb_tree_hash_leaves(const void* buf, uint64_t len,
+			       uint8_t (*digests)[SHA256_DIGEST_NWORDS * 4]);
+
+/**
+ * @brief  Combine leaf digests into the SHA256 tree hash.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Pairs of digests are hashed together level by level, a digest with no
+ * right neighbour moving up unchanged, until one digest is left. Each level
+ * is hashed as one batch.
+ *
+ * @param  digests Array of n leaf digests
+ * @param  n Number of leaves
+ * @param  digest Digest receiving the tree hash
+ * @returns 0 on success, -1 on no leaves, memory allocation failure or job error
+ */
+int sha256_mb_tree_hash_combine(const uint8_t (*digests)[SHA256_DIGEST_NWORDS * 4],
+				uint32_t n, uint8_t digest[SHA256_DIGEST_NWORDS * 4]);
+
+/**
+ * @brief  Compute the SHA256 tree hash of a message using every lane.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Standard tree hash of Amazon Glacier, the binary form of its
+ * x-amz-sha256-tree-hash. A single large message is spread over all lanes of
+ * the manager as independent leaves. A message of at most one chunk gives
+ * its plain SHA-256 digest.
+ *
+ * @param  buf Message to be hashed
+ * @param  len Length of the message (in bytes)
+ * @param  digest Digest receiving the tree hash
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int sha256_mb_tree_hash(const void* buf, uint64_t len, uint8_t digest[SHA256_DIGEST_NWORDS * 4]);
+
+/******************** checksum in the same pass **********************/
+
+/**
+ * @brief Initialize a SHA256 plus checksum ctx.
+ *
+ * Sets the checksum computed next to SHA256 for every job on the ctx.
+ *
+ * @param cctx	Structure holding ctx job info
+ * @param alg	Checksum type
+ * @param seed	Checksum seed, 0 for the plain CRC32C or xxHash64 of the message
+ * @returns void
+ */
+void sha256_csum_ctx_init(SHA256_CSUM_HASH_CTX* cctx, SHA256_CSUM_ALG alg, uint64_t seed);
+
+/**
+ * @brief Initialize the SHA256 plus checksum multi-buffer manager structure.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns void
+ */
+void sha256_csum_ctx_mgr_init(SHA256_CSUM_HASH_CTX_MGR* mgr);
+
+/**
+ * @brief Submit a new SHA256 plus checksum job to the multi-buffer manager.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * Works like sha256_ctx_mgr_submit(), and also computes the checksum chosen
+ * by sha256_csum_ctx_init() into cctx->csum. The buffer goes to the lanes
+ * SHA256_CSUM_SLICE bytes at a time, and each slice is checksummed as its
+ * lane returns it, so the data is read from memory once for both.
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  cctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA256_CSUM_HASH_CTX* sha256_csum_ctx_mgr_submit(SHA256_CSUM_HASH_CTX_MGR* mgr,
+						 SHA256_CSUM_HASH_CTX* cctx,
+						 const void* buffer, uint32_t len,
+						 HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all submitted SHA256 plus checksum jobs and return when complete.
+ * @requires SSE4.1 or AVX or AVX2
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+SHA256_CSUM_HASH_CTX* sha256_csum_ctx_mgr_flush(SHA256_CSUM_HASH_CTX_MGR* mgr);
+
 
 /*******************************************************************
  * CTX level API function prototypes
@@ -444,6 +1222,11 @@ void        sha256_mb_mgr_init_avx512_ni    (SHA256_MB_JOB_MGR *state);
 SHA256_JOB* sha256_mb_mgr_submit_avx512_ni  (SHA256_MB_JOB_MGR *state, SHA256_JOB* job);
 SHA256_JOB* sha256_mb_mgr_flush_avx512_ni   (SHA256_MB_JOB_MGR *state);
 
+void        sha256_ctx_mgr_deadline_init     (SHA256_HASH_CTX_MGR *mgr);
+int         sha256_ctx_mgr_deadline_submit   (SHA256_HASH_CTX_MGR *mgr, uint32_t len,
+					      SHA256_HASH_CTX *ctx);
+void        sha256_ctx_mgr_deadline_complete (SHA256_HASH_CTX_MGR *mgr);
+
 #ifdef __cplusplus
 }
 #endif
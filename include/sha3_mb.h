@@ -0,0 +1,308 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#ifndef _SHA3_MB_H_
+#define _SHA3_MB_H_
+
+/**
+ *  @file sha3_mb.h
+ *  @brief Multi-buffer CTX API SHA3 and SHAKE function prototypes and structures
+ *
+ * Interface for multi-buffer SHA3-256, SHA3-512, SHAKE128 and SHAKE256 functions
+ *
+ * <b> Multi-buffer SHA3  Entire or First-Update..Update-Last </b>
+ *
+ * The interface follows the other multi-buffer hashes: a SHA3_HASH_CTX_MGR schedules
+ * SHA3_HASH_CTX objects given to it with sha3_ctx_mgr_submit() and hands them back,
+ * in general out of order, from a later submit or sha3_ctx_mgr_flush(). Every job
+ * runs the Keccak-f[1600] permutation, so contexts of different algorithms may share
+ * one manager and are processed side by side.
+ *
+ * Each SHA3_HASH_CTX must be set up with sha3_ctx_init() before first use, which picks
+ * the algorithm and the buffer receiving the digest. For SHAKE128 and SHAKE256 the
+ * digest length is chosen freely and the whole output is squeezed before the context
+ * is returned with HASH_CTX_STS_COMPLETE. A context keeps its algorithm and digest
+ * buffer when it is reused by another HASH_FIRST submit.
+ *
+ * The SHA3 CTX interface functions are available in a base version and, on x86_64,
+ * AVX2 and AVX512 versions processing 4 and 8 Keccak states at a time. A multibinary
+ * interface selects the appropriate version at runtime.
+ */
+
+#include <stdint.h>
+#include "multi_buffer.h"
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hash Constants and Typedefs
+#define SHA3_STATE_NWORDS		25	//!< Keccak-f[1600] state, in 64-bit words
+#define SHA3_MAX_LANES			8
+#define SHA3_X4_LANES			4
+#define SHA3_X8_LANES			8
+#define SHA3_256_RATE			136
+#define SHA3_512_RATE			72
+#define SHAKE128_RATE			168
+#define SHAKE256_RATE			136
+#define SHA3_MAX_RATE			SHAKE128_RATE
+#define SHA3_256_DIGEST_SIZE		32
+#define SHA3_512_DIGEST_SIZE		64
+
+/** @brief Algorithms run by a SHA3_HASH_CTX */
+
+typedef enum {
+	SHA3_ALG_256 = 0,	//!< SHA3-256, 32 byte digest
+	SHA3_ALG_512,		//!< SHA3-512, 64 byte digest
+	SHA3_ALG_SHAKE128,	//!< SHAKE128, any digest length
+	SHA3_ALG_SHAKE256	//!< SHAKE256, any digest length
+} SHA3_ALG;
+
+/** @brief Scheduler layer - Holds info describing a single SHA3 job for the multi-buffer manager */
+
+typedef struct {
+	uint8_t *buffer;	//!< pointer to data buffer for this job, NULL to only run the permutation
+	uint64_t len;	//!< length of buffer for this job in blocks (permutations if buffer is NULL).
+	uint32_t rate;	//!< block size of the job's algorithm in bytes
+	DECLARE_ALIGNED(uint64_t state[SHA3_STATE_NWORDS], 64);	//!< Keccak state
+	JOB_STS status;	//!< output job status
+	void *user_data;	//!< pointer for user's job-related data
+} SHA3_JOB;
+
+/** @brief Scheduler layer - Lane data */
+
+typedef struct {
+	SHA3_JOB *job_in_lane;
+} SHA3_LANE_DATA;
+
+/** @brief Scheduler layer - Holds state for multi-buffer SHA3 jobs */
+
+typedef struct {
+	uint64_t lens[SHA3_MAX_LANES];	//!< blocks left in each lane shifted by 4, or'ed with the lane index
+	uint64_t unused_lanes;	//!< each nibble is index (0...3 or 0...7) of unused lanes, top nibble is set to F as a flag
+	SHA3_LANE_DATA ldata[SHA3_MAX_LANES];
+	uint32_t num_lanes_inuse;
+} SHA3_MB_JOB_MGR;
+
+/** @brief Context layer - Holds state for multi-buffer SHA3 jobs */
+
+typedef struct {
+	SHA3_MB_JOB_MGR mgr;
+} SHA3_HASH_CTX_MGR;
+
+/** @brief Context layer - Holds info describing a single SHA3 job for the multi-buffer CTX manager */
+
+typedef struct {
+	SHA3_JOB job;	// Must be at struct offset 0.
+	HASH_CTX_STS status;	//!< Context status flag
+	HASH_CTX_ERROR error;	//!< Context error flag
+	uint64_t total_length;	//!< Running counter of length processed for this CTX's job
+	const void *incoming_buffer;	//!< pointer to data input buffer for this CTX's job
+	uint32_t incoming_buffer_length;	//!< length of buffer for this job in bytes.
+	uint8_t partial_block_buffer[SHA3_MAX_RATE];	//!< CTX partial block
+	uint32_t partial_block_buffer_length;
+	void *user_data;	//!< pointer for user to keep any job-related data
+	uint8_t suffix;	//!< domain separation bits of the algorithm
+	uint8_t *digest;	//!< buffer receiving the digest, set by sha3_ctx_init()
+	uint32_t digest_len;	//!< length of digest in bytes
+	uint32_t digest_done;	//!< bytes of digest squeezed so far
+} SHA3_HASH_CTX;
+
+/******************** multibinary function prototypes **********************/
+
+/**
+* @brief Initialize the SHA3 multi-buffer manager structure.
+*
+* @param mgr	Structure holding context level state info
+* @returns void
+*/
+void sha3_ctx_mgr_init(SHA3_HASH_CTX_MGR * mgr);
+
+/**
+* @brief  Submit a new SHA3 job to the multi-buffer manager.
+*
+* @param  mgr Structure holding context level state info
+* @param  ctx Structure holding ctx job info
+* @param  buffer Pointer to buffer to be processed
+* @param  len Length of buffer (in bytes) to be processed
+* @param  flags Input flag specifying job type (first, update, last or entire)
+* @returns NULL if no jobs complete or pointer to jobs structure.
+*/
+SHA3_HASH_CTX *sha3_ctx_mgr_submit(SHA3_HASH_CTX_MGR * mgr, SHA3_HASH_CTX * ctx,
+				   const void *buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+* @brief Finish all submitted SHA3 jobs and return when complete.
+*
+* @param mgr	Structure holding context level state info
+* @returns NULL if no jobs to complete or pointer to jobs structure.
+*/
+SHA3_HASH_CTX *sha3_ctx_mgr_flush(SHA3_HASH_CTX_MGR * mgr);
+
+/**
+* @brief  Set up a SHA3 ctx for an algorithm and digest buffer.
+*
+* Does what hash_ctx_init does for the other hashes, so the ctx is ready for a
+* HASH_FIRST submit. The digest is written to digest once the ctx is returned
+* with HASH_CTX_STS_COMPLETE.
+*
+* @param  ctx Structure holding ctx job info
+* @param  alg Algorithm to run
+* @param  digest Buffer receiving the digest
+* @param  digest_len Length of digest (in bytes); must be SHA3_256_DIGEST_SIZE
+*         or SHA3_512_DIGEST_SIZE for SHA3-256 and SHA3-512, any non-zero
+*         length for SHAKE128 and SHAKE256
+* @returns 0 on success, -1 on unknown algorithm or bad digest length
+*/
+int sha3_ctx_init(SHA3_HASH_CTX * ctx, SHA3_ALG alg, uint8_t * digest, uint32_t digest_len);
+
+/*******************************************************************
+ * CTX level API function prototypes
+ ******************************************************************/
+
+/**
+ * @brief Initialize the SHA3 multi-buffer manager structure.
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns void
+ */
+void sha3_ctx_mgr_init_base(SHA3_HASH_CTX_MGR * mgr);
+
+/**
+ * @brief  Submit a new SHA3 job to the multi-buffer manager.
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA3_HASH_CTX *sha3_ctx_mgr_submit_base(SHA3_HASH_CTX_MGR * mgr, SHA3_HASH_CTX * ctx,
+					const void *buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all submitted SHA3 jobs and return when complete.
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+SHA3_HASH_CTX *sha3_ctx_mgr_flush_base(SHA3_HASH_CTX_MGR * mgr);
+
+/**
+ * @brief Initialize the SHA3 multi-buffer manager structure.
+ * @requires AVX2
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns void
+ */
+void sha3_ctx_mgr_init_avx2(SHA3_HASH_CTX_MGR * mgr);
+
+/**
+ * @brief  Submit a new SHA3 job to the multi-buffer manager.
+ * @requires AVX2
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA3_HASH_CTX *sha3_ctx_mgr_submit_avx2(SHA3_HASH_CTX_MGR * mgr, SHA3_HASH_CTX * ctx,
+					const void *buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all submitted SHA3 jobs and return when complete.
+ * @requires AVX2
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+SHA3_HASH_CTX *sha3_ctx_mgr_flush_avx2(SHA3_HASH_CTX_MGR * mgr);
+
+/**
+ * @brief Initialize the SHA3 multi-buffer manager structure.
+ * @requires AVX512
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns void
+ */
+void sha3_ctx_mgr_init_avx512(SHA3_HASH_CTX_MGR * mgr);
+
+/**
+ * @brief  Submit a new SHA3 job to the multi-buffer manager.
+ * @requires AVX512
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA3_HASH_CTX *sha3_ctx_mgr_submit_avx512(SHA3_HASH_CTX_MGR * mgr, SHA3_HASH_CTX * ctx,
+					  const void *buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all submitted SHA3 jobs and return when complete.
+ * @requires AVX512
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+SHA3_HASH_CTX *sha3_ctx_mgr_flush_avx512(SHA3_HASH_CTX_MGR * mgr);
+
+/*******************************************************************
+ * Scheduler (internal) level out-of-order function prototypes
+ ******************************************************************/
+
+void sha3_keccak_f1600(uint64_t state[SHA3_STATE_NWORDS]);
+
+void sha3_mb_mgr_init_base(SHA3_MB_JOB_MGR * state);
+SHA3_JOB *sha3_mb_mgr_submit_base(SHA3_MB_JOB_MGR * state, SHA3_JOB * job);
+SHA3_JOB *sha3_mb_mgr_flush_base(SHA3_MB_JOB_MGR * state);
+
+void sha3_mb_mgr_init_avx2(SHA3_MB_JOB_MGR * state);
+SHA3_JOB *sha3_mb_mgr_submit_avx2(SHA3_MB_JOB_MGR * state, SHA3_JOB * job);
+SHA3_JOB *sha3_mb_mgr_flush_avx2(SHA3_MB_JOB_MGR * state);
+
+void sha3_mb_mgr_init_avx512(SHA3_MB_JOB_MGR * state);
+SHA3_JOB *sha3_mb_mgr_submit_avx512(SHA3_MB_JOB_MGR * state, SHA3_JOB * job);
+SHA3_JOB *sha3_mb_mgr_flush_avx512(SHA3_MB_JOB_MGR * state);
+
+void sha3_mb_x4_avx2(SHA3_JOB * jobs[SHA3_X4_LANES], uint64_t len);
+void sha3_mb_x8_avx512(SHA3_JOB * jobs[SHA3_X8_LANES], uint64_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SHA3_MB_H_
@@ -130,6 +130,14 @@ extern "C" {
 #define SHA512_INITIAL_DIGEST		\
 	0x6a09e667f3bcc908,0xbb67ae8584caa73b,0x3c6ef372fe94f82b,0xa54ff53a5f1d36f1, \
 	0x510e527fade682d1,0x9b05688c2b3e6c1f,0x1f83d9abfb41bd6b,0x5be0cd19137e2179
+#define SHA384_DIGEST_NWORDS		6	//!< SHA-384 result is the first 6 words of result_digest
+#define SHA384_INITIAL_DIGEST		\
+	0xcbbb9d5dc1059ed8,0x629a292a367cd507,0x9159015a3070dd17,0x152fecd8f70e5939, \
+	0x67332667ffc00b31,0x8eb44a8768581511,0xdb0c2e0d64f98fa7,0x47b5481dbefa4fa4
+#define SHA512_256_DIGEST_NWORDS	4	//!< SHA-512/256 result is the first 4 words of result_digest
+#define SHA512_256_INITIAL_DIGEST	\
+	0x22312194fc2bf72c,0x9f555fa3c84c64c2,0x2393b86b6f53b151,0x963877195940eabd, \
+	0x96283ee2a88effe3,0xbe5e1e2553863992,0x2b0199fc2c85b8aa,0x0eb72ddc81c52ca2
 
 
 typedef uint64_t sha512_digest_array[SHA512_DIGEST_NWORDS][SHA512_MAX_LANES];
@@ -186,8 +194,70 @@ typedef struct {
 	uint8_t		partial_block_buffer[SHA512_BLOCK_SIZE * 2]; //!< CTX partial blocks
 	uint32_t	partial_block_buffer_length;
 	void*		user_data;	//!< pointer for user to keep any job-related data
+	const void*	pending_buffer;	//!< rest of a sha512_ctx_mgr_submit_64() buffer not yet handed to the manager
+	uint64_t	pending_length;	//!< length of pending_buffer in bytes
+	HASH_CTX_FLAG	pending_flags;	//!< flags for the last piece of pending_buffer
 } SHA512_HASH_CTX;
 
+/** @brief Context layer - Holds a SHA512 ctx snapshot taken on a block boundary */
+
+typedef struct {
+	SHA512_WORD_T	digest[SHA512_DIGEST_NWORDS];	//!< hash state after total_length bytes
+	uint64_t	total_length;	//!< bytes hashed so far, a whole number of blocks
+} SHA512_MIDSTATE;
+
+/** @brief Context layer - Holds the ipad and opad midstates of one HMAC-SHA512 key */
+
+typedef struct {
+	SHA512_MIDSTATE	ipad;	//!< state after hashing the key xor ipad block
+	SHA512_MIDSTATE	opad;	//!< state after hashing the key xor opad block
+} HMAC_SHA512_KEY;
+
+/** @brief Context layer - Holds info describing a single HMAC-SHA512 job */
+
+typedef struct {
+	SHA512_HASH_CTX	ctx;	//!< hash state, holds the MAC in ctx.job.result_digest once complete
+	const HMAC_SHA512_KEY*	key;	//!< key of the job, set by the HASH_FIRST submit
+	SHA512_WORD_T	inner_digest[SHA512_DIGEST_NWORDS];	//!< inner hash in message byte order
+	int	outer;	//!< set once the outer hash is submitted
+} HMAC_SHA512_HASH_CTX;
+
+/** @brief Context layer - Holds state for multi-buffer HMAC-SHA512 jobs */
+
+typedef struct {
+	SHA512_HASH_CTX_MGR	mgr;
+} HMAC_SHA512_HASH_CTX_MGR;
+
+#define MERKLE_SHA512_MAX_HEIGHT	64
+
+/** @brief Merkle tree - Pending subtrees of a SHA512 Merkle tree built by appending leaves */
+
+typedef struct {
+	uint8_t	frontier[MERKLE_SHA512_MAX_HEIGHT][SHA512_DIGEST_NWORDS * 8];	//!< root of the pending perfect subtree of each height
+	uint64_t	nleaves;	//!< number of leaves appended so far
+} MERKLE_SHA512_STATE;
+
+/** @brief Context layer - Holds a job kept back by the length-aware scheduler */
+
+typedef struct {
+	SHA512_HASH_CTX*	ctx;	//!< ctx of the held back job
+	const void*	buffer;	//!< buffer passed to the scheduler submit
+	uint32_t	len;	//!< length of buffer in bytes
+	HASH_CTX_FLAG	flags;	//!< flags passed to the scheduler submit
+	HASH_CTX_STS	status;	//!< ctx status before the job was held back
+} SHA512_SCHED_ENTRY;
+
+#define SHA512_SCHED_QUEUE_MAX		(2 * SHA512_MAX_LANES)
+
+/** @brief Context layer - SHA512 manager with a length sorted submission queue */
+
+typedef struct {
+	SHA512_HASH_CTX_MGR	mgr;
+	SHA512_SCHED_ENTRY	queue[SHA512_SCHED_QUEUE_MAX]; //!< pending jobs, sorted by length
+	uint32_t	queue_len;	//!< number of pending jobs
+	uint32_t	queue_depth;	//!< jobs held back before the longest is released
+} SHA512_HASH_CTX_SCHED;
+
 /*******************************************************************
  * Context level API function prototypes
  ******************************************************************/
@@ -352,6 +422,79 @@ SHA512_HASH_CTX* sha512_ctx_mgr_submit_sb_sse4 (SHA512_HASH_CTX_MGR* mgr, SHA512
  */
 SHA512_HASH_CTX* sha512_ctx_mgr_flush_sb_sse4  (SHA512_HASH_CTX_MGR* mgr);
 
+/**
+ * @brief Initialize the SHA512 multi-buffer manager structure.
+ * @requires AVX2
+ *
+ * Single buffer path for when one stream has to finish as soon as possible
+ * rather than many streams sharing the lanes. sha512_ctx_mgr_init() picks it
+ * on Atom class cores with AVX2, as it picks the sb_sse4 path on Avoton.
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns void
+ */
+void      sha512_ctx_mgr_init_sb_avx2   (SHA512_HASH_CTX_MGR* mgr);
+
+/**
+ * @brief  Submit a new SHA512 job to the multi-buffer manager.
+ * @requires AVX2
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA512_HASH_CTX* sha512_ctx_mgr_submit_sb_avx2 (SHA512_HASH_CTX_MGR* mgr, SHA512_HASH_CTX* ctx,
+					const void* buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all submitted SHA512 jobs and return when complete.
+ * @requires AVX2
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+SHA512_HASH_CTX* sha512_ctx_mgr_flush_sb_avx2  (SHA512_HASH_CTX_MGR* mgr);
+
+/**
+ * @brief Initialize the SHA512 multi-buffer manager structure.
+ * @requires AVX2 and SHA512
+ *
+ * Uses the SHA512 instruction extension on up to two lanes, so a single
+ * stream is hashed at the speed of the x1 kernel. sha512_ctx_mgr_init()
+ * does not select it; callers that know the CPU supports the extension
+ * can use the _ni functions directly.
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns void
+ */
+void      sha512_ctx_mgr_init_ni   (SHA512_HASH_CTX_MGR* mgr);
+
+/**
+ * @brief  Submit a new SHA512 job to the multi-buffer manager.
+ * @requires AVX2 and SHA512
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA512_HASH_CTX* sha512_ctx_mgr_submit_ni (SHA512_HASH_CTX_MGR* mgr, SHA512_HASH_CTX* ctx,
+					const void* buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all submitted SHA512 jobs and return when complete.
+ * @requires AVX2 and SHA512
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+SHA512_HASH_CTX* sha512_ctx_mgr_flush_ni  (SHA512_HASH_CTX_MGR* mgr);
+
 /******************** multibinary function prototypes **********************/
 
 /**
@@ -386,6 +529,415 @@ SHA512_HASH_CTX* sha512_ctx_mgr_submit (SHA512_HASH_CTX_MGR* mgr, SHA512_HASH_CT
  */
 SHA512_HASH_CTX* sha512_ctx_mgr_flush  (SHA512_HASH_CTX_MGR* mgr);
 
+/******************** batch submit **********************/
+
+/**
+ * @brief  Submit an array of SHA512 jobs to the multi-buffer manager.
+ * @requires SSE4.1
+ *
+ * Equivalent to calling sha512_ctx_mgr_submit() on each ctx[i] in turn with
+ * buffer[i] and len[i], but every ctx handed back by the manager is collected
+ * in the completed array instead of being returned one by one. Contexts that
+ * were rejected are returned there as well with their error member set.
+ *
+ * The flags are checked and the selected submit is looked up once per
+ * batch rather than per job. Invalid flags reject the whole batch: every
+ * ctx is returned in completed with HASH_CTX_ERROR_INVALID_FLAGS set.
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Array of num structures holding ctx job info
+ * @param  buffer Array of num pointers to buffers to be processed
+ * @param  len Array of num buffer lengths (in bytes)
+ * @param  num Number of jobs to submit
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @param  completed Array of at least num entries that receives returned jobs
+ * @param  num_completed Number of entries written to completed
+ * @returns void
+ */
+void sha512_ctx_mgr_submit_batch(SHA512_HASH_CTX_MGR* mgr, SHA512_HASH_CTX* ctx[],
+				 const void* buffer[], const uint32_t len[], uint32_t num,
+				 HASH_CTX_FLAG flags, SHA512_HASH_CTX* completed[],
+				 uint32_t* num_completed);
+
+/******************** hashing of many buffers **********************/
+
+/**
+ * @brief  Hash a set of independent buffers with SHA512 in one call.
+ * @requires SSE4.1
+ *
+ * Stateless helper that owns a SHA512_HASH_CTX_MGR and a pool of contexts and
+ * drives submit and flush until every buffer is hashed. Jobs are started
+ * longest first so lanes stay busy until the end. Buffers larger than 4GB are
+ * accepted and fed to the manager in several updates.
+ *
+ * @param  bufs Array of n pointers to buffers to be hashed
+ * @param  lens Array of n buffer lengths (in bytes)
+ * @param  n Number of buffers
+ * @param  digests Array of n digests receiving the result of each buffer
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int sha512_mb_hash_many(const void* bufs[], const uint64_t lens[], uint32_t n,
+			uint8_t (*digests)[SHA512_DIGEST_NWORDS * 8]);
+
+/******************** length-aware scheduler **********************/
+
+/**
+ * @brief Initialize the length-aware SHA512 scheduler.
+ * @requires SSE4.1
+ *
+ * The scheduler holds up to depth submitted jobs in a queue sorted by length
+ * and only hands the longest of them to the multi-buffer manager once the
+ * queue is full (longest-processing-time-first). Long jobs then start early
+ * and the jobs left for the flush tail are the short ones, so fewer lanes sit
+ * idle while the last long job runs. A depth of 0 disables the queue.
+ *
+ * @param sched	Structure holding scheduler and context level state info
+ * @param depth	Number of jobs to hold back, at most SHA512_SCHED_QUEUE_MAX
+ * @returns void
+ */
+void sha512_ctx_sched_init(SHA512_HASH_CTX_SCHED* sched, uint32_t depth);
+
+/**
+ * @brief  Submit a new SHA512 job through the length-aware scheduler.
+ * @requires SSE4.1
+ *
+ * Same semantics as sha512_ctx_mgr_submit(). A held back ctx is marked as
+ * processing until it is returned by a later submit or flush.
+ *
+ * @param  sched Structure holding scheduler and context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA512_HASH_CTX* sha512_ctx_sched_submit(SHA512_HASH_CTX_SCHED* sched, SHA512_HASH_CTX* ctx,
+					 const void* buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all jobs held by the SHA512 scheduler and return when complete.
+ * @requires SSE4.1
+ *
+ * @param sched	Structure holding scheduler and context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+SHA512_HASH_CTX* sha512_ctx_sched_flush(SHA512_HASH_CTX_SCHED* sched);
+
+/******************** jobs larger than 4GB **********************/
+
+/**
+ * @brief Submit a SHA512 job of up to 2^64 - 1 bytes to the multi-buffer manager.
+ * @requires SSE4.1
+ *
+ * Same as sha512_ctx_mgr_submit() with a 64-bit length. Buffers too long for
+ * one lane scheduling round are handed to the manager in pieces as earlier
+ * pieces complete, so the ctx is only returned once all of buffer has been
+ * processed. Jobs are finished with sha512_ctx_mgr_flush() and can share mgr
+ * with jobs from sha512_ctx_mgr_submit().
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA512_HASH_CTX* sha512_ctx_mgr_submit_64(SHA512_HASH_CTX_MGR* mgr, SHA512_HASH_CTX* ctx,
+					  const void* buffer, uint64_t len, HASH_CTX_FLAG flags);
+
+/******************** digest variants **********************/
+
+/**
+ * @brief  Submit a new SHA384 job to a SHA512 multi-buffer manager.
+ * @requires SSE4.1
+ *
+ * Same as sha512_ctx_mgr_submit() but a job started with HASH_FIRST uses the
+ * SHA-384 initial digest. SHA384, SHA512/256 and SHA512 jobs can be mixed on
+ * one manager, which is initialized and flushed with the sha512_ctx_mgr_*
+ * functions. The digest is the first SHA384_DIGEST_NWORDS words of
+ * result_digest.
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA512_HASH_CTX* sha384_ctx_mgr_submit (SHA512_HASH_CTX_MGR* mgr, SHA512_HASH_CTX* ctx,
+					const void* buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief  Submit a new SHA512/256 job to a SHA512 multi-buffer manager.
+ * @requires SSE4.1
+ *
+ * As sha384_ctx_mgr_submit() with the SHA-512/256 initial digest. The digest
+ * is the first SHA512_256_DIGEST_NWORDS words of result_digest.
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  ctx Structure holding ctx job info
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+SHA512_HASH_CTX* sha512_256_ctx_mgr_submit (SHA512_HASH_CTX_MGR* mgr, SHA512_HASH_CTX* ctx,
+					    const void* buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/******************** HMAC **********************/
+
+/**
+ * @brief Precompute the HMAC-SHA512 ipad and opad midstates of a key.
+ *
+ * Done once per key. Jobs using the key then start one block into the
+ * message instead of hashing the padded key each time.
+ *
+ * @param key	Structure receiving the midstates
+ * @param k	Pointer to the key
+ * @param len	Length of the key in bytes
+ * @returns void
+ */
+void hmac_sha512_key_init(HMAC_SHA512_KEY* key, const void* k, uint32_t len);
+
+/**
+ * @brief Initialize the HMAC-SHA512 multi-buffer manager structure.
+ * @requires SSE4.1
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns void
+ */
+void hmac_sha512_ctx_mgr_init(HMAC_SHA512_HASH_CTX_MGR* mgr);
+
+/**
+ * @brief Submit a new HMAC-SHA512 job to the multi-buffer manager.
+ * @requires SSE4.1
+ *
+ * Works like sha512_ctx_mgr_submit() on the message. A job started with
+ * HASH_FIRST begins from the ipad midstate of key; key is ignored for other
+ * flags and must stay valid until the job completes. Once the message is
+ * done, the outer hash over the inner digest is submitted to the same lanes,
+ * so the ctx is only returned with the MAC in ctx.job.result_digest.
+ *
+ * @param  mgr Structure holding context level state info
+ * @param  hctx Structure holding ctx job info
+ * @param  key Key midstates from hmac_sha512_key_init()
+ * @param  buffer Pointer to buffer to be processed
+ * @param  len Length of buffer (in bytes) to be processed
+ * @param  flags Input flag specifying job type (first, update, last or entire)
+ * @returns NULL if no jobs complete or pointer to jobs structure.
+ */
+HMAC_SHA512_HASH_CTX* hmac_sha512_ctx_mgr_submit(HMAC_SHA512_HASH_CTX_MGR* mgr,
+						 HMAC_SHA512_HASH_CTX* hctx,
+						 const HMAC_SHA512_KEY* key, const void* buffer,
+						 uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+ * @brief Finish all submitted HMAC-SHA512 jobs and return when complete.
+ * @requires SSE4.1
+ *
+ * @param mgr	Structure holding context level state info
+ * @returns NULL if no jobs to complete or pointer to jobs structure.
+ */
+HMAC_SHA512_HASH_CTX* hmac_sha512_ctx_mgr_flush(HMAC_SHA512_HASH_CTX_MGR* mgr);
+
+/******************** saved midstates **********************/
+
+/**
+ * @brief Save the state of a SHA512 ctx for sha512_ctx_midstate_restore().
+ *
+ * ctx must be idle on a block boundary, i.e. returned from HASH_FIRST or
+ * HASH_UPDATE submits whose lengths add up to a whole number of blocks. A
+ * midstate is only valid with the library build and CPU that produced it.
+ *
+ * @param ctx	Structure holding ctx job info
+ * @param ms	Structure receiving the midstate
+ * @returns 0 on success, -1 if ctx is busy, complete or has a partial block
+ */
+int sha512_ctx_midstate_save(const SHA512_HASH_CTX* ctx, SHA512_MIDSTATE* ms);
+
+/**
+ * @brief Start a SHA512 ctx from a saved midstate instead of the initial digest.
+ *
+ * ctx is left idle as if the prefix the midstate was taken after had just
+ * been submitted to it. Continue the job with HASH_UPDATE or HASH_LAST, not
+ * HASH_FIRST. Any number of contexts can be started from the same midstate.
+ *
+ * @param ctx	Structure holding ctx job info
+ * @param ms	Midstate from sha512_ctx_midstate_save()
+ * @returns 0 on success, -1 if ctx is being processed
+ */
+int sha512_ctx_midstate_restore(SHA512_HASH_CTX* ctx, const SHA512_MIDSTATE* ms);
+
+/******************** PBKDF2 **********************/
+
+/**
+ * @brief  Derive keys with PBKDF2-HMAC-SHA512 for a set of passwords in one call.
+ * @requires SSE4.1
+ *
+ * Every dk_len-byte output block of every password is an independent chain
+ * of iter HMACs, and all chains are kept in flight in the multi-buffer
+ * manager at once. After the first HMAC of a chain, each hash is a single
+ * pre-padded block resumed from the HMAC key midstates, so the iteration
+ * loop costs two block compressions per iteration and no buffering.
+ *
+ * @param  pass Array of n pointers to passwords
+ * @param  pass_lens Array of n password lengths (in bytes)
+ * @param  salt Array of n pointers to salts
+ * @param  salt_lens Array of n salt lengths (in bytes)
+ * @param  iter Iteration count, at least 1
+ * @param  dk Array of n buffers of dk_len bytes receiving the derived keys
+ * @param  dk_len Length of each derived key (in bytes)
+ * @param  n Number of keys to derive
+ * @returns 0 on success, -1 on invalid iteration count, memory allocation failure or job error
+ */
+int pbkdf2_hmac_sha512_mb(const void* pass[], const uint32_t pass_lens[],
+			  const void* salt[], const uint32_t salt_lens[], uint32_t iter,
+			  uint8_t* dk[], uint32_t dk_len, uint32_t n);
+
+/******************** HKDF **********************/
+
+/**
+ * @brief  HKDF-Extract with HMAC-SHA384 for a set of connections in one call.
+ * @requires SSE4.1
+ *
+ * Computes PRK = HMAC-SHA384(salt, IKM) (RFC 5869) for n independent
+ * inputs, with all of them in flight on the SHA512 multi-buffer lanes at once.
+ *
+ * @param  salt Array of n pointers to salts, an empty salt stands for HashLen zeros
+ * @param  salt_lens Array of n salt lengths (in bytes)
+ * @param  ikm Array of n pointers to input keying material
+ * @param  ikm_lens Array of n input keying material lengths (in bytes)
+ * @param  prk Array of n buffers of SHA384_DIGEST_NWORDS * 8 bytes receiving the PRKs
+ * @param  n Number of extract steps
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int hkdf_sha384_mb_extract(const void* salt[], const uint32_t salt_lens[],
+			   const void* ikm[], const uint32_t ikm_lens[], uint8_t* prk[], uint32_t n);
+
+/**
+ * @brief  HKDF-Expand with HMAC-SHA384 for a set of connections in one call.
+ * @requires SSE4.1
+ *
+ * Computes okm_lens[i] bytes of OKM = T(1) | T(2) | ... (RFC 5869) for n
+ * independent PRK and info pairs. The blocks T(i) of one output chain from
+ * each other, so batching comes from running many connections side by side,
+ * as with the many short HKDF-Expand-Label steps of a TLS 1.3 key schedule.
+ *
+ * @param  prk Array of n pointers to pseudorandom keys
+ * @param  prk_lens Array of n PRK lengths (in bytes)
+ * @param  info Array of n pointers to context and application specific info
+ * @param  info_lens Array of n info lengths (in bytes)
+ * @param  okm Array of n buffers receiving the output keying material
+ * @param  okm_lens Array of n output lengths, each at most 255 * HashLen bytes
+ * @param  n Number of expand steps
+ * @returns 0 on success, -1 on output length too long, memory allocation failure or job error
+ */
+int hkdf_sha384_mb_expand(const void* prk[], const uint32_t prk_lens[],
+			  const void* info[], const uint32_t info_lens[],
+			  uint8_t* okm[], const uint32_t okm_lens[], uint32_t n);
+
+/******************** Merkle trees **********************/
+
+/**
+ * @brief  Number of nodes in a SHA512 Merkle tree of nleaves leaves.
+ *
+ * @param  nleaves Number of leaves
+ * @returns Number of digests written by merkle_sha512_build()
+ */
+uint64_t merkle_sha512_tree_nodes(uint32_t nleaves);
+
+/**
+ * @brief  Build a whole SHA512 Merkle tree over a set of fixed size leaves.
+ * @requires SSE4.1
+ *
+ * Leaves are hashed as 0x00 | leaf and interior nodes as 0x01 | left | right
+ * as in RFC 6962, a node with no right sibling being promoted unchanged. The
+ * hashes of each level are submitted to the multi-buffer manager as one batch.
+ * The tree is stored level by level starting with the leaf hashes, so the
+ * root is the last node. A tree of no leaves is the hash of the empty string.
+ *
+ * @param  leaves Buffer of nleaves leaves stored back to back
+ * @param  nleaves Number of leaves
+ * @param  leaf_size Size of each leaf (in bytes)
+ * @param  tree Array of merkle_sha512_tree_nodes(nleaves) digests receiving the tree
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int merkle_sha512_build(const void* leaves, uint32_t nleaves, uint32_t leaf_size,
+			uint8_t (*tree)[SHA512_DIGEST_NWORDS * 8]);
+
+/**
+ * @brief  Recompute the paths of changed leaves in a tree from merkle_sha512_build().
+ * @requires SSE4.1
+ *
+ * The changed leaves, and then the changed nodes of each level, are hashed as
+ * one batch per level. Nodes shared by several paths are hashed once.
+ *
+ * @param  tree Tree of nleaves leaves to update in place
+ * @param  nleaves Number of leaves of the tree
+ * @param  leaves Buffer of nleaves leaves holding the new contents
+ * @param  leaf_size Size of each leaf (in bytes)
+ * @param  idx Array of nidx indexes of changed leaves, in any order
+ * @param  nidx Number of changed leaves
+ * @returns 0 on success, -1 on index out of range, memory allocation failure or job error
+ */
+int merkle_sha512_update(uint8_t (*tree)[SHA512_DIGEST_NWORDS * 8], uint32_t nleaves,
+			 const void* leaves, uint32_t leaf_size, const uint32_t idx[],
+			 uint32_t nidx);
+
+/**
+ * @brief  Start a SHA512 Merkle tree to be built by appending leaves.
+ *
+ * @param  state Structure holding the pending subtrees
+ * @returns void
+ */
+void merkle_sha512_init(MERKLE_SHA512_STATE* state);
+
+/**
+ * @brief  Append leaves to a SHA512 Merkle tree and fold them into its pending subtrees.
+ * @requires SSE4.1
+ *
+ * Only the root of each pending perfect subtree is kept, so memory does not
+ * grow with the tree. Leaves are hashed and paired up level by level in
+ * batches of up to a thousand, and may be appended in any number of calls.
+ *
+ * @param  state Structure holding the pending subtrees
+ * @param  leaves Buffer of nleaves leaves stored back to back
+ * @param  nleaves Number of leaves to append
+ * @param  leaf_size Size of each leaf (in bytes)
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int merkle_sha512_append(MERKLE_SHA512_STATE* state, const void* leaves, uint32_t nleaves,
+			 uint32_t leaf_size);
+
+/**
+ * @brief  Compute the root of the leaves appended so far to a SHA512 Merkle tree.
+ * @requires SSE4.1
+ *
+ * The state is left unchanged, more leaves can be appended afterwards.
+ *
+ * @param  state Structure holding the pending subtrees
+ * @param  root Digest receiving the root, as merkle_sha512_build() would give
+ * @returns 0 on success, -1 on job error
+ */
+int merkle_sha512_final(const MERKLE_SHA512_STATE* state,
+			uint8_t root[SHA512_DIGEST_NWORDS * 8]);
+
+/**
+ * @brief  Compute the root of a SHA512 Merkle tree without storing the tree.
+ * @requires SSE4.1
+ *
+ * Same as merkle_sha512_init(), merkle_sha512_append() and merkle_sha512_final().
+ *
+ * @param  leaves Buffer of nleaves leaves stored back to back
+ * @param  nleaves Number of leaves
+ * @param  leaf_size Size of each leaf (in bytes)
+ * @param  root Digest receiving the root
+ * @returns 0 on success, -1 on memory allocation failure or job error
+ */
+int merkle_sha512_root(const void* leaves, uint32_t nleaves, uint32_t leaf_size,
+		       uint8_t root[SHA512_DIGEST_NWORDS * 8]);
+
+
 /*******************************************************************
  * Scheduler (internal) level out-of-order function prototypes
  ******************************************************************/
@@ -413,6 +965,19 @@ void        sha512_sb_mgr_init_sse4   (SHA512_MB_JOB_MGR *state);
 SHA512_JOB* sha512_sb_mgr_submit_sse4 (SHA512_MB_JOB_MGR *state, SHA512_JOB* job);
 SHA512_JOB* sha512_sb_mgr_flush_sse4  (SHA512_MB_JOB_MGR *state);
 
+// Single buffer SHA512 APIs for AVX2
+void        sha512_avx2              (const void* M, void* D, uint64_t L);
+void        sha512_sb_mgr_init_avx2   (SHA512_MB_JOB_MGR *state);
+SHA512_JOB* sha512_sb_mgr_submit_avx2 (SHA512_MB_JOB_MGR *state, SHA512_JOB* job);
+SHA512_JOB* sha512_sb_mgr_flush_avx2  (SHA512_MB_JOB_MGR *state);
+
+// SHA512 instruction extension APIs, one or two lanes
+void        sha512_ni_x1             (SHA512_JOB* job, uint64_t blocks);
+void        sha512_ni_x2             (SHA512_JOB* job0, SHA512_JOB* job1, uint64_t blocks);
+void        sha512_mb_mgr_init_ni    (SHA512_MB_JOB_MGR *state);
+SHA512_JOB* sha512_mb_mgr_submit_ni  (SHA512_MB_JOB_MGR *state, SHA512_JOB* job);
+SHA512_JOB* sha512_mb_mgr_flush_ni   (SHA512_MB_JOB_MGR *state);
+
 #ifdef __cplusplus
 }
 #endif
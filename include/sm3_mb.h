@@ -57,6 +57,7 @@ extern "C" {
 #define SM3_BLOCK_SIZE			64
 #define SM3_LOG2_BLOCK_SIZE			6
 #define SM3_PADLENGTHFIELD_SIZE		8
+#define SM3_HASH_SHORT_MAX_LEN		(2 * SM3_BLOCK_SIZE - 1 - SM3_PADLENGTHFIELD_SIZE)	//!< longest message of sm3_mb_hash_short()
 #define SM3_INITIAL_DIGEST		\
 	0x7380166f, 0x4914b2b9, 0x172442d7, 0xda8a0600, \
 	0xa96f30bc, 0x163138aa, 0xe38dee4d, 0xb0fb0e4e
@@ -115,8 +116,70 @@ typedef struct {
 	uint8_t partial_block_buffer[SM3_BLOCK_SIZE * 2];	//!< CTX partial blocks
 	uint32_t partial_block_buffer_length;
 	void *user_data;	//!< pointer for user to keep any job-related data
+	const void *pending_buffer;	//!< rest of a sm3_ctx_mgr_submit_64() buffer not yet handed to the manager
+	uint64_t pending_length;	//!< length of pending_buffer in bytes
+	HASH_CTX_FLAG pending_flags;	//!< flags for the last piece of pending_buffer
 } SM3_HASH_CTX;
 
+/** @brief Context layer - Holds a SM3 ctx snapshot taken on a block boundary */
+
+typedef struct {
+	SM3_WORD_T digest[SM3_DIGEST_NWORDS];	//!< hash state after total_length bytes
+	uint64_t total_length;	//!< bytes hashed so far, a whole number of blocks
+} SM3_MIDSTATE;
+
+/** @brief Context layer - Holds the ipad and opad midstates of one HMAC-SM3 key */
+
+typedef struct {
+	SM3_MIDSTATE ipad;	//!< state after hashing the key xor ipad block
+	SM3_MIDSTATE opad;	//!< state after hashing the key xor opad block
+} HMAC_SM3_KEY;
+
+/** @brief Context layer - Holds info describing a single HMAC-SM3 job */
+
+typedef struct {
+	SM3_HASH_CTX ctx;	//!< hash state, holds the MAC in ctx.job.result_digest once complete
+	const HMAC_SM3_KEY *key;	//!< key of the job, set by the HASH_FIRST submit
+	SM3_WORD_T inner_digest[SM3_DIGEST_NWORDS];	//!< inner hash in message byte order
+	int outer;	//!< set once the outer hash is submitted
+} HMAC_SM3_HASH_CTX;
+
+/** @brief Context layer - Holds state for multi-buffer HMAC-SM3 jobs */
+
+typedef struct {
+	SM3_HASH_CTX_MGR mgr;
+} HMAC_SM3_HASH_CTX_MGR;
+
+#define MERKLE_SM3_MAX_HEIGHT	64
+
+/** @brief Merkle tree - Pending subtrees of a SM3 Merkle tree built by appending leaves */
+
+typedef struct {
+	uint8_t frontier[MERKLE_SM3_MAX_HEIGHT][SM3_DIGEST_NWORDS * 4];	//!< root of the pending perfect subtree of each height
+	uint64_t nleaves;	//!< number of leaves appended so far
+} MERKLE_SM3_STATE;
+
+/** @brief Context layer - Holds a job kept back by the length-aware scheduler */
+
+typedef struct {
+	SM3_HASH_CTX *ctx;	//!< ctx of the held back job
+	const void *buffer;	//!< buffer passed to the scheduler submit
+	uint32_t len;	//!< length of buffer in bytes
+	HASH_CTX_FLAG flags;	//!< flags passed to the scheduler submit
+	HASH_CTX_STS status;	//!< ctx status before the job was held back
+} SM3_SCHED_ENTRY;
+
+#define SM3_SCHED_QUEUE_MAX		(2 * SM3_MAX_LANES)
+
+/** @brief Context layer - SM3 manager with a length sorted submission queue */
+
+typedef struct {
+	SM3_HASH_CTX_MGR mgr;
+	SM3_SCHED_ENTRY queue[SM3_SCHED_QUEUE_MAX];	//!< pending jobs, sorted by length
+	uint32_t queue_len;	//!< number of pending jobs
+	uint32_t queue_depth;	//!< jobs held back before the longest is released
+} SM3_HASH_CTX_SCHED;
+
 /******************** multibinary function prototypes **********************/
 
 /**
@@ -149,6 +212,312 @@ SM3_HASH_CTX *sm3_ctx_mgr_submit(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX * ctx,
 */
 SM3_HASH_CTX *sm3_ctx_mgr_flush(SM3_HASH_CTX_MGR * mgr);
 
+/******************** batch submit **********************/
+
+/**
+* @brief  Submit an array of SM3 jobs to the multi-buffer manager.
+*
+* Equivalent to calling sm3_ctx_mgr_submit() on each ctx[i] in turn with
+* buffer[i] and len[i], but every ctx handed back by the manager is collected
+* in the completed array instead of being returned one by one. Contexts that
+* were rejected are returned there as well with their error member set.
+*
+* The flags are checked and the selected submit is looked up once per
+* batch rather than per job. Invalid flags reject the whole batch: every
+* ctx is returned in completed with HASH_CTX_ERROR_INVALID_FLAGS set.
+*
+* @param  mgr Structure holding context level state info
+* @param  ctx Array of num structures holding ctx job info
+* @param  buffer Array of num pointers to buffers to be processed
+* @param  len Array of num buffer lengths (in bytes)
+* @param  num Number of jobs to submit
+* @param  flags Input flag specifying job type (first, update, last or entire)
+* @param  completed Array of at least num entries that receives returned jobs
+* @param  num_completed Number of entries written to completed
+* @returns void
+*/
+void sm3_ctx_mgr_submit_batch(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX * ctx[],
+			      const void *buffer[], const uint32_t len[], uint32_t num,
+			      HASH_CTX_FLAG flags, SM3_HASH_CTX * completed[],
+			      uint32_t * num_completed);
+
+/******************** hashing of many buffers **********************/
+
+/**
+* @brief  Hash a set of independent buffers with SM3 in one call.
+*
+* Stateless helper that owns a SM3_HASH_CTX_MGR and a pool of contexts and
+* drives submit and flush until every buffer is hashed. Jobs are started
+* longest first so lanes stay busy until the end. Buffers larger than 4GB are
+* accepted and fed to the manager in several updates.
+*
+* @param  bufs Array of n pointers to buffers to be hashed
+* @param  lens Array of n buffer lengths (in bytes)
+* @param  n Number of buffers
+* @param  digests Array of n digests receiving the result of each buffer
+* @returns 0 on success, -1 on memory allocation failure or job error
+*/
+int sm3_mb_hash_many(const void *bufs[], const uint64_t lens[], uint32_t n,
+		     uint8_t (*digests)[SM3_DIGEST_NWORDS * 4]);
+
+/******************** length-aware scheduler **********************/
+
+/**
+* @brief Initialize the length-aware SM3 scheduler.
+*
+* The scheduler holds up to depth submitted jobs in a queue sorted by length
+* and only hands the longest of them to the multi-buffer manager once the
+* queue is full (longest-processing-time-first). Long jobs then start early
+* and the jobs left for the flush tail are the short ones, so fewer lanes sit
+* idle while the last long job runs. A depth of 0 disables the queue.
+*
+* @param sched	Structure holding scheduler and context level state info
+* @param depth	Number of jobs to hold back, at most SM3_SCHED_QUEUE_MAX
+* @returns void
+*/
+void sm3_ctx_sched_init(SM3_HASH_CTX_SCHED * sched, uint32_t depth);
+
+/**
+* @brief  Submit a new SM3 job through the length-aware scheduler.
+*
+* Same semantics as sm3_ctx_mgr_submit(). A held back ctx is marked as
+* processing until it is returned by a later submit or flush.
+*
+* @param  sched Structure holding scheduler and context level state info
+* @param  ctx Structure holding ctx job info
+* @param  buffer Pointer to buffer to be processed
+* @param  len Length of buffer (in bytes) to be processed
+* @param  flags Input flag specifying job type (first, update, last or entire)
+* @returns NULL if no jobs complete or pointer to jobs structure.
+*/
+SM3_HASH_CTX *sm3_ctx_sched_submit(SM3_HASH_CTX_SCHED * sched, SM3_HASH_CTX * ctx,
+				    const void *buffer, uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+* @brief Finish all jobs held by the SM3 scheduler and return when complete.
+*
+* @param sched	Structure holding scheduler and context level state info
+* @returns NULL if no jobs to complete or pointer to jobs structure.
+*/
+SM3_HASH_CTX *sm3_ctx_sched_flush(SM3_HASH_CTX_SCHED * sched);
+
+/******************** jobs larger than 4GB **********************/
+
+/**
+* @brief Submit a SM3 job of up to 2^64 - 1 bytes to the multi-buffer manager.
+*
+* Same as sm3_ctx_mgr_submit() with a 64-bit length. Buffers too long for
+* one lane scheduling round are handed to the manager in pieces as earlier
+* pieces complete, so the ctx is only returned once all of buffer has been
+* processed. Jobs are finished with sm3_ctx_mgr_flush() and can share mgr
+* with jobs from sm3_ctx_mgr_submit().
+*
+* @param  mgr Structure holding context level state info
+* @param  ctx Structure holding ctx job info
+* @param  buffer Pointer to buffer to be processed
+* @param  len Length of buffer (in bytes) to be processed
+* @param  flags Input flag specifying job type (first, update, last or entire)
+* @returns NULL if no jobs complete or pointer to jobs structure.
+*/
+SM3_HASH_CTX *sm3_ctx_mgr_submit_64(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX * ctx,
+				    const void *buffer, uint64_t len, HASH_CTX_FLAG flags);
+
+/******************** HMAC **********************/
+
+/**
+* @brief Precompute the HMAC-SM3 ipad and opad midstates of a key.
+*
+* Done once per key. Jobs using the key then start one block into the
+* message instead of hashing the padded key each time.
+*
+* @param key	Structure receiving the midstates
+* @param k	Pointer to the key
+* @param len	Length of the key in bytes
+* @returns void
+*/
+void hmac_sm3_key_init(HMAC_SM3_KEY * key, const void *k, uint32_t len);
+
+/**
+* @brief Initialize the HMAC-SM3 multi-buffer manager structure.
+*
+* @param mgr	Structure holding context level state info
+* @returns void
+*/
+void hmac_sm3_ctx_mgr_init(HMAC_SM3_HASH_CTX_MGR * mgr);
+
+/**
+* @brief Submit a new HMAC-SM3 job to the multi-buffer manager.
+*
+* Works like sm3_ctx_mgr_submit() on the message. A job started with
+* HASH_FIRST begins from the ipad midstate of key; key is ignored for other
+* flags and must stay valid until the job completes. Once the message is
+* done, the outer hash over the inner digest is submitted to the same lanes,
+* so the ctx is only returned with the MAC in ctx.job.result_digest.
+*
+* @param  mgr Structure holding context level state info
+* @param  hctx Structure holding ctx job info
+* @param  key Key midstates from hmac_sm3_key_init()
+* @param  buffer Pointer to buffer to be processed
+* @param  len Length of buffer (in bytes) to be processed
+* @param  flags Input flag specifying job type (first, update, last or entire)
+* @returns NULL if no jobs complete or pointer to jobs structure.
+*/
+HMAC_SM3_HASH_CTX *hmac_sm3_ctx_mgr_submit(HMAC_SM3_HASH_CTX_MGR * mgr,
+					   HMAC_SM3_HASH_CTX * hctx,
+					   const HMAC_SM3_KEY * key, const void *buffer,
+					   uint32_t len, HASH_CTX_FLAG flags);
+
+/**
+* @brief Finish all submitted HMAC-SM3 jobs and return when complete.
+*
+* @param mgr	Structure holding context level state info
+* @returns NULL if no jobs to complete or pointer to jobs structure.
+*/
+HMAC_SM3_HASH_CTX *hmac_sm3_ctx_mgr_flush(HMAC_SM3_HASH_CTX_MGR * mgr);
+
+/******************** saved midstates **********************/
+
+/**
+* @brief Save the state of a SM3 ctx for sm3_ctx_midstate_restore().
+*
+* ctx must be idle on a block boundary, i.e. returned from HASH_FIRST or
+* HASH_UPDATE submits whose lengths add up to a whole number of blocks. A
+* midstate is only valid with the library build and CPU that produced it.
+*
+* @param ctx	Structure holding ctx job info
+* @param ms	Structure receiving the midstate
+* @returns 0 on success, -1 if ctx is busy, complete or has a partial block
+*/
+int sm3_ctx_midstate_save(const SM3_HASH_CTX * ctx, SM3_MIDSTATE * ms);
+
+/**
+* @brief Start a SM3 ctx from a saved midstate instead of the initial digest.
+*
+* ctx is left idle as if the prefix the midstate was taken after had just
+* been submitted to it. Continue the job with HASH_UPDATE or HASH_LAST, not
+* HASH_FIRST. Any number of contexts can be started from the same midstate.
+*
+* @param ctx	Structure holding ctx job info
+* @param ms	Midstate from sm3_ctx_midstate_save()
+* @returns 0 on success, -1 if ctx is being processed
+*/
+int sm3_ctx_midstate_restore(SM3_HASH_CTX * ctx, const SM3_MIDSTATE * ms);
+
+/******************** short messages **********************/
+
+/**
+* @brief  Hash a set of short messages of one fixed length with SM3 in one call.
+*
+* For keys and fingerprints of up to SM3_HASH_SHORT_MAX_LEN bytes, which
+* fit in one or two blocks once padded. The padding is laid out once per lane
+* and each message is hashed as whole blocks, bypassing the copy into
+* partial_block_buffer and the padding step of the ctx manager.
+*
+* @param  msgs Array of n pointers to messages of len bytes
+* @param  len Length of every message (in bytes), at most SM3_HASH_SHORT_MAX_LEN
+* @param  n Number of messages
+* @param  digests Array of n digests receiving the result of each message
+* @returns 0 on success, -1 on message too long or job error
+*/
+int sm3_mb_hash_short(const void *msgs[], uint32_t len, uint32_t n,
+		      uint8_t (*digests)[SM3_DIGEST_NWORDS * 4]);
+
+/******************** Merkle trees **********************/
+
+/**
+* @brief  Number of nodes in a SM3 Merkle tree of nleaves leaves.
+*
+* @param  nleaves Number of leaves
+* @returns Number of digests written by merkle_sm3_build()
+*/
+uint64_t merkle_sm3_tree_nodes(uint32_t nleaves);
+
+/**
+* @brief  Build a whole SM3 Merkle tree over a set of fixed size leaves.
+*
+* Leaves are hashed as 0x00 | leaf and interior nodes as 0x01 | left | right
+* as in RFC 6962, a node with no right sibling being promoted unchanged. The
+* hashes of each level are submitted to the multi-buffer manager as one batch.
+* The tree is stored level by level starting with the leaf hashes, so the
+* root is the last node. A tree of no leaves is the hash of the empty string.
+*
+* @param  leaves Buffer of nleaves leaves stored back to back
+* @param  nleaves Number of leaves
+* @param  leaf_size Size of each leaf (in bytes)
+* @param  tree Array of merkle_sm3_tree_nodes(nleaves) digests receiving the tree
+* @returns 0 on success, -1 on memory allocation failure or job error
+*/
+int merkle_sm3_build(const void *leaves, uint32_t nleaves, uint32_t leaf_size,
+		     uint8_t (*tree)[SM3_DIGEST_NWORDS * 4]);
+
+/**
+* @brief  Recompute the paths of changed leaves in a tree from merkle_sm3_build().
+*
+* The changed leaves, and then the changed nodes of each level, are hashed as
+* one batch per level. Nodes shared by several paths are hashed once.
+*
+* @param  tree Tree of nleaves leaves to update in place
+* @param  nleaves Number of leaves of the tree
+* @param  leaves Buffer of nleaves leaves holding the new contents
+* @param  leaf_size Size of each leaf (in bytes)
+* @param  idx Array of nidx indexes of changed leaves, in any order
+* @param  nidx Number of changed leaves
+* @returns 0 on success, -1 on index out of range, memory allocation failure or job error
+*/
+int merkle_sm3_update(uint8_t (*tree)[SM3_DIGEST_NWORDS * 4], uint32_t nleaves,
+		      const void *leaves, uint32_t leaf_size, const uint32_t idx[],
+		      uint32_t nidx);
+
+/**
+* @brief  Start a SM3 Merkle tree to be built by appending leaves.
+*
+* @param  state Structure holding the pending subtrees
+* @returns void
+*/
+void merkle_sm3_init(MERKLE_SM3_STATE *state);
+
+/**
+* @brief  Append leaves to a SM3 Merkle tree and fold them into its pending subtrees.
+*
+* Only the root of each pending perfect subtree is kept, so memory does not
+* grow with the tree. Leaves are hashed and paired up level by level in
+* batches of up to a thousand, and may be appended in any number of calls.
+*
+* @param  state Structure holding the pending subtrees
+* @param  leaves Buffer of nleaves leaves stored back to back
+* @param  nleaves Number of leaves to append
+* @param  leaf_size Size of each leaf (in bytes)
+* @returns 0 on success, -1 on memory allocation failure or job error
+*/
+int merkle_sm3_append(MERKLE_SM3_STATE *state, const void *leaves, uint32_t nleaves,
+		      uint32_t leaf_size);
+
+/**
+* @brief  Compute the root of the leaves appended so far to a SM3 Merkle tree.
+*
+* The state is left unchanged, more leaves can be appended afterwards.
+*
+* @param  state Structure holding the pending subtrees
+* @param  root Digest receiving the root, as merkle_sm3_build() would give
+* @returns 0 on success, -1 on job error
+*/
+int merkle_sm3_final(const MERKLE_SM3_STATE *state,
+		     uint8_t root[SM3_DIGEST_NWORDS * 4]);
+
+/**
+* @brief  Compute the root of a SM3 Merkle tree without storing the tree.
+*
+* Same as merkle_sm3_init(), merkle_sm3_append() and merkle_sm3_final().
+*
+* @param  leaves Buffer of nleaves leaves stored back to back
+* @param  nleaves Number of leaves
+* @param  leaf_size Size of each leaf (in bytes)
+* @param  root Digest receiving the root
+* @returns 0 on success, -1 on memory allocation failure or job error
+*/
+int merkle_sm3_root(const void *leaves, uint32_t nleaves, uint32_t leaf_size,
+		    uint8_t root[SM3_DIGEST_NWORDS * 4]);
+
 #ifdef __cplusplus
 }
 #endif
@@ -28,6 +28,7 @@
 **********************************************************************/
 #include <stdlib.h>
 #include "md5_mb.h"
+#include "md5_ctx_submit_64.h"
 #include "memcpy_inline.h"
 void md5_mb_mgr_init_sve(MD5_MB_JOB_MGR * state);
 MD5_JOB *md5_mb_mgr_submit_sve(MD5_MB_JOB_MGR * state, MD5_JOB * job);
@@ -75,6 +76,9 @@ MD5_HASH_CTX *md5_ctx_mgr_submit_sve(MD5_HASH_CTX_MGR * mgr, MD5_HASH_CTX * ctx,
 	// If we made it here, there were no errors during this call to submit
 	ctx->error = HASH_CTX_ERROR_NONE;
 
+	// Only md5_ctx_mgr_submit_64() leaves pieces pending, once this submit returns
+	ctx->pending_length = 0;
+
 	// Store buffer ptr info from user
 	ctx->incoming_buffer = buffer;
 	ctx->incoming_buffer_length = len;
@@ -198,6 +202,10 @@ static MD5_HASH_CTX *md5_ctx_mgr_resubmit(MD5_HASH_CTX_MGR * mgr, MD5_HASH_CTX *
 			continue;
 		}
 
+		// Take up the next piece of a md5_ctx_mgr_submit_64() job in place
+		if (md5_ctx_submit_64_next(ctx))
+			continue;
+
 		if (ctx)
 			ctx->status = HASH_CTX_STS_IDLE;
 		return ctx;
@@ -38,6 +38,7 @@
 #endif
 
 #include "md5_mb.h"
+#include "md5_ctx_submit_64.h"
 #include "memcpy_inline.h"
 
 #ifdef _MSC_VER
@@ -90,6 +91,9 @@ MD5_HASH_CTX *md5_ctx_mgr_submit_avx512(MD5_HASH_CTX_MGR * mgr, MD5_HASH_CTX * c
 	// If we made it here, there were no errors during this call to submit
 	ctx->error = HASH_CTX_ERROR_NONE;
 
+	// Only md5_ctx_mgr_submit_64() leaves pieces pending, once this submit returns
+	ctx->pending_length = 0;
+
 	// Store buffer ptr info from user
 	ctx->incoming_buffer = buffer;
 	ctx->incoming_buffer_length = len;
@@ -214,6 +218,10 @@ static MD5_HASH_CTX *md5_ctx_mgr_resubmit(MD5_HASH_CTX_MGR * mgr, MD5_HASH_CTX *
 			continue;
 		}
 
+		// Take up the next piece of a md5_ctx_mgr_submit_64() job in place
+		if (md5_ctx_submit_64_next(ctx))
+			continue;
+
 		if (ctx)
 			ctx->status = HASH_CTX_STS_IDLE;
 		return ctx;
@@ -91,6 +91,9 @@ MD5_HASH_CTX *md5_ctx_mgr_submit_base(MD5_HASH_CTX_MGR * mgr, MD5_HASH_CTX * ctx
 		return ctx;
 	}
 
+	// Every piece is hashed before this submit returns, so none is left pending
+	ctx->pending_length = 0;
+
 	if (flags == HASH_FIRST) {
 
 		md5_init(ctx, buffer, len);
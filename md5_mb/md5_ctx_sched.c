@@ -0,0 +1,117 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stddef.h>
+#include "md5_mb.h"
+
+static void md5_sched_enqueue(MD5_HASH_CTX_SCHED * sched, MD5_HASH_CTX * ctx,
+			      const void *buffer, uint32_t len, HASH_CTX_FLAG flags)
+{
+	MD5_SCHED_ENTRY *q = sched->queue;
+	uint32_t i = sched->queue_len++;
+
+	// Keep the queue sorted by ascending length, the longest job is at the tail
+	while (i > 0 && q[i - 1].len > len) {
+		q[i] = q[i - 1];
+		i--;
+	}
+
+	q[i].ctx = ctx;
+	q[i].buffer = buffer;
+	q[i].len = len;
+	q[i].flags = flags;
+	q[i].status = ctx->status;
+
+	// Held back jobs look like any other job in flight to the user
+	ctx->status = HASH_CTX_STS_PROCESSING;
+	ctx->error = HASH_CTX_ERROR_NONE;
+}
+
+static MD5_HASH_CTX *md5_sched_release(MD5_HASH_CTX_SCHED * sched)
+{
+	MD5_SCHED_ENTRY *e = &sched->queue[--sched->queue_len];
+
+	e->ctx->status = e->status;
+	return md5_ctx_mgr_submit(&sched->mgr, e->ctx, e->buffer, e->len, e->flags);
+}
+
+void md5_ctx_sched_init(MD5_HASH_CTX_SCHED * sched, uint32_t depth)
+{
+	md5_ctx_mgr_init(&sched->mgr);
+	sched->queue_len = 0;
+	sched->queue_depth = (depth > MD5_SCHED_QUEUE_MAX) ? MD5_SCHED_QUEUE_MAX : depth;
+}
+
+MD5_HASH_CTX *md5_ctx_sched_submit(MD5_HASH_CTX_SCHED * sched, MD5_HASH_CTX * ctx,
+				   const void *buffer, uint32_t len,
+				   HASH_CTX_FLAG flags)
+{
+	if (sched->queue_depth == 0)
+		return md5_ctx_mgr_submit(&sched->mgr, ctx, buffer, len, flags);
+
+	if (flags & (~HASH_ENTIRE)) {
+		// User should not pass anything other than FIRST, UPDATE, or LAST
+		ctx->error = HASH_CTX_ERROR_INVALID_FLAGS;
+		return ctx;
+	}
+
+	if (ctx->status & HASH_CTX_STS_PROCESSING) {
+		// Cannot submit to a currently processing or held back job.
+		ctx->error = HASH_CTX_ERROR_ALREADY_PROCESSING;
+		return ctx;
+	}
+
+	if ((ctx->status & HASH_CTX_STS_COMPLETE) && !(flags & HASH_FIRST)) {
+		// Cannot update a finished job.
+		ctx->error = HASH_CTX_ERROR_ALREADY_COMPLETED;
+		return ctx;
+	}
+
+	md5_sched_enqueue(sched, ctx, buffer, len, flags);
+
+	if (sched->queue_len < sched->queue_depth)
+		return NULL;
+
+	// Queue is full, hand the longest pending job to the lanes
+	return md5_sched_release(sched);
+}
+
+MD5_HASH_CTX *md5_ctx_sched_flush(MD5_HASH_CTX_SCHED * sched)
+{
+	MD5_HASH_CTX *ctx;
+
+	// Drain the held back jobs longest first before flushing the lanes
+	while (sched->queue_len) {
+		ctx = md5_sched_release(sched);
+		if (ctx)
+			return ctx;
+	}
+
+	return md5_ctx_mgr_flush(&sched->mgr);
+}
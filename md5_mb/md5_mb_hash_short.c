@@ -0,0 +1,105 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <string.h>
+#include "md5_mb_pool.h"
+#include "endian_helper.h"
+
+/*
+ * Messages of one fixed length all share the same padding, so it is laid out
+ * once at the tail of a block buffer per lane and only the message bytes are
+ * copied in front of it. The manager then takes the one or two whole blocks
+ * straight into a lane, skipping partial_block_buffer and hash_pad().
+ */
+struct md5_short_batch {
+	const void **msgs;
+	uint32_t len;
+	uint32_t nbytes;
+	uint8_t(*blocks)[2 * MD5_BLOCK_SIZE];
+	uint8_t(*digests)[MD5_DIGEST_NWORDS * 4];
+};
+
+// A ctx owns the block buffer of its lane while it is in the manager
+static MD5_HASH_CTX *md5_short_start(MD5_HASH_CTX_MGR * mgr, MD5_HASH_CTX * ctx,
+				     uint32_t i, uint32_t lane, void *arg)
+{
+	struct md5_short_batch *batch = arg;
+
+	ctx->user_data = batch->digests[i];
+	memcpy(batch->blocks[lane], batch->msgs[i], batch->len);
+
+	return md5_ctx_mgr_submit(mgr, ctx, batch->blocks[lane], batch->nbytes, HASH_FIRST);
+}
+
+// The message went in whole, so a ctx handed back is always done
+static int md5_short_next(MD5_HASH_CTX_MGR * mgr, MD5_HASH_CTX ** ctx, void *arg)
+{
+	uint8_t *digest = (*ctx)->user_data;
+	uint32_t j, w;
+
+	for (j = 0; j < MD5_DIGEST_NWORDS; j++) {
+		w = to_le32((*ctx)->job.result_digest[j]);
+		memcpy(&digest[4 * j], &w, sizeof(w));
+	}
+
+	return 0;
+}
+
+int md5_mb_hash_short(const void *msgs[], uint32_t len, uint32_t n,
+		      uint8_t(*digests)[MD5_DIGEST_NWORDS * 4])
+{
+	DECLARE_ALIGNED(uint8_t blocks[MD5_MAX_LANES][2 * MD5_BLOCK_SIZE], 16);
+	struct md5_short_batch batch;
+	uint32_t i, nbytes;
+	uint64_t bits;
+
+	if (len > MD5_HASH_SHORT_MAX_LEN)
+		return -1;
+
+	if (n == 0)
+		return 0;
+
+	nbytes = (len + 1 + MD5_PADLENGTHFIELD_SIZE > MD5_BLOCK_SIZE) ?
+	    2 * MD5_BLOCK_SIZE : MD5_BLOCK_SIZE;
+	bits = to_le64((uint64_t) len << 3);
+
+	memset(blocks, 0, sizeof(blocks));
+	for (i = 0; i < MD5_MAX_LANES; i++) {
+		blocks[i][len] = 0x80;
+		memcpy(&blocks[i][nbytes - sizeof(bits)], &bits, sizeof(bits));
+	}
+
+	batch.msgs = msgs;
+	batch.len = len;
+	batch.nbytes = nbytes;
+	batch.blocks = blocks;
+	batch.digests = digests;
+
+	return md5_mb_pool_run(n, md5_short_start, md5_short_next, &batch);
+}
@@ -0,0 +1,92 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "md5_mb.h"
+
+#define TEST_BUFS 100
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+
+static uint8_t bufs[TEST_BUFS][MD5_HASH_SHORT_MAX_LEN];
+static uint8_t digests[TEST_BUFS][MD5_DIGEST_NWORDS * 4];
+static uint8_t digests_ref[TEST_BUFS][MD5_DIGEST_NWORDS * 4];
+
+int main(void)
+{
+	const void *buf_ptrs[TEST_BUFS];
+	uint64_t lens[TEST_BUFS];
+	uint32_t i, j, len, jobs;
+
+	printf("md5_mb_hash_short test, lengths 0 to %d: ", MD5_HASH_SHORT_MAX_LEN);
+
+	srand(TEST_SEED);
+
+	for (i = 0; i < TEST_BUFS; i++)
+		buf_ptrs[i] = bufs[i];
+
+	// Every length of one and two blocks, checked against the ctx manager path
+	for (len = 0; len <= MD5_HASH_SHORT_MAX_LEN; len++) {
+		jobs = rand() % TEST_BUFS + 1;
+
+		for (i = 0; i < jobs; i++) {
+			for (j = 0; j < len; j++)
+				bufs[i][j] = rand();
+			lens[i] = len;
+		}
+
+		if (md5_mb_hash_short(buf_ptrs, len, jobs, digests) != 0 ||
+		    md5_mb_hash_many(buf_ptrs, lens, jobs, digests_ref) != 0) {
+			printf("Hash returned an error, len %d\n", len);
+			return 1;
+		}
+
+		if (memcmp(digests, digests_ref, jobs * sizeof(digests[0]))) {
+			printf("Test failed, len %d\n", len);
+			return 1;
+		}
+
+		if (len % 8 == 0) {
+			putchar('.');
+			fflush(0);
+		}
+	}
+
+	if (md5_mb_hash_short(buf_ptrs, MD5_HASH_SHORT_MAX_LEN + 1, 1, digests) == 0) {
+		printf("Overlong message not rejected\n");
+		return 1;
+	}
+
+	printf(" Pass\n");
+
+	return 0;
+}
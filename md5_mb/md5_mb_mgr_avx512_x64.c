@@ -0,0 +1,137 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stddef.h>
+#include <assert.h>
+#include "md5_mb.h"
+
+#ifdef HAVE_AS_KNOWS_AVX512
+
+void md5_mb_mgr_init_avx512_x64(MD5_MB_JOB_MGR_X64 * state, uint32_t num_lanes)
+{
+	unsigned int i;
+
+	// Whole groups of 16 lanes only, up to four of them
+	num_lanes = (num_lanes + MD5_X16_LANES - 1) & ~(MD5_X16_LANES - 1);
+	if (num_lanes < MD5_X16_LANES)
+		num_lanes = MD5_X16_LANES;
+	if (num_lanes > MD5_X64_MAX_LANES)
+		num_lanes = MD5_X64_MAX_LANES;
+
+	state->num_lanes = num_lanes;
+	state->num_lanes_inuse = 0;
+	for (i = 0; i < MD5_X64_MAX_LANES; i++) {
+		state->lens[i] = 0;
+		state->ldata[i].job_in_lane = NULL;
+	}
+}
+
+static void md5_mb_mgr_do_jobs(MD5_MB_JOB_MGR_X64 * state)
+{
+	MD5_JOB *jobs[MD5_X64_MAX_LANES];
+	uint64_t len = UINT64_MAX;
+	uint32_t i, num_groups = 0;
+
+	// Run every lane in use for as many blocks as the shortest job has left
+	for (i = 0; i < state->num_lanes; i++) {
+		jobs[i] = state->ldata[i].job_in_lane;
+		if (jobs[i] == NULL)
+			continue;
+		if (state->lens[i] < len)
+			len = state->lens[i];
+		num_groups = i / MD5_X16_LANES + 1;
+	}
+	if (len == UINT64_MAX || len == 0)
+		return;
+
+	// Groups past the last busy lane are left out while flushing
+	md5_mb_x16x4_avx512(jobs, len, num_groups);
+
+	for (i = 0; i < state->num_lanes; i++) {
+		if (jobs[i] == NULL)
+			continue;
+		state->lens[i] -= len;
+		jobs[i]->len -= len;
+		jobs[i]->buffer += len << MD5_LOG2_BLOCK_SIZE;
+	}
+}
+
+static MD5_JOB *md5_mb_mgr_free_lane(MD5_MB_JOB_MGR_X64 * state)
+{
+	MD5_JOB *ret;
+	uint32_t i;
+
+	for (i = 0; i < state->num_lanes; i++) {
+		ret = state->ldata[i].job_in_lane;
+		if (ret != NULL && state->lens[i] == 0) {
+			state->num_lanes_inuse--;
+			state->ldata[i].job_in_lane = NULL;
+			ret->status = STS_COMPLETED;
+			return ret;
+		}
+	}
+	return NULL;
+}
+
+MD5_JOB *md5_mb_mgr_submit_avx512_x64(MD5_MB_JOB_MGR_X64 * state, MD5_JOB * job)
+{
+	uint32_t lane_idx;
+
+	// Too many lanes for a nibble list of free lanes, take the first empty one
+	for (lane_idx = 0; lane_idx < state->num_lanes; lane_idx++)
+		if (state->ldata[lane_idx].job_in_lane == NULL)
+			break;
+	//fatal error
+	assert(lane_idx < state->num_lanes);
+	state->lens[lane_idx] = job->len;
+	state->ldata[lane_idx].job_in_lane = job;
+	state->num_lanes_inuse++;
+	job->status = STS_BEING_PROCESSED;
+
+	//submit will wait all lane has data
+	if (state->num_lanes_inuse < state->num_lanes)
+		return NULL;
+
+	md5_mb_mgr_do_jobs(state);
+	return md5_mb_mgr_free_lane(state);
+}
+
+MD5_JOB *md5_mb_mgr_flush_avx512_x64(MD5_MB_JOB_MGR_X64 * state)
+{
+	MD5_JOB *ret;
+
+	ret = md5_mb_mgr_free_lane(state);
+	if (ret)
+		return ret;
+
+	md5_mb_mgr_do_jobs(state);
+	return md5_mb_mgr_free_lane(state);
+}
+
+#endif // HAVE_AS_KNOWS_AVX512
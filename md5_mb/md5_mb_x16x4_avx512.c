@@ -0,0 +1,273 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#if defined(__clang__)
+# pragma clang attribute push (__attribute__((target("avx512f"))), apply_to=function)
+#elif defined(__ICC)
+# pragma intel optimization_parameter target_arch=CORE-AVX512
+#elif defined(__ICL)
+# pragma [intel] optimization_parameter target_arch=CORE-AVX512
+#elif (__GNUC__ >= 5)
+# pragma GCC target("avx512f")
+#endif
+
+#include <immintrin.h>
+#include "md5_mb.h"
+
+#ifdef HAVE_AS_KNOWS_AVX512
+
+typedef __m512i VEC;
+
+#define LOAD(p)		_mm512_load_si512(p)
+#define LOADU(p)	_mm512_loadu_si512(p)
+#define STORE(p, a)	_mm512_store_si512(p, a)
+#define SET1(x)		_mm512_set1_epi32(x)
+#define ADD(a, b)	_mm512_add_epi32(a, b)
+#define ROL(a, n)	_mm512_rol_epi32(a, n)
+#define TERNLOG(a, b, c, imm)	_mm512_ternarylogic_epi32(a, b, c, imm)
+
+// Round functions as vpternlogd truth tables of (b, c, d)
+#define MD5_F	0xca		// (b & c) | (~b & d)
+#define MD5_G	0xe4		// (b & d) | (c & ~d)
+#define MD5_H	0x96		// b ^ c ^ d
+#define MD5_I	0x39		// c ^ (b | ~d)
+
+static const uint8_t md5_zero_block[MD5_BLOCK_SIZE];
+
+// Transpose the next block of 16 lanes into one message word per vector
+static inline void md5_load_x16(VEC m[16], const uint8_t * p[MD5_X16_LANES])
+{
+	VEC r[16], t[16];
+	int i;
+
+	for (i = 0; i < 16; i++)
+		r[i] = LOADU(p[i]);
+
+	// 4x4 transpose within each 128-bit lane
+	for (i = 0; i < 16; i += 2) {
+		t[i] = _mm512_unpacklo_epi32(r[i], r[i + 1]);
+		t[i + 1] = _mm512_unpackhi_epi32(r[i], r[i + 1]);
+	}
+	for (i = 0; i < 16; i += 4) {
+		r[i] = _mm512_unpacklo_epi64(t[i], t[i + 2]);
+		r[i + 1] = _mm512_unpackhi_epi64(t[i], t[i + 2]);
+		r[i + 2] = _mm512_unpacklo_epi64(t[i + 1], t[i + 3]);
+		r[i + 3] = _mm512_unpackhi_epi64(t[i + 1], t[i + 3]);
+	}
+
+	// Then a 4x4 transpose of the 128-bit lanes
+	for (i = 0; i < 4; i++) {
+		t[i] = _mm512_shuffle_i32x4(r[i], r[i + 4], 0x88);
+		t[i + 4] = _mm512_shuffle_i32x4(r[i], r[i + 4], 0xdd);
+		t[i + 8] = _mm512_shuffle_i32x4(r[i + 8], r[i + 12], 0x88);
+		t[i + 12] = _mm512_shuffle_i32x4(r[i + 8], r[i + 12], 0xdd);
+	}
+	for (i = 0; i < 4; i++) {
+		m[i] = _mm512_shuffle_i32x4(t[i], t[i + 8], 0x88);
+		m[i + 8] = _mm512_shuffle_i32x4(t[i], t[i + 8], 0xdd);
+		m[i + 4] = _mm512_shuffle_i32x4(t[i + 4], t[i + 12], 0x88);
+		m[i + 12] = _mm512_shuffle_i32x4(t[i + 4], t[i + 12], 0xdd);
+	}
+}
+
+#define STEP1(f, a, b, c, d, x, s, k) \
+	a = ADD(b, ROL(ADD(ADD(a, TERNLOG(b, c, d, f)), ADD(x, SET1(k))), s))
+
+// Same step on every group, the groups are independent and interleave
+#define STEP(f, a, b, c, d, x, s, k) \
+	do { \
+		STEP1(f, a[0], b[0], c[0], d[0], m[0][x], s, k); \
+		if (ng > 1) \
+			STEP1(f, a[1], b[1], c[1], d[1], m[1][x], s, k); \
+		if (ng > 2) \
+			STEP1(f, a[2], b[2], c[2], d[2], m[2][x], s, k); \
+		if (ng > 3) \
+			STEP1(f, a[3], b[3], c[3], d[3], m[3][x], s, k); \
+	} while (0)
+
+// ng is a constant in each caller so the unused groups compile away, which
+// needs the body inlined into every case of md5_mb_x16x4_avx512()
+#ifdef __GNUC__
+# define MD5_FORCE_INLINE static inline __attribute__((always_inline))
+#else
+# define MD5_FORCE_INLINE static __forceinline
+#endif
+
+MD5_FORCE_INLINE void md5_mb_x16xn_avx512(MD5_JOB ** jobs, uint64_t len, const int ng)
+{
+	DECLARE_ALIGNED(MD5_WORD_T words[MD5_DIGEST_NWORDS][MD5_X16_LANES], 64);
+	VEC a[4], b[4], c[4], d[4], aa[4], bb[4], cc[4], dd[4], m[4][16];
+	const uint8_t *p[MD5_X64_MAX_LANES];
+	uint64_t blk;
+	int g, i, w;
+
+	// Gather the digests, an empty lane runs on a zero block
+	for (g = 0; g < ng; g++) {
+		for (i = 0; i < MD5_X16_LANES; i++) {
+			MD5_JOB *job = jobs[g * MD5_X16_LANES + i];
+
+			p[g * MD5_X16_LANES + i] = job ? job->buffer : md5_zero_block;
+			for (w = 0; w < MD5_DIGEST_NWORDS; w++)
+				words[w][i] = job ? job->result_digest[w] : 0;
+		}
+		a[g] = LOAD(words[0]);
+		b[g] = LOAD(words[1]);
+		c[g] = LOAD(words[2]);
+		d[g] = LOAD(words[3]);
+	}
+
+	for (blk = 0; blk < len; blk++) {
+		for (g = 0; g < ng; g++) {
+			md5_load_x16(m[g], &p[g * MD5_X16_LANES]);
+			aa[g] = a[g];
+			bb[g] = b[g];
+			cc[g] = c[g];
+			dd[g] = d[g];
+		}
+
+		STEP(MD5_F, a, b, c, d, 0, 7, 0xd76aa478);
+		STEP(MD5_F, d, a, b, c, 1, 12, 0xe8c7b756);
+		STEP(MD5_F, c, d, a, b, 2, 17, 0x242070db);
+		STEP(MD5_F, b, c, d, a, 3, 22, 0xc1bdceee);
+		STEP(MD5_F, a, b, c, d, 4, 7, 0xf57c0faf);
+		STEP(MD5_F, d, a, b, c, 5, 12, 0x4787c62a);
+		STEP(MD5_F, c, d, a, b, 6, 17, 0xa8304613);
+		STEP(MD5_F, b, c, d, a, 7, 22, 0xfd469501);
+		STEP(MD5_F, a, b, c, d, 8, 7, 0x698098d8);
+		STEP(MD5_F, d, a, b, c, 9, 12, 0x8b44f7af);
+		STEP(MD5_F, c, d, a, b, 10, 17, 0xffff5bb1);
+		STEP(MD5_F, b, c, d, a, 11, 22, 0x895cd7be);
+		STEP(MD5_F, a, b, c, d, 12, 7, 0x6b901122);
+		STEP(MD5_F, d, a, b, c, 13, 12, 0xfd987193);
+		STEP(MD5_F, c, d, a, b, 14, 17, 0xa679438e);
+		STEP(MD5_F, b, c, d, a, 15, 22, 0x49b40821);
+
+		STEP(MD5_G, a, b, c, d, 1, 5, 0xf61e2562);
+		STEP(MD5_G, d, a, b, c, 6, 9, 0xc040b340);
+		STEP(MD5_G, c, d, a, b, 11, 14, 0x265e5a51);
+		STEP(MD5_G, b, c, d, a, 0, 20, 0xe9b6c7aa);
+		STEP(MD5_G, a, b, c, d, 5, 5, 0xd62f105d);
+		STEP(MD5_G, d, a, b, c, 10, 9, 0x02441453);
+		STEP(MD5_G, c, d, a, b, 15, 14, 0xd8a1e681);
+		STEP(MD5_G, b, c, d, a, 4, 20, 0xe7d3fbc8);
+		STEP(MD5_G, a, b, c, d, 9, 5, 0x21e1cde6);
+		STEP(MD5_G, d, a, b, c, 14, 9, 0xc33707d6);
+		STEP(MD5_G, c, d, a, b, 3, 14, 0xf4d50d87);
+		STEP(MD5_G, b, c, d, a, 8, 20, 0x455a14ed);
+		STEP(MD5_G, a, b, c, d, 13, 5, 0xa9e3e905);
+		STEP(MD5_G, d, a, b, c, 2, 9, 0xfcefa3f8);
+		STEP(MD5_G, c, d, a, b, 7, 14, 0x676f02d9);
+		STEP(MD5_G, b, c, d, a, 12, 20, 0x8d2a4c8a);
+
+		STEP(MD5_H, a, b, c, d, 5, 4, 0xfffa3942);
+		STEP(MD5_H, d, a, b, c, 8, 11, 0x8771f681);
+		STEP(MD5_H, c, d, a, b, 11, 16, 0x6d9d6122);
+		STEP(MD5_H, b, c, d, a, 14, 23, 0xfde5380c);
+		STEP(MD5_H, a, b, c, d, 1, 4, 0xa4beea44);
+		STEP(MD5_H, d, a, b, c, 4, 11, 0x4bdecfa9);
+		STEP(MD5_H, c, d, a, b, 7, 16, 0xf6bb4b60);
+		STEP(MD5_H, b, c, d, a, 10, 23, 0xbebfbc70);
+		STEP(MD5_H, a, b, c, d, 13, 4, 0x289b7ec6);
+		STEP(MD5_H, d, a, b, c, 0, 11, 0xeaa127fa);
+		STEP(MD5_H, c, d, a, b, 3, 16, 0xd4ef3085);
+		STEP(MD5_H, b, c, d, a, 6, 23, 0x04881d05);
+		STEP(MD5_H, a, b, c, d, 9, 4, 0xd9d4d039);
+		STEP(MD5_H, d, a, b, c, 12, 11, 0xe6db99e5);
+		STEP(MD5_H, c, d, a, b, 15, 16, 0x1fa27cf8);
+		STEP(MD5_H, b, c, d, a, 2, 23, 0xc4ac5665);
+
+		STEP(MD5_I, a, b, c, d, 0, 6, 0xf4292244);
+		STEP(MD5_I, d, a, b, c, 7, 10, 0x432aff97);
+		STEP(MD5_I, c, d, a, b, 14, 15, 0xab9423a7);
+		STEP(MD5_I, b, c, d, a, 5, 21, 0xfc93a039);
+		STEP(MD5_I, a, b, c, d, 12, 6, 0x655b59c3);
+		STEP(MD5_I, d, a, b, c, 3, 10, 0x8f0ccc92);
+		STEP(MD5_I, c, d, a, b, 10, 15, 0xffeff47d);
+		STEP(MD5_I, b, c, d, a, 1, 21, 0x85845dd1);
+		STEP(MD5_I, a, b, c, d, 8, 6, 0x6fa87e4f);
+		STEP(MD5_I, d, a, b, c, 15, 10, 0xfe2ce6e0);
+		STEP(MD5_I, c, d, a, b, 6, 15, 0xa3014314);
+		STEP(MD5_I, b, c, d, a, 13, 21, 0x4e0811a1);
+		STEP(MD5_I, a, b, c, d, 4, 6, 0xf7537e82);
+		STEP(MD5_I, d, a, b, c, 11, 10, 0xbd3af235);
+		STEP(MD5_I, c, d, a, b, 2, 15, 0x2ad7d2bb);
+		STEP(MD5_I, b, c, d, a, 9, 21, 0xeb86d391);
+
+		for (g = 0; g < ng; g++) {
+			a[g] = ADD(a[g], aa[g]);
+			b[g] = ADD(b[g], bb[g]);
+			c[g] = ADD(c[g], cc[g]);
+			d[g] = ADD(d[g], dd[g]);
+		}
+		for (i = 0; i < ng * MD5_X16_LANES; i++)
+			if (p[i] != md5_zero_block)
+				p[i] += MD5_BLOCK_SIZE;
+	}
+
+	// Scatter the digests back to the jobs
+	for (g = 0; g < ng; g++) {
+		STORE(words[0], a[g]);
+		STORE(words[1], b[g]);
+		STORE(words[2], c[g]);
+		STORE(words[3], d[g]);
+		for (i = 0; i < MD5_X16_LANES; i++) {
+			MD5_JOB *job = jobs[g * MD5_X16_LANES + i];
+
+			if (job == NULL)
+				continue;
+			for (w = 0; w < MD5_DIGEST_NWORDS; w++)
+				job->result_digest[w] = words[w][i];
+		}
+	}
+}
+
+// Four groups of 16 lanes, each group the width of one zmm register
+void md5_mb_x16x4_avx512(MD5_JOB * jobs[MD5_X64_MAX_LANES], uint64_t len, uint32_t num_groups)
+{
+	switch (num_groups) {
+	case 1:
+		md5_mb_x16xn_avx512(jobs, len, 1);
+		break;
+	case 2:
+		md5_mb_x16xn_avx512(jobs, len, 2);
+		break;
+	case 3:
+		md5_mb_x16xn_avx512(jobs, len, 3);
+		break;
+	default:
+		md5_mb_x16xn_avx512(jobs, len, 4);
+		break;
+	}
+}
+
+#endif // HAVE_AS_KNOWS_AVX512
+
+#if defined(__clang__)
+# pragma clang attribute pop
+#endif
@@ -0,0 +1,304 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "md5_mb.h"
+#include "isal_crypto_dispatch.h"
+
+// Tests the experimental 64-lane manager with 16, 32, 48 and 64 lanes.
+// It is called directly as it is not dispatched.
+
+#define TEST_LEN  (8*1024)
+#define TEST_BUFS 160
+#define NUM_JOBS  400
+#ifndef RANDOMS
+# define RANDOMS  8
+#endif
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+
+#define MAX_UPDATE_LEN	(4 * MD5_BLOCK_SIZE + 17)
+
+#if (!defined(NOARCH)) && defined(HAVE_AS_KNOWS_AVX512) && (defined(__i386__) \
+	|| defined(__x86_64__) || defined( _M_X64) || defined(_M_IX86))
+# define HAVE_MD5_X64
+#endif
+
+#ifdef HAVE_MD5_X64
+typedef uint32_t DigestMD5[MD5_DIGEST_NWORDS];
+
+#define MSGS 13
+
+static uint8_t msg1[] = "Test vector from febooti.com";
+static uint8_t msg2[] = "12345678901234567890" "12345678901234567890"
+    "12345678901234567890" "12345678901234567890";
+static uint8_t msg3[] = "";
+static uint8_t msg4[] = "abcdefghijklmnopqrstuvwxyz";
+static uint8_t msg5[] = "message digest";
+static uint8_t msg6[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ" "abcdefghijklmnopqrstuvwxyz0123456789";
+static uint8_t msg7[] = "abc";
+static uint8_t msg8[] = "a";
+
+static uint8_t msg9[] = "";
+static uint8_t msgA[] = "abcdefghijklmnopqrstuvwxyz";
+static uint8_t msgB[] = "message digest";
+static uint8_t msgC[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ" "abcdefghijklmnopqrstuvwxyz0123456789";
+static uint8_t msgD[] = "abc";
+
+static DigestMD5 expResultDigest1 = { 0x61b60a50, 0xfbb76d3c, 0xf5620cd3, 0x0f3d57ff };
+static DigestMD5 expResultDigest2 = { 0xa2f4ed57, 0x55c9e32b, 0x2eda49ac, 0x7ab60721 };
+static DigestMD5 expResultDigest3 = { 0xd98c1dd4, 0x04b2008f, 0x980980e9, 0x7e42f8ec };
+static DigestMD5 expResultDigest4 = { 0xd7d3fcc3, 0x00e49261, 0x6c49fb7d, 0x3be167ca };
+static DigestMD5 expResultDigest5 = { 0x7d696bf9, 0x8d93b77c, 0x312f5a52, 0xd061f1aa };
+static DigestMD5 expResultDigest6 = { 0x98ab74d1, 0xf5d977d2, 0x2c1c61a5, 0x9f9d419f };
+static DigestMD5 expResultDigest7 = { 0x98500190, 0xb04fd23c, 0x7d3f96d6, 0x727fe128 };
+static DigestMD5 expResultDigest8 = { 0xb975c10c, 0xa8b6f1c0, 0xe299c331, 0x61267769 };
+
+static DigestMD5 expResultDigest9 = { 0xd98c1dd4, 0x04b2008f, 0x980980e9, 0x7e42f8ec };
+static DigestMD5 expResultDigestA = { 0xd7d3fcc3, 0x00e49261, 0x6c49fb7d, 0x3be167ca };
+static DigestMD5 expResultDigestB = { 0x7d696bf9, 0x8d93b77c, 0x312f5a52, 0xd061f1aa };
+static DigestMD5 expResultDigestC = { 0x98ab74d1, 0xf5d977d2, 0x2c1c61a5, 0x9f9d419f };
+static DigestMD5 expResultDigestD = { 0x98500190, 0xb04fd23c, 0x7d3f96d6, 0x727fe128 };
+
+static uint8_t *msgs[MSGS] = { msg1, msg2, msg3, msg4, msg5, msg6, msg7, msg8, msg9,
+	msgA, msgB, msgC, msgD
+};
+
+static uint32_t *expResultDigest[MSGS] = {
+	expResultDigest1, expResultDigest2, expResultDigest3,
+	expResultDigest4, expResultDigest5, expResultDigest6,
+	expResultDigest7, expResultDigest8, expResultDigest9,
+	expResultDigestA, expResultDigestB, expResultDigestC,
+	expResultDigestD
+};
+
+/* Reference digest and ctx pool global to reduce stack usage */
+static uint32_t digest_ref[TEST_BUFS][MD5_DIGEST_NWORDS];
+static MD5_HASH_CTX ctxpool[NUM_JOBS];
+
+extern void md5_ref(uint8_t * input_data, uint32_t * digest, uint32_t len);
+
+// Generates pseudo-random data
+static void rand_buffer(unsigned char *buf, const long buffer_size)
+{
+	long i;
+	for (i = 0; i < buffer_size; i++)
+		buf[i] = rand();
+}
+
+static int check_digest(uint32_t job, const uint32_t * digest, const uint32_t * good)
+{
+	uint32_t j;
+
+	for (j = 0; j < MD5_DIGEST_NWORDS; j++) {
+		if (digest[j] != good[j]) {
+			printf("\nTest %d, digest %d is %08X, should be %08X\n",
+			       job, j, digest[j], good[j]);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+// Known answers, enough jobs in flight to fill the lanes several times
+static int kat_test(MD5_HASH_CTX_MGR_X64 * mgr, uint32_t num_lanes)
+{
+	MD5_HASH_CTX *ctx;
+	uint32_t i, returned = 0;
+
+	md5_ctx_mgr_init_avx512_x64(mgr, num_lanes);
+
+	for (i = 0; i < NUM_JOBS; i++) {
+		hash_ctx_init(&ctxpool[i]);
+		ctx = md5_ctx_mgr_submit_avx512_x64(mgr, &ctxpool[i], msgs[i % MSGS],
+						    strlen((char *)msgs[i % MSGS]), HASH_ENTIRE);
+		if (ctx && ctx->error) {
+			printf("\nsubmit error %d\n", ctx->error);
+			return -1;
+		}
+		if (ctx)
+			returned++;
+	}
+
+	while ((ctx = md5_ctx_mgr_flush_avx512_x64(mgr)) != NULL) {
+		if (ctx->error) {
+			printf("\nflush error %d\n", ctx->error);
+			return -1;
+		}
+		returned++;
+	}
+
+	if (returned != NUM_JOBS) {
+		printf("\n%d of %d jobs returned\n", returned, NUM_JOBS);
+		return -1;
+	}
+
+	for (i = 0; i < NUM_JOBS; i++)
+		if (check_digest(i, ctxpool[i].job.result_digest, expResultDigest[i % MSGS]))
+			return -1;
+
+	return 0;
+}
+
+// Random length jobs fed in random size updates, several of them in flight
+static int rand_update_test(MD5_HASH_CTX_MGR_X64 * mgr, uint32_t num_lanes,
+			    unsigned char **bufs)
+{
+	MD5_HASH_CTX *ctx;
+	uint32_t lens[TEST_BUFS], done[TEST_BUFS], last[TEST_BUFS];
+	uint32_t i, t, jobs, len, pending, submitted;
+	HASH_CTX_FLAG flags;
+
+	for (t = 0; t < RANDOMS; t++) {
+		jobs = rand() % TEST_BUFS + 1;
+
+		for (i = 0; i < jobs; i++) {
+			lens[i] = rand() % TEST_LEN;
+			rand_buffer(bufs[i], lens[i]);
+			md5_ref(bufs[i], digest_ref[i], lens[i]);
+			hash_ctx_init(&ctxpool[i]);
+			done[i] = 0;
+			last[i] = 0;
+		}
+
+		md5_ctx_mgr_init_avx512_x64(mgr, num_lanes);
+
+		for (;;) {
+			pending = 0;
+			submitted = 0;
+			for (i = 0; i < jobs; i++) {
+				if (last[i])
+					continue;
+				pending++;
+				if (hash_ctx_processing(&ctxpool[i]))
+					continue;
+
+				len = rand() % MAX_UPDATE_LEN;
+				flags = (done[i] == 0) ? HASH_FIRST : HASH_UPDATE;
+				if (lens[i] - done[i] <= len) {
+					len = lens[i] - done[i];
+					flags |= HASH_LAST;
+					last[i] = 1;
+				}
+
+				ctx = md5_ctx_mgr_submit_avx512_x64(mgr, &ctxpool[i],
+								    bufs[i] + done[i], len, flags);
+				if (ctx && ctx->error) {
+					printf("\nsubmit error %d\n", ctx->error);
+					return -1;
+				}
+				done[i] += len;
+				submitted++;
+			}
+			if (pending == 0)
+				break;
+
+			// Leave jobs in the lanes between rounds now and then
+			if (submitted == 0 || (rand() & 1))
+				while (md5_ctx_mgr_flush_avx512_x64(mgr) != NULL) ;
+		}
+
+		while (md5_ctx_mgr_flush_avx512_x64(mgr) != NULL) ;
+
+		for (i = 0; i < jobs; i++) {
+			if (!hash_ctx_complete(&ctxpool[i])) {
+				printf("\nTest %d not complete\n", i);
+				return -1;
+			}
+			if (check_digest(i, ctxpool[i].job.result_digest, digest_ref[i]))
+				return -1;
+		}
+		putchar('.');
+		fflush(0);
+	}
+
+	return 0;
+}
+#endif
+
+int main(void)
+{
+#ifdef HAVE_MD5_X64
+	struct isal_crypto_dispatch_info info;
+	MD5_HASH_CTX_MGR_X64 *mgr = NULL;
+	unsigned char *bufs[TEST_BUFS];
+	static const uint32_t lanes[] = { 16, 32, 48, MD5_X64_MAX_LANES };
+	uint32_t l;
+	int i, ret;
+#endif
+
+	printf("md5_mb_x64 test:");
+
+#ifdef HAVE_MD5_X64
+	if (isal_crypto_dispatch_info(&info, NULL, 0) < 0) {
+		printf(" isal_crypto_dispatch_info failed\n");
+		return 1;
+	}
+	if (!(info.cpu_features & ISAL_CPU_X86_AVX512)) {
+		printf(" no AVX512VL, skipped\n");
+		return 0;
+	}
+
+	ret = posix_memalign((void *)&mgr, 64, sizeof(MD5_HASH_CTX_MGR_X64));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	for (i = 0; i < TEST_BUFS; i++) {
+		bufs[i] = (unsigned char *)malloc(TEST_LEN);
+		if (bufs[i] == NULL) {
+			printf("malloc failed test aborted\n");
+			return 1;
+		}
+	}
+
+	srand(TEST_SEED);
+
+	for (l = 0; l < sizeof(lanes) / sizeof(lanes[0]); l++) {
+		printf(" %d", lanes[l]);
+		if (kat_test(mgr, lanes[l]) || rand_update_test(mgr, lanes[l], bufs)) {
+			printf("Test failed function check\n");
+			return 1;
+		}
+	}
+
+	for (i = 0; i < TEST_BUFS; i++)
+		free(bufs[i]);
+	free(mgr);
+#else
+	printf(" not built");
+#endif
+
+	printf(" Pass\n");
+	return 0;
+}
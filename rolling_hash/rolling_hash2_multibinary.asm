@@ -28,6 +28,7 @@
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 
 %include "reg_sizes.asm"
+%include "multibinary.asm"
 
 %ifidn __OUTPUT_FORMAT__, elf32
 
@@ -54,9 +55,17 @@ extern rolling_hash2_run_until_base
 section .data
 ;;; *_mbinit are initial values for *_dispatched; is updated on first call.
 ;;; Therefore, *_dispatch_init is only executed on first call.
+;;; Same layout as the *_dispatch_info made by mbin_interface.
 
+align 8
+mk_global rolling_hash2_run_until_dispatch_info, data, hidden
+rolling_hash2_run_until_dispatch_info:
 rolling_hash2_run_until_dispatched:
 	def_wrd      rolling_hash2_run_until_mbinit
+	def_wrd      rolling_hash2_run_until_mbinit
+	def_wrd      rolling_hash2_run_until_dispatch_init
+	def_wrd      0
+	dd           -1, 0
 
 section .text
 
@@ -72,9 +81,15 @@ rolling_hash2_run_until:
 	jmp	wrd_sz [rolling_hash2_run_until_dispatched]
 
 rolling_hash2_run_until_dispatch_init:
+	endbranch
 	push    arg1
 %ifidn __OUTPUT_FORMAT__, elf32		;; 32-bit check
+	push    eax
+	push    ebx
 	lea     arg1, [rolling_hash2_run_until_base]
+	mbin_dispatch_record rolling_hash2_run_until, rolling_hash2_run_until_base
+	pop     ebx
+	pop     eax
 %else
 	push    rax
 	push    rbx
@@ -82,6 +97,7 @@ rolling_hash2_run_until_dispatch_init:
 	push    rdx
 	lea     arg1, [rolling_hash2_run_until_base WRT_OPT] ; Default
 
+	mbin_isa_cap ISAL_ISA_SSE, _done_rolling_hash2_run_until_data_init
 	mov     eax, 1
 	cpuid
 	lea     rbx, [rolling_hash2_run_until_00 WRT_OPT]
@@ -95,6 +111,7 @@ rolling_hash2_run_until_dispatch_init:
 	jne	_done_rolling_hash2_run_until_data_init
 	mov	rsi, rbx
 
+	mbin_isa_cap ISAL_ISA_AVX2, _ymm_check_rolling_hash2_run_until
 	;; Try for AVX2
 	xor	ecx, ecx
 	mov	eax, 7
@@ -103,6 +120,7 @@ rolling_hash2_run_until_dispatch_init:
 	lea     rbx, [rolling_hash2_run_until_04 WRT_OPT]
 	cmovne	rsi, rbx
 
+_ymm_check_rolling_hash2_run_until:
 	;;  Does it have xmm and ymm support
 	xor     ecx, ecx
 	xgetbv
@@ -112,6 +130,8 @@ rolling_hash2_run_until_dispatch_init:
 	lea     rsi, [rolling_hash2_run_until_00 WRT_OPT]
 
 _done_rolling_hash2_run_until_data_init:
+	mbin_dispatch_record rolling_hash2_run_until, rolling_hash2_run_until_base, \
+		rolling_hash2_run_until_00, rolling_hash2_run_until_04
 	pop     rdx
 	pop     rcx
 	pop     rbx
@@ -38,6 +38,7 @@
 #endif
 
 #include "sha1_mb.h"
+#include "sha1_ctx_submit_64.h"
 #include "memcpy_inline.h"
 #include "endian_helper.h"
 
@@ -92,6 +93,9 @@ SHA1_HASH_CTX *sha1_ctx_mgr_submit_avx512(SHA1_HASH_CTX_MGR * mgr, SHA1_HASH_CTX
 	// If we made it here, there were no errors during this call to submit
 	ctx->error = HASH_CTX_ERROR_NONE;
 
+	// Only sha1_ctx_mgr_submit_64() leaves pieces pending, once this submit returns
+	ctx->pending_length = 0;
+
 	// Store buffer ptr info from user
 	ctx->incoming_buffer = buffer;
 	ctx->incoming_buffer_length = len;
@@ -215,6 +219,10 @@ static SHA1_HASH_CTX *sha1_ctx_mgr_resubmit(SHA1_HASH_CTX_MGR * mgr, SHA1_HASH_C
 			continue;
 		}
 
+		// Take up the next piece of a sha1_ctx_mgr_submit_64() job in place
+		if (sha1_ctx_submit_64_next(ctx))
+			continue;
+
 		if (ctx)
 			ctx->status = HASH_CTX_STS_IDLE;
 		return ctx;
@@ -106,6 +106,9 @@ SHA1_HASH_CTX *sha1_ctx_mgr_submit_base(SHA1_HASH_CTX_MGR * mgr, SHA1_HASH_CTX *
 		return ctx;
 	}
 
+	// Every piece is hashed before this submit returns, so none is left pending
+	ctx->pending_length = 0;
+
 	if (flags == HASH_FIRST) {
 
 		sha1_init(ctx, buffer, len);
@@ -0,0 +1,67 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include "sha1_mb.h"
+#include "dispatch_table.h"
+
+typedef SHA1_HASH_CTX *(*sha1_submit_fn)(SHA1_HASH_CTX_MGR * mgr, SHA1_HASH_CTX * ctx,
+					 const void *buffer, uint32_t len,
+					 HASH_CTX_FLAG flags);
+
+void sha1_ctx_mgr_submit_batch(SHA1_HASH_CTX_MGR * mgr, SHA1_HASH_CTX * ctx[],
+			       const void *buffer[], const uint32_t len[], uint32_t num,
+			       HASH_CTX_FLAG flags, SHA1_HASH_CTX * completed[],
+			       uint32_t * num_completed)
+{
+	sha1_submit_fn submit;
+	SHA1_HASH_CTX *ret;
+	uint32_t i, n = 0;
+
+	if (flags & (~HASH_ENTIRE)) {
+		// The flags are shared, so the whole batch is rejected up front
+		for (i = 0; i < num; i++) {
+			ctx[i]->error = HASH_CTX_ERROR_INVALID_FLAGS;
+			completed[i] = ctx[i];
+		}
+		*num_completed = num;
+		return;
+	}
+	// Resolve the dispatched submit once rather than jumping through it per job
+	submit = (sha1_submit_fn) sha1_ctx_mgr_submit_dispatch_target();
+
+	for (i = 0; i < num; i++) {
+		ret = submit(mgr, ctx[i], buffer[i], len[i], flags);
+
+		// Each submit returns at most one ctx, either finished or rejected with an error
+		if (ret)
+			completed[n++] = ret;
+	}
+
+	*num_completed = n;
+}
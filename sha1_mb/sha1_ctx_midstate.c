@@ -0,0 +1,57 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <string.h>
+#include "sha1_mb.h"
+
+int sha1_ctx_midstate_save(const SHA1_HASH_CTX * ctx, SHA1_MIDSTATE * ms)
+{
+	// Only an idle ctx on a block boundary has nothing outside result_digest
+	if (ctx->status != HASH_CTX_STS_IDLE || ctx->partial_block_buffer_length)
+		return -1;
+
+	memcpy(ms->digest, ctx->job.result_digest, sizeof(ms->digest));
+	ms->total_length = ctx->total_length;
+
+	return 0;
+}
+
+int sha1_ctx_midstate_restore(SHA1_HASH_CTX * ctx, const SHA1_MIDSTATE * ms)
+{
+	if (ctx->status & HASH_CTX_STS_PROCESSING)
+		return -1;
+
+	memcpy(ctx->job.result_digest, ms->digest, sizeof(ms->digest));
+	ctx->total_length = ms->total_length;
+	ctx->partial_block_buffer_length = 0;
+	ctx->error = HASH_CTX_ERROR_NONE;
+	ctx->status = HASH_CTX_STS_IDLE;
+
+	return 0;
+}
@@ -0,0 +1,137 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "sha1_mb_pool.h"
+#include "endian_helper.h"
+
+// Jobs longer than this are fed to the manager as several updates. Must be a
+// multiple of the block size so that no partial block is buffered in between.
+#define SHA1_HASH_MANY_CHUNK	(1U << 31)
+
+struct sha1_many_job {
+	const uint8_t *buf;
+	uint64_t len;
+	uint64_t done;
+	uint32_t idx;
+};
+
+struct sha1_many_batch {
+	struct sha1_many_job *jobs;
+	uint8_t(*digests)[SHA1_DIGEST_NWORDS * 4];
+};
+
+static int sha1_many_cmp(const void *a, const void *b)
+{
+	const struct sha1_many_job *ja = a;
+	const struct sha1_many_job *jb = b;
+
+	// Longest first
+	if (ja->len != jb->len)
+		return (ja->len < jb->len) ? 1 : -1;
+	return (ja->idx > jb->idx) - (ja->idx < jb->idx);
+}
+
+static SHA1_HASH_CTX *sha1_many_submit(SHA1_HASH_CTX_MGR * mgr, SHA1_HASH_CTX * ctx)
+{
+	struct sha1_many_job *job = ctx->user_data;
+	uint64_t remain = job->len - job->done;
+	uint32_t len = (remain > SHA1_HASH_MANY_CHUNK) ? SHA1_HASH_MANY_CHUNK : remain;
+	HASH_CTX_FLAG flags = (job->done == 0) ? HASH_FIRST : HASH_UPDATE;
+	const uint8_t *buf = job->buf + job->done;
+
+	if (len == remain)
+		flags |= HASH_LAST;
+
+	job->done += len;
+	return sha1_ctx_mgr_submit(mgr, ctx, buf, len, flags);
+}
+
+static SHA1_HASH_CTX *sha1_many_start(SHA1_HASH_CTX_MGR * mgr, SHA1_HASH_CTX * ctx,
+				      uint32_t i, uint32_t lane, void *arg)
+{
+	struct sha1_many_batch *batch = arg;
+
+	ctx->user_data = &batch->jobs[i];
+	return sha1_many_submit(mgr, ctx);
+}
+
+// Resubmit an unfinished job, or store the digest of a finished one
+static int sha1_many_next(SHA1_HASH_CTX_MGR * mgr, SHA1_HASH_CTX ** ctx, void *arg)
+{
+	struct sha1_many_batch *batch = arg;
+	struct sha1_many_job *job = (*ctx)->user_data;
+	uint32_t j, w;
+
+	if (job->done < job->len) {
+		*ctx = sha1_many_submit(mgr, *ctx);
+		return 1;
+	}
+
+	for (j = 0; j < SHA1_DIGEST_NWORDS; j++) {
+		w = to_be32((*ctx)->job.result_digest[j]);
+		memcpy(&batch->digests[job->idx][4 * j], &w, sizeof(w));
+	}
+
+	return 0;
+}
+
+int sha1_mb_hash_many(const void *bufs[], const uint64_t lens[], uint32_t n,
+		      uint8_t(*digests)[SHA1_DIGEST_NWORDS * 4])
+{
+	struct sha1_many_batch batch;
+	struct sha1_many_job *jobs;
+	uint32_t i;
+	int ret;
+
+	if (n == 0)
+		return 0;
+
+	jobs = (struct sha1_many_job *)malloc(n * sizeof(*jobs));
+	if (jobs == NULL)
+		return -1;
+
+	for (i = 0; i < n; i++) {
+		jobs[i].buf = (const uint8_t *)bufs[i];
+		jobs[i].len = lens[i];
+		jobs[i].done = 0;
+		jobs[i].idx = i;
+	}
+
+	// Start the longest jobs first so that lanes stay balanced until the end
+	qsort(jobs, n, sizeof(*jobs), sha1_many_cmp);
+
+	batch.jobs = jobs;
+	batch.digests = digests;
+	ret = sha1_mb_pool_run(n, sha1_many_start, sha1_many_next, &batch);
+
+	free(jobs);
+	return ret;
+}
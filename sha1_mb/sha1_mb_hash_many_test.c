@@ -0,0 +1,122 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha1_mb.h"
+#include "endian_helper.h"
+
+#define TEST_LEN  (64*1024)
+#define TEST_BUFS 200
+#ifndef RANDOMS
+# define RANDOMS  10
+#endif
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+
+static uint32_t digest_ref[TEST_BUFS][SHA1_DIGEST_NWORDS];
+static uint8_t digests[TEST_BUFS][SHA1_DIGEST_NWORDS * 4];
+
+// Compare against reference function
+extern void sha1_ref(uint8_t * input_data, uint32_t * digest, uint32_t len);
+
+// Generates pseudo-random data
+static void rand_buffer(unsigned char *buf, const long buffer_size)
+{
+	long i;
+	for (i = 0; i < buffer_size; i++)
+		buf[i] = rand();
+}
+
+int main(void)
+{
+	const void *buf_ptrs[TEST_BUFS];
+	unsigned char *bufs[TEST_BUFS];
+	uint64_t lens[TEST_BUFS];
+	uint32_t i, j, t, jobs, w, fail = 0;
+
+	printf("sha1_mb_hash_many test, %d sets of %dx%d max: ", RANDOMS, TEST_BUFS,
+	       TEST_LEN);
+
+	srand(TEST_SEED);
+
+	for (i = 0; i < TEST_BUFS; i++) {
+		bufs[i] = (unsigned char *)malloc(TEST_LEN);
+		if (bufs[i] == NULL) {
+			printf("malloc failed test aborted\n");
+			return 1;
+		}
+		buf_ptrs[i] = bufs[i];
+	}
+
+	for (t = 0; t < RANDOMS; t++) {
+		jobs = rand() % TEST_BUFS + 1;
+
+		for (i = 0; i < jobs; i++) {
+			// Mix of empty, short and long buffers
+			lens[i] = (i % 8 == 0) ? 0 : rand() % (TEST_LEN >> (i % 4 * 4));
+			rand_buffer(bufs[i], lens[i]);
+			sha1_ref(bufs[i], digest_ref[i], lens[i]);
+		}
+
+		if (sha1_mb_hash_many(buf_ptrs, lens, jobs, digests) != 0) {
+			printf("sha1_mb_hash_many returned an error\n");
+			return 1;
+		}
+
+		for (i = 0; i < jobs; i++) {
+			for (j = 0; j < SHA1_DIGEST_NWORDS; j++) {
+				w = to_be32(digest_ref[i][j]);
+				if (memcmp(&digests[i][4 * j], &w, sizeof(w))) {
+					fail++;
+					printf("Test%d, digest%d fail\n", i, j);
+				}
+			}
+		}
+		if (fail) {
+			printf("Test failed function check %d\n", fail);
+			return fail;
+		}
+
+		putchar('.');
+		fflush(0);
+	}
+
+	if (sha1_mb_hash_many(buf_ptrs, lens, 0, digests) != 0)
+		fail++;
+
+	if (fail)
+		printf("Test failed function check %d\n", fail);
+	else
+		printf(" sha1_mb_hash_many rand: Pass\n");
+
+	return fail;
+}
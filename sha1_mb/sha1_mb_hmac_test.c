@@ -0,0 +1,195 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha1_mb.h"
+#include "endian_helper.h"
+
+#define KEYS 4
+#define MSGS 4
+#define LONG_MSG_LEN 1000
+#define NUM_JOBS 1000
+
+static const uint32_t key_lens[KEYS] = { 0, 20, 64, 131 };
+
+static uint8_t msg1[] = "Hi There";
+static uint8_t msg2[] = "what do ya want for nothing?";
+static uint8_t msg3[50];
+static uint8_t msg4[LONG_MSG_LEN];
+
+static uint8_t *msgs[MSGS] = { msg1, msg2, msg3, msg4 };
+static const uint32_t msg_lens[MSGS] =
+    { sizeof(msg1) - 1, sizeof(msg2) - 1, sizeof(msg3), sizeof(msg4) };
+
+static uint8_t exp_mac[KEYS][MSGS][20] = {
+	{
+	 {0x69, 0x53, 0x6c, 0xc8, 0x4e, 0xee, 0x5f, 0xe5, 0x1c, 0x5b,
+	  0x05, 0x1a, 0xff, 0x84, 0x85, 0xf5, 0xc9, 0xef, 0x0b, 0x58},
+	 {0x22, 0xe9, 0x99, 0xc6, 0x0f, 0x94, 0xd0, 0xf2, 0xd6, 0x35,
+	  0xca, 0x4c, 0xf1, 0xb1, 0x74, 0xe5, 0xcb, 0x51, 0x4d, 0x38},
+	 {0x3e, 0xa2, 0x3a, 0xdd, 0x71, 0x31, 0x92, 0x0c, 0xed, 0xd9,
+	  0xfa, 0x0b, 0x7e, 0xd1, 0x30, 0xf9, 0xe0, 0x32, 0x0b, 0x1b},
+	 {0x8c, 0x7e, 0x59, 0xfd, 0x81, 0x09, 0x5c, 0x08, 0x7c, 0xd2,
+	  0x4e, 0x94, 0xce, 0x6f, 0x9a, 0xdc, 0xb5, 0x43, 0xfd, 0x16},
+	 },
+	{
+	 {0xf2, 0xb3, 0x5a, 0x66, 0x7f, 0xf1, 0x03, 0xab, 0xc9, 0xd7,
+	  0xb2, 0x21, 0xe5, 0xb6, 0x6e, 0x31, 0x58, 0xf2, 0xdd, 0x71},
+	 {0xa8, 0x7c, 0x34, 0x41, 0x7f, 0xc5, 0xe2, 0x70, 0xb7, 0x18,
+	  0xaa, 0xf4, 0x5a, 0xd5, 0xae, 0x25, 0x04, 0x47, 0x1e, 0x7c},
+	 {0xe8, 0x84, 0xf6, 0xb9, 0xca, 0xd3, 0xd5, 0xff, 0x69, 0xdc,
+	  0x5a, 0x37, 0x84, 0x73, 0x14, 0x31, 0x84, 0x79, 0xce, 0x1b},
+	 {0xcb, 0x45, 0xf9, 0x91, 0x9b, 0xdb, 0x62, 0xa1, 0xf9, 0xe1,
+	  0xe2, 0x24, 0xe6, 0x39, 0xa6, 0xb5, 0x33, 0x2b, 0x31, 0x97},
+	 },
+	{
+	 {0xfb, 0x4b, 0xb7, 0xc1, 0xa4, 0x16, 0x11, 0x36, 0x58, 0xfa,
+	  0x8c, 0xa5, 0x6d, 0x1f, 0x6f, 0xc5, 0x41, 0x10, 0x4b, 0xc1},
+	 {0x4f, 0x12, 0x0c, 0xd3, 0x0d, 0xa8, 0xfb, 0xd9, 0x82, 0x8b,
+	  0xf8, 0x89, 0xe0, 0x5c, 0x08, 0x1c, 0xfa, 0x33, 0x1c, 0xd2},
+	 {0x99, 0x24, 0x37, 0xa9, 0x38, 0x1e, 0x41, 0x87, 0xea, 0xfb,
+	  0x42, 0xfd, 0x2c, 0xba, 0xc6, 0x62, 0xae, 0xe1, 0xf2, 0x50},
+	 {0x39, 0x69, 0xc2, 0x34, 0x32, 0xb0, 0x02, 0xc1, 0x9f, 0x11,
+	  0x82, 0xf3, 0x7f, 0xbe, 0x92, 0xaf, 0xb6, 0x7d, 0xc1, 0x06},
+	 },
+	{
+	 {0x59, 0x85, 0x6a, 0xb6, 0xef, 0x48, 0x3e, 0x2a, 0xd6, 0xb3,
+	  0x46, 0x51, 0x6b, 0x43, 0xf6, 0xa2, 0x57, 0x04, 0x47, 0x9c},
+	 {0x78, 0x0f, 0x49, 0x5d, 0x80, 0x04, 0x9a, 0xbd, 0x1b, 0xa5,
+	  0xae, 0x01, 0x06, 0x36, 0x84, 0x5e, 0x6b, 0xd5, 0x63, 0xa5},
+	 {0x65, 0x5b, 0xf6, 0x5b, 0x3b, 0x11, 0xe7, 0x3e, 0x3c, 0xac,
+	  0x31, 0xf8, 0x63, 0xc9, 0x2a, 0x85, 0x7e, 0x64, 0x37, 0x5e},
+	 {0x0e, 0x7b, 0xf3, 0xf7, 0x49, 0x11, 0x2f, 0x43, 0xc1, 0xf3,
+	  0x5b, 0xf1, 0xa1, 0x61, 0xc2, 0xff, 0x47, 0xd8, 0xec, 0x7a},
+	 },
+};
+
+// MAC of a completed ctx in byte order
+static void mac_bytes(uint8_t * out, HMAC_SHA1_HASH_CTX * hctx)
+{
+	uint32_t w;
+	int i;
+
+	for (i = 0; i < SHA1_DIGEST_NWORDS; i++) {
+		w = to_be32(hctx->ctx.job.result_digest[i]);
+		memcpy(out + i * sizeof(w), &w, sizeof(w));
+	}
+}
+
+static int check_mac(HMAC_SHA1_HASH_CTX * hctx, uint32_t job)
+{
+	uint8_t mac[sizeof(exp_mac[0][0])];
+
+	if (hctx->ctx.error || !hash_ctx_complete(&hctx->ctx))
+		return 1;
+
+	mac_bytes(mac, hctx);
+	return memcmp(mac, exp_mac[job % KEYS][job % MSGS], sizeof(mac));
+}
+
+int main(void)
+{
+	HMAC_SHA1_HASH_CTX_MGR *mgr = NULL;
+	HMAC_SHA1_HASH_CTX ctxpool[NUM_JOBS], *hctx;
+	HMAC_SHA1_KEY keys[KEYS];
+	uint8_t key[256];
+	uint32_t i, k, len, checked = 0;
+	int ret;
+
+	printf("hmac_sha1_mb test, %d jobs: ", NUM_JOBS);
+
+	ret = posix_memalign((void *)&mgr, 16, sizeof(HMAC_SHA1_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	memset(msg3, 0xdd, sizeof(msg3));
+	for (i = 0; i < LONG_MSG_LEN; i++)
+		msg4[i] = i * 13 + 5;
+	for (i = 0; i < sizeof(key); i++)
+		key[i] = i * 7 + 1;
+	for (k = 0; k < KEYS; k++)
+		hmac_sha1_key_init(&keys[k], key, key_lens[k]);
+
+	hmac_sha1_ctx_mgr_init(mgr);
+
+	// Whole messages, all keys and lengths mixed in the same lanes
+	for (i = 0; i < NUM_JOBS; i++) {
+		hash_ctx_init(&ctxpool[i].ctx);
+		ctxpool[i].ctx.user_data = (void *)((uint64_t) i);
+
+		hctx = hmac_sha1_ctx_mgr_submit(mgr, &ctxpool[i], &keys[i % KEYS],
+						  msgs[i % MSGS], msg_lens[i % MSGS], HASH_ENTIRE);
+		if (hctx) {
+			if (check_mac(hctx, (uint64_t) hctx->ctx.user_data)) {
+				printf("Test failed, job %d\n", (int)(uint64_t) hctx->ctx.user_data);
+				return 1;
+			}
+			checked++;
+		}
+	}
+
+	while ((hctx = hmac_sha1_ctx_mgr_flush(mgr))) {
+		if (check_mac(hctx, (uint64_t) hctx->ctx.user_data)) {
+			printf("Test failed, job %d\n", (int)(uint64_t) hctx->ctx.user_data);
+			return 1;
+		}
+		checked++;
+	}
+
+	if (checked != NUM_JOBS) {
+		printf("only tested %d rather than %d\n", checked, NUM_JOBS);
+		return 1;
+	}
+
+	// Same ctxs rekeyed and fed in two parts
+	for (i = 0; i < KEYS * MSGS; i++) {
+		len = msg_lens[i % MSGS] / 3;
+
+		hmac_sha1_ctx_mgr_submit(mgr, &ctxpool[i], &keys[i % KEYS], msgs[i % MSGS], len,
+					   HASH_FIRST);
+		while (hmac_sha1_ctx_mgr_flush(mgr)) ;
+
+		hmac_sha1_ctx_mgr_submit(mgr, &ctxpool[i], NULL, msgs[i % MSGS] + len,
+					   msg_lens[i % MSGS] - len, HASH_LAST);
+		while (hmac_sha1_ctx_mgr_flush(mgr)) ;
+
+		if (check_mac(&ctxpool[i], i)) {
+			printf("Test failed, job %d in parts\n", i);
+			return 1;
+		}
+	}
+
+	printf("Pass\n");
+
+	return 0;
+}
@@ -160,7 +160,8 @@ APPEND(skip_,I):
 	jz      len_is_0
 
 	; compare with sha-sb threshold, if num_lanes_inuse <= threshold, using sb func
-	cmp	dword [state + _num_lanes_inuse], SHA1_SB_THRESHOLD_AVX
+	mov	DWORD(tmp), [state + _num_lanes_inuse]
+	cmp	DWORD(tmp), [state + _sb_threshold]
 	ja	mb_processing
 
 	; lensN-len2=idx
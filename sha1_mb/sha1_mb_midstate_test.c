@@ -0,0 +1,158 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha1_mb.h"
+
+#define TEST_LEN  (16*1024)
+#define TEST_BUFS 100
+#ifndef RANDOMS
+# define RANDOMS  10
+#endif
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+
+static SHA1_WORD_T digest_ref[TEST_BUFS][SHA1_DIGEST_NWORDS];
+
+// Generates pseudo-random data
+static void rand_buffer(unsigned char *buf, const long buffer_size)
+{
+	long i;
+	for (i = 0; i < buffer_size; i++)
+		buf[i] = rand();
+}
+
+int main(void)
+{
+	SHA1_HASH_CTX_MGR *mgr = NULL;
+	SHA1_HASH_CTX ctxpool[TEST_BUFS], prefix_ctx;
+	SHA1_MIDSTATE ms;
+	uint32_t i, t, jobs, prefix_len, fail = 0;
+	unsigned char *bufs[TEST_BUFS];
+	uint32_t lens[TEST_BUFS];
+	int ret;
+
+	printf("multibinary_sha1_midstate test, %d sets of %dx%d max: ", RANDOMS, TEST_BUFS,
+	       TEST_LEN);
+
+	ret = posix_memalign((void *)&mgr, 16, sizeof(SHA1_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	srand(TEST_SEED);
+
+	for (i = 0; i < TEST_BUFS; i++) {
+		bufs[i] = (unsigned char *)malloc(2 * TEST_LEN);
+		if (bufs[i] == NULL) {
+			printf("malloc failed test aborted\n");
+			return 1;
+		}
+	}
+
+	sha1_ctx_mgr_init(mgr);
+
+	for (t = 0; t < RANDOMS; t++) {
+		jobs = rand() % TEST_BUFS + 1;
+		prefix_len = (rand() % (TEST_LEN / SHA1_BLOCK_SIZE)) * SHA1_BLOCK_SIZE;
+
+		// Every message starts with the same prefix
+		rand_buffer(bufs[0], prefix_len);
+		for (i = 0; i < jobs; i++) {
+			lens[i] = rand() % TEST_LEN;
+			memcpy(bufs[i], bufs[0], prefix_len);
+			rand_buffer(bufs[i] + prefix_len, lens[i]);
+		}
+
+		// Digests of the whole messages
+		for (i = 0; i < jobs; i++) {
+			hash_ctx_init(&ctxpool[i]);
+			sha1_ctx_mgr_submit(mgr, &ctxpool[i], bufs[i], prefix_len + lens[i],
+					      HASH_ENTIRE);
+		}
+		while (sha1_ctx_mgr_flush(mgr)) ;
+		for (i = 0; i < jobs; i++)
+			memcpy(digest_ref[i], ctxpool[i].job.result_digest,
+			       sizeof(digest_ref[i]));
+
+		// Hash the prefix once
+		hash_ctx_init(&prefix_ctx);
+		sha1_ctx_mgr_submit(mgr, &prefix_ctx, bufs[0], prefix_len, HASH_FIRST);
+		while (sha1_ctx_mgr_flush(mgr)) ;
+
+		if (sha1_ctx_midstate_save(&prefix_ctx, &ms)) {
+			printf("Midstate save failed\n");
+			return 1;
+		}
+
+		// Only the rest of each message goes through the lanes
+		for (i = 0; i < jobs; i++) {
+			if (sha1_ctx_midstate_restore(&ctxpool[i], &ms)) {
+				printf("Midstate restore failed\n");
+				return 1;
+			}
+			sha1_ctx_mgr_submit(mgr, &ctxpool[i], bufs[i] + prefix_len, lens[i],
+					      HASH_LAST);
+		}
+		while (sha1_ctx_mgr_flush(mgr)) ;
+
+		for (i = 0; i < jobs; i++) {
+			if (ctxpool[i].error || memcmp(ctxpool[i].job.result_digest,
+						       digest_ref[i], sizeof(digest_ref[i]))) {
+				fail++;
+				printf("Test%d midstate digest fail\n", i);
+			}
+		}
+		if (fail) {
+			printf("Test failed function check %d\n", fail);
+			return fail;
+		}
+
+		// A ctx holding a partial block or a final digest has no midstate
+		hash_ctx_init(&prefix_ctx);
+		sha1_ctx_mgr_submit(mgr, &prefix_ctx, bufs[0], prefix_len + 1, HASH_FIRST);
+		while (sha1_ctx_mgr_flush(mgr)) ;
+		if (!sha1_ctx_midstate_save(&prefix_ctx, &ms)
+		    || !sha1_ctx_midstate_save(&ctxpool[0], &ms)) {
+			printf("Midstate saved off a block boundary\n");
+			return 1;
+		}
+
+		putchar('.');
+		fflush(0);
+	}
+
+	printf(" multibinary_sha1_midstate rand: Pass\n");
+
+	return fail;
+}
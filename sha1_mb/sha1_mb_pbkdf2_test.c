@@ -0,0 +1,190 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha1_mb.h"
+#include "endian_helper.h"
+
+#define TEST_KEYS 32
+#define MAX_PASS_LEN (3 * SHA1_BLOCK_SIZE)
+#define MAX_SALT_LEN 80
+#define DIGEST_BYTES (SHA1_DIGEST_NWORDS * sizeof(SHA1_WORD_T))
+#define MAX_DK_LEN (3 * DIGEST_BYTES)
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+
+// Reference PBKDF2 built on the reference hash
+extern void sha1_ref(const uint8_t * input_data, uint32_t * digest, const uint32_t len);
+
+static const uint8_t rfc_dk[] = {
+	0x4b, 0x00, 0x79, 0x01, 0xb7, 0x65, 0x48, 0x9a, 0xbe, 0xad, 0x49, 0xd9, 0x26, 0xf7,
+	0x21, 0xd0, 0x65, 0xa4, 0x29, 0xc1
+};
+
+static const struct {
+	uint32_t iter;
+	uint32_t dk_len;
+} configs[] = { {1, DIGEST_BYTES}, {2, DIGEST_BYTES + 7}, {100, 2 * DIGEST_BYTES + 3} };
+
+static uint8_t pass[TEST_KEYS][MAX_PASS_LEN], salt[TEST_KEYS][MAX_SALT_LEN];
+static uint8_t dk[TEST_KEYS][MAX_DK_LEN], dk_ref[MAX_DK_LEN];
+
+static void hash_ref(uint8_t * msg, uint32_t len, uint8_t * out)
+{
+	SHA1_WORD_T digest[SHA1_DIGEST_NWORDS], w;
+	int i;
+
+	sha1_ref(msg, digest, len);
+	for (i = 0; i < SHA1_DIGEST_NWORDS; i++) {
+		w = to_be32(digest[i]);
+		memcpy(out + i * sizeof(w), &w, sizeof(w));
+	}
+}
+
+static void hmac_ref(const uint8_t * key, uint32_t key_len, const uint8_t * msg,
+		     uint32_t len, uint8_t * out)
+{
+	uint8_t buf[MAX_PASS_LEN + MAX_SALT_LEN + 4], k0[SHA1_BLOCK_SIZE];
+	int i;
+
+	memset(k0, 0, sizeof(k0));
+	if (key_len > SHA1_BLOCK_SIZE) {
+		memcpy(buf, key, key_len);
+		hash_ref(buf, key_len, k0);
+	} else
+		memcpy(k0, key, key_len);
+
+	for (i = 0; i < SHA1_BLOCK_SIZE; i++)
+		buf[i] = k0[i] ^ 0x36;
+	memcpy(buf + SHA1_BLOCK_SIZE, msg, len);
+	hash_ref(buf, SHA1_BLOCK_SIZE + len, out);
+
+	for (i = 0; i < SHA1_BLOCK_SIZE; i++)
+		buf[i] = k0[i] ^ 0x5c;
+	memcpy(buf + SHA1_BLOCK_SIZE, out, DIGEST_BYTES);
+	hash_ref(buf, SHA1_BLOCK_SIZE + DIGEST_BYTES, out);
+}
+
+static void pbkdf2_ref(const uint8_t * p, uint32_t p_len, const uint8_t * s, uint32_t s_len,
+		       uint32_t iter, uint8_t * out, uint32_t out_len)
+{
+	uint8_t msg[MAX_SALT_LEN + 4], u[DIGEST_BYTES], t[DIGEST_BYTES];
+	uint32_t i, j, k, n;
+
+	for (i = 1; out_len; i++) {
+		memcpy(msg, s, s_len);
+		msg[s_len] = i >> 24;
+		msg[s_len + 1] = i >> 16;
+		msg[s_len + 2] = i >> 8;
+		msg[s_len + 3] = i;
+		hmac_ref(p, p_len, msg, s_len + 4, u);
+		memcpy(t, u, sizeof(t));
+
+		for (j = 1; j < iter; j++) {
+			hmac_ref(p, p_len, u, sizeof(u), u);
+			for (k = 0; k < sizeof(t); k++)
+				t[k] ^= u[k];
+		}
+
+		n = out_len < sizeof(t) ? out_len : sizeof(t);
+		memcpy(out, t, n);
+		out += n;
+		out_len -= n;
+	}
+}
+
+int main(void)
+{
+	const void *pass_ptr[TEST_KEYS], *salt_ptr[TEST_KEYS];
+	uint32_t pass_lens[TEST_KEYS], salt_lens[TEST_KEYS];
+	uint8_t *dk_ptr[TEST_KEYS];
+	uint32_t i, j, c;
+
+	printf("pbkdf2_hmac_sha1_mb test: ");
+
+	// Known answer for password "password", salt "salt", 4096 iterations
+	pass_ptr[0] = "password";
+	pass_lens[0] = 8;
+	salt_ptr[0] = "salt";
+	salt_lens[0] = 4;
+	dk_ptr[0] = dk[0];
+	if (pbkdf2_hmac_sha1_mb(pass_ptr, pass_lens, salt_ptr, salt_lens, 4096, dk_ptr,
+				  sizeof(rfc_dk), 1)
+	    || memcmp(dk[0], rfc_dk, sizeof(rfc_dk))) {
+		printf("known answer fail\n");
+		return 1;
+	}
+
+	srand(TEST_SEED);
+
+	// Passwords shorter and longer than a block, salts of any length
+	for (i = 0; i < TEST_KEYS; i++) {
+		pass_lens[i] = rand() % MAX_PASS_LEN;
+		salt_lens[i] = rand() % MAX_SALT_LEN;
+		for (j = 0; j < pass_lens[i]; j++)
+			pass[i][j] = rand();
+		for (j = 0; j < salt_lens[i]; j++)
+			salt[i][j] = rand();
+		pass_ptr[i] = pass[i];
+		salt_ptr[i] = salt[i];
+		dk_ptr[i] = dk[i];
+	}
+
+	for (c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+		if (pbkdf2_hmac_sha1_mb(pass_ptr, pass_lens, salt_ptr, salt_lens,
+					  configs[c].iter, dk_ptr, configs[c].dk_len, TEST_KEYS)) {
+			printf("pbkdf2 returned an error\n");
+			return 1;
+		}
+
+		for (i = 0; i < TEST_KEYS; i++) {
+			pbkdf2_ref(pass[i], pass_lens[i], salt[i], salt_lens[i], configs[c].iter,
+				   dk_ref, configs[c].dk_len);
+			if (memcmp(dk[i], dk_ref, configs[c].dk_len)) {
+				printf("Test failed, key %d iter %d dk_len %d\n", i,
+				       configs[c].iter, configs[c].dk_len);
+				return 1;
+			}
+		}
+		putchar('.');
+	}
+
+	if (pbkdf2_hmac_sha1_mb(pass_ptr, pass_lens, salt_ptr, salt_lens, 0, dk_ptr,
+				  DIGEST_BYTES, TEST_KEYS) == 0) {
+		printf("zero iterations not rejected\n");
+		return 1;
+	}
+
+	printf(" Pass\n");
+
+	return 0;
+}
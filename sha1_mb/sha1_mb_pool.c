@@ -0,0 +1,87 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stddef.h>
+#include "sha1_mb_pool.h"
+
+/*
+ * Take a ctx handed back by the manager and carry on with its job, which may
+ * in turn hand back another ctx. Finished ones go back to the free list.
+ */
+static int sha1_mb_pool_retire(SHA1_HASH_CTX_MGR * mgr, SHA1_HASH_CTX * ctx,
+			       sha1_mb_pool_next_fn next, void *arg,
+			       SHA1_HASH_CTX * free_ctx[], uint32_t * nfree)
+{
+	int ret = 0;
+
+	while (ctx) {
+		if (ctx->error)
+			ret = -1;
+		else if (next(mgr, &ctx, arg))
+			continue;
+
+		free_ctx[(*nfree)++] = ctx;
+		ctx = NULL;
+	}
+
+	return ret;
+}
+
+int sha1_mb_pool_run(uint32_t n, sha1_mb_pool_start_fn start,
+		     sha1_mb_pool_next_fn next, void *arg)
+{
+	DECLARE_ALIGNED(SHA1_HASH_CTX_MGR mgr, 16);
+	SHA1_HASH_CTX ctxpool[SHA1_MAX_LANES], *free_ctx[SHA1_MAX_LANES], *ctx;
+	uint32_t i, lane, nfree = 0;
+	int ret = 0;
+
+	sha1_ctx_mgr_init(&mgr);
+
+	for (i = 0; i < SHA1_MAX_LANES; i++) {
+		hash_ctx_init(&ctxpool[i]);
+		free_ctx[nfree++] = &ctxpool[i];
+	}
+
+	for (i = 0; i < n; i++) {
+		// All contexts are in lanes, wait for one to come back
+		while (nfree == 0)
+			ret |= sha1_mb_pool_retire(&mgr, sha1_ctx_mgr_flush(&mgr), next, arg,
+						   free_ctx, &nfree);
+
+		ctx = free_ctx[--nfree];
+		lane = (uint32_t) (ctx - ctxpool);
+		ctx = start(&mgr, ctx, i, lane, arg);
+		ret |= sha1_mb_pool_retire(&mgr, ctx, next, arg, free_ctx, &nfree);
+	}
+
+	while ((ctx = sha1_ctx_mgr_flush(&mgr)) != NULL)
+		ret |= sha1_mb_pool_retire(&mgr, ctx, next, arg, free_ctx, &nfree);
+
+	return ret;
+}
@@ -0,0 +1,158 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sha1_mb.h"
+
+#define TEST_LEN  (64*1024)
+#define TEST_BUFS 100
+#ifndef RANDOMS
+# define RANDOMS  10
+#endif
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+
+static uint32_t digest_ref[TEST_BUFS][SHA1_DIGEST_NWORDS];
+
+// Compare against reference function
+extern void sha1_ref(uint8_t * input_data, uint32_t * digest, uint32_t len);
+
+// Generates pseudo-random data
+static void rand_buffer(unsigned char *buf, const long buffer_size)
+{
+	long i;
+	for (i = 0; i < buffer_size; i++)
+		buf[i] = rand();
+}
+
+int main(void)
+{
+	SHA1_HASH_CTX_SCHED *sched = NULL;
+	SHA1_HASH_CTX ctxpool[TEST_BUFS], *ctx;
+	uint32_t i, j, t, depth, jobs, returned, fail = 0;
+	unsigned char *bufs[TEST_BUFS];
+	uint32_t lens[TEST_BUFS];
+	int ret;
+
+	printf("multibinary_sha1_sched test, %d sets of %dx%d max: ", RANDOMS, TEST_BUFS,
+	       TEST_LEN);
+
+	ret = posix_memalign((void *)&sched, 16, sizeof(SHA1_HASH_CTX_SCHED));
+	if ((ret != 0) || (sched == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	srand(TEST_SEED);
+
+	for (i = 0; i < TEST_BUFS; i++) {
+		bufs[i] = (unsigned char *)malloc(TEST_LEN);
+		if (bufs[i] == NULL) {
+			printf("malloc failed test aborted\n");
+			return 1;
+		}
+		hash_ctx_init(&ctxpool[i]);
+	}
+
+	for (t = 0; t < RANDOMS; t++) {
+		jobs = rand() % TEST_BUFS + 1;
+		depth = t % (SHA1_SCHED_QUEUE_MAX + 1);
+
+		sha1_ctx_sched_init(sched, depth);
+
+		returned = 0;
+		for (i = 0; i < jobs; i++) {
+			lens[i] = rand() % TEST_LEN;
+			rand_buffer(bufs[i], lens[i]);
+			sha1_ref(bufs[i], digest_ref[i], lens[i]);
+
+			ctx = sha1_ctx_sched_submit(sched, &ctxpool[i], bufs[i], lens[i],
+						    HASH_ENTIRE);
+
+			// Nothing can come back before the queue is full
+			if (ctx && i + 1 < depth) {
+				printf("Job returned before queue was full\n");
+				return 1;
+			}
+			if (ctx && ctx->error) {
+				printf("Job %d returned an error %d\n", i, ctx->error);
+				return 1;
+			}
+			if (ctx)
+				returned++;
+		}
+
+		// A job still in flight must not be accepted again
+		for (i = 0; i < jobs; i++)
+			if (hash_ctx_processing(&ctxpool[i]))
+				break;
+
+		if (i < jobs) {
+			ctx = sha1_ctx_sched_submit(sched, &ctxpool[i], bufs[i], lens[i],
+						    HASH_ENTIRE);
+			if (ctx != &ctxpool[i] || ctx->error != HASH_CTX_ERROR_ALREADY_PROCESSING) {
+				printf("Resubmit of job in flight not rejected\n");
+				return 1;
+			}
+		}
+
+		while (sha1_ctx_sched_flush(sched))
+			returned++;
+
+		if (returned != jobs) {
+			printf("Test failed, %d of %d jobs returned\n", returned, jobs);
+			return 1;
+		}
+
+		for (i = 0; i < jobs; i++) {
+			for (j = 0; j < SHA1_DIGEST_NWORDS; j++) {
+				if (ctxpool[i].job.result_digest[j] != digest_ref[i][j]) {
+					fail++;
+					printf("Test%d, digest%d fail "
+					       "0x%08X <=> 0x%08X\n",
+					       i, j, ctxpool[i].job.result_digest[j],
+					       digest_ref[i][j]);
+				}
+			}
+		}
+		if (fail) {
+			printf("Test failed function check %d\n", fail);
+			return fail;
+		}
+
+		putchar('.');
+		fflush(0);
+	}
+
+	printf(" multibinary_sha1_sched rand: Pass\n");
+
+	return fail;
+}
@@ -0,0 +1,171 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha1_mb.h"
+
+// Small pieces so each test buffer is split between submit and the manager
+#define SHA1_SUBMIT_64_CHUNK	(4 * SHA1_BLOCK_SIZE)
+#include "sha1_ctx_submit_64.c"
+
+#define TEST_LEN  (64*1024)
+#define TEST_BUFS 100
+#ifndef RANDOMS
+# define RANDOMS  10
+#endif
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+
+static uint32_t digest_ref[TEST_BUFS][SHA1_DIGEST_NWORDS];
+
+// Generates pseudo-random data
+static void rand_buffer(unsigned char *buf, const long buffer_size)
+{
+	long i;
+	for (i = 0; i < buffer_size; i++)
+		buf[i] = rand();
+}
+
+int main(void)
+{
+	SHA1_HASH_CTX_MGR *mgr = NULL;
+	SHA1_HASH_CTX ctxpool[TEST_BUFS], *ctx;
+	uint32_t i, j, t, jobs, fail = 0;
+	unsigned char *bufs[TEST_BUFS];
+	uint32_t lens[TEST_BUFS], done[TEST_BUFS];
+	int ret;
+
+	printf("multibinary_sha1_submit_64 test, %d sets of %dx%d max: ", RANDOMS,
+	       TEST_BUFS, TEST_LEN);
+
+	ret = posix_memalign((void *)&mgr, 16, sizeof(SHA1_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	srand(TEST_SEED);
+
+	for (i = 0; i < TEST_BUFS; i++) {
+		bufs[i] = (unsigned char *)malloc(TEST_LEN);
+		if (bufs[i] == NULL) {
+			printf("malloc failed test aborted\n");
+			return 1;
+		}
+	}
+
+	for (t = 0; t < RANDOMS; t++) {
+		jobs = rand() % TEST_BUFS + 1;
+
+		// Digests from the 32-bit interface in one go
+		sha1_ctx_mgr_init(mgr);
+		for (i = 0; i < jobs; i++) {
+			hash_ctx_init(&ctxpool[i]);
+			lens[i] = rand() % TEST_LEN;
+			rand_buffer(bufs[i], lens[i]);
+			sha1_ctx_mgr_submit(mgr, &ctxpool[i], bufs[i], lens[i], HASH_ENTIRE);
+		}
+		while (sha1_ctx_mgr_flush(mgr)) ;
+		for (i = 0; i < jobs; i++)
+			memcpy(digest_ref[i], ctxpool[i].job.result_digest,
+			       sizeof(digest_ref[i]));
+
+		// Same data through the 64-bit interface in random pieces
+		sha1_ctx_mgr_init(mgr);
+		for (i = 0; i < jobs; i++) {
+			hash_ctx_init(&ctxpool[i]);
+			done[i] = 0;
+		}
+
+		for (i = 0; i < jobs; i++) {
+			uint64_t len = rand() % (lens[i] + 1);
+
+			ctx = sha1_ctx_mgr_submit_64(mgr, &ctxpool[i], bufs[i], len, HASH_FIRST);
+			done[i] = len;
+			if (ctx && ctx->error) {
+				printf("Job %d returned an error %d\n", i, ctx->error);
+				return 1;
+			}
+		}
+
+		while (sha1_ctx_mgr_flush(mgr)) ;
+
+		for (i = 0; i < jobs; i++) {
+			uint64_t len;
+
+			while ((len = rand() % (lens[i] - done[i] + 1)) < lens[i] - done[i]) {
+				unsigned char *buf = bufs[i] + done[i];
+
+				// Plain updates can be mixed in on the same ctx
+				if (len & 1)
+					sha1_ctx_mgr_submit(mgr, &ctxpool[i], buf,
+							    (uint32_t) len, HASH_UPDATE);
+				else
+					sha1_ctx_mgr_submit_64(mgr, &ctxpool[i], buf,
+							       len, HASH_UPDATE);
+				while (sha1_ctx_mgr_flush(mgr)) ;
+				done[i] += len;
+			}
+			sha1_ctx_mgr_submit_64(mgr, &ctxpool[i], bufs[i] + done[i], len,
+					       HASH_LAST);
+		}
+
+		while (sha1_ctx_mgr_flush(mgr)) ;
+
+		for (i = 0; i < jobs; i++) {
+			if (!hash_ctx_complete(&ctxpool[i]) || ctxpool[i].pending_length) {
+				printf("Job %d not complete\n", i);
+				return 1;
+			}
+			for (j = 0; j < SHA1_DIGEST_NWORDS; j++) {
+				if (ctxpool[i].job.result_digest[j] != digest_ref[i][j]) {
+					fail++;
+					printf("Test%d, digest%d fail "
+					       "0x%08X <=> 0x%08X\n",
+					       i, j, ctxpool[i].job.result_digest[j],
+					       digest_ref[i][j]);
+				}
+			}
+		}
+		if (fail) {
+			printf("Test failed function check %d\n", fail);
+			return fail;
+		}
+
+		putchar('.');
+		fflush(0);
+	}
+
+	printf(" multibinary_sha1_submit_64 rand: Pass\n");
+
+	return fail;
+}
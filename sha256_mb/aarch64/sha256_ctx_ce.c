@@ -30,12 +30,14 @@
 #include <stdint.h>
 #include <string.h>
 #include "sha256_mb.h"
+#include "sha256_ctx_submit_64.h"
 #include "memcpy_inline.h"
 #include "endian_helper.h"
 
 void sha256_mb_mgr_init_ce(SHA256_MB_JOB_MGR * state);
 SHA256_JOB *sha256_mb_mgr_submit_ce(SHA256_MB_JOB_MGR * state, SHA256_JOB * job);
 SHA256_JOB *sha256_mb_mgr_flush_ce(SHA256_MB_JOB_MGR * state);
+SHA256_HASH_CTX *sha256_ctx_mgr_flush_ce(SHA256_HASH_CTX_MGR * mgr);
 static inline void hash_init_digest(SHA256_WORD_T * digest);
 static inline uint32_t hash_pad(uint8_t padblock[SHA256_BLOCK_SIZE * 2], uint64_t total_len);
 static SHA256_HASH_CTX *sha256_ctx_mgr_resubmit(SHA256_HASH_CTX_MGR * mgr,
@@ -44,6 +46,7 @@ static SHA256_HASH_CTX *sha256_ctx_mgr_resubmit(SHA256_HASH_CTX_MGR * mgr,
 void sha256_ctx_mgr_init_ce(SHA256_HASH_CTX_MGR * mgr)
 {
 	sha256_mb_mgr_init_ce(&mgr->mgr);
+	sha256_ctx_mgr_deadline_init(mgr);
 }
 
 SHA256_HASH_CTX *sha256_ctx_mgr_submit_ce(SHA256_HASH_CTX_MGR * mgr, SHA256_HASH_CTX * ctx,
@@ -81,6 +84,9 @@ SHA256_HASH_CTX *sha256_ctx_mgr_submit_ce(SHA256_HASH_CTX_MGR * mgr, SHA256_HASH
 	// If we made it here, there were no errors during this call to submit
 	ctx->error = HASH_CTX_ERROR_NONE;
 
+	// Only sha256_ctx_mgr_submit_64() leaves pieces pending, once this submit returns
+	ctx->pending_length = 0;
+
 	// Store buffer ptr info from user
 	ctx->incoming_buffer = buffer;
 	ctx->incoming_buffer_length = len;
@@ -125,7 +131,13 @@ SHA256_HASH_CTX *sha256_ctx_mgr_submit_ce(SHA256_HASH_CTX_MGR * mgr, SHA256_HASH
 		}
 	}
 
-	return sha256_ctx_mgr_resubmit(mgr, ctx);
+	ctx = sha256_ctx_mgr_resubmit(mgr, ctx);
+
+	// Advance the partially filled lanes once a deadline limit is hit
+	if (sha256_ctx_mgr_deadline_submit(mgr, len, ctx))
+		return sha256_ctx_mgr_flush_ce(mgr);
+
+	return ctx;
 }
 
 SHA256_HASH_CTX *sha256_ctx_mgr_flush_ce(SHA256_HASH_CTX_MGR * mgr)
@@ -144,8 +156,10 @@ SHA256_HASH_CTX *sha256_ctx_mgr_flush_ce(SHA256_HASH_CTX_MGR * mgr)
 		ctx = sha256_ctx_mgr_resubmit(mgr, ctx);
 
 		// If sha256_ctx_mgr_resubmit returned a job, it is ready to be returned.
-		if (ctx)
+		if (ctx) {
+			sha256_ctx_mgr_deadline_complete(mgr);
 			return ctx;
+		}
 
 		// Otherwise, all jobs currently being managed by the SHA256_HASH_CTX_MGR still need processing. Loop.
 	}
@@ -206,6 +220,10 @@ static SHA256_HASH_CTX *sha256_ctx_mgr_resubmit(SHA256_HASH_CTX_MGR * mgr,
 			continue;
 		}
 
+		// Take up the next piece of a sha256_ctx_mgr_submit_64() job in place
+		if (sha256_ctx_submit_64_next(ctx))
+			continue;
+
 		if (ctx)
 			ctx->status = HASH_CTX_STS_IDLE;
 		return ctx;
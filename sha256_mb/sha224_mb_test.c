@@ -0,0 +1,148 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha256_mb.h"
+
+#define MSGS 4
+#define NUM_JOBS 1000
+
+static uint8_t msg1[] = "abc";
+static uint8_t msg2[] = "";
+static uint8_t msg3[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+static uint8_t msg4[] =
+    "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopq"
+    "klmnopqrlmnopqrsmnopqrstnopqrstu";
+
+static uint8_t *msgs[MSGS] = { msg1, msg2, msg3, msg4 };
+
+static uint32_t exp_sha224[MSGS][SHA224_DIGEST_NWORDS] = {
+	{0x23097d22, 0x3405d822, 0x8642a477, 0xbda255b3, 0x2aadbce4, 0xbda0b3f7, 0xe36c9da7},
+	{0xd14a028c, 0x2a3a2bc9, 0x476102bb, 0x288234c4, 0x15a2b01f, 0x828ea62a, 0xc5b3e42f},
+	{0x75388b16, 0x512776cc, 0x5dba5da1, 0xfd890150, 0xb0c6455c, 0xb4f58b19, 0x52522525},
+	{0xc97ca9a5, 0x59850ce9, 0x7a04a96d, 0xef6d99a9, 0xe0e0e2ab, 0x14e6b8df, 0x265fc0b3}
+};
+
+static uint32_t exp_sha256[MSGS][SHA256_DIGEST_NWORDS] = {
+	{0xba7816bf, 0x8f01cfea, 0x414140de, 0x5dae2223, 0xb00361a3, 0x96177a9c, 0xb410ff61,
+	 0xf20015ad},
+	{0xe3b0c442, 0x98fc1c14, 0x9afbf4c8, 0x996fb924, 0x27ae41e4, 0x649b934c, 0xa495991b,
+	 0x7852b855},
+	{0x248d6a61, 0xd20638b8, 0xe5c02693, 0x0c3e6039, 0xa33ce459, 0x64ff2167, 0xf6ecedd4,
+	 0x19db06c1},
+	{0xcf5b16a7, 0x78af8380, 0x036ce59e, 0x7b049237, 0x0b249b11, 0xe8f07a51, 0xafac4503,
+	 0x7afee9d1}
+};
+
+// Odd jobs are SHA224 on the first round and SHA256 on the second, even ones the reverse
+static int is_sha224(uint32_t job, int round)
+{
+	return (job + round) & 1;
+}
+
+static int check_digest(SHA256_HASH_CTX * ctx, uint32_t job, int round)
+{
+	uint32_t j, m = job % MSGS;
+
+	if (is_sha224(job, round)) {
+		for (j = 0; j < SHA224_DIGEST_NWORDS; j++)
+			if (ctx->job.result_digest[j] != exp_sha224[m][j])
+				return 1;
+	} else {
+		for (j = 0; j < SHA256_DIGEST_NWORDS; j++)
+			if (ctx->job.result_digest[j] != exp_sha256[m][j])
+				return 1;
+	}
+	return 0;
+}
+
+int main(void)
+{
+	SHA256_HASH_CTX_MGR *mgr = NULL;
+	SHA256_HASH_CTX ctxpool[NUM_JOBS], *ctx;
+	uint32_t i, checked;
+	int round, ret;
+	uint8_t *msg;
+
+	ret = posix_memalign((void *)&mgr, 16, sizeof(SHA256_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	sha256_ctx_mgr_init(mgr);
+
+	for (i = 0; i < NUM_JOBS; i++) {
+		hash_ctx_init(&ctxpool[i]);
+		ctxpool[i].user_data = (void *)((uint64_t) i);
+	}
+
+	// Second round restarts every completed ctx as the other variant
+	for (round = 0; round < 2; round++) {
+		checked = 0;
+		for (i = 0; i < NUM_JOBS; i++) {
+			msg = msgs[i % MSGS];
+			if (is_sha224(i, round))
+				ctx = sha224_ctx_mgr_submit(mgr, &ctxpool[i], msg,
+							    strlen((char *)msg), HASH_ENTIRE);
+			else
+				ctx = sha256_ctx_mgr_submit(mgr, &ctxpool[i], msg,
+							    strlen((char *)msg), HASH_ENTIRE);
+
+			if (ctx) {
+				if (ctx->error || check_digest(ctx, (uint64_t) ctx->user_data, round)) {
+					printf("Test failed, job %d round %d\n",
+					       (int)(uint64_t) ctx->user_data, round);
+					return 1;
+				}
+				checked++;
+			}
+		}
+
+		while ((ctx = sha256_ctx_mgr_flush(mgr))) {
+			if (ctx->error || check_digest(ctx, (uint64_t) ctx->user_data, round)) {
+				printf("Test failed, job %d round %d\n",
+				       (int)(uint64_t) ctx->user_data, round);
+				return 1;
+			}
+			checked++;
+		}
+
+		if (checked != NUM_JOBS) {
+			printf("only tested %d rather than %d\n", checked, NUM_JOBS);
+			return 1;
+		}
+	}
+
+	printf(" multibinary_sha224 test: Pass\n");
+
+	return 0;
+}
@@ -38,6 +38,7 @@
 #endif
 
 #include "sha256_mb.h"
+#include "sha256_ctx_submit_64.h"
 #include "memcpy_inline.h"
 #include "endian_helper.h"
 
@@ -66,6 +67,8 @@ static SHA256_HASH_CTX *sha256_ctx_mgr_resubmit(SHA256_HASH_CTX_MGR * mgr,
 void sha256_ctx_mgr_init_avx512_ni(SHA256_HASH_CTX_MGR * mgr)
 {
 	sha256_mb_mgr_init_avx512(&mgr->mgr);
+	mgr->mgr.sb_threshold = SHA256_NI_SB_THRESHOLD_AVX512;
+	sha256_ctx_mgr_deadline_init(mgr);
 }
 
 SHA256_HASH_CTX *sha256_ctx_mgr_submit_avx512_ni(SHA256_HASH_CTX_MGR * mgr,
@@ -103,6 +106,9 @@ SHA256_HASH_CTX *sha256_ctx_mgr_submit_avx512_ni(SHA256_HASH_CTX_MGR * mgr,
 	// If we made it here, there were no errors during this call to submit
 	ctx->error = HASH_CTX_ERROR_NONE;
 
+	// Only sha256_ctx_mgr_submit_64() leaves pieces pending, once this submit returns
+	ctx->pending_length = 0;
+
 	// Store buffer ptr info from user
 	ctx->incoming_buffer = buffer;
 	ctx->incoming_buffer_length = len;
@@ -146,7 +152,13 @@ SHA256_HASH_CTX *sha256_ctx_mgr_submit_avx512_ni(SHA256_HASH_CTX_MGR * mgr,
 		}
 	}
 
-	return sha256_ctx_mgr_resubmit(mgr, ctx);
+	ctx = sha256_ctx_mgr_resubmit(mgr, ctx);
+
+	// Advance the partially filled lanes once a deadline limit is hit
+	if (sha256_ctx_mgr_deadline_submit(mgr, len, ctx))
+		return sha256_ctx_mgr_flush_avx512_ni(mgr);
+
+	return ctx;
 }
 
 SHA256_HASH_CTX *sha256_ctx_mgr_flush_avx512_ni(SHA256_HASH_CTX_MGR * mgr)
@@ -165,8 +177,10 @@ SHA256_HASH_CTX *sha256_ctx_mgr_flush_avx512_ni(SHA256_HASH_CTX_MGR * mgr)
 		ctx = sha256_ctx_mgr_resubmit(mgr, ctx);
 
 		// If sha256_ctx_mgr_resubmit returned a job, it is ready to be returned.
-		if (ctx)
+		if (ctx) {
+			sha256_ctx_mgr_deadline_complete(mgr);
 			return ctx;
+		}
 
 		// Otherwise, all jobs currently being managed by the SHA256_HASH_CTX_MGR still need processing. Loop.
 	}
@@ -227,6 +241,10 @@ static SHA256_HASH_CTX *sha256_ctx_mgr_resubmit(SHA256_HASH_CTX_MGR * mgr,
 			continue;
 		}
 
+		// Take up the next piece of a sha256_ctx_mgr_submit_64() job in place
+		if (sha256_ctx_submit_64_next(ctx))
+			continue;
+
 		if (ctx)
 			ctx->status = HASH_CTX_STS_IDLE;
 		return ctx;
@@ -97,6 +97,9 @@ SHA256_HASH_CTX *sha256_ctx_mgr_submit_base(SHA256_HASH_CTX_MGR * mgr, SHA256_HA
 		return ctx;
 	}
 
+	// Every piece is hashed before this submit returns, so none is left pending
+	ctx->pending_length = 0;
+
 	if (flags == HASH_FIRST) {
 
 		sha256_init(ctx, buffer, len);
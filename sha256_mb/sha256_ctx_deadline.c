@@ -0,0 +1,102 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <string.h>
+#include "sha256_mb.h"
+
+#if defined(_MSC_VER)
+# include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+# include <x86intrin.h>
+#endif
+
+static inline uint64_t sha256_deadline_clock(void)
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#elif defined(__aarch64__)
+	uint64_t t;
+	__asm__ volatile ("mrs %0, cntvct_el0":"=r" (t));
+	return t;
+#else
+	return 0;
+#endif
+}
+
+void sha256_ctx_mgr_set_deadline(SHA256_HASH_CTX_MGR * mgr, uint64_t max_bytes,
+				 uint32_t max_jobs, uint64_t max_cycles)
+{
+	SHA256_DEADLINE *d = &mgr->deadline;
+
+	d->max_bytes = max_bytes;
+	d->max_jobs = max_jobs;
+	d->max_cycles = max_cycles;
+
+	// The clock is only kept up to date while a cycle budget is set
+	if (max_cycles)
+		d->tsc = sha256_deadline_clock();
+}
+
+void sha256_ctx_mgr_deadline_init(SHA256_HASH_CTX_MGR * mgr)
+{
+	memset(&mgr->deadline, 0, sizeof(mgr->deadline));
+}
+
+void sha256_ctx_mgr_deadline_complete(SHA256_HASH_CTX_MGR * mgr)
+{
+	SHA256_DEADLINE *d = &mgr->deadline;
+
+	d->jobs--;
+	d->bytes = 0;
+	if (d->max_cycles)
+		d->tsc = sha256_deadline_clock();
+}
+
+/*
+ * Account for a job accepted by submit, ctx being what submit is about to
+ * return. Returns non-zero when the caller should flush to make progress.
+ */
+int sha256_ctx_mgr_deadline_submit(SHA256_HASH_CTX_MGR * mgr, uint32_t len,
+				   SHA256_HASH_CTX * ctx)
+{
+	SHA256_DEADLINE *d = &mgr->deadline;
+
+	if (d->jobs++ == 0 && d->max_cycles)
+		d->tsc = sha256_deadline_clock();
+	d->bytes += len;
+
+	if (ctx) {
+		sha256_ctx_mgr_deadline_complete(mgr);
+		return 0;
+	}
+
+	return (d->max_jobs && d->jobs >= d->max_jobs) ||
+	    (d->max_bytes && d->bytes >= d->max_bytes) ||
+	    (d->max_cycles && sha256_deadline_clock() - d->tsc >= d->max_cycles);
+}
@@ -0,0 +1,157 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <string.h>
+#include "sha256_mb.h"
+#include "endian_helper.h"
+
+// Digest words of a completed ctx in message byte order
+static void hmac_sha256_digest_bytes(SHA256_WORD_T * out, const SHA256_HASH_CTX * ctx)
+{
+	int i;
+
+	for (i = 0; i < SHA256_DIGEST_NWORDS; i++)
+		out[i] = to_be32(ctx->job.result_digest[i]);
+}
+
+// Run one job to completion on an otherwise idle manager
+static void hmac_sha256_hash_once(SHA256_HASH_CTX_MGR * mgr, SHA256_HASH_CTX * ctx,
+				  const void *buffer, uint32_t len, HASH_CTX_FLAG flags)
+{
+	hash_ctx_init(ctx);
+	if (sha256_ctx_mgr_submit(mgr, ctx, buffer, len, flags) == NULL)
+		while (sha256_ctx_mgr_flush(mgr)) ;
+}
+
+void hmac_sha256_key_init(HMAC_SHA256_KEY * key, const void *k, uint32_t len)
+{
+	DECLARE_ALIGNED(SHA256_HASH_CTX_MGR mgr, 16);
+	SHA256_HASH_CTX ctx;
+	SHA256_WORD_T kdigest[SHA256_DIGEST_NWORDS];
+	uint8_t pad[SHA256_BLOCK_SIZE];
+	int i;
+
+	// Midstates come from the dispatched code so they match its digest layout
+	sha256_ctx_mgr_init(&mgr);
+
+	// Keys longer than a block are replaced by their digest
+	if (len > SHA256_BLOCK_SIZE) {
+		hmac_sha256_hash_once(&mgr, &ctx, k, len, HASH_ENTIRE);
+		hmac_sha256_digest_bytes(kdigest, &ctx);
+		k = kdigest;
+		len = sizeof(kdigest);
+	}
+
+	memset(pad, 0, sizeof(pad));
+	memcpy(pad, k, len);
+
+	// The ipad and opad blocks are hashed once here rather than per message
+	for (i = 0; i < SHA256_BLOCK_SIZE; i++)
+		pad[i] ^= 0x36;
+	hmac_sha256_hash_once(&mgr, &ctx, pad, SHA256_BLOCK_SIZE, HASH_FIRST);
+	sha256_ctx_midstate_save(&ctx, &key->ipad);
+
+	for (i = 0; i < SHA256_BLOCK_SIZE; i++)
+		pad[i] ^= 0x36 ^ 0x5c;
+	hmac_sha256_hash_once(&mgr, &ctx, pad, SHA256_BLOCK_SIZE, HASH_FIRST);
+	sha256_ctx_midstate_save(&ctx, &key->opad);
+
+	memset(pad, 0, sizeof(pad));
+	memset(kdigest, 0, sizeof(kdigest));
+	memset(&ctx, 0, sizeof(ctx));
+}
+
+void hmac_sha256_ctx_mgr_init(HMAC_SHA256_HASH_CTX_MGR * mgr)
+{
+	sha256_ctx_mgr_init(&mgr->mgr);
+}
+
+// Start the outer hash of any ctx whose inner hash is done
+static HMAC_SHA256_HASH_CTX *hmac_sha256_retire(HMAC_SHA256_HASH_CTX_MGR * mgr,
+						SHA256_HASH_CTX * ctx)
+{
+	HMAC_SHA256_HASH_CTX *hctx;
+
+	while (ctx && ctx->error == HASH_CTX_ERROR_NONE && hash_ctx_complete(ctx)) {
+		hctx = (HMAC_SHA256_HASH_CTX *) ctx;
+		if (hctx->outer)
+			break;
+
+		hmac_sha256_digest_bytes(hctx->inner_digest, ctx);
+		sha256_ctx_midstate_restore(ctx, &hctx->key->opad);
+		hctx->outer = 1;
+
+		ctx = sha256_ctx_mgr_submit(&mgr->mgr, ctx, hctx->inner_digest,
+					    sizeof(hctx->inner_digest), HASH_LAST);
+	}
+
+	return (HMAC_SHA256_HASH_CTX *) ctx;
+}
+
+HMAC_SHA256_HASH_CTX *hmac_sha256_ctx_mgr_submit(HMAC_SHA256_HASH_CTX_MGR * mgr,
+						 HMAC_SHA256_HASH_CTX * hctx,
+						 const HMAC_SHA256_KEY * key, const void *buffer,
+						 uint32_t len, HASH_CTX_FLAG flags)
+{
+	SHA256_HASH_CTX *ctx = &hctx->ctx;
+
+	if (flags & (~HASH_ENTIRE)) {
+		ctx->error = HASH_CTX_ERROR_INVALID_FLAGS;
+		return hctx;
+	}
+
+	if (flags & HASH_FIRST) {
+		if (ctx->status & HASH_CTX_STS_PROCESSING) {
+			ctx->error = HASH_CTX_ERROR_ALREADY_PROCESSING;
+			return hctx;
+		}
+
+		hctx->key = key;
+		hctx->outer = 0;
+		sha256_ctx_midstate_restore(ctx, &key->ipad);
+	}
+
+	ctx = sha256_ctx_mgr_submit(&mgr->mgr, ctx, buffer, len, flags & ~HASH_FIRST);
+
+	return hmac_sha256_retire(mgr, ctx);
+}
+
+HMAC_SHA256_HASH_CTX *hmac_sha256_ctx_mgr_flush(HMAC_SHA256_HASH_CTX_MGR * mgr)
+{
+	SHA256_HASH_CTX *ctx;
+	HMAC_SHA256_HASH_CTX *hctx;
+
+	while ((ctx = sha256_ctx_mgr_flush(&mgr->mgr)) != NULL) {
+		hctx = hmac_sha256_retire(mgr, ctx);
+		if (hctx)
+			return hctx;
+	}
+
+	return NULL;
+}
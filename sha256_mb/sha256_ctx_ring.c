@@ -0,0 +1,109 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stddef.h>
+#include "sha256_mb.h"
+
+int sha256_ctx_ring_init(SHA256_HASH_CTX_RING * ring, SHA256_RING_SQE * sq,
+			 SHA256_HASH_CTX ** cq, uint32_t entries)
+{
+	if (entries == 0 || (entries & (entries - 1)))
+		return -1;
+
+	sha256_ctx_mgr_init(&ring->mgr);
+	ring->sq = sq;
+	ring->cq = cq;
+	ring->mask = entries - 1;
+	ring->sq_head = 0;
+	ring->sq_tail = 0;
+	ring->cq_head = 0;
+	ring->cq_tail = 0;
+
+	return 0;
+}
+
+int sha256_ctx_ring_submit(SHA256_HASH_CTX_RING * ring, SHA256_HASH_CTX * ctx,
+			   const void *buffer, uint32_t len, HASH_CTX_FLAG flags)
+{
+	SHA256_RING_SQE *sqe;
+
+	if (ring->sq_tail - ring->sq_head > ring->mask)
+		return -1;
+
+	sqe = &ring->sq[ring->sq_tail & ring->mask];
+	sqe->ctx = ctx;
+	sqe->buffer = buffer;
+	sqe->len = len;
+	sqe->flags = flags;
+	ring->sq_tail++;
+
+	return 0;
+}
+
+SHA256_HASH_CTX *sha256_ctx_ring_complete(SHA256_HASH_CTX_RING * ring)
+{
+	if (ring->cq_head == ring->cq_tail)
+		return NULL;
+
+	return ring->cq[ring->cq_head++ & ring->mask];
+}
+
+static inline int sha256_ring_cq_full(SHA256_HASH_CTX_RING * ring)
+{
+	return ring->cq_tail - ring->cq_head > ring->mask;
+}
+
+uint32_t sha256_ctx_mgr_process(SHA256_HASH_CTX_RING * ring, uint32_t budget)
+{
+	SHA256_HASH_CTX *ctx;
+	SHA256_RING_SQE *sqe;
+	uint32_t done = 0;
+
+	// Each submit or flush may complete one job, keep a slot free for it
+	while (done < budget && ring->sq_head != ring->sq_tail && !sha256_ring_cq_full(ring)) {
+		sqe = &ring->sq[ring->sq_head++ & ring->mask];
+		ctx = sha256_ctx_mgr_submit(&ring->mgr, sqe->ctx, sqe->buffer, sqe->len,
+					    sqe->flags);
+		if (ctx)
+			ring->cq[ring->cq_tail++ & ring->mask] = ctx;
+		done++;
+	}
+
+	// Nothing more to batch with, finish what is in the lanes
+	if (ring->sq_head == ring->sq_tail) {
+		while (!sha256_ring_cq_full(ring)) {
+			ctx = sha256_ctx_mgr_flush(&ring->mgr);
+			if (ctx == NULL)
+				break;
+			ring->cq[ring->cq_tail++ & ring->mask] = ctx;
+		}
+	}
+
+	return done;
+}
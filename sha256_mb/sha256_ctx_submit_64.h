@@ -0,0 +1,83 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#ifndef _SHA256_CTX_SUBMIT_64_H_
+#define _SHA256_CTX_SUBMIT_64_H_
+
+/**
+ *  @file sha256_ctx_submit_64.h
+ *  @brief Internal piece handling shared by sha256_ctx_mgr_submit_64() and the ctx managers
+ *
+ *  sha256_ctx_mgr_submit_64() submits the first piece of a long buffer itself and
+ *  leaves the rest in the ctx pending_* fields. Pieces end on a block boundary,
+ *  so when the manager hands such a ctx back to resubmit the next piece can be
+ *  hashed in place, and the plain submit and flush never return it half done.
+ */
+#include <stdint.h>
+#include <assert.h>
+#include "sha256_mb.h"
+
+// Largest piece handed to the manager at once, a whole number of blocks
+#ifndef SHA256_SUBMIT_64_CHUNK
+# define SHA256_SUBMIT_64_CHUNK	(1U << 31)
+#endif
+
+/**
+ * @brief Load the next pending piece of a sha256_ctx_mgr_submit_64() job into ctx.
+ *
+ * @returns 1 if ctx now holds a piece to hash, or 0 if nothing is pending
+ */
+static inline int sha256_ctx_submit_64_next(SHA256_HASH_CTX * ctx)
+{
+	uint64_t len = ctx->pending_length;
+
+	if (len == 0)
+		return 0;
+
+	// The previous piece ended on a block boundary
+	assert(ctx->partial_block_buffer_length == 0);
+
+	if (len > SHA256_SUBMIT_64_CHUNK)
+		len = SHA256_SUBMIT_64_CHUNK;
+
+	ctx->incoming_buffer = ctx->pending_buffer;
+	ctx->incoming_buffer_length = (uint32_t) len;
+	ctx->total_length += len;
+
+	ctx->pending_buffer = (const uint8_t *)ctx->pending_buffer + len;
+	ctx->pending_length -= len;
+
+	ctx->status = (ctx->pending_length == 0 && (ctx->pending_flags & HASH_LAST)) ?
+	    (HASH_CTX_STS) (HASH_CTX_STS_PROCESSING | HASH_CTX_STS_LAST) :
+	    HASH_CTX_STS_PROCESSING;
+
+	return 1;
+}
+
+#endif // _SHA256_CTX_SUBMIT_64_H_
@@ -0,0 +1,243 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha256_mb.h"
+
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+
+#define TEST_BUFS 48
+#define MAX_LEN (3 * SHA256_CSUM_SLICE + 200)
+
+extern void sha256_ref(uint8_t * input_data, uint32_t * digest, uint32_t len);
+
+static uint8_t *bufs[TEST_BUFS];
+static uint32_t lens[TEST_BUFS];
+static uint64_t seeds[TEST_BUFS];
+
+static uint32_t crc32c_ref(uint32_t crc, const uint8_t * buf, uint64_t len)
+{
+	int i;
+
+	crc = ~crc;
+	while (len--) {
+		crc ^= *buf++;
+		for (i = 0; i < 8; i++)
+			crc = (crc >> 1) ^ (0x82f63b78 & (0 - (crc & 1)));
+	}
+	return ~crc;
+}
+
+#define P1 0x9e3779b185ebca87ULL
+#define P2 0xc2b2ae3d27d4eb4fULL
+#define P3 0x165667b19e3779f9ULL
+#define P4 0x85ebca77c2b2ae63ULL
+#define P5 0x27d4eb2f165667c5ULL
+
+static uint64_t rol(uint64_t x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t rd(const uint8_t * p, int n)
+{
+	uint64_t x = 0;
+
+	while (n--)
+		x = (x << 8) | p[n];
+	return x;
+}
+
+static uint64_t xxh64_ref(const uint8_t * p, uint64_t len, uint64_t seed)
+{
+	const uint8_t *end = p + len;
+	uint64_t v[4] = { seed + P1 + P2, seed + P2, seed, seed - P1 };
+	uint64_t h;
+	int i;
+
+	if (len >= 32) {
+		for (; end - p >= 32; p += 32)
+			for (i = 0; i < 4; i++)
+				v[i] = rol(v[i] + rd(p + 8 * i, 8) * P2, 31) * P1;
+		h = rol(v[0], 1) + rol(v[1], 7) + rol(v[2], 12) + rol(v[3], 18);
+		for (i = 0; i < 4; i++)
+			h = (h ^ (rol(v[i] * P2, 31) * P1)) * P1 + P4;
+	} else
+		h = seed + P5;
+
+	h += len;
+	for (; end - p >= 8; p += 8)
+		h = rol(h ^ (rol(rd(p, 8) * P2, 31) * P1), 27) * P1 + P4;
+	if (end - p >= 4) {
+		h = rol(h ^ (rd(p, 4) * P1), 23) * P2 + P3;
+		p += 4;
+	}
+	for (; p < end; p++)
+		h = rol(h ^ (*p * P5), 11) * P1;
+
+	h = (h ^ (h >> 33)) * P2;
+	h = (h ^ (h >> 29)) * P3;
+	return h ^ (h >> 32);
+}
+
+static int check_ctx(SHA256_CSUM_HASH_CTX * cctx)
+{
+	uint32_t digest_ref[SHA256_DIGEST_NWORDS];
+	uint64_t i = (uint64_t) cctx->ctx.user_data;
+	uint64_t csum_ref;
+
+	if (cctx->ctx.error || !hash_ctx_complete(&cctx->ctx))
+		return 1;
+
+	sha256_ref(bufs[i], digest_ref, lens[i]);
+	if (memcmp(digest_ref, cctx->ctx.job.result_digest, sizeof(digest_ref)))
+		return 1;
+
+	if (cctx->alg == SHA256_CSUM_CRC32C)
+		csum_ref = crc32c_ref((uint32_t) seeds[i], bufs[i], lens[i]);
+	else
+		csum_ref = xxh64_ref(bufs[i], lens[i], seeds[i]);
+
+	return cctx->csum != csum_ref;
+}
+
+static int retire(SHA256_CSUM_HASH_CTX * cctx, uint32_t * checked)
+{
+	if (cctx == NULL || !hash_ctx_complete(&cctx->ctx))
+		return 0;
+
+	(*checked)++;
+	return check_ctx(cctx);
+}
+
+static int run_jobs(SHA256_CSUM_HASH_CTX_MGR * mgr, SHA256_CSUM_HASH_CTX * ctxpool,
+		    uint32_t piece)
+{
+	uint32_t pos[TEST_BUFS];
+	uint32_t i, len, left, checked = 0;
+	HASH_CTX_FLAG flags;
+
+	for (i = 0; i < TEST_BUFS; i++) {
+		sha256_csum_ctx_init(&ctxpool[i], i & 1 ? SHA256_CSUM_XXH64 : SHA256_CSUM_CRC32C,
+				     seeds[i]);
+		ctxpool[i].ctx.user_data = (void *)((uint64_t) i);
+		pos[i] = 0;
+	}
+
+	// Feed every buffer in pieces of piece + i bytes until all are submitted
+	do {
+		left = 0;
+		for (i = 0; i < TEST_BUFS; i++) {
+			if (pos[i] > lens[i])
+				continue;
+			if (hash_ctx_processing(&ctxpool[i].ctx)) {
+				left++;
+				continue;
+			}
+
+			len = lens[i] - pos[i];
+			flags = pos[i] ? HASH_UPDATE : HASH_FIRST;
+			if (len > piece + i)
+				len = piece + i;
+			else
+				flags |= HASH_LAST;
+
+			if (retire(sha256_csum_ctx_mgr_submit(mgr, &ctxpool[i], bufs[i] + pos[i],
+							      len, flags), &checked))
+				return 1;
+
+			// Step past the end once the last piece is in
+			pos[i] += (flags & HASH_LAST) ? len + 1 : len;
+			left++;
+		}
+		if (retire(sha256_csum_ctx_mgr_flush(mgr), &checked))
+			return 1;
+	} while (left);
+
+	return checked != TEST_BUFS;
+}
+
+int main(void)
+{
+	SHA256_CSUM_HASH_CTX_MGR *mgr = NULL;
+	SHA256_CSUM_HASH_CTX ctxpool[TEST_BUFS];
+	static const uint8_t kat_msg[] = "123456789";
+	uint32_t i, j;
+	int ret;
+
+	printf("sha256_csum_mb test, %d buffers: ", TEST_BUFS);
+
+	ret = posix_memalign((void *)&mgr, 16, sizeof(SHA256_CSUM_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+	sha256_csum_ctx_mgr_init(mgr);
+
+	// Known answers for the reference checksums
+	if (crc32c_ref(0, kat_msg, 9) != 0xe3069283 ||
+	    xxh64_ref(kat_msg, 0, 0) != 0xef46db3751d8e999ULL ||
+	    xxh64_ref((const uint8_t *)"abc", 3, 0) != 0x44bc2cf5ad770999ULL) {
+		printf("Test failed, reference checksum\n");
+		return 1;
+	}
+
+	srand(TEST_SEED);
+	for (i = 0; i < TEST_BUFS; i++) {
+		// Lengths around the slice and stripe boundaries, then random ones
+		lens[i] = i < 8 ? (i / 2) * SHA256_CSUM_SLICE + (i & 1) * 31 : rand() % MAX_LEN;
+		seeds[i] = i < 8 ? 0 : ((uint64_t) rand() << 32) | rand();
+		bufs[i] = (uint8_t *) malloc(lens[i] + 1);
+		if (bufs[i] == NULL) {
+			printf("malloc failed test aborted\n");
+			return 1;
+		}
+		for (j = 0; j < lens[i]; j++)
+			bufs[i][j] = rand();
+	}
+
+	// Whole buffers, then pieces smaller than, around and above a slice
+	if (run_jobs(mgr, ctxpool, MAX_LEN) || run_jobs(mgr, ctxpool, 1) ||
+	    run_jobs(mgr, ctxpool, 61) || run_jobs(mgr, ctxpool, 1000) ||
+	    run_jobs(mgr, ctxpool, SHA256_CSUM_SLICE + 5)) {
+		printf("Test failed\n");
+		return 1;
+	}
+
+	for (i = 0; i < TEST_BUFS; i++)
+		free(bufs[i]);
+	free(mgr);
+
+	printf("Pass\n");
+	return 0;
+}
@@ -0,0 +1,249 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "sha256_mb_pool.h"
+#include "endian_helper.h"
+
+#define HKDF_SHA256_DIGEST_BYTES	(SHA256_DIGEST_NWORDS * sizeof(SHA256_WORD_T))
+#define HKDF_SHA256_MAX_OKM_LEN	(255 * HKDF_SHA256_DIGEST_BYTES)
+
+/*
+ * One HKDF step of one connection: a run of HMACs under the same key, the
+ * salt for extract or the PRK for expand. The ipad and opad blocks are hashed
+ * once into keyed midstates, and every HMAC of the run is resumed from them,
+ * so expand costs two compressions per output block beyond its message.
+ */
+struct hkdf_sha256_job {
+	uint8_t k0[SHA256_BLOCK_SIZE];	// key, hashed if longer than a block
+	uint8_t block[SHA256_BLOCK_SIZE];	// K0 ^ ipad or K0 ^ opad in flight
+	SHA256_MIDSTATE ipad;
+	SHA256_MIDSTATE opad;
+	uint8_t t[HKDF_SHA256_DIGEST_BYTES];	// inner digest, then T(i)
+	const void *key;
+	uint32_t key_len;
+	const void *part[3];	// pieces of the inner message
+	uint32_t part_len[3];
+	uint32_t nparts, cur;
+	uint8_t counter;	// expand block number i
+	enum { HKDF_KEY, HKDF_IPAD, HKDF_OPAD, HKDF_INNER, HKDF_OUTER } stage;
+	uint8_t *out;
+	uint32_t out_len;	// output bytes still to produce
+};
+
+static void hkdf_sha256_digest_bytes(uint8_t * out, const SHA256_WORD_T * digest)
+{
+	SHA256_WORD_T w;
+	int i;
+
+	for (i = 0; i < SHA256_DIGEST_NWORDS; i++) {
+		w = to_be32(digest[i]);
+		memcpy(&out[i * sizeof(w)], &w, sizeof(w));
+	}
+}
+
+// Hash K0 ^ pad from the initial digest, leaving its midstate in the ctx
+static SHA256_HASH_CTX *hkdf_sha256_pad_submit(SHA256_HASH_CTX_MGR * mgr,
+					       SHA256_HASH_CTX * ctx, uint8_t pad)
+{
+	struct hkdf_sha256_job *job = ctx->user_data;
+	int i;
+
+	for (i = 0; i < SHA256_BLOCK_SIZE; i++)
+		job->block[i] = job->k0[i] ^ pad;
+
+	return sha256_ctx_mgr_submit(mgr, ctx, job->block, SHA256_BLOCK_SIZE, HASH_FIRST);
+}
+
+// Submit the next piece of the inner message, the last one with HASH_LAST
+static SHA256_HASH_CTX *hkdf_sha256_inner_submit(SHA256_HASH_CTX_MGR * mgr,
+						 SHA256_HASH_CTX * ctx)
+{
+	struct hkdf_sha256_job *job = ctx->user_data;
+	uint32_t i = job->cur++;
+
+	return sha256_ctx_mgr_submit(mgr, ctx, job->part[i], job->part_len[i],
+				     job->cur == job->nparts ? HASH_LAST : HASH_UPDATE);
+}
+
+static SHA256_HASH_CTX *hkdf_sha256_start(SHA256_HASH_CTX_MGR * mgr, SHA256_HASH_CTX * ctx,
+					  uint32_t i, uint32_t lane, void *arg)
+{
+	struct hkdf_sha256_job *job = (struct hkdf_sha256_job *)arg + i;
+
+	ctx->user_data = job;
+	ctx->error = HASH_CTX_ERROR_NONE;
+
+	if (job->key_len > SHA256_BLOCK_SIZE) {
+		job->stage = HKDF_KEY;
+		return sha256_ctx_mgr_submit(mgr, ctx, job->key, job->key_len, HASH_ENTIRE);
+	}
+
+	memcpy(job->k0, job->key, job->key_len);
+	job->stage = HKDF_IPAD;
+	return hkdf_sha256_pad_submit(mgr, ctx, 0x36);
+}
+
+/*
+ * Start the next hash of the job of a ctx handed back by the manager.
+ * Finished jobs have their output stored.
+ */
+static int hkdf_sha256_next(SHA256_HASH_CTX_MGR * mgr, SHA256_HASH_CTX ** ctx, void *arg)
+{
+	struct hkdf_sha256_job *job = (*ctx)->user_data;
+	uint32_t len;
+
+	if (job->stage == HKDF_KEY) {
+		hkdf_sha256_digest_bytes(job->k0, (*ctx)->job.result_digest);
+		job->stage = HKDF_IPAD;
+		*ctx = hkdf_sha256_pad_submit(mgr, *ctx, 0x36);
+	} else if (job->stage == HKDF_IPAD) {
+		sha256_ctx_midstate_save(*ctx, &job->ipad);
+		job->stage = HKDF_OPAD;
+		*ctx = hkdf_sha256_pad_submit(mgr, *ctx, 0x5c);
+	} else if (job->stage == HKDF_OPAD) {
+		sha256_ctx_midstate_save(*ctx, &job->opad);
+		job->stage = HKDF_INNER;
+		sha256_ctx_midstate_restore(*ctx, &job->ipad);
+		*ctx = hkdf_sha256_inner_submit(mgr, *ctx);
+	} else if (job->stage == HKDF_INNER && job->cur < job->nparts) {
+		*ctx = hkdf_sha256_inner_submit(mgr, *ctx);
+	} else if (job->stage == HKDF_INNER) {
+		hkdf_sha256_digest_bytes(job->t, (*ctx)->job.result_digest);
+		job->stage = HKDF_OUTER;
+		sha256_ctx_midstate_restore(*ctx, &job->opad);
+		*ctx = sha256_ctx_mgr_submit(mgr, *ctx, job->t, sizeof(job->t), HASH_LAST);
+	} else {
+		hkdf_sha256_digest_bytes(job->t, (*ctx)->job.result_digest);
+		len = job->out_len < sizeof(job->t) ? job->out_len : sizeof(job->t);
+		memcpy(job->out, job->t, len);
+		job->out += len;
+		job->out_len -= len;
+
+		if (job->out_len == 0)
+			return 0;
+
+		// T(i) = HMAC(PRK, T(i-1) | info | i)
+		job->counter++;
+		job->part[0] = job->t;
+		job->part_len[0] = sizeof(job->t);
+		job->cur = 0;
+		job->nparts = 3;
+		job->stage = HKDF_INNER;
+		sha256_ctx_midstate_restore(*ctx, &job->ipad);
+		*ctx = hkdf_sha256_inner_submit(mgr, *ctx);
+	}
+
+	return 1;
+}
+
+// Run all jobs with every lane of the manager kept busy
+static int hkdf_sha256_run(struct hkdf_sha256_job *jobs, uint32_t n)
+{
+	int ret = sha256_mb_pool_run(n, hkdf_sha256_start, hkdf_sha256_next, jobs);
+
+	memset(jobs, 0, n * sizeof(*jobs));
+	return ret;
+}
+
+int hkdf_sha256_mb_extract(const void *salt[], const uint32_t salt_lens[],
+			   const void *ikm[], const uint32_t ikm_lens[], uint8_t * prk[],
+			   uint32_t n)
+{
+	struct hkdf_sha256_job *jobs;
+	uint32_t i;
+	int ret;
+
+	if (n == 0)
+		return 0;
+
+	jobs = (struct hkdf_sha256_job *)calloc(n, sizeof(*jobs));
+	if (jobs == NULL)
+		return -1;
+
+	// PRK = HMAC(salt, IKM), a missing salt being an empty key
+	for (i = 0; i < n; i++) {
+		jobs[i].key = salt[i];
+		jobs[i].key_len = salt_lens[i];
+		jobs[i].part[0] = ikm[i];
+		jobs[i].part_len[0] = ikm_lens[i];
+		jobs[i].nparts = 1;
+		jobs[i].out = prk[i];
+		jobs[i].out_len = HKDF_SHA256_DIGEST_BYTES;
+	}
+
+	ret = hkdf_sha256_run(jobs, n);
+	free(jobs);
+	return ret;
+}
+
+int hkdf_sha256_mb_expand(const void *prk[], const uint32_t prk_lens[],
+			  const void *info[], const uint32_t info_lens[],
+			  uint8_t * okm[], const uint32_t okm_lens[], uint32_t n)
+{
+	struct hkdf_sha256_job *jobs, *job;
+	uint32_t i, k;
+	int ret;
+
+	if (n == 0)
+		return 0;
+
+	for (i = 0; i < n; i++)
+		if (okm_lens[i] > HKDF_SHA256_MAX_OKM_LEN)
+			return -1;
+
+	jobs = (struct hkdf_sha256_job *)calloc(n, sizeof(*jobs));
+	if (jobs == NULL)
+		return -1;
+
+	// T(1) = HMAC(PRK, info | 0x01), later blocks chain from the previous one.
+	// Connections asking for no output are left out.
+	for (i = 0, k = 0; i < n; i++) {
+		if (okm_lens[i] == 0)
+			continue;
+
+		job = &jobs[k++];
+		job->key = prk[i];
+		job->key_len = prk_lens[i];
+		job->counter = 1;
+		job->part[1] = info[i];
+		job->part_len[1] = info_lens[i];
+		job->part[2] = &job->counter;
+		job->part_len[2] = 1;
+		job->cur = 1;
+		job->nparts = 3;
+		job->out = okm[i];
+		job->out_len = okm_lens[i];
+	}
+
+	ret = hkdf_sha256_run(jobs, k);
+	free(jobs);
+	return ret;
+}
@@ -0,0 +1,193 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha256_mb.h"
+
+#define DIGEST_BYTES (SHA256_DIGEST_NWORDS * sizeof(SHA256_WORD_T))
+#define MAX_FIELD_LEN 300
+#define MAX_OKM_LEN 160
+#define NUM_JOBS 100
+
+// RFC 5869 test cases and extra ones with long salts, empty IKM and long info
+struct field {
+	uint8_t start, step;
+	uint32_t len;
+};
+
+static const struct {
+	struct field salt, ikm, info;
+	uint32_t okm_len;
+	uint8_t prk[DIGEST_BYTES];
+	uint8_t okm[MAX_OKM_LEN];
+} vecs[] = {
+	{{0x00, 1, 13}, {0x0b, 0, 22}, {0xf0, 1, 10}, 42,
+	 {0x07, 0x77, 0x09, 0x36, 0x2c, 0x2e, 0x32, 0xdf, 0x0d, 0xdc, 0x3f, 0x0d,
+	  0xc4, 0x7b, 0xba, 0x63, 0x90, 0xb6, 0xc7, 0x3b, 0xb5, 0x0f, 0x9c, 0x31,
+	  0x22, 0xec, 0x84, 0x4a, 0xd7, 0xc2, 0xb3, 0xe5},
+	 {0x3c, 0xb2, 0x5f, 0x25, 0xfa, 0xac, 0xd5, 0x7a, 0x90, 0x43, 0x4f, 0x64,
+	  0xd0, 0x36, 0x2f, 0x2a, 0x2d, 0x2d, 0x0a, 0x90, 0xcf, 0x1a, 0x5a, 0x4c,
+	  0x5d, 0xb0, 0x2d, 0x56, 0xec, 0xc4, 0xc5, 0xbf, 0x34, 0x00, 0x72, 0x08,
+	  0xd5, 0xb8, 0x87, 0x18, 0x58, 0x65}},
+	{{0x60, 1, 80}, {0x00, 1, 80}, {0xb0, 1, 80}, 82,
+	 {0x06, 0xa6, 0xb8, 0x8c, 0x58, 0x53, 0x36, 0x1a, 0x06, 0x10, 0x4c, 0x9c,
+	  0xeb, 0x35, 0xb4, 0x5c, 0xef, 0x76, 0x00, 0x14, 0x90, 0x46, 0x71, 0x01,
+	  0x4a, 0x19, 0x3f, 0x40, 0xc1, 0x5f, 0xc2, 0x44},
+	 {0xb1, 0x1e, 0x39, 0x8d, 0xc8, 0x03, 0x27, 0xa1, 0xc8, 0xe7, 0xf7, 0x8c,
+	  0x59, 0x6a, 0x49, 0x34, 0x4f, 0x01, 0x2e, 0xda, 0x2d, 0x4e, 0xfa, 0xd8,
+	  0xa0, 0x50, 0xcc, 0x4c, 0x19, 0xaf, 0xa9, 0x7c, 0x59, 0x04, 0x5a, 0x99,
+	  0xca, 0xc7, 0x82, 0x72, 0x71, 0xcb, 0x41, 0xc6, 0x5e, 0x59, 0x0e, 0x09,
+	  0xda, 0x32, 0x75, 0x60, 0x0c, 0x2f, 0x09, 0xb8, 0x36, 0x77, 0x93, 0xa9,
+	  0xac, 0xa3, 0xdb, 0x71, 0xcc, 0x30, 0xc5, 0x81, 0x79, 0xec, 0x3e, 0x87,
+	  0xc1, 0x4c, 0x01, 0xd5, 0xc1, 0xf3, 0x43, 0x4f, 0x1d, 0x87}},
+	{{0x00, 0, 0}, {0x0b, 0, 22}, {0x00, 0, 0}, 42,
+	 {0x19, 0xef, 0x24, 0xa3, 0x2c, 0x71, 0x7b, 0x16, 0x7f, 0x33, 0xa9, 0x1d,
+	  0x6f, 0x64, 0x8b, 0xdf, 0x96, 0x59, 0x67, 0x76, 0xaf, 0xdb, 0x63, 0x77,
+	  0xac, 0x43, 0x4c, 0x1c, 0x29, 0x3c, 0xcb, 0x04},
+	 {0x8d, 0xa4, 0xe7, 0x75, 0xa5, 0x63, 0xc1, 0x8f, 0x71, 0x5f, 0x80, 0x2a,
+	  0x06, 0x3c, 0x5a, 0x31, 0xb8, 0xa1, 0x1f, 0x5c, 0x5e, 0xe1, 0x87, 0x9e,
+	  0xc3, 0x45, 0x4e, 0x5f, 0x3c, 0x73, 0x8d, 0x2d, 0x9d, 0x20, 0x13, 0x95,
+	  0xfa, 0xa4, 0xb6, 0x1a, 0x96, 0xc8}},
+	{{0x11, 7, 200}, {0x23, 3, 33}, {0x5a, 1, 1}, 1,
+	 {0xec, 0x6d, 0xf0, 0x06, 0x65, 0x5d, 0x9e, 0x44, 0x6b, 0x28, 0xaf, 0xc9,
+	  0x2a, 0xa1, 0x3c, 0x24, 0xc6, 0x55, 0xeb, 0xc0, 0x03, 0x84, 0x36, 0xef,
+	  0x79, 0xd0, 0x99, 0x5c, 0x92, 0x2b, 0xc0, 0x09},
+	 {0x67}},
+	{{0x01, 1, 32}, {0x99, 5, 300}, {0x42, 9, 150}, 101,
+	 {0x30, 0xf1, 0x71, 0x03, 0x97, 0x69, 0x8f, 0x54, 0x50, 0xb9, 0xdd, 0x43,
+	  0xb6, 0xc6, 0xe1, 0x30, 0x5a, 0xb7, 0x88, 0xcf, 0xd1, 0xd0, 0x46, 0xe2,
+	  0xbb, 0x55, 0xd1, 0x47, 0x4f, 0x87, 0x21, 0x77},
+	 {0x87, 0x96, 0x74, 0xa1, 0x56, 0x59, 0x54, 0x97, 0xf8, 0x3a, 0xe5, 0xe2,
+	  0xb3, 0xbe, 0xa4, 0xd2, 0x82, 0x3f, 0xbb, 0x01, 0x67, 0x7b, 0x7f, 0xd5,
+	  0x51, 0x88, 0x60, 0x9f, 0x8b, 0x99, 0xd1, 0xf8, 0x91, 0xbc, 0x56, 0x43,
+	  0x08, 0xcd, 0x5c, 0x79, 0x7b, 0x54, 0x4e, 0x69, 0xc3, 0xc1, 0xf4, 0xee,
+	  0x8f, 0x0c, 0x67, 0x9c, 0xe4, 0x74, 0xf1, 0xe6, 0x6a, 0xeb, 0x5e, 0x8e,
+	  0x32, 0x53, 0xaf, 0x21, 0xbc, 0x51, 0x2c, 0x30, 0xf3, 0x5c, 0x6e, 0xae,
+	  0xa9, 0xfa, 0xf7, 0xdd, 0x44, 0x63, 0x40, 0x12, 0xf5, 0xcf, 0x66, 0x07,
+	  0xf6, 0xa9, 0x97, 0xef, 0xe2, 0x2c, 0x70, 0xef, 0x8c, 0x0b, 0x14, 0xff,
+	  0xc8, 0x52, 0x03, 0x02, 0x4e}},
+	{{0x7f, 3, 1}, {0x00, 0, 0}, {0x10, 1, 255}, 64,
+	 {0xa6, 0xa7, 0x0a, 0xa0, 0x91, 0x0f, 0xbe, 0x20, 0xfe, 0x85, 0x50, 0x41,
+	  0xb6, 0xae, 0x21, 0x3d, 0x59, 0x60, 0x90, 0x04, 0x52, 0x24, 0x2a, 0x16,
+	  0x2b, 0x99, 0x97, 0xe9, 0xc4, 0x0c, 0x05, 0x71},
+	 {0xee, 0x21, 0x82, 0x9e, 0x86, 0x2d, 0xf5, 0x10, 0xa7, 0x27, 0x0a, 0x69,
+	  0x8b, 0x1a, 0xb2, 0xaa, 0xae, 0xec, 0xa1, 0x92, 0x87, 0x97, 0xef, 0xdb,
+	  0xee, 0x88, 0xb8, 0xd1, 0xba, 0xa9, 0x6e, 0xe5, 0x22, 0xb5, 0x31, 0x73,
+	  0xe1, 0x49, 0x0f, 0xe7, 0x3b, 0x1d, 0x44, 0xbc, 0xa6, 0x7b, 0xff, 0x88,
+	  0xf6, 0xf9, 0x6c, 0x8c, 0xfa, 0x54, 0xdf, 0x43, 0x0b, 0xce, 0x2d, 0x64,
+	  0xfd, 0x3e, 0x12, 0xe2}}
+};
+
+#define NUM_VECS (sizeof(vecs) / sizeof(vecs[0]))
+
+static uint8_t fields[NUM_VECS][3][MAX_FIELD_LEN];
+static uint8_t prk[NUM_JOBS][DIGEST_BYTES], okm[NUM_JOBS][MAX_OKM_LEN];
+
+static void fill(uint8_t * buf, const struct field *f)
+{
+	uint32_t j;
+
+	for (j = 0; j < f->len; j++)
+		buf[j] = f->start + f->step * j;
+}
+
+int main(void)
+{
+	const void *salt[NUM_JOBS], *ikm[NUM_JOBS], *info[NUM_JOBS], *prk_ptr[NUM_JOBS];
+	uint32_t salt_lens[NUM_JOBS], ikm_lens[NUM_JOBS], info_lens[NUM_JOBS];
+	uint32_t prk_lens[NUM_JOBS], okm_lens[NUM_JOBS];
+	uint8_t *prk_out[NUM_JOBS], *okm_out[NUM_JOBS];
+	uint32_t i, v;
+
+	printf("hkdf_sha256_mb test: ");
+
+	for (v = 0; v < NUM_VECS; v++) {
+		fill(fields[v][0], &vecs[v].salt);
+		fill(fields[v][1], &vecs[v].ikm);
+		fill(fields[v][2], &vecs[v].info);
+	}
+
+	// Interleave the vectors so every lane sees a mix of lengths
+	for (i = 0; i < NUM_JOBS; i++) {
+		v = i % NUM_VECS;
+		salt[i] = fields[v][0];
+		salt_lens[i] = vecs[v].salt.len;
+		ikm[i] = fields[v][1];
+		ikm_lens[i] = vecs[v].ikm.len;
+		info[i] = fields[v][2];
+		info_lens[i] = vecs[v].info.len;
+		prk_ptr[i] = prk[i];
+		prk_lens[i] = DIGEST_BYTES;
+		prk_out[i] = prk[i];
+		okm_out[i] = okm[i];
+		okm_lens[i] = vecs[v].okm_len;
+	}
+
+	if (hkdf_sha256_mb_extract(salt, salt_lens, ikm, ikm_lens, prk_out, NUM_JOBS)) {
+		printf("extract returned an error\n");
+		return 1;
+	}
+
+	for (i = 0; i < NUM_JOBS; i++) {
+		if (memcmp(prk[i], vecs[i % NUM_VECS].prk, DIGEST_BYTES)) {
+			printf("Test failed, extract job %d\n", i);
+			return 1;
+		}
+	}
+	putchar('.');
+
+	memset(okm, 0, sizeof(okm));
+	if (hkdf_sha256_mb_expand(prk_ptr, prk_lens, info, info_lens, okm_out, okm_lens, NUM_JOBS)) {
+		printf("expand returned an error\n");
+		return 1;
+	}
+
+	for (i = 0; i < NUM_JOBS; i++) {
+		v = i % NUM_VECS;
+		if (memcmp(okm[i], vecs[v].okm, vecs[v].okm_len) || okm[i][vecs[v].okm_len]) {
+			printf("Test failed, expand job %d\n", i);
+			return 1;
+		}
+	}
+	putchar('.');
+
+	// No more than 255 blocks of output
+	okm_lens[NUM_JOBS - 1] = 255 * DIGEST_BYTES + 1;
+	if (hkdf_sha256_mb_expand(prk_ptr, prk_lens, info, info_lens, okm_out, okm_lens, NUM_JOBS)
+	    == 0) {
+		printf("Overlong output not rejected\n");
+		return 1;
+	}
+
+	printf(" Pass\n");
+
+	return 0;
+}
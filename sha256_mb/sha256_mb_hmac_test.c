@@ -0,0 +1,227 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha256_mb.h"
+#include "endian_helper.h"
+
+#define KEYS 4
+#define MSGS 4
+#define LONG_MSG_LEN 1000
+#define NUM_JOBS 1000
+
+static const uint32_t key_lens[KEYS] = { 0, 20, 64, 131 };
+
+static uint8_t msg1[] = "Hi There";
+static uint8_t msg2[] = "what do ya want for nothing?";
+static uint8_t msg3[50];
+static uint8_t msg4[LONG_MSG_LEN];
+
+static uint8_t *msgs[MSGS] = { msg1, msg2, msg3, msg4 };
+static const uint32_t msg_lens[MSGS] =
+    { sizeof(msg1) - 1, sizeof(msg2) - 1, sizeof(msg3), sizeof(msg4) };
+
+static uint8_t exp_mac[KEYS][MSGS][32] = {
+	{
+	 {0xe4, 0x84, 0x11, 0x26, 0x27, 0x15, 0xc8, 0x37, 0x0c, 0xd5,
+	  0xe7, 0xbf, 0x8e, 0x82, 0xbe, 0xf5, 0x3b, 0xd5, 0x37, 0x12,
+	  0xd0, 0x07, 0xf3, 0x42, 0x93, 0x51, 0x84, 0x3b, 0x77, 0xc7,
+	  0xbb, 0x9b},
+	 {0x76, 0xd9, 0xe7, 0x19, 0x4e, 0x7d, 0xbc, 0x3a, 0xa0, 0x0b,
+	  0xbe, 0x8f, 0xfb, 0x9f, 0x6f, 0xcb, 0x5a, 0x93, 0x21, 0x70,
+	  0xf9, 0x71, 0xf9, 0x48, 0xbb, 0x2a, 0xb6, 0x16, 0x07, 0xd2,
+	  0xb9, 0xd6},
+	 {0x65, 0x8c, 0x19, 0x2b, 0x47, 0xd1, 0xc8, 0x4b, 0xc7, 0xd5,
+	  0xee, 0x38, 0xca, 0xa7, 0x58, 0x64, 0xfb, 0xf4, 0x3e, 0x79,
+	  0xbd, 0x18, 0xdb, 0x6c, 0x5f, 0xa8, 0x14, 0xed, 0x0d, 0x9c,
+	  0x4a, 0xb3},
+	 {0x70, 0xe6, 0xaa, 0xfe, 0x31, 0xaa, 0xa4, 0xe1, 0x7e, 0xd7,
+	  0x5c, 0x37, 0x7b, 0x08, 0xac, 0x2f, 0x67, 0xce, 0xd0, 0xf9,
+	  0x17, 0xcf, 0x38, 0x5c, 0xc6, 0x07, 0xa1, 0x1e, 0x82, 0x9c,
+	  0x9f, 0x01},
+	 },
+	{
+	 {0x7d, 0x5f, 0xe2, 0x07, 0xf3, 0x48, 0x65, 0x51, 0x09, 0xcc,
+	  0x51, 0xa2, 0x58, 0xfa, 0x63, 0xf1, 0x38, 0x90, 0x9d, 0xcd,
+	  0x1f, 0x3e, 0x03, 0xd1, 0x84, 0x8b, 0x6b, 0x47, 0x6a, 0xbe,
+	  0xf5, 0x96},
+	 {0x01, 0x79, 0x8d, 0xed, 0x41, 0x9e, 0x97, 0x48, 0x8e, 0xc2,
+	  0x02, 0xa3, 0x48, 0xed, 0x39, 0x6b, 0x8d, 0x61, 0x6f, 0xb6,
+	  0x6c, 0x7f, 0x32, 0xf9, 0x11, 0xca, 0x2e, 0x15, 0xbd, 0x26,
+	  0x82, 0xa7},
+	 {0xa5, 0x86, 0x60, 0x6c, 0xf0, 0x6d, 0x58, 0xe8, 0x52, 0x83,
+	  0xce, 0xc9, 0x02, 0x1b, 0xf6, 0xa5, 0x08, 0xdb, 0x3e, 0xd2,
+	  0xd5, 0xff, 0xe5, 0xbb, 0x2d, 0x89, 0x6e, 0x9d, 0x44, 0x89,
+	  0x66, 0xf7},
+	 {0xa0, 0x10, 0xfa, 0x53, 0x89, 0x33, 0xbf, 0xff, 0x5b, 0xbc,
+	  0x7c, 0x23, 0xe1, 0x35, 0x01, 0x30, 0x22, 0x56, 0x8a, 0x88,
+	  0x3b, 0xde, 0x0e, 0x00, 0x50, 0x7f, 0x02, 0x7d, 0x52, 0x84,
+	  0xcd, 0xa7},
+	 },
+	{
+	 {0xdc, 0x4e, 0xc5, 0xdc, 0x42, 0xeb, 0xf9, 0xdd, 0x8f, 0x34,
+	  0x40, 0x22, 0xf8, 0x36, 0xd7, 0x04, 0xdb, 0x12, 0x7b, 0xba,
+	  0xe7, 0x84, 0x01, 0x12, 0x91, 0xd9, 0xd5, 0x33, 0x70, 0xb8,
+	  0x79, 0x50},
+	 {0xb3, 0x5d, 0xeb, 0x88, 0x11, 0xe0, 0x9e, 0x64, 0xa0, 0x13,
+	  0x22, 0x2c, 0x37, 0x22, 0x4b, 0x62, 0x92, 0x35, 0xfc, 0x49,
+	  0x7d, 0xbe, 0x99, 0x2e, 0xc4, 0x4e, 0x02, 0x0a, 0xb1, 0x2c,
+	  0xfb, 0xcd},
+	 {0x5e, 0x7c, 0xb7, 0xa5, 0xa9, 0xba, 0x27, 0x31, 0xfe, 0xa3,
+	  0xf7, 0x2a, 0xee, 0x88, 0xff, 0xe9, 0x9b, 0xa3, 0x58, 0x07,
+	  0x3b, 0xcf, 0x87, 0x9b, 0xa6, 0x2e, 0x6b, 0x55, 0x55, 0x3d,
+	  0xb7, 0xe7},
+	 {0xfa, 0x7c, 0xbc, 0x60, 0xec, 0xe9, 0x54, 0x10, 0xd1, 0x23,
+	  0x19, 0xe6, 0x1b, 0xd1, 0x2d, 0xe7, 0x7c, 0xbb, 0xe1, 0x95,
+	  0x3a, 0xef, 0x30, 0x22, 0xae, 0x26, 0x5b, 0xd9, 0x2f, 0x9e,
+	  0xc1, 0x05},
+	 },
+	{
+	 {0xca, 0xb4, 0x53, 0x48, 0x68, 0xa8, 0x48, 0x6e, 0x7a, 0x6c,
+	  0xa0, 0x7e, 0xcc, 0x92, 0xc1, 0x05, 0xd2, 0xe9, 0x11, 0x3f,
+	  0x82, 0xb3, 0x36, 0xc5, 0xcf, 0xae, 0x41, 0xd9, 0x4c, 0xc8,
+	  0x7a, 0x97},
+	 {0xc2, 0x30, 0x0b, 0xb4, 0xb5, 0x7e, 0xe8, 0xdd, 0x03, 0xae,
+	  0x0d, 0x05, 0xd9, 0xe0, 0x5c, 0x20, 0x01, 0xeb, 0x65, 0x09,
+	  0xa3, 0x88, 0x67, 0xab, 0xdb, 0xd2, 0x08, 0x79, 0x73, 0xb5,
+	  0x10, 0x07},
+	 {0xba, 0xc0, 0x18, 0x5e, 0xc3, 0x71, 0x15, 0x02, 0x6b, 0xe7,
+	  0xfe, 0x85, 0xb1, 0x67, 0x75, 0xcc, 0xea, 0x95, 0x94, 0x6d,
+	  0x4d, 0xaa, 0x3b, 0xb4, 0x31, 0x6b, 0x26, 0x5e, 0x28, 0xc8,
+	  0x1f, 0xca},
+	 {0x94, 0xde, 0xab, 0xfb, 0xf7, 0xe1, 0xee, 0x7c, 0x0d, 0xd0,
+	  0xdf, 0xe2, 0xaa, 0x08, 0xbb, 0xaa, 0xf6, 0x91, 0x01, 0x8f,
+	  0x73, 0x8d, 0x66, 0x1c, 0xb9, 0x57, 0x3e, 0x08, 0xe4, 0xa9,
+	  0xf2, 0x96},
+	 },
+};
+
+// MAC of a completed ctx in byte order
+static void mac_bytes(uint8_t * out, HMAC_SHA256_HASH_CTX * hctx)
+{
+	uint32_t w;
+	int i;
+
+	for (i = 0; i < SHA256_DIGEST_NWORDS; i++) {
+		w = to_be32(hctx->ctx.job.result_digest[i]);
+		memcpy(out + i * sizeof(w), &w, sizeof(w));
+	}
+}
+
+static int check_mac(HMAC_SHA256_HASH_CTX * hctx, uint32_t job)
+{
+	uint8_t mac[sizeof(exp_mac[0][0])];
+
+	if (hctx->ctx.error || !hash_ctx_complete(&hctx->ctx))
+		return 1;
+
+	mac_bytes(mac, hctx);
+	return memcmp(mac, exp_mac[job % KEYS][job % MSGS], sizeof(mac));
+}
+
+int main(void)
+{
+	HMAC_SHA256_HASH_CTX_MGR *mgr = NULL;
+	HMAC_SHA256_HASH_CTX ctxpool[NUM_JOBS], *hctx;
+	HMAC_SHA256_KEY keys[KEYS];
+	uint8_t key[256];
+	uint32_t i, k, len, checked = 0;
+	int ret;
+
+	printf("hmac_sha256_mb test, %d jobs: ", NUM_JOBS);
+
+	ret = posix_memalign((void *)&mgr, 16, sizeof(HMAC_SHA256_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	memset(msg3, 0xdd, sizeof(msg3));
+	for (i = 0; i < LONG_MSG_LEN; i++)
+		msg4[i] = i * 13 + 5;
+	for (i = 0; i < sizeof(key); i++)
+		key[i] = i * 7 + 1;
+	for (k = 0; k < KEYS; k++)
+		hmac_sha256_key_init(&keys[k], key, key_lens[k]);
+
+	hmac_sha256_ctx_mgr_init(mgr);
+
+	// Whole messages, all keys and lengths mixed in the same lanes
+	for (i = 0; i < NUM_JOBS; i++) {
+		hash_ctx_init(&ctxpool[i].ctx);
+		ctxpool[i].ctx.user_data = (void *)((uint64_t) i);
+
+		hctx = hmac_sha256_ctx_mgr_submit(mgr, &ctxpool[i], &keys[i % KEYS],
+						  msgs[i % MSGS], msg_lens[i % MSGS], HASH_ENTIRE);
+		if (hctx) {
+			if (check_mac(hctx, (uint64_t) hctx->ctx.user_data)) {
+				printf("Test failed, job %d\n", (int)(uint64_t) hctx->ctx.user_data);
+				return 1;
+			}
+			checked++;
+		}
+	}
+
+	while ((hctx = hmac_sha256_ctx_mgr_flush(mgr))) {
+		if (check_mac(hctx, (uint64_t) hctx->ctx.user_data)) {
+			printf("Test failed, job %d\n", (int)(uint64_t) hctx->ctx.user_data);
+			return 1;
+		}
+		checked++;
+	}
+
+	if (checked != NUM_JOBS) {
+		printf("only tested %d rather than %d\n", checked, NUM_JOBS);
+		return 1;
+	}
+
+	// Same ctxs rekeyed and fed in two parts
+	for (i = 0; i < KEYS * MSGS; i++) {
+		len = msg_lens[i % MSGS] / 3;
+
+		hmac_sha256_ctx_mgr_submit(mgr, &ctxpool[i], &keys[i % KEYS], msgs[i % MSGS], len,
+					   HASH_FIRST);
+		while (hmac_sha256_ctx_mgr_flush(mgr)) ;
+
+		hmac_sha256_ctx_mgr_submit(mgr, &ctxpool[i], NULL, msgs[i % MSGS] + len,
+					   msg_lens[i % MSGS] - len, HASH_LAST);
+		while (hmac_sha256_ctx_mgr_flush(mgr)) ;
+
+		if (check_mac(&ctxpool[i], i)) {
+			printf("Test failed, job %d in parts\n", i);
+			return 1;
+		}
+	}
+
+	printf("Pass\n");
+
+	return 0;
+}
@@ -65,6 +65,7 @@ FIELD   _lens,          4*16,    8
 FIELD   _unused_lanes,  8,      8
 FIELD   _ldata,         _LANE_DATA_size*16, _LANE_DATA_align
 FIELD   _num_lanes_inuse, 4,    4
+FIELD   _sb_threshold,  4,      4
 END_FIELDS
 
 %assign _MB_MGR_size    _FIELD_OFFSET
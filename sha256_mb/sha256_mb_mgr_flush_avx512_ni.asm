@@ -172,7 +172,8 @@ APPEND(skip_,I):
 	jz      len_is_0
 
 	; compare with shani-sb threshold, if num_lanes_inuse <= threshold, using shani func
-	cmp     dword [state + _num_lanes_inuse], SHA256_NI_SB_THRESHOLD_AVX512
+	mov     DWORD(tmp), [state + _num_lanes_inuse]
+	cmp     DWORD(tmp), [state + _sb_threshold]
 	ja      mb_processing
 
 	; lensN-len2=idx
@@ -159,12 +159,16 @@ sha256_mb_mgr_submit_sse_ni:
 
 	add     dword [state + _num_lanes_inuse], 1
 
-	cmp     unused_lanes, 0xF32	; we will process two jobs at the same time
-	jne 	return_null		; wait for another sha_ni job
+	cmp     unused_lanes, 0xF	; all 4 sse lanes are busy
+	je      start_loop
 
 	; compare with shani-sb threshold, if num_lanes_sse <= threshold, using shani func
-  %if SHA256_NI_SB_THRESHOLD_SSE >= 4   ; there are 4 lanes in sse mb
-  ; shani glue code
+	cmp     unused_lanes, 0xF32	; we will process two jobs at the same time
+	jne     return_null		; wait for another sha_ni job
+	cmp     dword [state + _sb_threshold], 4	; there are 4 lanes in sse mb
+	jb      return_null		; wait for all 4 lanes to be filled
+
+	; shani glue code
 	mov     DWORD(lens0), [state + _lens + 0*4]
 	mov     idx, lens0
 	mov     DWORD(lens1), [state + _lens + 1*4]
@@ -187,12 +191,9 @@ sha256_mb_mgr_submit_sse_ni:
 	; len is arg2, idx and nlane in r10
 	call    sha256_ni_x2
 	; state and idx are intact
-  %else
-  ; original mb code
-	cmp     unused_lanes, 0xF
-	jne     return_null
+	jmp     len_is_0
 
-    start_loop:
+start_loop:
 	; Find min length
 	mov     DWORD(lens0), [state + _lens + 0*4]
 	mov     idx, lens0
@@ -224,7 +225,6 @@ sha256_mb_mgr_submit_sse_ni:
 	; len is arg2
 	call     sha256_mb_x4_sse
 	; state and idx are intact
-  %endif
 len_is_0:
 	; process completed job "idx"
 	imul    lane_data, idx, _LANE_DATA_size
@@ -0,0 +1,191 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "sha256_mb_pool.h"
+#include "endian_helper.h"
+
+#define SHA256_DIGEST_BYTES	(SHA256_DIGEST_NWORDS * sizeof(SHA256_WORD_T))
+
+/*
+ * One block T_i = U_1 ^ ... ^ U_iter of a derived key. Apart from the salt
+ * in U_1, every HMAC in the chain is two compressions of a message of one
+ * digest, so block is kept pre-padded and handed to the manager as a whole
+ * block that never goes through partial_block_buffer.
+ */
+struct pbkdf2_sha256_job {
+	uint8_t block[SHA256_BLOCK_SIZE];	// U_j and its padding
+	SHA256_WORD_T t[SHA256_DIGEST_NWORDS];	// running xor of the U_j
+	const HMAC_SHA256_KEY *key;
+	const void *salt;
+	uint32_t salt_len;
+	uint8_t index[4];	// INT(i), big endian block number
+	uint32_t left;		// U_j still to compute
+	enum { PBKDF2_SALT, PBKDF2_INNER, PBKDF2_OUTER } stage;	// hash in flight
+	uint8_t *out;
+	uint32_t out_len;
+};
+
+// Hash the pre-padded block from a keyed midstate
+static SHA256_HASH_CTX *pbkdf2_sha256_compress(SHA256_HASH_CTX_MGR * mgr,
+					       SHA256_HASH_CTX * ctx,
+					       const SHA256_MIDSTATE * midstate)
+{
+	struct pbkdf2_sha256_job *job = ctx->user_data;
+
+	sha256_ctx_midstate_restore(ctx, midstate);
+	return sha256_ctx_mgr_submit(mgr, ctx, job->block, SHA256_BLOCK_SIZE, HASH_UPDATE);
+}
+
+// Store a digest as the message of the next compression
+static void pbkdf2_sha256_set_block(struct pbkdf2_sha256_job *job,
+				    const SHA256_WORD_T * digest)
+{
+	SHA256_WORD_T w;
+	int i;
+
+	for (i = 0; i < SHA256_DIGEST_NWORDS; i++) {
+		w = to_be32(digest[i]);
+		memcpy(&job->block[i * sizeof(w)], &w, sizeof(w));
+	}
+}
+
+static SHA256_HASH_CTX *pbkdf2_sha256_start(SHA256_HASH_CTX_MGR * mgr,
+					    SHA256_HASH_CTX * ctx, uint32_t i, uint32_t lane,
+					    void *arg)
+{
+	struct pbkdf2_sha256_job *job = (struct pbkdf2_sha256_job *)arg + i;
+
+	ctx->user_data = job;
+	job->stage = PBKDF2_SALT;
+	sha256_ctx_midstate_restore(ctx, &job->key->ipad);
+
+	return sha256_ctx_mgr_submit(mgr, ctx, job->salt, job->salt_len, HASH_UPDATE);
+}
+
+/*
+ * Start the next hash of the chain of a ctx handed back by the manager.
+ * Finished chains have their block of the derived key stored.
+ */
+static int pbkdf2_sha256_next(SHA256_HASH_CTX_MGR * mgr, SHA256_HASH_CTX ** ctx, void *arg)
+{
+	struct pbkdf2_sha256_job *job = (*ctx)->user_data;
+	uint32_t i;
+
+	if (job->stage == PBKDF2_SALT) {
+		// The salt is followed by INT(i), padded by the manager
+		job->stage = PBKDF2_INNER;
+		*ctx = sha256_ctx_mgr_submit(mgr, *ctx, job->index, sizeof(job->index),
+					     HASH_LAST);
+		return 1;
+	}
+
+	pbkdf2_sha256_set_block(job, (*ctx)->job.result_digest);
+
+	if (job->stage == PBKDF2_INNER) {
+		job->stage = PBKDF2_OUTER;
+		*ctx = pbkdf2_sha256_compress(mgr, *ctx, &job->key->opad);
+		return 1;
+	}
+
+	for (i = 0; i < SHA256_DIGEST_NWORDS; i++)
+		job->t[i] ^= (*ctx)->job.result_digest[i];
+
+	if (--job->left) {
+		job->stage = PBKDF2_INNER;
+		*ctx = pbkdf2_sha256_compress(mgr, *ctx, &job->key->ipad);
+		return 1;
+	}
+
+	pbkdf2_sha256_set_block(job, job->t);
+	memcpy(job->out, job->block, job->out_len);
+	return 0;
+}
+
+int pbkdf2_hmac_sha256_mb(const void *pass[], const uint32_t pass_lens[],
+			  const void *salt[], const uint32_t salt_lens[], uint32_t iter,
+			  uint8_t * dk[], uint32_t dk_len, uint32_t n)
+{
+	struct pbkdf2_sha256_job *jobs, *job;
+	HMAC_SHA256_KEY *keys;
+	uint32_t i, k, nblocks, njobs;
+	uint64_t bits;
+	int ret;
+
+	if (iter == 0)
+		return -1;
+
+	if (n == 0 || dk_len == 0)
+		return 0;
+
+	nblocks = (dk_len + SHA256_DIGEST_BYTES - 1) / SHA256_DIGEST_BYTES;
+	njobs = n * nblocks;
+
+	keys = (HMAC_SHA256_KEY *) malloc(n * sizeof(*keys));
+	jobs = (struct pbkdf2_sha256_job *)malloc(njobs * sizeof(*jobs));
+	if (keys == NULL || jobs == NULL) {
+		free(keys);
+		free(jobs);
+		return -1;
+	}
+
+	// Every block of every key is an independent chain
+	bits = to_be64((uint64_t) (SHA256_BLOCK_SIZE + SHA256_DIGEST_BYTES) * 8);
+	for (k = 0; k < n; k++) {
+		hmac_sha256_key_init(&keys[k], pass[k], pass_lens[k]);
+
+		for (i = 0; i < nblocks; i++) {
+			job = &jobs[k * nblocks + i];
+			memset(job, 0, sizeof(*job));
+			job->block[SHA256_DIGEST_BYTES] = 0x80;
+			memcpy(&job->block[SHA256_BLOCK_SIZE - sizeof(bits)], &bits,
+			       sizeof(bits));
+			job->key = &keys[k];
+			job->salt = salt[k];
+			job->salt_len = salt_lens[k];
+			job->index[0] = (uint8_t) ((i + 1) >> 24);
+			job->index[1] = (uint8_t) ((i + 1) >> 16);
+			job->index[2] = (uint8_t) ((i + 1) >> 8);
+			job->index[3] = (uint8_t) (i + 1);
+			job->left = iter;
+			job->out = dk[k] + i * SHA256_DIGEST_BYTES;
+			job->out_len = (i + 1 < nblocks) ? SHA256_DIGEST_BYTES :
+			    dk_len - i * SHA256_DIGEST_BYTES;
+		}
+	}
+
+	ret = sha256_mb_pool_run(njobs, pbkdf2_sha256_start, pbkdf2_sha256_next, jobs);
+
+	memset(keys, 0, n * sizeof(*keys));
+	memset(jobs, 0, njobs * sizeof(*jobs));
+	free(keys);
+	free(jobs);
+	return ret;
+}
@@ -0,0 +1,171 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "sha256_mb.h"
+
+#define TEST_LEN  (16*1024)
+#define TEST_BUFS 200
+#ifndef RANDOMS
+# define RANDOMS  10
+#endif
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+#define RING_MAX  64
+
+static uint32_t digest_ref[TEST_BUFS][SHA256_DIGEST_NWORDS];
+
+// Compare against reference function
+extern void sha256_ref(uint8_t * input_data, uint32_t * digest, uint32_t len);
+
+// Generates pseudo-random data
+static void rand_buffer(unsigned char *buf, const long buffer_size)
+{
+	long i;
+	for (i = 0; i < buffer_size; i++)
+		buf[i] = rand();
+}
+
+int main(void)
+{
+	SHA256_HASH_CTX_RING *ring = NULL;
+	SHA256_RING_SQE sq[RING_MAX];
+	SHA256_HASH_CTX *cq[RING_MAX];
+	SHA256_HASH_CTX ctxpool[TEST_BUFS], *ctx;
+	uint32_t i, j, t, entries, jobs, submitted, returned, fail = 0;
+	unsigned char *bufs[TEST_BUFS];
+	uint32_t lens[TEST_BUFS];
+	uint8_t seen[TEST_BUFS];
+	int ret;
+
+	printf("multibinary_sha256_ring test, %d sets of %dx%d max: ", RANDOMS, TEST_BUFS,
+	       TEST_LEN);
+
+	ret = posix_memalign((void *)&ring, 16, sizeof(SHA256_HASH_CTX_RING));
+	if ((ret != 0) || (ring == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	if (sha256_ctx_ring_init(ring, sq, cq, 0) == 0
+	    || sha256_ctx_ring_init(ring, sq, cq, 12) == 0) {
+		printf("Ring size that is not a power of 2 accepted\n");
+		return 1;
+	}
+
+	srand(TEST_SEED);
+
+	for (i = 0; i < TEST_BUFS; i++) {
+		bufs[i] = (unsigned char *)malloc(TEST_LEN);
+		if (bufs[i] == NULL) {
+			printf("malloc failed test aborted\n");
+			return 1;
+		}
+		hash_ctx_init(&ctxpool[i]);
+		ctxpool[i].user_data = (void *)((uint64_t) i);
+	}
+
+	for (t = 0; t < RANDOMS; t++) {
+		jobs = rand() % TEST_BUFS + 1;
+		entries = 1 << (t % 7);
+
+		if (sha256_ctx_ring_init(ring, sq, cq, entries)) {
+			printf("Ring init of %d entries failed\n", entries);
+			return 1;
+		}
+
+		for (i = 0; i < jobs; i++) {
+			lens[i] = rand() % TEST_LEN;
+			rand_buffer(bufs[i], lens[i]);
+			sha256_ref(bufs[i], digest_ref[i], lens[i]);
+			seen[i] = 0;
+		}
+
+		submitted = 0;
+		returned = 0;
+		while (returned < jobs) {
+			// Fill the submission ring as far as it goes
+			while (submitted < jobs
+			       && sha256_ctx_ring_submit(ring, &ctxpool[submitted],
+							 bufs[submitted], lens[submitted],
+							 HASH_ENTIRE) == 0)
+				submitted++;
+
+			if (submitted < jobs && ring->sq_tail - ring->sq_head != entries) {
+				printf("Submission ring refused an entry while not full\n");
+				return 1;
+			}
+
+			sha256_ctx_mgr_process(ring, rand() % (2 * entries) + 1);
+
+			// Reap only some of the completions to keep the ring under pressure
+			j = rand() % (entries + 1);
+			while (j-- && (ctx = sha256_ctx_ring_complete(ring)) != NULL) {
+				i = (uint32_t) (uint64_t) ctx->user_data;
+				if (ctx->error || seen[i]) {
+					printf("Job %d completed twice or with error %d\n", i,
+					       ctx->error);
+					return 1;
+				}
+				seen[i] = 1;
+				returned++;
+			}
+		}
+
+		if (sha256_ctx_ring_complete(ring) != NULL || sha256_ctx_mgr_flush(&ring->mgr)) {
+			printf("Test failed, extra jobs completed\n");
+			return 1;
+		}
+
+		for (i = 0; i < jobs; i++) {
+			for (j = 0; j < SHA256_DIGEST_NWORDS; j++) {
+				if (ctxpool[i].job.result_digest[j] != digest_ref[i][j]) {
+					fail++;
+					printf("Test%d, digest%d fail "
+					       "0x%08X <=> 0x%08X\n",
+					       i, j, ctxpool[i].job.result_digest[j],
+					       digest_ref[i][j]);
+				}
+			}
+		}
+		if (fail) {
+			printf("Test failed function check %d\n", fail);
+			return fail;
+		}
+
+		putchar('.');
+		fflush(0);
+	}
+
+	printf(" multibinary_sha256_ring rand: Pass\n");
+
+	return fail;
+}
@@ -0,0 +1,162 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "sha256_mb.h"
+
+#define SHA256_TREE_HASH_DIGEST_BYTES	(SHA256_DIGEST_NWORDS * 4)
+
+/*
+ * Tree hash as defined by Amazon Glacier: the message is cut into
+ * SHA256_TREE_HASH_CHUNK_SIZE leaves hashed with SHA-256, and pairs of
+ * digests are hashed together level by level, a digest with no right
+ * neighbour moving up unchanged. Leaves and the nodes of a level are all
+ * independent, so each set is handed to the manager as one batch.
+ */
+uint64_t sha256_mb_tree_hash_nleaves(uint64_t len)
+{
+	return len ? (len + SHA256_TREE_HASH_CHUNK_SIZE - 1) / SHA256_TREE_HASH_CHUNK_SIZE : 1;
+}
+
+int sha256_mb_tree_hash_leaves(const void *buf, uint64_t len,
+			       uint8_t(*digests)[SHA256_DIGEST_NWORDS * 4])
+{
+	const void **bufs;
+	uint64_t *lens, i, n = sha256_mb_tree_hash_nleaves(len);
+	int ret;
+
+	if (n > UINT32_MAX)
+		return -1;
+
+	bufs = (const void **)malloc(n * sizeof(*bufs));
+	lens = (uint64_t *) malloc(n * sizeof(*lens));
+	if (bufs == NULL || lens == NULL) {
+		free(bufs);
+		free(lens);
+		return -1;
+	}
+
+	for (i = 0; i < n; i++) {
+		bufs[i] = (const uint8_t *)buf + i * SHA256_TREE_HASH_CHUNK_SIZE;
+		lens[i] = (i + 1 < n) ? SHA256_TREE_HASH_CHUNK_SIZE :
+		    len - i * SHA256_TREE_HASH_CHUNK_SIZE;
+	}
+
+	ret = sha256_mb_hash_many(bufs, lens, (uint32_t) n, digests);
+
+	free(bufs);
+	free(lens);
+	return ret;
+}
+
+int sha256_mb_tree_hash_combine(const uint8_t(*digests)[SHA256_DIGEST_NWORDS * 4],
+				uint32_t n, uint8_t digest[SHA256_DIGEST_NWORDS * 4])
+{
+	uint8_t(*level)[SHA256_TREE_HASH_DIGEST_BYTES], (*next)[SHA256_TREE_HASH_DIGEST_BYTES];
+	const void **bufs;
+	uint64_t *lens;
+	uint32_t i, m;
+	int ret = 0;
+
+	if (n == 0)
+		return -1;
+
+	if (n == 1) {
+		memcpy(digest, digests[0], SHA256_TREE_HASH_DIGEST_BYTES);
+		return 0;
+	}
+
+	// Nodes are hashed straight out of the level below, so levels alternate buffers
+	level = (uint8_t(*)[SHA256_TREE_HASH_DIGEST_BYTES])
+	    malloc((n / 2 + 1) * sizeof(*level));
+	next = (uint8_t(*)[SHA256_TREE_HASH_DIGEST_BYTES])
+	    malloc((n / 2 + 1) * sizeof(*next));
+	bufs = (const void **)malloc((n / 2) * sizeof(*bufs));
+	lens = (uint64_t *) malloc((n / 2) * sizeof(*lens));
+	if (level == NULL || next == NULL || bufs == NULL || lens == NULL) {
+		free(level);
+		free(next);
+		free(bufs);
+		free(lens);
+		return -1;
+	}
+
+	for (i = 0; i < n / 2; i++) {
+		bufs[i] = digests[2 * i];
+		lens[i] = 2 * SHA256_TREE_HASH_DIGEST_BYTES;
+	}
+	ret |= sha256_mb_hash_many(bufs, lens, n / 2, level);
+	if (n & 1)
+		memcpy(level[n / 2], digests[n - 1], SHA256_TREE_HASH_DIGEST_BYTES);
+
+	for (m = n / 2 + (n & 1); m > 1; m = m / 2 + (m & 1)) {
+		uint8_t(*t)[SHA256_TREE_HASH_DIGEST_BYTES];
+
+		for (i = 0; i < m / 2; i++)
+			bufs[i] = level[2 * i];
+		ret |= sha256_mb_hash_many(bufs, lens, m / 2, next);
+		if (m & 1)
+			memcpy(next[m / 2], level[m - 1], SHA256_TREE_HASH_DIGEST_BYTES);
+
+		t = level;
+		level = next;
+		next = t;
+	}
+
+	memcpy(digest, level[0], SHA256_TREE_HASH_DIGEST_BYTES);
+
+	free(level);
+	free(next);
+	free(bufs);
+	free(lens);
+	return ret;
+}
+
+int sha256_mb_tree_hash(const void *buf, uint64_t len, uint8_t digest[SHA256_DIGEST_NWORDS * 4])
+{
+	uint8_t(*digests)[SHA256_TREE_HASH_DIGEST_BYTES];
+	uint64_t n = sha256_mb_tree_hash_nleaves(len);
+	int ret;
+
+	if (n > UINT32_MAX)
+		return -1;
+
+	digests = (uint8_t(*)[SHA256_TREE_HASH_DIGEST_BYTES]) malloc(n * sizeof(*digests));
+	if (digests == NULL)
+		return -1;
+
+	ret = sha256_mb_tree_hash_leaves(buf, len, digests);
+	if (ret == 0)
+		ret = sha256_mb_tree_hash_combine((const uint8_t(*)[SHA256_TREE_HASH_DIGEST_BYTES])
+						  digests, (uint32_t) n, digest);
+
+	free(digests);
+	return ret;
+}
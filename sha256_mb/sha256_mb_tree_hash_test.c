@@ -0,0 +1,139 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha256_mb.h"
+#include "endian_helper.h"
+
+#define CHUNK SHA256_TREE_HASH_CHUNK_SIZE
+#define MAX_LEAVES 8
+#define TEST_LEN (MAX_LEAVES * CHUNK)
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+
+static const uint64_t test_lens[] = {
+	0, 1, CHUNK - 1, CHUNK, CHUNK + 1, 2 * CHUNK, 3 * CHUNK + 5, 5 * CHUNK,
+	7 * CHUNK + CHUNK / 2, TEST_LEN
+};
+
+static uint8_t digests[MAX_LEAVES][SHA256_DIGEST_NWORDS * 4];
+
+// Compare against reference function
+extern void sha256_ref(uint8_t * input_data, uint32_t * digest, uint32_t len);
+
+static void hash_ref(uint8_t * buf, uint32_t len, uint8_t * out)
+{
+	uint32_t digest[SHA256_DIGEST_NWORDS], w;
+	int i;
+
+	sha256_ref(buf, digest, len);
+	for (i = 0; i < SHA256_DIGEST_NWORDS; i++) {
+		w = to_be32(digest[i]);
+		memcpy(&out[4 * i], &w, sizeof(w));
+	}
+}
+
+// Tree hash of leaf digests, pairing neighbours level by level
+static void combine_ref(uint8_t(*d)[SHA256_DIGEST_NWORDS * 4], uint32_t n, uint8_t * out)
+{
+	uint32_t i, m;
+
+	for (m = n; m > 1; m = (m + 1) / 2)
+		for (i = 0; i < m; i += 2)
+			if (i + 1 < m)
+				hash_ref(d[i], 2 * sizeof(d[0]), d[i / 2]);
+			else
+				memcpy(d[i / 2], d[i], sizeof(d[0]));
+
+	memcpy(out, d[0], sizeof(d[0]));
+}
+
+int main(void)
+{
+	uint8_t *buf, digest[SHA256_DIGEST_NWORDS * 4], digest_ref[SHA256_DIGEST_NWORDS * 4];
+	uint8_t ref_leaves[MAX_LEAVES][SHA256_DIGEST_NWORDS * 4];
+	uint64_t i, len, n, k;
+	uint32_t t;
+
+	printf("sha256_mb_tree_hash test: ");
+
+	buf = malloc(TEST_LEN);
+	if (buf == NULL) {
+		printf("malloc failed test aborted\n");
+		return 1;
+	}
+
+	srand(TEST_SEED);
+	for (i = 0; i < TEST_LEN; i++)
+		buf[i] = rand();
+
+	for (t = 0; t < sizeof(test_lens) / sizeof(test_lens[0]); t++) {
+		len = test_lens[t];
+		n = sha256_mb_tree_hash_nleaves(len);
+
+		for (i = 0; i < n; i++)
+			hash_ref(buf + i * CHUNK, (i + 1 < n) ? CHUNK : len - i * CHUNK,
+				 ref_leaves[i]);
+		combine_ref(ref_leaves, n, digest_ref);
+
+		if (sha256_mb_tree_hash(buf, len, digest) || memcmp(digest, digest_ref,
+								   sizeof(digest))) {
+			printf("Test failed, len %lu\n", (unsigned long)len);
+			return 1;
+		}
+
+		// Leaves hashed in two slices, as two threads would
+		k = n / 2;
+		if (sha256_mb_tree_hash_leaves(buf, k * CHUNK, digests) ||
+		    sha256_mb_tree_hash_leaves(buf + k * CHUNK, len - k * CHUNK, digests + k) ||
+		    sha256_mb_tree_hash_combine((const uint8_t(*)[SHA256_DIGEST_NWORDS * 4])
+						digests, n, digest)
+		    || memcmp(digest, digest_ref, sizeof(digest))) {
+			printf("Test failed, len %lu in slices\n", (unsigned long)len);
+			return 1;
+		}
+
+		putchar('.');
+		fflush(0);
+	}
+
+	if (sha256_mb_tree_hash_combine((const uint8_t(*)[SHA256_DIGEST_NWORDS * 4])digests, 0,
+					digest) == 0) {
+		printf("Empty tree not rejected\n");
+		return 1;
+	}
+
+	free(buf);
+	printf(" Pass\n");
+
+	return 0;
+}
@@ -0,0 +1,270 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#if defined(__clang__)
+# pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__ICC)
+# pragma intel optimization_parameter target_arch=AVX2
+#elif defined(__ICL)
+# pragma [intel] optimization_parameter target_arch=AVX2
+#elif (__GNUC__ >= 5)
+# pragma GCC target("avx2")
+#endif
+
+#include <assert.h>
+#include "sha3_mb.h"
+#include "memcpy_inline.h"
+
+#ifdef _MSC_VER
+# include <intrin.h>
+# define inline __inline
+#endif
+
+static inline void hash_pad(SHA3_HASH_CTX * ctx);
+static inline void hash_squeeze(SHA3_HASH_CTX * ctx);
+static SHA3_HASH_CTX *sha3_ctx_mgr_resubmit(SHA3_HASH_CTX_MGR * mgr, SHA3_HASH_CTX * ctx);
+
+void sha3_ctx_mgr_init_avx2(SHA3_HASH_CTX_MGR * mgr)
+{
+	sha3_mb_mgr_init_avx2(&mgr->mgr);
+}
+
+SHA3_HASH_CTX *sha3_ctx_mgr_submit_avx2(SHA3_HASH_CTX_MGR * mgr, SHA3_HASH_CTX * ctx,
+					const void *buffer, uint32_t len, HASH_CTX_FLAG flags)
+{
+	const uint32_t rate = ctx->job.rate;
+
+	if (flags & (~HASH_ENTIRE)) {
+		// User should not pass anything other than FIRST, UPDATE, or LAST
+		ctx->error = HASH_CTX_ERROR_INVALID_FLAGS;
+		return ctx;
+	}
+
+	if (ctx->status & HASH_CTX_STS_PROCESSING) {
+		// Cannot submit to a currently processing job.
+		ctx->error = HASH_CTX_ERROR_ALREADY_PROCESSING;
+		return ctx;
+	}
+
+	if ((ctx->status & HASH_CTX_STS_COMPLETE) && !(flags & HASH_FIRST)) {
+		// Cannot update a finished job.
+		ctx->error = HASH_CTX_ERROR_ALREADY_COMPLETED;
+		return ctx;
+	}
+
+	if (flags & HASH_FIRST) {
+		// Init state
+		memclr_fixedlen(ctx->job.state, sizeof(ctx->job.state));
+
+		// Reset byte counters
+		ctx->total_length = 0;
+		ctx->digest_done = 0;
+
+		// Clear extra block
+		ctx->partial_block_buffer_length = 0;
+	}
+	// If we made it here, there were no errors during this call to submit
+	ctx->error = HASH_CTX_ERROR_NONE;
+
+	// Store buffer ptr info from user
+	ctx->incoming_buffer = buffer;
+	ctx->incoming_buffer_length = len;
+
+	// Store the user's request flags and mark this ctx as currently being processed.
+	ctx->status = (flags & HASH_LAST) ?
+	    (HASH_CTX_STS) (HASH_CTX_STS_PROCESSING | HASH_CTX_STS_LAST) :
+	    HASH_CTX_STS_PROCESSING;
+
+	// Advance byte counter
+	ctx->total_length += len;
+
+	// If there is anything currently buffered in the extra block, append to it until it contains a whole block.
+	// Or if the user's buffer contains less than a whole block, append as much as possible to the extra block.
+	if ((ctx->partial_block_buffer_length) | (len < rate)) {
+		// Compute how many bytes to copy from user buffer into extra block
+		uint32_t copy_len = rate - ctx->partial_block_buffer_length;
+		if (len < copy_len)
+			copy_len = len;
+
+		if (copy_len) {
+			// Copy and update relevant pointers and counters
+			memcpy_varlen(&ctx->partial_block_buffer
+				      [ctx->partial_block_buffer_length], buffer, copy_len);
+
+			ctx->partial_block_buffer_length += copy_len;
+			ctx->incoming_buffer = (const void *)((const char *)buffer + copy_len);
+			ctx->incoming_buffer_length = len - copy_len;
+		}
+		// The extra block should never contain more than 1 block here
+		assert(ctx->partial_block_buffer_length <= rate);
+
+		// If the extra block buffer contains exactly 1 block, it can be hashed.
+		if (ctx->partial_block_buffer_length >= rate) {
+			ctx->partial_block_buffer_length = 0;
+
+			ctx->job.buffer = ctx->partial_block_buffer;
+			ctx->job.len = 1;
+			ctx = (SHA3_HASH_CTX *) sha3_mb_mgr_submit_avx2(&mgr->mgr, &ctx->job);
+		}
+	}
+
+	return sha3_ctx_mgr_resubmit(mgr, ctx);
+}
+
+SHA3_HASH_CTX *sha3_ctx_mgr_flush_avx2(SHA3_HASH_CTX_MGR * mgr)
+{
+	SHA3_HASH_CTX *ctx;
+
+	while (1) {
+		ctx = (SHA3_HASH_CTX *) sha3_mb_mgr_flush_avx2(&mgr->mgr);
+
+		// If flush returned 0, there are no more jobs in flight.
+		if (!ctx)
+			return NULL;
+
+		// If flush returned a job, verify that it is safe to return to the user.
+		// If it is not ready, resubmit the job to finish processing.
+		ctx = sha3_ctx_mgr_resubmit(mgr, ctx);
+
+		// If sha3_ctx_mgr_resubmit returned a job, it is ready to be returned.
+		if (ctx)
+			return ctx;
+
+		// Otherwise, all jobs currently being managed by the SHA3_HASH_CTX_MGR still need processing. Loop.
+	}
+}
+
+static SHA3_HASH_CTX *sha3_ctx_mgr_resubmit(SHA3_HASH_CTX_MGR * mgr, SHA3_HASH_CTX * ctx)
+{
+	while (ctx) {
+		if (ctx->status & HASH_CTX_STS_COMPLETE) {
+			hash_squeeze(ctx);
+
+			// Each further block of output takes one more permutation
+			if (ctx->digest_done < ctx->digest_len) {
+				ctx->job.buffer = NULL;
+				ctx->job.len = 1;
+				ctx = (SHA3_HASH_CTX *) sha3_mb_mgr_submit_avx2(&mgr->mgr,
+										&ctx->job);
+				continue;
+			}
+			ctx->status = HASH_CTX_STS_COMPLETE;	// Clear PROCESSING bit
+			return ctx;
+		}
+		// If the extra block is empty, begin hashing what remains in the user's buffer.
+		if (ctx->partial_block_buffer_length == 0 && ctx->incoming_buffer_length) {
+			const void *buffer = ctx->incoming_buffer;
+			uint32_t len = ctx->incoming_buffer_length;
+
+			// Only entire blocks can be hashed. Copy remainder to extra block buffer.
+			uint32_t copy_len = len % ctx->job.rate;
+
+			if (copy_len) {
+				len -= copy_len;
+				memcpy_varlen(ctx->partial_block_buffer,
+					      ((const char *)buffer + len), copy_len);
+				ctx->partial_block_buffer_length = copy_len;
+			}
+
+			ctx->incoming_buffer_length = 0;
+
+			// Set len to the number of blocks to be hashed in the user's buffer
+			len /= ctx->job.rate;
+
+			if (len) {
+				ctx->job.buffer = (uint8_t *) buffer;
+				ctx->job.len = len;
+				ctx = (SHA3_HASH_CTX *) sha3_mb_mgr_submit_avx2(&mgr->mgr,
+										&ctx->job);
+				continue;
+			}
+		}
+		// If the extra block is not empty, then we are either on the last block
+		// or we need more user input before continuing.
+		if (ctx->status & HASH_CTX_STS_LAST) {
+			hash_pad(ctx);
+
+			ctx->status =
+			    (HASH_CTX_STS) (HASH_CTX_STS_PROCESSING | HASH_CTX_STS_COMPLETE);
+			ctx->job.buffer = ctx->partial_block_buffer;
+			ctx->job.len = 1;
+			ctx = (SHA3_HASH_CTX *) sha3_mb_mgr_submit_avx2(&mgr->mgr, &ctx->job);
+			continue;
+		}
+
+		if (ctx)
+			ctx->status = HASH_CTX_STS_IDLE;
+		return ctx;
+	}
+
+	return NULL;
+}
+
+static inline void hash_pad(SHA3_HASH_CTX * ctx)
+{
+	uint8_t *padblock = ctx->partial_block_buffer;
+	uint32_t i = ctx->partial_block_buffer_length;
+
+	// pad10*1 after the domain bits, always within the one block
+	memclr_varlen(&padblock[i], ctx->job.rate - i);
+	padblock[i] = ctx->suffix;
+	padblock[ctx->job.rate - 1] |= 0x80;
+	ctx->partial_block_buffer_length = 0;
+}
+
+static inline void hash_squeeze(SHA3_HASH_CTX * ctx)
+{
+	uint32_t i, n = ctx->digest_len - ctx->digest_done;
+
+	if (n > ctx->job.rate)
+		n = ctx->job.rate;
+
+	// State words hold the output bytes in little-endian order
+	for (i = 0; i < n; i++)
+		ctx->digest[ctx->digest_done + i] = (uint8_t) (ctx->job.state[i / 8] >> (8 * (i % 8)));
+	ctx->digest_done += n;
+}
+
+struct slver {
+	uint16_t snum;
+	uint8_t ver;
+	uint8_t core;
+};
+struct slver sha3_ctx_mgr_init_avx2_slver_0000;
+struct slver sha3_ctx_mgr_init_avx2_slver = { 0x2406, 0x00, 0x00 };
+
+struct slver sha3_ctx_mgr_submit_avx2_slver_0000;
+struct slver sha3_ctx_mgr_submit_avx2_slver = { 0x2407, 0x00, 0x00 };
+
+struct slver sha3_ctx_mgr_flush_avx2_slver_0000;
+struct slver sha3_ctx_mgr_flush_avx2_slver = { 0x2408, 0x00, 0x00 };
+
+#if defined(__clang__)
+# pragma clang attribute pop
+#endif
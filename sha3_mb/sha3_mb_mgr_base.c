@@ -0,0 +1,128 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <string.h>
+#include "sha3_mb.h"
+#include "endian_helper.h"
+
+static const uint64_t keccak_rc[24] = {
+	0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+	0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+	0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+	0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+	0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+	0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+	0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+	0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+static const int keccak_rotc[24] = {
+	1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+	27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+
+static const int keccak_piln[24] = {
+	10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+	15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+#define rol64(x, r) (((x) << (r)) | ((x) >> (64 - (r))))
+
+static inline uint64_t load_le64(const uint8_t * p)
+{
+	uint64_t x;
+
+	memcpy(&x, p, sizeof(x));
+	return to_le64(x);
+}
+
+void sha3_keccak_f1600(uint64_t A[SHA3_STATE_NWORDS])
+{
+	uint64_t C[5], D, t, u;
+	int r, i, j;
+
+	for (r = 0; r < 24; r++) {
+		// Theta
+		for (i = 0; i < 5; i++)
+			C[i] = A[i] ^ A[i + 5] ^ A[i + 10] ^ A[i + 15] ^ A[i + 20];
+		for (i = 0; i < 5; i++) {
+			D = C[(i + 4) % 5] ^ rol64(C[(i + 1) % 5], 1);
+			for (j = 0; j < 25; j += 5)
+				A[j + i] ^= D;
+		}
+
+		// Rho and pi
+		t = A[1];
+		for (i = 0; i < 24; i++) {
+			j = keccak_piln[i];
+			u = A[j];
+			A[j] = rol64(t, keccak_rotc[i]);
+			t = u;
+		}
+
+		// Chi
+		for (j = 0; j < 25; j += 5) {
+			for (i = 0; i < 5; i++)
+				C[i] = A[j + i];
+			for (i = 0; i < 5; i++)
+				A[j + i] = C[i] ^ (~C[(i + 1) % 5] & C[(i + 2) % 5]);
+		}
+
+		// Iota
+		A[0] ^= keccak_rc[r];
+	}
+}
+
+void sha3_mb_mgr_init_base(SHA3_MB_JOB_MGR * state)
+{
+}
+
+SHA3_JOB *sha3_mb_mgr_submit_base(SHA3_MB_JOB_MGR * state, SHA3_JOB * job)
+{
+	uint64_t blk;
+	uint32_t i;
+
+	// A single lane, the job is done before it is handed back
+	for (blk = 0; blk < job->len; blk++) {
+		if (job->buffer) {
+			for (i = 0; i < job->rate / 8; i++)
+				job->state[i] ^= load_le64(job->buffer + 8 * i);
+			job->buffer += job->rate;
+		}
+		sha3_keccak_f1600(job->state);
+	}
+	job->len = 0;
+	job->status = STS_COMPLETED;
+	return job;
+}
+
+SHA3_JOB *sha3_mb_mgr_flush_base(SHA3_MB_JOB_MGR * state)
+{
+	return NULL;
+}
@@ -0,0 +1,176 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha3_mb.h"
+
+#define MSGS		9
+#define MAX_DIGEST	64
+#define CHUNK		7
+
+static uint8_t msg_a3[200];
+
+static const struct {
+	SHA3_ALG alg;
+	const uint8_t *msg;
+	uint32_t len;
+	uint32_t digest_len;
+	const char *digest;
+} vectors[MSGS] = {
+	{SHA3_ALG_256, (const uint8_t *)"", 0, 32,
+	 "a7ffc6f8bf1ed76651c14756a061d662f580ff4de43b49fa82d80a4b80f8434a"},
+	{SHA3_ALG_256, (const uint8_t *)"abc", 3, 32,
+	 "3a985da74fe225b2045c172d6bd390bd855f086e3e9d525b46bfe24511431532"},
+	{SHA3_ALG_512, (const uint8_t *)"abc", 3, 64,
+	 "b751850b1a57168a5693cd924b6b096e08f621827444f70d884f5d0240d2712e"
+	 "10e116e9192af3c91a7ec57647e3934057340b4cf408d5a56592f8274eec53f0"},
+	{SHA3_ALG_SHAKE128, (const uint8_t *)"", 0, 32,
+	 "7f9c2ba4e88f827d616045507605853ed73b8093f6efbc88eb1a6eacfa66ef26"},
+	{SHA3_ALG_SHAKE256, (const uint8_t *)"", 0, 64,
+	 "46b9dd2b0ba88d13233b3feb743eeb243fcd52ea62b81b82b50c27646ed5762f"
+	 "d75dc4ddd8c0f200cb05019d67b592f6fc821c49479ab48640292eacb3b7c4be"},
+	{SHA3_ALG_256, msg_a3, 200, 32,
+	 "79f38adec5c20307a98ef76e8324afbfd46cfd81b22e3973c65fa1bd9de31787"},
+	{SHA3_ALG_512, msg_a3, 200, 64,
+	 "e76dfad22084a8b1467fcf2ffa58361bec7628edf5f3fdc0e4805dc48caeeca8"
+	 "1b7c13c30adf52a3659584739a2df46be589c51ca1a4a8416df6545a1ce8ba00"},
+	{SHA3_ALG_SHAKE128, msg_a3, 200, 32,
+	 "131ab8d2b594946b9c81333f9bb6e0ce75c3b93104fa3469d3917457385da037"},
+	{SHA3_ALG_SHAKE256, msg_a3, 200, 32,
+	 "cd8a920ed141aa0407a22d59288652e9d9f1a7ee0c1e7c1ca699424da84a904d"}
+};
+
+static int check_digest(int t, const uint8_t * digest)
+{
+	char hex[2 * MAX_DIGEST + 1];
+	uint32_t i;
+
+	for (i = 0; i < vectors[t].digest_len; i++)
+		sprintf(&hex[2 * i], "%02x", digest[i]);
+
+	if (strcmp(hex, vectors[t].digest)) {
+		printf("\nsha3 vector %d mismatch\n  got %s\n  exp %s\n", t, hex,
+		       vectors[t].digest);
+		return 1;
+	}
+	return 0;
+}
+
+int main(void)
+{
+	SHA3_HASH_CTX_MGR *mgr = NULL;
+	SHA3_HASH_CTX ctxpool[MSGS], *ctx = NULL;
+	uint8_t digests[MSGS][MAX_DIGEST];
+	uint32_t i, off, len, fail = 0, checked = 0;
+	HASH_CTX_FLAG flags;
+	int ret;
+
+	printf("multibinary_sha3 test: ");
+
+	ret = posix_memalign((void *)&mgr, 64, sizeof(SHA3_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+	memset(msg_a3, 0xa3, sizeof(msg_a3));
+
+	sha3_ctx_mgr_init(mgr);
+
+	// Whole messages, every algorithm sharing the one manager
+	for (i = 0; i < MSGS; i++) {
+		if (sha3_ctx_init(&ctxpool[i], vectors[i].alg, digests[i], vectors[i].digest_len)) {
+			printf("sha3_ctx_init failed on vector %d\n", i);
+			return 1;
+		}
+		ctx = sha3_ctx_mgr_submit(mgr, &ctxpool[i], vectors[i].msg, vectors[i].len,
+					  HASH_ENTIRE);
+		if (ctx) {
+			if (ctx->error) {
+				printf("submit error %d on vector %d\n", ctx->error, i);
+				return 1;
+			}
+			fail += check_digest((int)(ctx - ctxpool), ctx->digest);
+			checked++;
+		}
+	}
+	while ((ctx = sha3_ctx_mgr_flush(mgr)) != NULL) {
+		fail += check_digest((int)(ctx - ctxpool), ctx->digest);
+		checked++;
+	}
+	if (checked != MSGS) {
+		printf("only %d of %d contexts returned\n", checked, MSGS);
+		fail++;
+	}
+
+	// The same messages fed in odd sized pieces, one context at a time
+	for (i = 0; i < MSGS; i++) {
+		memset(digests[i], 0, MAX_DIGEST);
+		off = 0;
+		flags = HASH_FIRST;
+		do {
+			len = vectors[i].len - off < CHUNK ? vectors[i].len - off : CHUNK;
+			if (off + len == vectors[i].len)
+				flags |= HASH_LAST;
+			ctx = sha3_ctx_mgr_submit(mgr, &ctxpool[i], vectors[i].msg + off, len,
+						  flags);
+			if (ctx == NULL)
+				ctx = sha3_ctx_mgr_flush(mgr);
+			if (ctx == NULL || ctx->error) {
+				printf("update error on vector %d\n", i);
+				return 1;
+			}
+			off += len;
+			flags = HASH_UPDATE;
+		} while (off < vectors[i].len);
+
+		if (!hash_ctx_complete(&ctxpool[i])) {
+			printf("vector %d not complete\n", i);
+			return 1;
+		}
+		fail += check_digest(i, digests[i]);
+	}
+
+	// Digest lengths that do not match the algorithm are refused
+	if (!sha3_ctx_init(&ctxpool[0], SHA3_ALG_256, digests[0], SHA3_512_DIGEST_SIZE) ||
+	    !sha3_ctx_init(&ctxpool[0], SHA3_ALG_SHAKE128, digests[0], 0)) {
+		printf("bad digest length accepted\n");
+		fail++;
+	}
+
+	aligned_free(mgr);
+
+	if (fail)
+		printf("Test failed function check %d\n", fail);
+	else
+		printf(" multibinary_sha3 test: Pass\n");
+
+	return fail;
+}
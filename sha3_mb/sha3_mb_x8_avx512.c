@@ -0,0 +1,175 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#if defined(__clang__)
+# pragma clang attribute push (__attribute__((target("avx512f"))), apply_to=function)
+#elif defined(__ICC)
+# pragma intel optimization_parameter target_arch=CORE-AVX512
+#elif defined(__ICL)
+# pragma [intel] optimization_parameter target_arch=CORE-AVX512
+#elif (__GNUC__ >= 5)
+# pragma GCC target("avx512f")
+#endif
+
+#include <string.h>
+#include <immintrin.h>
+#include "sha3_mb.h"
+#include "endian_helper.h"
+
+#ifdef HAVE_AS_KNOWS_AVX512
+
+typedef __m512i VEC;
+
+#define LOAD(p)			_mm512_load_si512(p)
+#define STORE(p, a)		_mm512_store_si512(p, a)
+#define SET1(x)			_mm512_set1_epi64((long long)(x))
+#define XOR(a, b)		_mm512_xor_si512(a, b)
+#define XOR5(a, b, c, d, e)	_mm512_ternarylogic_epi64(XOR(a, b), XOR(c, d), e, 0x96)
+#define ROL(a, n)		_mm512_rolv_epi64(a, _mm512_set1_epi64(n))
+// a ^ (~b & c) in one instruction
+#define CHI(a, b, c)		_mm512_ternarylogic_epi64(a, b, c, 0xd2)
+
+static const uint64_t keccak_rc[24] = {
+	0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+	0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+	0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+	0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+	0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+	0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+	0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+	0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+static const int keccak_rotc[24] = {
+	1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+	27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+
+static const int keccak_piln[24] = {
+	10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+	15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+static inline uint64_t load_le64(const uint8_t * p)
+{
+	uint64_t x;
+
+	memcpy(&x, p, sizeof(x));
+	return to_le64(x);
+}
+
+// One Keccak-f[1600] state per 64-bit element
+static void keccak_f1600_x8(VEC A[SHA3_STATE_NWORDS])
+{
+	VEC C[5], D, t, u;
+	int r, i, j;
+
+	for (r = 0; r < 24; r++) {
+		// Theta
+		for (i = 0; i < 5; i++)
+			C[i] = XOR5(A[i], A[i + 5], A[i + 10], A[i + 15], A[i + 20]);
+		for (i = 0; i < 5; i++) {
+			D = XOR(C[(i + 4) % 5], ROL(C[(i + 1) % 5], 1));
+			for (j = 0; j < 25; j += 5)
+				A[j + i] = XOR(A[j + i], D);
+		}
+
+		// Rho and pi
+		t = A[1];
+		for (i = 0; i < 24; i++) {
+			j = keccak_piln[i];
+			u = A[j];
+			A[j] = ROL(t, keccak_rotc[i]);
+			t = u;
+		}
+
+		// Chi
+		for (j = 0; j < 25; j += 5) {
+			for (i = 0; i < 5; i++)
+				C[i] = A[j + i];
+			for (i = 0; i < 5; i++)
+				A[j + i] = CHI(C[i], C[(i + 1) % 5], C[(i + 2) % 5]);
+		}
+
+		// Iota
+		A[0] = XOR(A[0], SET1(keccak_rc[r]));
+	}
+}
+
+void sha3_mb_x8_avx512(SHA3_JOB * jobs[SHA3_X8_LANES], uint64_t len)
+{
+	DECLARE_ALIGNED(uint64_t lanes[SHA3_STATE_NWORDS][SHA3_X8_LANES], 64);
+	VEC A[SHA3_STATE_NWORDS];
+	const uint8_t *p[SHA3_X8_LANES];
+	uint32_t nwords[SHA3_X8_LANES], maxwords = 0;
+	uint64_t blk;
+	int i, w;
+
+	// Gather the states, an empty lane runs on zeros
+	for (i = 0; i < SHA3_X8_LANES; i++) {
+		p[i] = jobs[i] ? jobs[i]->buffer : NULL;
+		nwords[i] = p[i] ? jobs[i]->rate / 8 : 0;
+		if (nwords[i] > maxwords)
+			maxwords = nwords[i];
+		for (w = 0; w < SHA3_STATE_NWORDS; w++)
+			lanes[w][i] = jobs[i] ? jobs[i]->state[w] : 0;
+	}
+	for (w = 0; w < SHA3_STATE_NWORDS; w++)
+		A[w] = LOAD(lanes[w]);
+
+	for (blk = 0; blk < len; blk++) {
+		// Absorb one block per lane, each lane at its own rate
+		if (maxwords) {
+			for (w = 0; w < (int)maxwords; w++)
+				for (i = 0; i < SHA3_X8_LANES; i++)
+					lanes[w][i] = (uint32_t) w < nwords[i] ?
+					    load_le64(p[i] + 8 * w) : 0;
+			for (w = 0; w < (int)maxwords; w++)
+				A[w] = XOR(A[w], LOAD(lanes[w]));
+			for (i = 0; i < SHA3_X8_LANES; i++)
+				if (p[i])
+					p[i] += 8 * nwords[i];
+		}
+		keccak_f1600_x8(A);
+	}
+
+	// Scatter the states back to the jobs
+	for (w = 0; w < SHA3_STATE_NWORDS; w++)
+		STORE(lanes[w], A[w]);
+	for (i = 0; i < SHA3_X8_LANES; i++)
+		if (jobs[i])
+			for (w = 0; w < SHA3_STATE_NWORDS; w++)
+				jobs[i]->state[w] = lanes[w][i];
+}
+
+#endif // HAVE_AS_KNOWS_AVX512
+
+#if defined(__clang__)
+# pragma clang attribute pop
+#endif
@@ -0,0 +1,155 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <string.h>
+#include "sha3_mb.h"
+
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+// Reference SHA3 and SHAKE Functions
+////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////
+
+#define rol64(x, r) ((r) ? (((x) << (r)) | ((x) >> (64 - (r)))) : (x))
+
+// Rotation offsets r[x][y] of the rho step
+static const int rho[5][5] = {
+	{0, 36, 3, 41, 18},
+	{1, 44, 10, 45, 2},
+	{62, 6, 43, 15, 61},
+	{28, 55, 25, 21, 56},
+	{27, 20, 39, 8, 14}
+};
+
+// Round constants from the LFSR of the iota step
+static uint64_t keccak_ref_rc(int round)
+{
+	uint64_t rc = 0;
+	uint8_t lfsr = 1;
+	int i, j;
+
+	for (i = 0; i < 24 && i <= round; i++) {
+		rc = 0;
+		for (j = 0; j < 7; j++) {
+			if (lfsr & 1)
+				rc |= 1ULL << ((1 << j) - 1);
+			lfsr = (lfsr & 0x80) ? (uint8_t) ((lfsr << 1) ^ 0x71) : (uint8_t) (lfsr << 1);
+		}
+	}
+	return rc;
+}
+
+static void keccak_ref_permute(uint64_t a[5][5])
+{
+	uint64_t b[5][5], c[5], d[5];
+	int round, x, y;
+
+	for (round = 0; round < 24; round++) {
+		for (x = 0; x < 5; x++)
+			c[x] = a[x][0] ^ a[x][1] ^ a[x][2] ^ a[x][3] ^ a[x][4];
+		for (x = 0; x < 5; x++)
+			d[x] = c[(x + 4) % 5] ^ rol64(c[(x + 1) % 5], 1);
+		for (x = 0; x < 5; x++)
+			for (y = 0; y < 5; y++)
+				a[x][y] ^= d[x];
+
+		for (x = 0; x < 5; x++)
+			for (y = 0; y < 5; y++)
+				b[y][(2 * x + 3 * y) % 5] = rol64(a[x][y], rho[x][y]);
+
+		for (x = 0; x < 5; x++)
+			for (y = 0; y < 5; y++)
+				a[x][y] = b[x][y] ^ (~b[(x + 1) % 5][y] & b[(x + 2) % 5][y]);
+
+		a[0][0] ^= keccak_ref_rc(round);
+	}
+}
+
+// Byte i of the state is byte i % 8 of lane (x, y) = ((i / 8) % 5, (i / 8) / 5)
+static void keccak_ref_xor_byte(uint64_t a[5][5], uint32_t i, uint8_t v)
+{
+	a[(i / 8) % 5][(i / 8) / 5] ^= (uint64_t) v << (8 * (i % 8));
+}
+
+static uint8_t keccak_ref_get_byte(uint64_t a[5][5], uint32_t i)
+{
+	return (uint8_t) (a[(i / 8) % 5][(i / 8) / 5] >> (8 * (i % 8)));
+}
+
+void sha3_ref(SHA3_ALG alg, const uint8_t * input_data, uint64_t len, uint8_t * digest,
+	      uint32_t digest_len)
+{
+	uint64_t a[5][5];
+	uint32_t rate, i;
+	uint8_t suffix;
+
+	switch (alg) {
+	case SHA3_ALG_256:
+		rate = SHA3_256_RATE;
+		suffix = 0x06;
+		break;
+	case SHA3_ALG_512:
+		rate = SHA3_512_RATE;
+		suffix = 0x06;
+		break;
+	case SHA3_ALG_SHAKE128:
+		rate = SHAKE128_RATE;
+		suffix = 0x1f;
+		break;
+	default:
+		rate = SHAKE256_RATE;
+		suffix = 0x1f;
+		break;
+	}
+
+	memset(a, 0, sizeof(a));
+
+	// Absorb
+	i = 0;
+	while (len--) {
+		keccak_ref_xor_byte(a, i++, *input_data++);
+		if (i == rate) {
+			keccak_ref_permute(a);
+			i = 0;
+		}
+	}
+	keccak_ref_xor_byte(a, i, suffix);
+	keccak_ref_xor_byte(a, rate - 1, 0x80);
+	keccak_ref_permute(a);
+
+	// Squeeze
+	i = 0;
+	while (digest_len--) {
+		if (i == rate) {
+			keccak_ref_permute(a);
+			i = 0;
+		}
+		*digest++ = keccak_ref_get_byte(a, i++);
+	}
+}
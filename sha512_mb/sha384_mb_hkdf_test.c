@@ -0,0 +1,205 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha512_mb.h"
+
+#define DIGEST_BYTES (SHA384_DIGEST_NWORDS * sizeof(SHA512_WORD_T))
+#define MAX_FIELD_LEN 300
+#define MAX_OKM_LEN 160
+#define NUM_JOBS 100
+
+// RFC 5869 test cases and extra ones with long salts, empty IKM and long info
+struct field {
+	uint8_t start, step;
+	uint32_t len;
+};
+
+static const struct {
+	struct field salt, ikm, info;
+	uint32_t okm_len;
+	uint8_t prk[DIGEST_BYTES];
+	uint8_t okm[MAX_OKM_LEN];
+} vecs[] = {
+	{{0x00, 1, 13}, {0x0b, 0, 22}, {0xf0, 1, 10}, 42,
+	 {0x70, 0x4b, 0x39, 0x99, 0x07, 0x79, 0xce, 0x1d, 0xc5, 0x48, 0x05, 0x2c,
+	  0x7d, 0xc3, 0x9f, 0x30, 0x35, 0x70, 0xdd, 0x13, 0xfb, 0x39, 0xf7, 0xac,
+	  0xc5, 0x64, 0x68, 0x0b, 0xef, 0x80, 0xe8, 0xde, 0xc7, 0x0e, 0xe9, 0xa7,
+	  0xe1, 0xf3, 0xe2, 0x93, 0xef, 0x68, 0xec, 0xeb, 0x07, 0x2a, 0x5a, 0xde},
+	 {0x9b, 0x50, 0x97, 0xa8, 0x60, 0x38, 0xb8, 0x05, 0x30, 0x90, 0x76, 0xa4,
+	  0x4b, 0x3a, 0x9f, 0x38, 0x06, 0x3e, 0x25, 0xb5, 0x16, 0xdc, 0xbf, 0x36,
+	  0x9f, 0x39, 0x4c, 0xfa, 0xb4, 0x36, 0x85, 0xf7, 0x48, 0xb6, 0x45, 0x77,
+	  0x63, 0xe4, 0xf0, 0x20, 0x4f, 0xc5}},
+	{{0x60, 1, 80}, {0x00, 1, 80}, {0xb0, 1, 80}, 82,
+	 {0xb3, 0x19, 0xf6, 0x83, 0x1d, 0xff, 0x93, 0x14, 0xef, 0xb6, 0x43, 0xba,
+	  0xa2, 0x92, 0x63, 0xb3, 0x0e, 0x4a, 0x8d, 0x77, 0x9f, 0xe3, 0x1e, 0x9c,
+	  0x90, 0x1e, 0xfd, 0x7d, 0xe7, 0x37, 0xc8, 0x5b, 0x62, 0xe6, 0x76, 0xd4,
+	  0xdc, 0x87, 0xb0, 0x89, 0x5c, 0x6a, 0x7d, 0xc9, 0x7b, 0x52, 0xce, 0xbb},
+	 {0x48, 0x4c, 0xa0, 0x52, 0xb8, 0xcc, 0x72, 0x4f, 0xd1, 0xc4, 0xec, 0x64,
+	  0xd5, 0x7b, 0x4e, 0x81, 0x8c, 0x7e, 0x25, 0xa8, 0xe0, 0xf4, 0x56, 0x9e,
+	  0xd7, 0x2a, 0x6a, 0x05, 0xfe, 0x06, 0x49, 0xee, 0xbf, 0x69, 0xf8, 0xd5,
+	  0xc8, 0x32, 0x85, 0x6b, 0xf4, 0xe4, 0xfb, 0xc1, 0x79, 0x67, 0xd5, 0x49,
+	  0x75, 0x32, 0x4a, 0x94, 0x98, 0x7f, 0x7f, 0x41, 0x83, 0x58, 0x17, 0xd8,
+	  0x99, 0x4f, 0xdb, 0xd6, 0xf4, 0xc0, 0x9c, 0x55, 0x00, 0xdc, 0xa2, 0x4a,
+	  0x56, 0x22, 0x2f, 0xea, 0x53, 0xd8, 0x96, 0x7a, 0x8b, 0x2e}},
+	{{0x00, 0, 0}, {0x0b, 0, 22}, {0x00, 0, 0}, 42,
+	 {0x10, 0xe4, 0x0c, 0xf0, 0x72, 0xa4, 0xc5, 0x62, 0x6e, 0x43, 0xdd, 0x22,
+	  0xc1, 0xcf, 0x72, 0x7d, 0x4b, 0xb1, 0x40, 0x97, 0x5c, 0x9a, 0xd0, 0xcb,
+	  0xc8, 0xe4, 0x5b, 0x40, 0x06, 0x8f, 0x8f, 0x0b, 0xa5, 0x7c, 0xdb, 0x59,
+	  0x8a, 0xf9, 0xdf, 0xa6, 0x96, 0x3a, 0x96, 0x89, 0x9a, 0xf0, 0x47, 0xe5},
+	 {0xc8, 0xc9, 0x6e, 0x71, 0x0f, 0x89, 0xb0, 0xd7, 0x99, 0x0b, 0xca, 0x68,
+	  0xbc, 0xde, 0xc8, 0xcf, 0x85, 0x40, 0x62, 0xe5, 0x4c, 0x73, 0xa7, 0xab,
+	  0xc7, 0x43, 0xfa, 0xde, 0x9b, 0x24, 0x2d, 0xaa, 0xcc, 0x1c, 0xea, 0x56,
+	  0x70, 0x41, 0x5b, 0x52, 0x84, 0x9c}},
+	{{0x11, 7, 200}, {0x23, 3, 33}, {0x5a, 1, 1}, 1,
+	 {0x6f, 0x1e, 0x99, 0x68, 0x3c, 0x71, 0x89, 0xe6, 0xcd, 0x7a, 0xa0, 0x19,
+	  0x4d, 0xcd, 0x8d, 0xc0, 0xdb, 0xd7, 0x17, 0x25, 0xb7, 0x90, 0xa1, 0x7e,
+	  0x0f, 0x4c, 0x7b, 0xdf, 0xdb, 0x14, 0x85, 0xd0, 0x31, 0x68, 0xdd, 0x76,
+	  0xc6, 0xc2, 0xce, 0xe5, 0x7e, 0xb7, 0x09, 0xf0, 0xd9, 0x7f, 0x0f, 0x4d},
+	 {0xbb}},
+	{{0x01, 1, 48}, {0x99, 5, 300}, {0x42, 9, 150}, 149,
+	 {0x56, 0x49, 0x43, 0x92, 0xc5, 0x2c, 0x3c, 0xe9, 0xe1, 0xea, 0xe5, 0x63,
+	  0xd1, 0xdd, 0xb6, 0x2e, 0x77, 0xec, 0x60, 0x77, 0x3c, 0xae, 0x76, 0x67,
+	  0xda, 0x16, 0x85, 0x4e, 0x9f, 0x4f, 0xc4, 0x63, 0xbb, 0xcf, 0xa7, 0x24,
+	  0xb0, 0x1b, 0x67, 0x4c, 0x5c, 0x62, 0x27, 0xa3, 0xe5, 0xe2, 0x3b, 0xc8},
+	 {0xee, 0xef, 0x40, 0x88, 0x9a, 0x3c, 0x64, 0xb6, 0x30, 0xc4, 0x1b, 0xd4,
+	  0x07, 0x9d, 0x9d, 0x70, 0x67, 0x54, 0x8d, 0xc5, 0xfe, 0x9b, 0x10, 0x5e,
+	  0x36, 0x8d, 0x48, 0x15, 0x46, 0x39, 0x7e, 0xeb, 0x9e, 0x4c, 0x59, 0x47,
+	  0x45, 0xef, 0xd6, 0xcd, 0x91, 0x09, 0x04, 0x20, 0x7e, 0xdd, 0x84, 0x14,
+	  0xd7, 0x39, 0x37, 0x7f, 0x2b, 0x9b, 0x00, 0xc5, 0x10, 0xd2, 0xcf, 0x39,
+	  0x1a, 0x02, 0x0b, 0x79, 0x06, 0xd5, 0xbf, 0x74, 0x7b, 0x28, 0x99, 0xe6,
+	  0x51, 0xaf, 0x42, 0x1d, 0x72, 0x75, 0x56, 0x46, 0x1d, 0x5f, 0x39, 0x70,
+	  0x2c, 0xa4, 0xe9, 0xa8, 0xb9, 0x09, 0xf4, 0x54, 0x1a, 0x98, 0x68, 0x1f,
+	  0x5e, 0xda, 0x03, 0x91, 0x5b, 0x1a, 0x8c, 0x30, 0x6e, 0xe0, 0x2a, 0x8d,
+	  0x31, 0x22, 0x23, 0x85, 0xd9, 0xb3, 0x98, 0xe9, 0x85, 0x17, 0xa8, 0x5c,
+	  0xcc, 0x8a, 0x33, 0x92, 0xb5, 0x94, 0x67, 0x71, 0x76, 0x66, 0x9a, 0xf1,
+	  0x48, 0xd9, 0x40, 0xf7, 0xf5, 0x68, 0x52, 0x45, 0xf6, 0xc7, 0x31, 0x7f,
+	  0x56, 0x8d, 0x2c, 0xb2, 0xe6}},
+	{{0x7f, 3, 1}, {0x00, 0, 0}, {0x10, 1, 255}, 96,
+	 {0x2d, 0x6f, 0xba, 0xd0, 0xa8, 0xd2, 0xe3, 0x23, 0xc9, 0x6f, 0x65, 0x6f,
+	  0x5e, 0xf3, 0x43, 0x79, 0x59, 0x50, 0x5f, 0xc0, 0x60, 0xbe, 0xc5, 0x5e,
+	  0x80, 0xf0, 0x74, 0xbe, 0xca, 0x6d, 0xcd, 0xc1, 0xfa, 0x24, 0x7d, 0x91,
+	  0xe4, 0x84, 0x43, 0x4b, 0x9e, 0xd0, 0x4f, 0xc9, 0xf7, 0x6f, 0x82, 0xa9},
+	 {0xf2, 0x81, 0xa2, 0xaa, 0x8f, 0xd7, 0xae, 0xaf, 0xa7, 0x18, 0xa2, 0xb8,
+	  0xc2, 0xbd, 0x3f, 0x29, 0x7e, 0x14, 0xc8, 0x9c, 0x37, 0x71, 0x7a, 0x3d,
+	  0xa9, 0xf7, 0xe3, 0xc6, 0xe4, 0x31, 0x2b, 0x49, 0x32, 0x71, 0xfa, 0x40,
+	  0x56, 0x8c, 0x03, 0x91, 0x9b, 0xe7, 0x56, 0x62, 0xa5, 0x4f, 0xc1, 0xb0,
+	  0xe1, 0x2b, 0xc6, 0xa8, 0x44, 0x6f, 0x87, 0x3f, 0x72, 0xa6, 0x90, 0x22,
+	  0x54, 0x83, 0xfe, 0xc4, 0x8a, 0xc3, 0x8c, 0xcd, 0x95, 0x7d, 0x94, 0x4f,
+	  0x43, 0x7d, 0xb9, 0x2f, 0x61, 0xd3, 0x07, 0x00, 0x7d, 0x22, 0xd0, 0x94,
+	  0x3d, 0x3b, 0xb6, 0x2f, 0xb6, 0xd3, 0xa3, 0x1c, 0x65, 0x96, 0xd7, 0x7b}}
+};
+
+#define NUM_VECS (sizeof(vecs) / sizeof(vecs[0]))
+
+static uint8_t fields[NUM_VECS][3][MAX_FIELD_LEN];
+static uint8_t prk[NUM_JOBS][DIGEST_BYTES], okm[NUM_JOBS][MAX_OKM_LEN];
+
+static void fill(uint8_t * buf, const struct field *f)
+{
+	uint32_t j;
+
+	for (j = 0; j < f->len; j++)
+		buf[j] = f->start + f->step * j;
+}
+
+int main(void)
+{
+	const void *salt[NUM_JOBS], *ikm[NUM_JOBS], *info[NUM_JOBS], *prk_ptr[NUM_JOBS];
+	uint32_t salt_lens[NUM_JOBS], ikm_lens[NUM_JOBS], info_lens[NUM_JOBS];
+	uint32_t prk_lens[NUM_JOBS], okm_lens[NUM_JOBS];
+	uint8_t *prk_out[NUM_JOBS], *okm_out[NUM_JOBS];
+	uint32_t i, v;
+
+	printf("hkdf_sha384_mb test: ");
+
+	for (v = 0; v < NUM_VECS; v++) {
+		fill(fields[v][0], &vecs[v].salt);
+		fill(fields[v][1], &vecs[v].ikm);
+		fill(fields[v][2], &vecs[v].info);
+	}
+
+	// Interleave the vectors so every lane sees a mix of lengths
+	for (i = 0; i < NUM_JOBS; i++) {
+		v = i % NUM_VECS;
+		salt[i] = fields[v][0];
+		salt_lens[i] = vecs[v].salt.len;
+		ikm[i] = fields[v][1];
+		ikm_lens[i] = vecs[v].ikm.len;
+		info[i] = fields[v][2];
+		info_lens[i] = vecs[v].info.len;
+		prk_ptr[i] = prk[i];
+		prk_lens[i] = DIGEST_BYTES;
+		prk_out[i] = prk[i];
+		okm_out[i] = okm[i];
+		okm_lens[i] = vecs[v].okm_len;
+	}
+
+	if (hkdf_sha384_mb_extract(salt, salt_lens, ikm, ikm_lens, prk_out, NUM_JOBS)) {
+		printf("extract returned an error\n");
+		return 1;
+	}
+
+	for (i = 0; i < NUM_JOBS; i++) {
+		if (memcmp(prk[i], vecs[i % NUM_VECS].prk, DIGEST_BYTES)) {
+			printf("Test failed, extract job %d\n", i);
+			return 1;
+		}
+	}
+	putchar('.');
+
+	memset(okm, 0, sizeof(okm));
+	if (hkdf_sha384_mb_expand(prk_ptr, prk_lens, info, info_lens, okm_out, okm_lens, NUM_JOBS)) {
+		printf("expand returned an error\n");
+		return 1;
+	}
+
+	for (i = 0; i < NUM_JOBS; i++) {
+		v = i % NUM_VECS;
+		if (memcmp(okm[i], vecs[v].okm, vecs[v].okm_len) || okm[i][vecs[v].okm_len]) {
+			printf("Test failed, expand job %d\n", i);
+			return 1;
+		}
+	}
+	putchar('.');
+
+	// No more than 255 blocks of output
+	okm_lens[NUM_JOBS - 1] = 255 * DIGEST_BYTES + 1;
+	if (hkdf_sha384_mb_expand(prk_ptr, prk_lens, info, info_lens, okm_out, okm_lens, NUM_JOBS)
+	    == 0) {
+		printf("Overlong output not rejected\n");
+		return 1;
+	}
+
+	printf(" Pass\n");
+
+	return 0;
+}
@@ -0,0 +1,167 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha512_mb.h"
+
+#define MSGS 4
+#define VARIANTS 3
+#define NUM_JOBS 1000
+
+static uint8_t msg1[] = "abc";
+static uint8_t msg2[] = "";
+static uint8_t msg3[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+static uint8_t msg4[] =
+    "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopq"
+    "klmnopqrlmnopqrsmnopqrstnopqrstu";
+
+static uint8_t *msgs[MSGS] = { msg1, msg2, msg3, msg4 };
+
+static uint64_t exp_sha384[MSGS][SHA384_DIGEST_NWORDS] = {
+	{0xcb00753f45a35e8b, 0xb5a03d699ac65007, 0x272c32ab0eded163, 0x1a8b605a43ff5bed,
+	 0x8086072ba1e7cc23, 0x58baeca134c825a7},
+	{0x38b060a751ac9638, 0x4cd9327eb1b1e36a, 0x21fdb71114be0743, 0x4c0cc7bf63f6e1da,
+	 0x274edebfe76f65fb, 0xd51ad2f14898b95b},
+	{0x3391fdddfc8dc739, 0x3707a65b1b470939, 0x7cf8b1d162af05ab, 0xfe8f450de5f36bc6,
+	 0xb0455a8520bc4e6f, 0x5fe95b1fe3c8452b},
+	{0x09330c33f71147e8, 0x3d192fc782cd1b47, 0x53111b173b3b05d2, 0x2fa08086e3b0f712,
+	 0xfcc7c71a557e2db9, 0x66c3e9fa91746039}
+};
+
+static uint64_t exp_sha512_256[MSGS][SHA512_256_DIGEST_NWORDS] = {
+	{0x53048e2681941ef9, 0x9b2e29b76b4c7dab, 0xe4c2d0c634fc6d46, 0xe0e2f13107e7af23},
+	{0xc672b8d1ef56ed28, 0xab87c3622c511406, 0x9bdd3ad7b8f97374, 0x98d0c01ecef0967a},
+	{0xbde8e1f9f19bb9fd, 0x3406c90ec6bc47bd, 0x36d8ada9f11880db, 0xc8a22a7078b6a461},
+	{0x3928e184fb8690f8, 0x40da3988121d31be, 0x65cb9d3ef83ee614, 0x6feac861e19b563a}
+};
+
+static uint64_t exp_sha512[MSGS][SHA512_DIGEST_NWORDS] = {
+	{0xddaf35a193617aba, 0xcc417349ae204131, 0x12e6fa4e89a97ea2, 0x0a9eeee64b55d39a,
+	 0x2192992a274fc1a8, 0x36ba3c23a3feebbd, 0x454d4423643ce80e, 0x2a9ac94fa54ca49f},
+	{0xcf83e1357eefb8bd, 0xf1542850d66d8007, 0xd620e4050b5715dc, 0x83f4a921d36ce9ce,
+	 0x47d0d13c5d85f2b0, 0xff8318d2877eec2f, 0x63b931bd47417a81, 0xa538327af927da3e},
+	{0x204a8fc6dda82f0a, 0x0ced7beb8e08a416, 0x57c16ef468b228a8, 0x279be331a703c335,
+	 0x96fd15c13b1b07f9, 0xaa1d3bea57789ca0, 0x31ad85c7a71dd703, 0x54ec631238ca3445},
+	{0x8e959b75dae313da, 0x8cf4f72814fc143f, 0x8f7779c6eb9f7fa1, 0x7299aeadb6889018,
+	 0x501d289e4900f7e4, 0x331b99dec4b5433a, 0xc7d329eeb6dd2654, 0x5e96e55b874be909}
+};
+
+// Each ctx cycles through SHA384, SHA512/256 and SHA512 over the rounds
+static int variant(uint32_t job, int round)
+{
+	return (job + round) % VARIANTS;
+}
+
+static int check_digest(SHA512_HASH_CTX * ctx, uint32_t job, int round)
+{
+	uint32_t m = job % MSGS;
+
+	switch (variant(job, round)) {
+	case 0:
+		return memcmp(ctx->job.result_digest, exp_sha384[m], sizeof(exp_sha384[m]));
+	case 1:
+		return memcmp(ctx->job.result_digest, exp_sha512_256[m],
+			      sizeof(exp_sha512_256[m]));
+	default:
+		return memcmp(ctx->job.result_digest, exp_sha512[m], sizeof(exp_sha512[m]));
+	}
+}
+
+int main(void)
+{
+	SHA512_HASH_CTX_MGR *mgr = NULL;
+	SHA512_HASH_CTX ctxpool[NUM_JOBS], *ctx;
+	uint32_t i, len, checked;
+	int round, ret;
+	uint8_t *msg;
+
+	ret = posix_memalign((void *)&mgr, 16, sizeof(SHA512_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	sha512_ctx_mgr_init(mgr);
+
+	for (i = 0; i < NUM_JOBS; i++) {
+		hash_ctx_init(&ctxpool[i]);
+		ctxpool[i].user_data = (void *)((uint64_t) i);
+	}
+
+	// Later rounds restart every completed ctx as another variant
+	for (round = 0; round < VARIANTS; round++) {
+		checked = 0;
+		for (i = 0; i < NUM_JOBS; i++) {
+			msg = msgs[i % MSGS];
+			len = strlen((char *)msg);
+			switch (variant(i, round)) {
+			case 0:
+				ctx = sha384_ctx_mgr_submit(mgr, &ctxpool[i], msg, len,
+							    HASH_ENTIRE);
+				break;
+			case 1:
+				ctx = sha512_256_ctx_mgr_submit(mgr, &ctxpool[i], msg, len,
+								HASH_ENTIRE);
+				break;
+			default:
+				ctx = sha512_ctx_mgr_submit(mgr, &ctxpool[i], msg, len,
+							    HASH_ENTIRE);
+			}
+
+			if (ctx) {
+				if (ctx->error || check_digest(ctx, (uint64_t) ctx->user_data, round)) {
+					printf("Test failed, job %d round %d\n",
+					       (int)(uint64_t) ctx->user_data, round);
+					return 1;
+				}
+				checked++;
+			}
+		}
+
+		while ((ctx = sha512_ctx_mgr_flush(mgr))) {
+			if (ctx->error || check_digest(ctx, (uint64_t) ctx->user_data, round)) {
+				printf("Test failed, job %d round %d\n",
+				       (int)(uint64_t) ctx->user_data, round);
+				return 1;
+			}
+			checked++;
+		}
+
+		if (checked != NUM_JOBS) {
+			printf("only tested %d rather than %d\n", checked, NUM_JOBS);
+			return 1;
+		}
+	}
+
+	printf(" multibinary_sha384 and sha512_256 test: Pass\n");
+
+	return 0;
+}
@@ -0,0 +1,193 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#if defined(__clang__)
+# pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__ICC)
+# pragma intel optimization_parameter target_arch=AVX2
+#elif defined(__ICL)
+# pragma [intel] optimization_parameter target_arch=AVX2
+#elif (__GNUC__ >= 5)
+# pragma GCC target("avx2")
+#endif
+
+#include <immintrin.h>
+#include "sha512_mb.h"
+
+#ifdef _MSC_VER
+# define inline __inline
+#endif
+
+/*
+ * Single buffer SHA512 for AVX2. The rounds run on the scalar unit while
+ * the message schedule for the next four rounds is computed four words at
+ * a time in ymm registers, so the two overlap.
+ */
+
+DECLARE_ALIGNED(static const uint64_t K[80], 32) = {
+	0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
+	0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
+	0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+	0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235, 0xc19bf174cf692694,
+	0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+	0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+	0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4,
+	0xc6e00bf33da88fc2, 0xd5a79147930aa725, 0x06ca6351e003826f, 0x142929670a0e6e70,
+	0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+	0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
+	0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30,
+	0xd192e819d6ef5218, 0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+	0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8,
+	0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3,
+	0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+	0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b,
+	0xca273eceea26619c, 0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178,
+	0x06f067aa72176fba, 0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+	0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c,
+	0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817
+};
+
+#define ror64(x, r)	(((x) >> (r)) | ((x) << (64 - (r))))
+#define vror64(x, r)	_mm256_or_si256(_mm256_srli_epi64(x, r), _mm256_slli_epi64(x, 64 - (r)))
+
+#define S0(x)		(ror64(x, 28) ^ ror64(x, 34) ^ ror64(x, 39))
+#define S1(x)		(ror64(x, 14) ^ ror64(x, 18) ^ ror64(x, 41))
+#define CH(e, f, g)	(((f ^ g) & e) ^ g)
+#define MAJ(a, b, c)	(((a | b) & c) | (a & b))
+
+#define ROUND(a, b, c, d, e, f, g, h, wk) \
+	do { \
+		uint64_t t1 = h + S1(e) + CH(e, f, g) + (wk); \
+		d += t1; \
+		h = t1 + S0(a) + MAJ(a, b, c); \
+	} while (0)
+
+static inline __m256i sigma0(__m256i x)
+{
+	return _mm256_xor_si256(_mm256_xor_si256(vror64(x, 1), vror64(x, 8)),
+				_mm256_srli_epi64(x, 7));
+}
+
+static inline __m256i sigma1(__m256i x)
+{
+	return _mm256_xor_si256(_mm256_xor_si256(vror64(x, 19), vror64(x, 61)),
+				_mm256_srli_epi64(x, 6));
+}
+
+// Words 1..4 of the 8 words in lo:hi
+static inline __m256i align_q1(__m256i hi, __m256i lo)
+{
+	return _mm256_permute4x64_epi64(_mm256_blend_epi32(lo, hi, 0x03), 0x39);
+}
+
+// W[t..t+3] from x0 = W[t-16..t-13] up to x3 = W[t-4..t-1]
+static inline __m256i schedule(__m256i x0, __m256i x1, __m256i x2, __m256i x3)
+{
+	__m256i zero = _mm256_setzero_si256();
+	__m256i w, s1;
+
+	w = _mm256_add_epi64(x0, sigma0(align_q1(x1, x0)));
+	w = _mm256_add_epi64(w, align_q1(x3, x2));
+
+	// Words 0 and 1 need W[t-2] and W[t-1], words 2 and 3 the new words 0 and 1
+	s1 = sigma1(_mm256_permute4x64_epi64(x3, 0xee));
+	w = _mm256_add_epi64(w, _mm256_blend_epi32(zero, s1, 0x0f));
+	s1 = sigma1(_mm256_permute4x64_epi64(w, 0x44));
+	return _mm256_add_epi64(w, _mm256_blend_epi32(zero, s1, 0xf0));
+}
+
+void sha512_avx2(const void *M, void *D, uint64_t L)
+{
+	const uint8_t *buf = (const uint8_t *)M;
+	uint64_t *digest = (uint64_t *) D;
+	const __m256i bswap = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+					      0, 1, 2, 3, 4, 5, 6, 7,
+					      8, 9, 10, 11, 12, 13, 14, 15,
+					      0, 1, 2, 3, 4, 5, 6, 7);
+	DECLARE_ALIGNED(uint64_t wk[8], 32);
+	uint64_t a, b, c, d, e, f, g, h;
+	__m256i x0, x1, x2, x3, t0 = _mm256_setzero_si256(), t1 = t0;
+	int i;
+
+	for (; L; L--, buf += SHA512_BLOCK_SIZE) {
+		a = digest[0];
+		b = digest[1];
+		c = digest[2];
+		d = digest[3];
+		e = digest[4];
+		f = digest[5];
+		g = digest[6];
+		h = digest[7];
+
+		x0 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(buf + 0)), bswap);
+		x1 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(buf + 32)), bswap);
+		x2 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(buf + 64)), bswap);
+		x3 = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(buf + 96)), bswap);
+
+		// Eight rounds a pass so the state names come back to where they started
+		for (i = 0; i < 80; i += 8) {
+			_mm256_store_si256((__m256i *) & wk[0],
+					   _mm256_add_epi64(x0, _mm256_load_si256((const __m256i *)
+										  &K[i])));
+			_mm256_store_si256((__m256i *) & wk[4],
+					   _mm256_add_epi64(x1, _mm256_load_si256((const __m256i *)
+										  &K[i + 4])));
+			if (i < 64) {
+				t0 = schedule(x0, x1, x2, x3);
+				t1 = schedule(x1, x2, x3, t0);
+			}
+			x0 = x2;
+			x1 = x3;
+			x2 = t0;
+			x3 = t1;
+
+			ROUND(a, b, c, d, e, f, g, h, wk[0]);
+			ROUND(h, a, b, c, d, e, f, g, wk[1]);
+			ROUND(g, h, a, b, c, d, e, f, wk[2]);
+			ROUND(f, g, h, a, b, c, d, e, wk[3]);
+			ROUND(e, f, g, h, a, b, c, d, wk[4]);
+			ROUND(d, e, f, g, h, a, b, c, wk[5]);
+			ROUND(c, d, e, f, g, h, a, b, wk[6]);
+			ROUND(b, c, d, e, f, g, h, a, wk[7]);
+		}
+
+		digest[0] += a;
+		digest[1] += b;
+		digest[2] += c;
+		digest[3] += d;
+		digest[4] += e;
+		digest[5] += f;
+		digest[6] += g;
+		digest[7] += h;
+	}
+}
+
+#if defined(__clang__)
+# pragma clang attribute pop
+#endif
@@ -101,6 +101,9 @@ SHA512_HASH_CTX *sha512_ctx_mgr_submit_base(SHA512_HASH_CTX_MGR * mgr, SHA512_HA
 		return ctx;
 	}
 
+	// Every piece is hashed before this submit returns, so none is left pending
+	ctx->pending_length = 0;
+
 	if (flags == HASH_FIRST) {
 
 		sha512_init(ctx, buffer, len);
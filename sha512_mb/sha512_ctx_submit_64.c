@@ -0,0 +1,68 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stddef.h>
+#include "sha512_mb.h"
+#include "sha512_ctx_submit_64.h"
+
+SHA512_HASH_CTX *sha512_ctx_mgr_submit_64(SHA512_HASH_CTX_MGR * mgr, SHA512_HASH_CTX * ctx,
+					  const void *buffer, uint64_t len,
+					  HASH_CTX_FLAG flags)
+{
+	SHA512_HASH_CTX *ret;
+	uint64_t piece;
+
+	do {
+		// End the piece on a block boundary so the next one can be hashed in place
+		piece = SHA512_SUBMIT_64_CHUNK;
+		if (!(flags & HASH_FIRST))
+			piece -= ctx->partial_block_buffer_length;
+
+		if (len <= piece)
+			return sha512_ctx_mgr_submit(mgr, ctx, buffer, (uint32_t) len, flags);
+
+		ret = sha512_ctx_mgr_submit(mgr, ctx, buffer, (uint32_t) piece,
+					    flags & ~HASH_LAST);
+		if (ctx->error != HASH_CTX_ERROR_NONE)
+			return ret;
+
+		buffer = (const uint8_t *)buffer + piece;
+		len -= piece;
+		flags &= ~HASH_FIRST;
+
+		// Left for the manager to take up when the piece in flight completes
+		ctx->pending_buffer = buffer;
+		ctx->pending_length = len;
+		ctx->pending_flags = flags;
+
+		// A ctx handed straight back is not in flight, so submit its next piece here
+	} while (ret == ctx);
+
+	return ret;
+}
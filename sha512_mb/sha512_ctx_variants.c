@@ -0,0 +1,81 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <string.h>
+#include "sha512_mb.h"
+
+/*
+ * SHA-384 and SHA-512/256 run on the SHA-512 lanes unchanged apart from the
+ * initial digest, which is loaded here instead of by the ctx manager's
+ * HASH_FIRST handling. Every job takes its digest from its own ctx, so all
+ * three variants can share one manager.
+ */
+static SHA512_HASH_CTX *sha512_ctx_variant_submit(SHA512_HASH_CTX_MGR * mgr,
+						  SHA512_HASH_CTX * ctx, const void *buffer,
+						  uint32_t len, HASH_CTX_FLAG flags,
+						  const SHA512_WORD_T * iv)
+{
+	if (flags & (~HASH_ENTIRE)) {
+		ctx->error = HASH_CTX_ERROR_INVALID_FLAGS;
+		return ctx;
+	}
+
+	if (flags & HASH_FIRST) {
+		if (ctx->status & HASH_CTX_STS_PROCESSING) {
+			ctx->error = HASH_CTX_ERROR_ALREADY_PROCESSING;
+			return ctx;
+		}
+
+		memcpy(ctx->job.result_digest, iv, SHA512_DIGEST_NWORDS * sizeof(*iv));
+		ctx->total_length = 0;
+		ctx->partial_block_buffer_length = 0;
+		ctx->error = HASH_CTX_ERROR_NONE;
+		ctx->status = HASH_CTX_STS_IDLE;
+	}
+
+	return sha512_ctx_mgr_submit(mgr, ctx, buffer, len, flags & ~HASH_FIRST);
+}
+
+SHA512_HASH_CTX *sha384_ctx_mgr_submit(SHA512_HASH_CTX_MGR * mgr, SHA512_HASH_CTX * ctx,
+				       const void *buffer, uint32_t len, HASH_CTX_FLAG flags)
+{
+	static const SHA512_WORD_T sha384_iv[SHA512_DIGEST_NWORDS] = { SHA384_INITIAL_DIGEST };
+
+	return sha512_ctx_variant_submit(mgr, ctx, buffer, len, flags, sha384_iv);
+}
+
+SHA512_HASH_CTX *sha512_256_ctx_mgr_submit(SHA512_HASH_CTX_MGR * mgr, SHA512_HASH_CTX * ctx,
+					   const void *buffer, uint32_t len,
+					   HASH_CTX_FLAG flags)
+{
+	static const SHA512_WORD_T sha512_256_iv[SHA512_DIGEST_NWORDS] =
+	    { SHA512_256_INITIAL_DIGEST };
+
+	return sha512_ctx_variant_submit(mgr, ctx, buffer, len, flags, sha512_256_iv);
+}
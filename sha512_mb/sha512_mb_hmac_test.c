@@ -0,0 +1,275 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha512_mb.h"
+#include "endian_helper.h"
+
+#define KEYS 4
+#define MSGS 4
+#define LONG_MSG_LEN 1000
+#define NUM_JOBS 1000
+
+static const uint32_t key_lens[KEYS] = { 0, 20, 64, 131 };
+
+static uint8_t msg1[] = "Hi There";
+static uint8_t msg2[] = "what do ya want for nothing?";
+static uint8_t msg3[50];
+static uint8_t msg4[LONG_MSG_LEN];
+
+static uint8_t *msgs[MSGS] = { msg1, msg2, msg3, msg4 };
+static const uint32_t msg_lens[MSGS] =
+    { sizeof(msg1) - 1, sizeof(msg2) - 1, sizeof(msg3), sizeof(msg4) };
+
+static uint8_t exp_mac[KEYS][MSGS][64] = {
+	{
+	 {0xf7, 0x68, 0x8a, 0x10, 0x43, 0x26, 0xd3, 0x6c, 0x19, 0x40,
+	  0xf6, 0xd2, 0x8d, 0x74, 0x6c, 0x06, 0x61, 0xd3, 0x83, 0xe0,
+	  0xd1, 0x4f, 0xe8, 0xa0, 0x46, 0x49, 0x44, 0x47, 0x77, 0x61,
+	  0x0f, 0x5d, 0xd9, 0x56, 0x5a, 0x36, 0x84, 0x6a, 0xb9, 0xe9,
+	  0xe7, 0x34, 0xcf, 0x38, 0x0d, 0x3a, 0x07, 0x0d, 0x8e, 0xf0,
+	  0x21, 0xb5, 0xf3, 0xa5, 0x0c, 0x48, 0x17, 0x10, 0xa4, 0x64,
+	  0x96, 0x8e, 0x34, 0x19},
+	 {0x12, 0x63, 0xac, 0x64, 0x89, 0x32, 0x4b, 0xdd, 0x55, 0xfe,
+	  0xad, 0x95, 0x6d, 0xc2, 0xbe, 0x54, 0x7b, 0xec, 0xe2, 0xb6,
+	  0x99, 0x21, 0x4b, 0x63, 0xb0, 0x27, 0x01, 0x43, 0xd7, 0x40,
+	  0xad, 0x63, 0x8f, 0x3c, 0xc6, 0xfe, 0xed, 0xc7, 0x40, 0xf8,
+	  0xd9, 0xac, 0x44, 0x86, 0x6d, 0xf1, 0x2a, 0x00, 0x73, 0xd5,
+	  0x72, 0x14, 0xeb, 0x39, 0x3f, 0x69, 0x2b, 0x4a, 0xe1, 0x7e,
+	  0xdf, 0x30, 0xd8, 0x61},
+	 {0x36, 0x41, 0x13, 0x90, 0x6c, 0x72, 0x68, 0xf6, 0xc0, 0xc3,
+	  0xf4, 0x97, 0x74, 0x11, 0xcf, 0x34, 0x15, 0x1d, 0xa7, 0x03,
+	  0xdb, 0xf6, 0xe0, 0xd3, 0xcd, 0x2a, 0x21, 0x79, 0xfa, 0x04,
+	  0x46, 0x06, 0x0b, 0xf5, 0x01, 0x7d, 0x7f, 0x41, 0x33, 0x04,
+	  0x29, 0xaf, 0x17, 0xfa, 0xa4, 0xbc, 0xd4, 0xc3, 0xda, 0x1e,
+	  0x65, 0x47, 0x67, 0x67, 0x0e, 0xc1, 0x77, 0x23, 0x9c, 0x39,
+	  0xb3, 0xee, 0xf0, 0x86},
+	 {0x8e, 0x17, 0xcb, 0xd4, 0xfd, 0x0e, 0xb8, 0x35, 0x17, 0x20,
+	  0x8b, 0x75, 0x80, 0x1d, 0x9d, 0x22, 0xb2, 0xac, 0x80, 0xa5,
+	  0xe2, 0x42, 0xc1, 0x66, 0x03, 0x1c, 0x8c, 0x42, 0xdf, 0xd6,
+	  0xdd, 0x5b, 0x81, 0x29, 0xb8, 0xce, 0x49, 0xd8, 0xc0, 0x28,
+	  0xfd, 0xbd, 0xc1, 0x34, 0x1b, 0x9c, 0xa8, 0xe0, 0xb1, 0xd0,
+	  0xdd, 0xe4, 0xe5, 0x74, 0xb3, 0xaf, 0x81, 0x2d, 0x51, 0x1e,
+	  0x63, 0xf3, 0x2a, 0x3c},
+	 },
+	{
+	 {0x43, 0xfe, 0x3f, 0xfa, 0x3d, 0x06, 0x49, 0x8b, 0x00, 0x2d,
+	  0xca, 0xea, 0x24, 0x64, 0xcc, 0x9c, 0x51, 0xe0, 0x5e, 0x29,
+	  0x69, 0x4e, 0x86, 0x8d, 0x3f, 0x5b, 0x94, 0xbc, 0xb4, 0x09,
+	  0x8f, 0xd0, 0x85, 0x19, 0x2e, 0x5d, 0x5a, 0x3b, 0xa1, 0x80,
+	  0xdb, 0x1f, 0x0b, 0x5a, 0xb8, 0x20, 0xac, 0x93, 0xe2, 0xf6,
+	  0x26, 0x22, 0x0a, 0xa3, 0x4c, 0x70, 0xff, 0x77, 0x28, 0x8b,
+	  0xee, 0xbc, 0x6d, 0xa1},
+	 {0xa4, 0x35, 0x72, 0x76, 0xb4, 0x45, 0x24, 0x39, 0xb1, 0x8b,
+	  0x9f, 0xcf, 0x55, 0x4b, 0xa5, 0xa3, 0xd5, 0x3a, 0xbb, 0xc9,
+	  0x29, 0xa5, 0xfe, 0x6e, 0xfe, 0x53, 0x89, 0x48, 0x64, 0x04,
+	  0x0f, 0x90, 0x9c, 0x4f, 0xde, 0xd6, 0x95, 0x2e, 0xdb, 0x4f,
+	  0xd0, 0x0f, 0x74, 0x28, 0xa3, 0xd8, 0x86, 0xa5, 0x1a, 0x87,
+	  0xd1, 0xc1, 0x0f, 0x4d, 0xa4, 0xbe, 0xc6, 0xf0, 0xa9, 0x12,
+	  0x73, 0x58, 0xfa, 0xf8},
+	 {0x45, 0x30, 0x27, 0xf9, 0xe2, 0xb2, 0x95, 0x5f, 0xf6, 0xb8,
+	  0x9d, 0xb6, 0x89, 0x47, 0x37, 0x02, 0x37, 0xb6, 0xb0, 0xed,
+	  0x6d, 0x2b, 0x4e, 0xc1, 0x22, 0x30, 0x6e, 0x73, 0x23, 0xe2,
+	  0xa1, 0x0b, 0x81, 0x34, 0x84, 0x30, 0x07, 0xd9, 0xde, 0xd4,
+	  0xd0, 0xc7, 0x0c, 0x9f, 0x01, 0x12, 0xdc, 0xea, 0x36, 0x39,
+	  0xcf, 0x26, 0x10, 0xe9, 0x4c, 0x08, 0x50, 0x75, 0xcf, 0xac,
+	  0xb6, 0x96, 0xb2, 0x3c},
+	 {0x56, 0xfd, 0x57, 0x25, 0xc6, 0xb9, 0x96, 0x90, 0xeb, 0x4d,
+	  0xab, 0xc9, 0x71, 0x43, 0xdf, 0x06, 0xc7, 0xdf, 0x55, 0x84,
+	  0x9e, 0x49, 0xf9, 0xe5, 0xb1, 0xc3, 0x26, 0x92, 0xd2, 0x88,
+	  0x48, 0x95, 0x2d, 0x61, 0xd4, 0x67, 0x40, 0xa3, 0x9c, 0xa6,
+	  0xfa, 0xf9, 0x6a, 0x2f, 0x18, 0xff, 0xd1, 0x58, 0xd7, 0xfa,
+	  0x43, 0x00, 0xe8, 0xe9, 0x25, 0x9d, 0x4c, 0xa8, 0x22, 0xbb,
+	  0x85, 0xf6, 0x61, 0x6f},
+	 },
+	{
+	 {0x9a, 0xfe, 0xa6, 0x8d, 0xe6, 0x4a, 0x94, 0x34, 0x47, 0x12,
+	  0x6f, 0x93, 0x96, 0x2b, 0xe2, 0x06, 0x45, 0xa1, 0xef, 0x32,
+	  0x31, 0xff, 0x22, 0x60, 0x83, 0x4b, 0x66, 0x7d, 0xfc, 0x11,
+	  0x9e, 0x53, 0xfd, 0x3b, 0xa7, 0xc7, 0x65, 0xa4, 0x1e, 0xb7,
+	  0xab, 0x7b, 0x41, 0x8d, 0x18, 0xea, 0x8d, 0x5b, 0xc5, 0x1e,
+	  0x77, 0x07, 0xc7, 0x41, 0xe2, 0x6d, 0x00, 0xc3, 0x30, 0x62,
+	  0xd4, 0x4a, 0x6c, 0x0a},
+	 {0x54, 0x5c, 0xd7, 0x40, 0x0d, 0xb9, 0x1f, 0x35, 0xd0, 0xf8,
+	  0xc5, 0xb0, 0xc8, 0x83, 0x47, 0x40, 0xfa, 0xeb, 0x7e, 0x5f,
+	  0xd4, 0x04, 0x78, 0x7b, 0x6e, 0x31, 0x80, 0x6a, 0x5b, 0x91,
+	  0x10, 0x02, 0x15, 0xc3, 0x93, 0x8e, 0xff, 0x9b, 0x6d, 0xa7,
+	  0x1b, 0x7a, 0x02, 0xe0, 0x4f, 0x16, 0x69, 0xc9, 0x20, 0x5f,
+	  0x48, 0xc6, 0xda, 0xc1, 0x1e, 0xab, 0x66, 0xa8, 0x7c, 0xdf,
+	  0x72, 0x2b, 0x28, 0x4b},
+	 {0x73, 0xb0, 0x2b, 0x62, 0xee, 0x09, 0xd8, 0xff, 0x6d, 0x0d,
+	  0xeb, 0xa3, 0x69, 0x7b, 0x96, 0x37, 0x37, 0x3f, 0x4f, 0x3d,
+	  0x69, 0x0e, 0x08, 0xcb, 0x23, 0xcf, 0x24, 0xad, 0xa8, 0x25,
+	  0xfa, 0x3f, 0x23, 0x7a, 0xe5, 0x5e, 0x2e, 0x0e, 0xa1, 0x78,
+	  0xec, 0x36, 0x60, 0x5c, 0x40, 0x06, 0xa0, 0x7a, 0x37, 0x7a,
+	  0xb0, 0x08, 0xd2, 0x38, 0xca, 0x72, 0x1d, 0x81, 0x5a, 0x6d,
+	  0x76, 0xfc, 0x9c, 0xcc},
+	 {0xf4, 0x80, 0xc6, 0xaa, 0xf3, 0xb1, 0x23, 0x83, 0xbc, 0x33,
+	  0x9c, 0x3f, 0xa8, 0xea, 0x62, 0xd8, 0x95, 0x6f, 0xc5, 0xe9,
+	  0x5e, 0xf1, 0xc2, 0xc7, 0x96, 0x13, 0x58, 0x5a, 0x12, 0x1c,
+	  0x7d, 0xc8, 0x54, 0x7d, 0xe4, 0xa6, 0xd0, 0xb5, 0x21, 0x67,
+	  0x96, 0x1e, 0x86, 0xcb, 0x8a, 0x75, 0xb3, 0xa5, 0x36, 0x0a,
+	  0x88, 0x7b, 0x11, 0x83, 0x80, 0xa2, 0x30, 0xb3, 0xde, 0xb0,
+	  0xc5, 0x3c, 0x9e, 0xc9},
+	 },
+	{
+	 {0x24, 0x86, 0x57, 0x31, 0xb0, 0xad, 0x4b, 0x5c, 0x0f, 0x0b,
+	  0x00, 0x7c, 0x01, 0x6c, 0xce, 0x38, 0xd5, 0xa2, 0x97, 0x7b,
+	  0xd3, 0x59, 0x21, 0xc0, 0x35, 0x5a, 0x4d, 0xa1, 0xaa, 0x53,
+	  0xd9, 0x97, 0xa8, 0xb4, 0x9b, 0x88, 0x44, 0x61, 0x3f, 0x51,
+	  0xc7, 0xb3, 0x1f, 0xa6, 0xa8, 0x98, 0x88, 0xcb, 0xa6, 0x14,
+	  0xc9, 0xf3, 0xd5, 0x7c, 0x4f, 0xdd, 0x2d, 0xf6, 0xe3, 0x28,
+	  0xc8, 0x8a, 0xb1, 0x75},
+	 {0xc6, 0xe3, 0xb7, 0xbb, 0x53, 0x6d, 0xa0, 0x6c, 0x7d, 0x94,
+	  0x9a, 0xfd, 0x3a, 0x10, 0x28, 0x36, 0xfa, 0x85, 0xc9, 0xe5,
+	  0xf3, 0xaa, 0x49, 0x09, 0x1f, 0x11, 0x0a, 0xdf, 0x6b, 0x6b,
+	  0x2c, 0xaf, 0x65, 0xad, 0xa6, 0xfa, 0x34, 0xca, 0x4e, 0x6a,
+	  0x70, 0xf2, 0x56, 0x98, 0x6e, 0xfc, 0x7b, 0xe0, 0xa8, 0x28,
+	  0x69, 0xeb, 0xbe, 0xa0, 0xce, 0x37, 0xde, 0xc3, 0x96, 0x31,
+	  0x12, 0xa3, 0x48, 0xe6},
+	 {0x0a, 0x8c, 0xb4, 0x87, 0x39, 0x61, 0xfe, 0x4f, 0xc6, 0x5e,
+	  0x3a, 0x6f, 0x8a, 0xf3, 0x61, 0xed, 0x37, 0x10, 0x3f, 0x74,
+	  0xa2, 0x81, 0x4a, 0xb1, 0x9d, 0x20, 0x24, 0x3a, 0xba, 0x0e,
+	  0x55, 0x9c, 0x8f, 0x40, 0xf3, 0xaa, 0xfc, 0x9d, 0x13, 0x3c,
+	  0xf5, 0x55, 0xc3, 0xc2, 0x86, 0xd1, 0xd8, 0x99, 0xc5, 0xbd,
+	  0xb3, 0xc9, 0x55, 0x11, 0xba, 0xe9, 0xc9, 0xbb, 0x6d, 0xc0,
+	  0x19, 0x9a, 0x8d, 0x7d},
+	 {0x27, 0x23, 0x4f, 0x27, 0x78, 0xab, 0x74, 0xb7, 0x61, 0xea,
+	  0xc3, 0xc6, 0x99, 0x00, 0xda, 0x1b, 0x8f, 0xf3, 0xb8, 0x7f,
+	  0xe8, 0xe0, 0x0d, 0x41, 0x51, 0x91, 0x56, 0xb6, 0x34, 0x61,
+	  0x8e, 0x19, 0x7e, 0xde, 0xd9, 0x0b, 0x49, 0x30, 0x20, 0x54,
+	  0x0e, 0x99, 0xcf, 0x79, 0x1f, 0xeb, 0xf6, 0xf3, 0x5f, 0xa2,
+	  0xdd, 0x58, 0x61, 0xbb, 0x06, 0x70, 0xc1, 0x28, 0xc2, 0xcd,
+	  0x74, 0xf0, 0x7e, 0xb0},
+	 },
+};
+
+// MAC of a completed ctx in byte order
+static void mac_bytes(uint8_t * out, HMAC_SHA512_HASH_CTX * hctx)
+{
+	uint64_t w;
+	int i;
+
+	for (i = 0; i < SHA512_DIGEST_NWORDS; i++) {
+		w = to_be64(hctx->ctx.job.result_digest[i]);
+		memcpy(out + i * sizeof(w), &w, sizeof(w));
+	}
+}
+
+static int check_mac(HMAC_SHA512_HASH_CTX * hctx, uint32_t job)
+{
+	uint8_t mac[sizeof(exp_mac[0][0])];
+
+	if (hctx->ctx.error || !hash_ctx_complete(&hctx->ctx))
+		return 1;
+
+	mac_bytes(mac, hctx);
+	return memcmp(mac, exp_mac[job % KEYS][job % MSGS], sizeof(mac));
+}
+
+int main(void)
+{
+	HMAC_SHA512_HASH_CTX_MGR *mgr = NULL;
+	HMAC_SHA512_HASH_CTX ctxpool[NUM_JOBS], *hctx;
+	HMAC_SHA512_KEY keys[KEYS];
+	uint8_t key[256];
+	uint32_t i, k, len, checked = 0;
+	int ret;
+
+	printf("hmac_sha512_mb test, %d jobs: ", NUM_JOBS);
+
+	ret = posix_memalign((void *)&mgr, 16, sizeof(HMAC_SHA512_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	memset(msg3, 0xdd, sizeof(msg3));
+	for (i = 0; i < LONG_MSG_LEN; i++)
+		msg4[i] = i * 13 + 5;
+	for (i = 0; i < sizeof(key); i++)
+		key[i] = i * 7 + 1;
+	for (k = 0; k < KEYS; k++)
+		hmac_sha512_key_init(&keys[k], key, key_lens[k]);
+
+	hmac_sha512_ctx_mgr_init(mgr);
+
+	// Whole messages, all keys and lengths mixed in the same lanes
+	for (i = 0; i < NUM_JOBS; i++) {
+		hash_ctx_init(&ctxpool[i].ctx);
+		ctxpool[i].ctx.user_data = (void *)((uint64_t) i);
+
+		hctx = hmac_sha512_ctx_mgr_submit(mgr, &ctxpool[i], &keys[i % KEYS],
+						  msgs[i % MSGS], msg_lens[i % MSGS], HASH_ENTIRE);
+		if (hctx) {
+			if (check_mac(hctx, (uint64_t) hctx->ctx.user_data)) {
+				printf("Test failed, job %d\n", (int)(uint64_t) hctx->ctx.user_data);
+				return 1;
+			}
+			checked++;
+		}
+	}
+
+	while ((hctx = hmac_sha512_ctx_mgr_flush(mgr))) {
+		if (check_mac(hctx, (uint64_t) hctx->ctx.user_data)) {
+			printf("Test failed, job %d\n", (int)(uint64_t) hctx->ctx.user_data);
+			return 1;
+		}
+		checked++;
+	}
+
+	if (checked != NUM_JOBS) {
+		printf("only tested %d rather than %d\n", checked, NUM_JOBS);
+		return 1;
+	}
+
+	// Same ctxs rekeyed and fed in two parts
+	for (i = 0; i < KEYS * MSGS; i++) {
+		len = msg_lens[i % MSGS] / 3;
+
+		hmac_sha512_ctx_mgr_submit(mgr, &ctxpool[i], &keys[i % KEYS], msgs[i % MSGS], len,
+					   HASH_FIRST);
+		while (hmac_sha512_ctx_mgr_flush(mgr)) ;
+
+		hmac_sha512_ctx_mgr_submit(mgr, &ctxpool[i], NULL, msgs[i % MSGS] + len,
+					   msg_lens[i % MSGS] - len, HASH_LAST);
+		while (hmac_sha512_ctx_mgr_flush(mgr)) ;
+
+		if (check_mac(&ctxpool[i], i)) {
+			printf("Test failed, job %d in parts\n", i);
+			return 1;
+		}
+	}
+
+	printf("Pass\n");
+
+	return 0;
+}
@@ -0,0 +1,81 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#ifndef _SHA512_MB_POOL_H_
+#define _SHA512_MB_POOL_H_
+
+/**
+ *  @file sha512_mb_pool.h
+ *  @brief Internal ctx pool shared by the SHA512 batch functions
+ *
+ *  The batch functions hand their jobs to sha512_mb_pool_run(), which owns a
+ *  manager and one ctx per lane and keeps every lane busy until all jobs are
+ *  done. Each batch function only says how a job starts and how it carries on.
+ */
+#include <stdint.h>
+#include "sha512_mb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Submit the first piece of job i on an idle ctx.
+ *
+ * lane is the index of ctx in the pool, for per-lane buffers that must stay
+ * untouched until the ctx is handed back.
+ *
+ * @returns whatever the manager handed back
+ */
+typedef SHA512_HASH_CTX *(*sha512_mb_pool_start_fn)(SHA512_HASH_CTX_MGR * mgr,
+						    SHA512_HASH_CTX * ctx, uint32_t i,
+						    uint32_t lane, void *arg);
+
+/**
+ * @brief Carry on with the job of a ctx the manager handed back without error.
+ *
+ * @returns 1 if the next piece was submitted, *ctx then holding whatever the
+ *          manager handed back, or 0 if the job is finished and *ctx is free
+ */
+typedef int (*sha512_mb_pool_next_fn)(SHA512_HASH_CTX_MGR * mgr, SHA512_HASH_CTX ** ctx,
+				      void *arg);
+
+/**
+ * @brief Run n jobs through a SHA512 manager with every lane kept busy.
+ *
+ * @returns 0 on success, -1 if any ctx was handed back with an error
+ */
+int sha512_mb_pool_run(uint32_t n, sha512_mb_pool_start_fn start,
+		       sha512_mb_pool_next_fn next, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SHA512_MB_POOL_H_
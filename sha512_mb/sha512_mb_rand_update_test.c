@@ -72,6 +72,10 @@ int main(void)
 	unsigned char *bufs[TEST_BUFS];
 	unsigned char *buf_ptr[TEST_BUFS];
 	uint32_t lens[TEST_BUFS];
+	uint32_t first_lens[TEST_BUFS];
+	SHA512_HASH_CTX *ctx_ptrs[TEST_BUFS], *completed[TEST_BUFS];
+	const void *batch_bufs[TEST_BUFS];
+	uint32_t k, batch, num_completed;
 	unsigned int joblen, jobs, t;
 	int ret;
 
@@ -101,6 +105,8 @@ int main(void)
 		// Init ctx contents
 		hash_ctx_init(&ctxpool[i]);
 		ctxpool[i].user_data = (void *)((uint64_t) i);
+		ctx_ptrs[i] = &ctxpool[i];
+		batch_bufs[i] = bufs[i];
 
 		// Run reference test
 		sha512_ref(bufs[i], digest_ref[i], TEST_LEN);
@@ -291,6 +297,106 @@ int main(void)
 		fflush(0);
 	}			// random test t
 
+	// Run random jobs again, starting each batch with HASH_FIRST
+	for (t = 0; t < RANDOMS; t++) {
+		jobs = rand() % (TEST_BUFS) + 1;
+
+		for (i = 0; i < jobs; i++) {
+			joblen = rand() % (TEST_LEN);
+			rand_buffer(bufs[i], joblen);
+			lens[i] = joblen;
+			first_lens[i] = joblen < UPDATE_SIZE ? joblen : UPDATE_SIZE;
+			sha512_ref(bufs[i], digest_ref[i], lens[i]);
+		}
+
+		sha512_ctx_mgr_init(mgr);
+
+		for (i = 0; i < jobs; i += batch) {
+			batch = rand() % (2 * SHA512_MAX_LANES) + 1;
+			if (batch > jobs - i)
+				batch = jobs - i;
+
+			sha512_ctx_mgr_submit_batch(mgr, &ctx_ptrs[i], &batch_bufs[i],
+						    &first_lens[i], batch, HASH_FIRST,
+						    completed, &num_completed);
+
+			// Finish each returned job with the rest of its buffer as LAST
+			for (k = 0; k < num_completed; k++) {
+				ctx = completed[k];
+				while ((ctx != NULL) && !(hash_ctx_complete(ctx))) {
+					if (ctx->error) {
+						printf("Batch returned error %d\n", ctx->error);
+						return 1;
+					}
+					j = (unsigned long)(ctx->user_data);
+					buf_ptr[j] = bufs[j] + ctx->total_length;
+					len_rem = lens[j] - ctx->total_length;
+					ctx = sha512_ctx_mgr_submit(mgr,
+								    &ctxpool[j],
+								    buf_ptr[j],
+								    len_rem,
+								    HASH_LAST);
+				}
+			}
+		}
+
+		// Start flushing finished jobs, end on last flushed
+		ctx = sha512_ctx_mgr_flush(mgr);
+		while (ctx) {
+			if (hash_ctx_complete(ctx)) {
+				debug_char('-');
+				ctx = sha512_ctx_mgr_flush(mgr);
+				continue;
+			}
+			// Resubmit unfinished job
+			i = (unsigned long)(ctx->user_data);
+			buf_ptr[i] = bufs[i] + ctx->total_length;
+			len_rem = lens[i] - ctx->total_length;
+			ctx = sha512_ctx_mgr_submit(mgr, &ctxpool[i], buf_ptr[i], len_rem,
+						    HASH_LAST);
+
+			if (ctx == NULL)
+				ctx = sha512_ctx_mgr_flush(mgr);
+		}
+
+		// Check result digest
+		for (i = 0; i < jobs; i++) {
+			for (j = 0; j < SHA512_DIGEST_NWORDS; j++) {
+				if (ctxpool[i].job.result_digest[j] != digest_ref[i][j]) {
+					fail++;
+					printf("Test%d, digest%d fail %8lX <=> %8lX\n",
+					       i, j, ctxpool[i].job.result_digest[j],
+					       digest_ref[i][j]);
+				}
+			}
+		}
+		if (fail) {
+			printf("Test failed function check %d\n", fail);
+			return fail;
+		}
+
+		putchar('.');
+		fflush(0);
+	}			// batch test t
+
+	// A bad flag rejects the whole batch before any job reaches the manager
+	sha512_ctx_mgr_init(mgr);
+	sha512_ctx_mgr_submit_batch(mgr, ctx_ptrs, batch_bufs, lens, TEST_BUFS,
+				    (HASH_CTX_FLAG) (HASH_ENTIRE + 1), completed,
+				    &num_completed);
+	if (num_completed != TEST_BUFS || sha512_ctx_mgr_flush(mgr) != NULL) {
+		printf("Test failed, bad flags returned %d of %d jobs\n", num_completed,
+		       TEST_BUFS);
+		return 1;
+	}
+	for (i = 0; i < TEST_BUFS; i++) {
+		if (completed[i]->error != HASH_CTX_ERROR_INVALID_FLAGS) {
+			printf("Test failed, bad flags not reported for job %d\n", i);
+			return 1;
+		}
+	}
+	putchar('.');
+
 	if (fail)
 		printf("Test failed function check %d\n", fail);
 	else
@@ -0,0 +1,344 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sha512_mb.h"
+#include "isal_crypto_dispatch.h"
+
+#define TEST_LEN  (16*1024)
+#define TEST_BUFS 20
+#ifndef RANDOMS
+# define RANDOMS  10
+#endif
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+
+#define MAX_UPDATE_LEN	(4 * SHA512_BLOCK_SIZE + 17)
+
+typedef uint64_t DigestSHA512[SHA512_DIGEST_NWORDS];
+
+struct sha512_variant {
+	const char *name;
+	uint64_t cpu_features;	// ISAL_CPU_* needed to run it
+	void (*init)(SHA512_HASH_CTX_MGR *);
+	SHA512_HASH_CTX *(*submit)(SHA512_HASH_CTX_MGR *, SHA512_HASH_CTX *, const void *,
+				   uint32_t, HASH_CTX_FLAG);
+	SHA512_HASH_CTX *(*flush)(SHA512_HASH_CTX_MGR *);
+};
+
+// Managers called directly, so they are tested whatever the dispatch picks
+static const struct sha512_variant variants[] = {
+#if (!defined(NOARCH)) && (defined(__i386__) || defined(__x86_64__) \
+	|| defined( _M_X64) || defined(_M_IX86))
+	{"sb_avx2", ISAL_CPU_X86_AVX2, sha512_ctx_mgr_init_sb_avx2,
+	 sha512_ctx_mgr_submit_sb_avx2, sha512_ctx_mgr_flush_sb_avx2},
+# ifdef HAVE_AS_KNOWS_SHA512NI
+	{"ni", ISAL_CPU_X86_AVX2 | ISAL_CPU_X86_SHA512, sha512_ctx_mgr_init_ni,
+	 sha512_ctx_mgr_submit_ni, sha512_ctx_mgr_flush_ni},
+# endif
+#endif
+	{NULL, 0, NULL, NULL, NULL}
+};
+
+#define MSGS 8
+
+static uint8_t msg1[] = "The quick brown fox jumps over the lazy dog";
+static uint8_t msg2[] = "The quick brown fox jumps over the lazy dog.";
+static uint8_t msg3[] = { 0x0a, 0x55, 0xdb, 0 };
+static uint8_t msg4[] = { 0xba, 0xd7, 0xc6, 0x18, 0xf4, 0x5b, 0xe2, 0x07, 0x97, 0x5e, 0 };
+
+static uint8_t msg5[] = {
+	0xb1, 0x71, 0x5f, 0x78, 0x2f, 0xf0, 0x2c, 0x6b, 0x88, 0x93,
+	0x7f, 0x05, 0x41, 0x16, 0
+};
+
+static uint8_t msg6[] = {
+	0xc6, 0xa1, 0x70, 0x93, 0x65, 0x68, 0x65, 0x10, 0x20, 0xed,
+	0xfe, 0x15, 0xdf, 0x80, 0x12, 0xac, 0xda, 0x8d, 0
+};
+
+static uint8_t msg7[] = {
+	0xa8, 0xa3, 0x7d, 0xfc, 0x08, 0x3a, 0xd2, 0xf4, 0x7f, 0xff,
+	0x46, 0x87, 0x38, 0xbf, 0x8b, 0x72, 0x8e, 0xb7, 0xf1, 0x90,
+	0x7e, 0x42, 0x7f, 0xa1, 0x5c, 0xb4, 0x42, 0x4b, 0xc6, 0x85,
+	0xe5, 0x5e, 0xd7, 0xb2, 0x82, 0x5c, 0x9c, 0x60, 0xb8, 0x39,
+	0xcc, 0xc2, 0xfe, 0x5f, 0xb3, 0x3e, 0x36, 0xf5, 0x70, 0xcb,
+	0x86, 0x61, 0x60, 0x9e, 0x63, 0x0b, 0xda, 0x05, 0xee, 0x64,
+	0x1d, 0x93, 0x84, 0x28, 0x86, 0x7d, 0x90, 0xe0, 0x07, 0x44,
+	0xa4, 0xaa, 0xd4, 0x94, 0xc9, 0x3c, 0x5f, 0x6d, 0x13, 0x27,
+	0x87, 0x80, 0x78, 0x59, 0x0c, 0xdc, 0xe1, 0xe6, 0x47, 0xc9,
+	0x82, 0x08, 0x18, 0xf4, 0x67, 0x64, 0x1f, 0xcd, 0x50, 0x8e,
+	0x2f, 0x2e, 0xbf, 0xd0, 0xff, 0x3d, 0x4f, 0x27, 0x23, 0x93,
+	0x47, 0x8f, 0x3b, 0x9e, 0x6f, 0x80, 0x6b, 0x43, 0
+};
+
+static uint8_t msg8[] = "";
+
+static DigestSHA512 expResultDigest1 = {
+	0x07e547d9586f6a73, 0xf73fbac0435ed769, 0x51218fb7d0c8d788, 0xa309d785436bbb64,
+	0x2e93a252a954f239, 0x12547d1e8a3b5ed6, 0xe1bfd7097821233f, 0xa0538f3db854fee6
+};
+
+static DigestSHA512 expResultDigest2 = {
+	0x91ea1245f20d46ae, 0x9a037a989f54f1f7, 0x90f0a47607eeb8a1, 0x4d12890cea77a1bb,
+	0xc6c7ed9cf205e67b, 0x7f2b8fd4c7dfd3a7, 0xa8617e45f3c463d4, 0x81c7e586c39ac1ed
+};
+
+static DigestSHA512 expResultDigest3 = {
+	0x7952585e5330cb24, 0x7d72bae696fc8a6b, 0x0f7d0804577e347d, 0x99bc1b11e52f3849,
+	0x85a428449382306a, 0x89261ae143c2f3fb, 0x613804ab20b42dc0, 0x97e5bf4a96ef919b
+};
+
+static DigestSHA512 expResultDigest4 = {
+	0x5886828959d1f822, 0x54068be0bd14b6a8, 0x8f59f534061fb203, 0x76a0541052dd3635,
+	0xedf3c6f0ca3d0877, 0x5e13525df9333a21, 0x13c0b2af76515887, 0x529910b6c793c8a5
+};
+
+static DigestSHA512 expResultDigest5 = {
+	0xee1a56ee78182ec4, 0x1d2c3ab33d4c4187, 0x1d437c5c1ca060ee, 0x9e219cb83689b4e5,
+	0xa4174dfdab5d1d10, 0x96a31a7c8d3abda7, 0x5c1b5e6da97e1814, 0x901c505b0bc07f25
+};
+
+static DigestSHA512 expResultDigest6 = {
+	0xc36c100cdb6c8c45, 0xb072f18256d63a66, 0xc9843acb4d07de62, 0xe0600711d4fbe64c,
+	0x8cf314ec3457c903, 0x08147cb7ac7e4d07, 0x3ba10f0ced78ea72, 0x4a474b32dae71231
+};
+
+static DigestSHA512 expResultDigest7 = {
+	0x8e1c91729be8eb40, 0x226f6c58a029380e, 0xf7edb9dc166a5c3c, 0xdbcefe90bd30d85c,
+	0xb7c4b248e66abf0a, 0x3a4c842281299bef, 0x6db88858d9e5ab52, 0x44f70b7969e1c072
+};
+
+static DigestSHA512 expResultDigest8 = {
+	0xcf83e1357eefb8bd, 0xf1542850d66d8007, 0xd620e4050b5715dc, 0x83f4a921d36ce9ce,
+	0x47d0d13c5d85f2b0, 0xff8318d2877eec2f, 0x63b931bd47417a81, 0xa538327af927da3e
+};
+
+static uint8_t *msgs[MSGS] = { msg1, msg2, msg3, msg4, msg5, msg6, msg7, msg8 };
+
+static uint64_t *expResultDigest[MSGS] = { expResultDigest1, expResultDigest2,
+	expResultDigest3, expResultDigest4, expResultDigest5, expResultDigest6,
+	expResultDigest7, expResultDigest8
+};
+
+/* Reference digest global to reduce stack usage */
+static uint64_t digest_ref[TEST_BUFS][SHA512_DIGEST_NWORDS];
+
+extern void sha512_ref(uint8_t * input_data, uint64_t * digest, uint32_t len);
+
+// Generates pseudo-random data
+static void rand_buffer(unsigned char *buf, const long buffer_size)
+{
+	long i;
+	for (i = 0; i < buffer_size; i++)
+		buf[i] = rand();
+}
+
+static int check_digest(const char *name, uint32_t job, const uint64_t * digest,
+			const uint64_t * good)
+{
+	uint32_t j;
+
+	for (j = 0; j < SHA512_DIGEST_NWORDS; j++) {
+		if (digest[j] != good[j]) {
+			printf("\n%s: job %d, digest %d is %016llX, should be %016llX\n",
+			       name, job, j, (unsigned long long)digest[j],
+			       (unsigned long long)good[j]);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+// Known answers, all messages in flight at once
+static int kat_test(const struct sha512_variant *v, SHA512_HASH_CTX_MGR * mgr)
+{
+	SHA512_HASH_CTX ctxpool[MSGS], *ctx;
+	uint32_t i, returned = 0;
+
+	v->init(mgr);
+
+	for (i = 0; i < MSGS; i++) {
+		hash_ctx_init(&ctxpool[i]);
+		ctx = v->submit(mgr, &ctxpool[i], msgs[i], strlen((char *)msgs[i]), HASH_ENTIRE);
+		if (ctx && ctx->error) {
+			printf("\n%s: submit error %d\n", v->name, ctx->error);
+			return -1;
+		}
+		if (ctx)
+			returned++;
+	}
+
+	while ((ctx = v->flush(mgr)) != NULL) {
+		if (ctx->error) {
+			printf("\n%s: flush error %d\n", v->name, ctx->error);
+			return -1;
+		}
+		returned++;
+	}
+
+	if (returned != MSGS) {
+		printf("\n%s: %d of %d jobs returned\n", v->name, returned, MSGS);
+		return -1;
+	}
+
+	for (i = 0; i < MSGS; i++)
+		if (check_digest(v->name, i, ctxpool[i].job.result_digest, expResultDigest[i]))
+			return -1;
+
+	return 0;
+}
+
+// Random length jobs fed in random size updates, several of them in flight
+static int rand_update_test(const struct sha512_variant *v, SHA512_HASH_CTX_MGR * mgr,
+			    unsigned char **bufs)
+{
+	SHA512_HASH_CTX ctxpool[TEST_BUFS], *ctx;
+	uint32_t lens[TEST_BUFS], done[TEST_BUFS], last[TEST_BUFS];
+	uint32_t i, t, jobs, len, pending, submitted;
+	HASH_CTX_FLAG flags;
+
+	for (t = 0; t < RANDOMS; t++) {
+		jobs = rand() % TEST_BUFS + 1;
+
+		for (i = 0; i < jobs; i++) {
+			lens[i] = rand() % TEST_LEN;
+			rand_buffer(bufs[i], lens[i]);
+			sha512_ref(bufs[i], digest_ref[i], lens[i]);
+			hash_ctx_init(&ctxpool[i]);
+			done[i] = 0;
+			last[i] = 0;
+		}
+
+		v->init(mgr);
+
+		for (;;) {
+			pending = 0;
+			submitted = 0;
+			for (i = 0; i < jobs; i++) {
+				if (last[i])
+					continue;
+				pending++;
+				if (hash_ctx_processing(&ctxpool[i]))
+					continue;
+
+				len = rand() % MAX_UPDATE_LEN;
+				flags = (done[i] == 0) ? HASH_FIRST : HASH_UPDATE;
+				if (lens[i] - done[i] <= len) {
+					len = lens[i] - done[i];
+					flags |= HASH_LAST;
+					last[i] = 1;
+				}
+
+				ctx = v->submit(mgr, &ctxpool[i], bufs[i] + done[i], len, flags);
+				if (ctx && ctx->error) {
+					printf("\n%s: submit error %d\n", v->name, ctx->error);
+					return -1;
+				}
+				done[i] += len;
+				submitted++;
+			}
+			if (pending == 0)
+				break;
+
+			// Leave jobs in the lanes between rounds now and then
+			if (submitted == 0 || (rand() & 1))
+				while (v->flush(mgr) != NULL) ;
+		}
+
+		while (v->flush(mgr) != NULL) ;
+
+		for (i = 0; i < jobs; i++) {
+			if (!hash_ctx_complete(&ctxpool[i])) {
+				printf("\n%s: job %d not complete\n", v->name, i);
+				return -1;
+			}
+			if (check_digest(v->name, i, ctxpool[i].job.result_digest, digest_ref[i]))
+				return -1;
+		}
+		putchar('.');
+	}
+
+	return 0;
+}
+
+int main(void)
+{
+	struct isal_crypto_dispatch_info info;
+	SHA512_HASH_CTX_MGR *mgr = NULL;
+	const struct sha512_variant *v;
+	unsigned char *bufs[TEST_BUFS];
+	int i, ret;
+
+	printf("sha512_mb_variants test:");
+
+	if (isal_crypto_dispatch_info(&info, NULL, 0) < 0) {
+		printf(" isal_crypto_dispatch_info failed\n");
+		return 1;
+	}
+
+	ret = posix_memalign((void *)&mgr, 16, sizeof(SHA512_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	for (i = 0; i < TEST_BUFS; i++) {
+		bufs[i] = (unsigned char *)malloc(TEST_LEN);
+		if (bufs[i] == NULL) {
+			printf("malloc failed test aborted\n");
+			return 1;
+		}
+	}
+
+	srand(TEST_SEED);
+
+	for (v = variants; v->name != NULL; v++) {
+		if ((info.cpu_features & v->cpu_features) != v->cpu_features) {
+			printf(" %s(skipped)", v->name);
+			continue;
+		}
+		printf(" %s", v->name);
+		if (kat_test(v, mgr) || rand_update_test(v, mgr, bufs)) {
+			printf("Test failed function check\n");
+			return 1;
+		}
+		fflush(0);
+	}
+
+	for (i = 0; i < TEST_BUFS; i++)
+		free(bufs[i]);
+	free(mgr);
+
+	printf(" Pass\n");
+	return 0;
+}
@@ -30,19 +30,40 @@
 %include "reg_sizes.asm"
 %include "multibinary.asm"
 
+;;;;;
+; mbin_atom_avx2_check parameters
+; Use the single buffer function on Atom class cores with AVX2, where the
+; AVX2 lanes do not pay off, like AVOTON for SSE. Clobbers eax-edx.
+; 1-> AVX2 single buffer opt func
+;;;;;
+%macro mbin_atom_avx2_check 1
+		mov	eax, 1
+		cpuid
+		and	eax, FLAG_CPUID1_EAX_STEP_MASK
+		lea	mbin_rbx, [%1 WRT_OPT]
+		cmp	eax, FLAG_CPUID1_EAX_ALDERLAKE_N
+		cmove	mbin_rsi, mbin_rbx
+		cmp	eax, FLAG_CPUID1_EAX_SIERRAFOREST
+		cmove	mbin_rsi, mbin_rbx
+%endmacro
+
 ;;;;;
 ; mbin_dispatch_init_avoton parameters
 ; Use this function when SSE/00/01 is a minimum requirement
 ; if AVOTON is true, then use avoton_func instead of sse_func
+; if an Atom class core with AVX2 is found, then use avx2_sb_func instead
+; of the AVX2 lanes, as AVOTON does for SSE
 ; 1-> function name
 ; 2-> SSE/00/01 optimized function used as base
 ; 3-> AVX or AVX/02 opt func
 ; 4-> AVX2 or AVX/04 opt func
 ; 5-> AVOTON opt func
+; 6-> AVX2 single buffer opt func
 ;;;;;
-%macro mbin_dispatch_init_avoton 5
+%macro mbin_dispatch_init_avoton 6
 	section .text
 	%1_dispatch_init:
+		endbranch
 		push	mbin_rsi
 		push	mbin_rax
 		push	mbin_rbx
@@ -60,12 +81,14 @@
 		cmove   mbin_rsi, mbin_rdi
 		je	_%1_init_done
 
+		mbin_isa_cap ISAL_ISA_AVX, _%1_init_done
 		and	ecx, (FLAG_CPUID1_ECX_AVX | FLAG_CPUID1_ECX_OSXSAVE)
 		cmp	ecx, (FLAG_CPUID1_ECX_AVX | FLAG_CPUID1_ECX_OSXSAVE)
 		lea	mbin_rbx, [%3 WRT_OPT] ; AVX (gen2) opt func
 		jne	_%1_init_done ; AVX is not available so end
 		mov	mbin_rsi, mbin_rbx
 
+		mbin_isa_cap ISAL_ISA_AVX2, _%1_ymm_check
 		;; Try for AVX2
 		xor	ecx, ecx
 		mov	eax, 7
@@ -73,7 +96,11 @@
 		test	ebx, FLAG_CPUID7_EBX_AVX2
 		lea	mbin_rbx, [%4 WRT_OPT] ; AVX (gen4) opt func
 		cmovne	mbin_rsi, mbin_rbx
+		je	_%1_ymm_check
+
+		mbin_atom_avx2_check %6
 
+	_%1_ymm_check:
 		;; Does it have xmm and ymm support
 		xor	ecx, ecx
 		xgetbv
@@ -83,6 +110,7 @@
 		lea	mbin_rsi, [%2 WRT_OPT]
 
 	_%1_init_done:
+		mbin_dispatch_record %1, %2, %3, %4, %5, %6
 		pop	mbin_rdi
 		pop	mbin_rdx
 		pop	mbin_rcx
@@ -96,6 +124,8 @@
 ;;;;;
 ; mbin_dispatch_init6_avoton parameters
 ; if AVOTON is true, then use avoton_func instead of sse_func
+; if an Atom class core with AVX2 is found, then use avx2_sb_func instead
+; of the AVX2 lanes
 ; 1-> function name
 ; 2-> base function
 ; 3-> SSE4_1 or 00/01 optimized function
@@ -103,10 +133,12 @@
 ; 5-> AVX2/04 opt func
 ; 6-> AVX512/06 opt func
 ; 7-> AVOTON opt func
+; 8-> AVX2 single buffer opt func
 ;;;;;
-%macro mbin_dispatch_init6_avoton 7
+%macro mbin_dispatch_init6_avoton 8
 	section .text
 	%1_dispatch_init:
+		endbranch
 		push	mbin_rsi
 		push	mbin_rax
 		push	mbin_rbx
@@ -115,6 +147,7 @@
 		push	mbin_rdi
 		lea	mbin_rsi, [%2 WRT_OPT] ; Default - use base function
 
+		mbin_isa_cap ISAL_ISA_SSE, _%1_init_done
 		mov	eax, 1
 		cpuid
 		mov	ebx, ecx ; save cpuid1.ecx
@@ -130,6 +163,7 @@
 		je	_%1_init_done
 
 
+		mbin_isa_cap ISAL_ISA_AVX, _%1_init_done
 		;; Test for XMM_YMM support/AVX
 		test	ecx, FLAG_CPUID1_ECX_OSXSAVE
 		je	_%1_init_done
@@ -144,6 +178,7 @@
 		je	_%1_init_done
 		lea	mbin_rsi, [%4 WRT_OPT] ; AVX/02 opt
 
+		mbin_isa_cap ISAL_ISA_AVX2, _%1_init_done
 		;; Test for AVX2
 		xor	ecx, ecx
 		mov	eax, 7
@@ -152,16 +187,22 @@
 		je	_%1_init_done		; No AVX2 possible
 		lea	mbin_rsi, [%5 WRT_OPT] 	; AVX2/04 opt func
 
+		mbin_isa_cap ISAL_ISA_AVX512, _%1_atom_check
 		;; Test for AVX512
 		and	edi, FLAG_XGETBV_EAX_ZMM_OPM
 		cmp	edi, FLAG_XGETBV_EAX_ZMM_OPM
-		jne	_%1_init_done	  ; No AVX512 possible
+		jne	_%1_atom_check	  ; No AVX512 possible
 		and	ebx, FLAGS_CPUID7_EBX_AVX512_G1
 		cmp	ebx, FLAGS_CPUID7_EBX_AVX512_G1
 		lea	mbin_rbx, [%6 WRT_OPT] ; AVX512/06 opt
 		cmove	mbin_rsi, mbin_rbx
+		je	_%1_init_done
+
+	_%1_atom_check:
+		mbin_atom_avx2_check %8
 
 	_%1_init_done:
+		mbin_dispatch_record %1, %2, %3, %4, %5, %6, %7, %8
 		pop	mbin_rdi
 		pop	mbin_rdx
 		pop	mbin_rcx
@@ -207,6 +248,10 @@ extern sha512_ctx_mgr_init_sb_sse4
 extern sha512_ctx_mgr_submit_sb_sse4
 extern sha512_ctx_mgr_flush_sb_sse4
 
+extern sha512_ctx_mgr_init_sb_avx2
+extern sha512_ctx_mgr_submit_sb_avx2
+extern sha512_ctx_mgr_flush_sb_avx2
+
 ;;; *_mbinit are initial values for *_dispatched; is updated on first call.
 ;;; Therefore, *_dispatch_init is only executed on first call.
 
@@ -220,29 +265,29 @@ mbin_interface sha512_ctx_mgr_flush
  mbin_dispatch_init6_avoton sha512_ctx_mgr_init, sha512_ctx_mgr_init_base, \
 			sha512_ctx_mgr_init_sse, sha512_ctx_mgr_init_avx, \
 			sha512_ctx_mgr_init_avx2, sha512_ctx_mgr_init_avx512, \
-			sha512_ctx_mgr_init_sb_sse4
+			sha512_ctx_mgr_init_sb_sse4, sha512_ctx_mgr_init_sb_avx2
 
  mbin_dispatch_init6_avoton sha512_ctx_mgr_submit, sha512_ctx_mgr_submit_base, \
 			sha512_ctx_mgr_submit_sse, sha512_ctx_mgr_submit_avx, \
 			sha512_ctx_mgr_submit_avx2, sha512_ctx_mgr_submit_avx512, \
-			sha512_ctx_mgr_submit_sb_sse4
+			sha512_ctx_mgr_submit_sb_sse4, sha512_ctx_mgr_submit_sb_avx2
 
  mbin_dispatch_init6_avoton sha512_ctx_mgr_flush, sha512_ctx_mgr_flush_base, \
 			sha512_ctx_mgr_flush_sse, sha512_ctx_mgr_flush_avx, \
 			sha512_ctx_mgr_flush_avx2, sha512_ctx_mgr_flush_avx512, \
-			sha512_ctx_mgr_flush_sb_sse4
+			sha512_ctx_mgr_flush_sb_sse4, sha512_ctx_mgr_flush_sb_avx2
 %else
  mbin_dispatch_init_avoton sha512_ctx_mgr_init, sha512_ctx_mgr_init_sse, \
 			sha512_ctx_mgr_init_avx, sha512_ctx_mgr_init_avx2, \
-			sha512_ctx_mgr_init_sb_sse4
+			sha512_ctx_mgr_init_sb_sse4, sha512_ctx_mgr_init_sb_avx2
 
  mbin_dispatch_init_avoton sha512_ctx_mgr_submit, sha512_ctx_mgr_submit_sse, \
 			sha512_ctx_mgr_submit_avx, sha512_ctx_mgr_submit_avx2, \
-			sha512_ctx_mgr_submit_sb_sse4
+			sha512_ctx_mgr_submit_sb_sse4, sha512_ctx_mgr_submit_sb_avx2
 
  mbin_dispatch_init_avoton sha512_ctx_mgr_flush, sha512_ctx_mgr_flush_sse, \
 			sha512_ctx_mgr_flush_avx, sha512_ctx_mgr_flush_avx2, \
-			sha512_ctx_mgr_flush_sb_sse4
+			sha512_ctx_mgr_flush_sb_sse4, sha512_ctx_mgr_flush_sb_avx2
 %endif
 
 
@@ -0,0 +1,247 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+%include "sha512_job.asm"
+%include "reg_sizes.asm"
+
+%ifdef HAVE_AS_KNOWS_SHA512NI
+
+[bits 64]
+default rel
+section .text
+
+%ifidn __OUTPUT_FORMAT__, elf64
+ ; Linux
+ %define arg0  rdi
+ %define arg1  rsi
+%else
+ ; Windows
+ %define arg0   rcx
+ %define arg1   rdx
+%endif
+
+%define STATE0		ymm0	; A B E F, A in the top qword
+%define STATE1		ymm1	; C D G H, C in the top qword
+%define MSG0		ymm2
+%define MSG1		ymm3
+%define MSG2		ymm4
+%define MSG3		ymm5
+%define MSG0x		xmm2
+%define MSG1x		xmm3
+%define MSG2x		xmm4
+%define MSG3x		xmm5
+%define WK		ymm6
+%define WKx		xmm6
+%define TMP		ymm7
+%define SHUF_MASK	ymm8
+%define ABEF_SAVE	ymm9
+%define CDGH_SAVE	ymm10
+
+%define JOB	arg0
+%define NBLK	arg1
+%define DPTR	r10
+%define TBL	rax
+
+;; Four rounds on message words %1 = W[4*%2 .. 4*%2+3]
+%macro ROUNDS4 2
+	vpaddq		WK, %1, [TBL + %2*32]
+	vsha512rnds2	STATE1, STATE0, WKx
+	vperm2i128	WK, WK, WK, 0x01
+	vsha512rnds2	STATE0, STATE1, WKx
+%endmacro
+
+;; W[t..t+3] into %1 = W[t-16..t-13], from %2x = W[t-12..t-11], %3 = W[t-8..t-5], %4 = W[t-4..t-1]
+%macro SCHED4 4
+	vsha512msg1	%1, %2
+	vperm2i128	TMP, %3, %4, 0x21
+	vpalignr	TMP, TMP, %3, 8		; W[t-7..t-4]
+	vpaddq		%1, %1, TMP
+	vsha512msg2	%1, %4
+%endmacro
+
+align 32
+
+; void sha512_ni_x1(SHA512_JOB *job, uint64_t blocks);
+; arg 0 : JOB : job holding the digest and buffer of the lane
+; arg 1 : NBLK : size (in blocks) ;; assumed to be >= 1
+;
+; Clobbers registers: rax, r10, ymm0-ymm10
+;
+mk_global sha512_ni_x1, function, internal
+sha512_ni_x1:
+	endbranch
+	shl	NBLK, 7		; transform blk amount into bytes
+	jz	backto_mgr
+
+%ifidn __OUTPUT_FORMAT__, win64
+	sub	rsp, 5*16 + 8
+	vmovdqu	[rsp + 0*16], xmm6
+	vmovdqu	[rsp + 1*16], xmm7
+	vmovdqu	[rsp + 2*16], xmm8
+	vmovdqu	[rsp + 3*16], xmm9
+	vmovdqu	[rsp + 4*16], xmm10
+%endif
+
+	;; digests -> ABEF(state0), CDGH(state1)
+	vmovdqu		TMP, [JOB + _result_digest + 0*32]	; a b c d
+	vmovdqu		WK,  [JOB + _result_digest + 1*32]	; e f g h
+	vperm2i128	STATE0, TMP, WK, 0x20			; a b e f
+	vperm2i128	STATE1, TMP, WK, 0x31			; c d g h
+	vpermq		STATE0, STATE0, 0x1b			; f e b a
+	vpermq		STATE1, STATE1, 0x1b			; h g d c
+
+	vmovdqa		SHUF_MASK, [PSHUFFLE_BYTE_FLIP_MASK]
+	lea		TBL, [TABLE]
+
+	mov		DPTR, [JOB + _buffer]
+	;; nblk is used to indicate data end
+	add		NBLK, DPTR
+
+lloop:
+	; /* Save hash values for addition after rounds */
+	vmovdqa		ABEF_SAVE, STATE0
+	vmovdqa		CDGH_SAVE, STATE1
+
+	; /* Rounds 0-15 */
+	vmovdqu		MSG0, [DPTR + 0*32]
+	vpshufb		MSG0, MSG0, SHUF_MASK
+	ROUNDS4		MSG0, 0
+	vmovdqu		MSG1, [DPTR + 1*32]
+	vpshufb		MSG1, MSG1, SHUF_MASK
+	ROUNDS4		MSG1, 1
+	vmovdqu		MSG2, [DPTR + 2*32]
+	vpshufb		MSG2, MSG2, SHUF_MASK
+	ROUNDS4		MSG2, 2
+	vmovdqu		MSG3, [DPTR + 3*32]
+	vpshufb		MSG3, MSG3, SHUF_MASK
+	ROUNDS4		MSG3, 3
+
+	; /* Rounds 16-79 */
+%assign g 4
+%rep 4
+	SCHED4		MSG0, MSG1x, MSG2, MSG3
+	ROUNDS4		MSG0, g
+%assign g g+1
+	SCHED4		MSG1, MSG2x, MSG3, MSG0
+	ROUNDS4		MSG1, g
+%assign g g+1
+	SCHED4		MSG2, MSG3x, MSG0, MSG1
+	ROUNDS4		MSG2, g
+%assign g g+1
+	SCHED4		MSG3, MSG0x, MSG1, MSG2
+	ROUNDS4		MSG3, g
+%assign g g+1
+%endrep
+
+	; /* Add current hash values with previously saved */
+	vpaddq		STATE0, STATE0, ABEF_SAVE
+	vpaddq		STATE1, STATE1, CDGH_SAVE
+
+	; Increment data pointer and loop if more to process
+	add		DPTR, 128
+	cmp		DPTR, NBLK
+	jne		lloop
+
+	; write out digests
+	vpermq		STATE0, STATE0, 0x1b			; a b e f
+	vpermq		STATE1, STATE1, 0x1b			; c d g h
+	vperm2i128	TMP, STATE0, STATE1, 0x20		; a b c d
+	vperm2i128	WK, STATE0, STATE1, 0x31		; e f g h
+	vmovdqu		[JOB + _result_digest + 0*32], TMP
+	vmovdqu		[JOB + _result_digest + 1*32], WK
+
+	vzeroupper
+
+%ifidn __OUTPUT_FORMAT__, win64
+	vmovdqu	xmm6,  [rsp + 0*16]
+	vmovdqu	xmm7,  [rsp + 1*16]
+	vmovdqu	xmm8,  [rsp + 2*16]
+	vmovdqu	xmm9,  [rsp + 3*16]
+	vmovdqu	xmm10, [rsp + 4*16]
+	add	rsp, 5*16 + 8
+%endif
+
+backto_mgr:
+	;;;;;;;;;;;;;;;;
+	;; Postamble
+
+	ret
+
+
+section .data align=32
+PSHUFFLE_BYTE_FLIP_MASK:
+	dq 0x0001020304050607, 0x08090a0b0c0d0e0f
+	dq 0x0001020304050607, 0x08090a0b0c0d0e0f
+TABLE:
+	dq	0x428a2f98d728ae22, 0x7137449123ef65cd
+	dq	0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc
+	dq	0x3956c25bf348b538, 0x59f111f1b605d019
+	dq	0x923f82a4af194f9b, 0xab1c5ed5da6d8118
+	dq	0xd807aa98a3030242, 0x12835b0145706fbe
+	dq	0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2
+	dq	0x72be5d74f27b896f, 0x80deb1fe3b1696b1
+	dq	0x9bdc06a725c71235, 0xc19bf174cf692694
+	dq	0xe49b69c19ef14ad2, 0xefbe4786384f25e3
+	dq	0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65
+	dq	0x2de92c6f592b0275, 0x4a7484aa6ea6e483
+	dq	0x5cb0a9dcbd41fbd4, 0x76f988da831153b5
+	dq	0x983e5152ee66dfab, 0xa831c66d2db43210
+	dq	0xb00327c898fb213f, 0xbf597fc7beef0ee4
+	dq	0xc6e00bf33da88fc2, 0xd5a79147930aa725
+	dq	0x06ca6351e003826f, 0x142929670a0e6e70
+	dq	0x27b70a8546d22ffc, 0x2e1b21385c26c926
+	dq	0x4d2c6dfc5ac42aed, 0x53380d139d95b3df
+	dq	0x650a73548baf63de, 0x766a0abb3c77b2a8
+	dq	0x81c2c92e47edaee6, 0x92722c851482353b
+	dq	0xa2bfe8a14cf10364, 0xa81a664bbc423001
+	dq	0xc24b8b70d0f89791, 0xc76c51a30654be30
+	dq	0xd192e819d6ef5218, 0xd69906245565a910
+	dq	0xf40e35855771202a, 0x106aa07032bbd1b8
+	dq	0x19a4c116b8d2d0c8, 0x1e376c085141ab53
+	dq	0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8
+	dq	0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb
+	dq	0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3
+	dq	0x748f82ee5defb2fc, 0x78a5636f43172f60
+	dq	0x84c87814a1f0ab72, 0x8cc702081a6439ec
+	dq	0x90befffa23631e28, 0xa4506cebde82bde9
+	dq	0xbef9a3f7b2c67915, 0xc67178f2e372532b
+	dq	0xca273eceea26619c, 0xd186b8c721c0c207
+	dq	0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178
+	dq	0x06f067aa72176fba, 0x0a637dc5a2c898a6
+	dq	0x113f9804bef90dae, 0x1b710b35131c471b
+	dq	0x28db77f523047d84, 0x32caab7b40c72493
+	dq	0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c
+	dq	0x4cc5d4becb3e42b6, 0x597f299cfc657e2a
+	dq	0x5fcb6fab3ad6faec, 0x6c44198c4a475817
+%else
+%ifidn __OUTPUT_FORMAT__, win64
+global no_sha512_ni_x1
+no_sha512_ni_x1:
+%endif
+%endif ; HAVE_AS_KNOWS_SHA512NI
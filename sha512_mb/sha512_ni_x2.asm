@@ -0,0 +1,319 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+%include "sha512_job.asm"
+%include "reg_sizes.asm"
+
+%ifdef HAVE_AS_KNOWS_SHA512NI
+
+[bits 64]
+default rel
+section .text
+
+%ifidn __OUTPUT_FORMAT__, elf64
+ ; Linux
+ %define arg0  rdi
+ %define arg1  rsi
+ %define arg2  rdx
+%else
+ ; Windows
+ %define arg0   rcx
+ %define arg1   rdx
+ %define arg2   r8
+%endif
+
+;; Lane A
+%define STATE0A		ymm0	; A B E F, A in the top qword
+%define STATE1A		ymm1	; C D G H, C in the top qword
+%define MSG0A		ymm2
+%define MSG1A		ymm3
+%define MSG2A		ymm4
+%define MSG3A		ymm5
+%define MSG0Ax		xmm2
+%define MSG1Ax		xmm3
+%define MSG2Ax		xmm4
+%define MSG3Ax		xmm5
+%define WKA		ymm6
+%define WKAx		xmm6
+
+;; Lane B
+%define STATE0B		ymm7
+%define STATE1B		ymm8
+%define MSG0B		ymm9
+%define MSG1B		ymm10
+%define MSG2B		ymm11
+%define MSG3B		ymm12
+%define MSG0Bx		xmm9
+%define MSG1Bx		xmm10
+%define MSG2Bx		xmm11
+%define MSG3Bx		xmm12
+%define WKB		ymm13
+%define WKBx		xmm13
+
+%define TMP		ymm14
+%define SHUF_MASK	ymm15
+
+%define JOBA	arg0
+%define JOBB	arg1
+%define NBLK	arg2
+%define DPTRA	r10
+%define DPTRB	r11
+%define IDX	r9
+%define TBL	rax
+
+;; Stack frame, 32 byte aligned
+%define _ABEF_SAVE_A	0*32
+%define _CDGH_SAVE_A	1*32
+%define _ABEF_SAVE_B	2*32
+%define _CDGH_SAVE_B	3*32
+%define _XMM_SAVE	4*32
+%define _RSP_SAVE	_XMM_SAVE + 10*16
+%define FRAME_SIZE	_RSP_SAVE + 8 + 32
+
+;; Four rounds of both lanes on message words W[4*%3 .. 4*%3+3] in %1 and %2
+%macro ROUNDS4_X2 3
+	vpaddq		WKA, %1, [TBL + %3*32]
+	vpaddq		WKB, %2, [TBL + %3*32]
+	vsha512rnds2	STATE1A, STATE0A, WKAx
+	vsha512rnds2	STATE1B, STATE0B, WKBx
+	vperm2i128	WKA, WKA, WKA, 0x01
+	vperm2i128	WKB, WKB, WKB, 0x01
+	vsha512rnds2	STATE0A, STATE1A, WKAx
+	vsha512rnds2	STATE0B, STATE1B, WKBx
+%endmacro
+
+;; W[t..t+3] into %1 = W[t-16..t-13], from %2x = W[t-12..t-11], %3 = W[t-8..t-5], %4 = W[t-4..t-1]
+%macro SCHED4 4
+	vsha512msg1	%1, %2
+	vperm2i128	TMP, %3, %4, 0x21
+	vpalignr	TMP, TMP, %3, 8		; W[t-7..t-4]
+	vpaddq		%1, %1, TMP
+	vsha512msg2	%1, %4
+%endmacro
+
+;; digest of job %1 -> ABEF(%2), CDGH(%3), clobbers %4
+%macro LOAD_DIGEST 4
+	vmovdqu		TMP, [%1 + _result_digest + 0*32]	; a b c d
+	vmovdqu		%4,  [%1 + _result_digest + 1*32]	; e f g h
+	vperm2i128	%2, TMP, %4, 0x20			; a b e f
+	vperm2i128	%3, TMP, %4, 0x31			; c d g h
+	vpermq		%2, %2, 0x1b				; f e b a
+	vpermq		%3, %3, 0x1b				; h g d c
+%endmacro
+
+;; ABEF(%2), CDGH(%3) -> digest of job %1, clobbers %4
+%macro STORE_DIGEST 4
+	vpermq		%2, %2, 0x1b				; a b e f
+	vpermq		%3, %3, 0x1b				; c d g h
+	vperm2i128	TMP, %2, %3, 0x20			; a b c d
+	vperm2i128	%4, %2, %3, 0x31			; e f g h
+	vmovdqu		[%1 + _result_digest + 0*32], TMP
+	vmovdqu		[%1 + _result_digest + 1*32], %4
+%endmacro
+
+;; block of lane %1 at DPTR %2 + IDX -> %3..%6
+%macro LOAD_MSG 5
+	vmovdqu		%2, [%1 + IDX + 0*32]
+	vmovdqu		%3, [%1 + IDX + 1*32]
+	vmovdqu		%4, [%1 + IDX + 2*32]
+	vmovdqu		%5, [%1 + IDX + 3*32]
+	vpshufb		%2, %2, SHUF_MASK
+	vpshufb		%3, %3, SHUF_MASK
+	vpshufb		%4, %4, SHUF_MASK
+	vpshufb		%5, %5, SHUF_MASK
+%endmacro
+
+align 32
+
+; void sha512_ni_x2(SHA512_JOB *job0, SHA512_JOB *job1, uint64_t blocks);
+; arg 0 : JOBA : job of the first lane
+; arg 1 : JOBB : job of the second lane
+; arg 2 : NBLK : size (in blocks) of both lanes ;; assumed to be >= 1
+;
+; Clobbers registers: rax, r9-r11, ymm0-ymm15
+;
+mk_global sha512_ni_x2, function, internal
+sha512_ni_x2:
+	endbranch
+	shl	NBLK, 7		; transform blk amount into bytes
+	jz	backto_mgr
+
+	mov	rax, rsp
+	sub	rsp, FRAME_SIZE
+	and	rsp, ~31
+	mov	[rsp + _RSP_SAVE], rax
+
+%ifidn __OUTPUT_FORMAT__, win64
+	vmovdqu	[rsp + _XMM_SAVE + 0*16], xmm6
+	vmovdqu	[rsp + _XMM_SAVE + 1*16], xmm7
+	vmovdqu	[rsp + _XMM_SAVE + 2*16], xmm8
+	vmovdqu	[rsp + _XMM_SAVE + 3*16], xmm9
+	vmovdqu	[rsp + _XMM_SAVE + 4*16], xmm10
+	vmovdqu	[rsp + _XMM_SAVE + 5*16], xmm11
+	vmovdqu	[rsp + _XMM_SAVE + 6*16], xmm12
+	vmovdqu	[rsp + _XMM_SAVE + 7*16], xmm13
+	vmovdqu	[rsp + _XMM_SAVE + 8*16], xmm14
+	vmovdqu	[rsp + _XMM_SAVE + 9*16], xmm15
+%endif
+
+	LOAD_DIGEST	JOBA, STATE0A, STATE1A, WKA
+	LOAD_DIGEST	JOBB, STATE0B, STATE1B, WKB
+
+	vmovdqa		SHUF_MASK, [PSHUFFLE_BYTE_FLIP_MASK]
+	lea		TBL, [TABLE]
+
+	mov		DPTRA, [JOBA + _buffer]
+	mov		DPTRB, [JOBB + _buffer]
+	xor		IDX, IDX
+
+lloop:
+	; /* Save hash values for addition after rounds */
+	vmovdqa		[rsp + _ABEF_SAVE_A], STATE0A
+	vmovdqa		[rsp + _CDGH_SAVE_A], STATE1A
+	vmovdqa		[rsp + _ABEF_SAVE_B], STATE0B
+	vmovdqa		[rsp + _CDGH_SAVE_B], STATE1B
+
+	; /* Rounds 0-15 */
+	LOAD_MSG	DPTRA, MSG0A, MSG1A, MSG2A, MSG3A
+	LOAD_MSG	DPTRB, MSG0B, MSG1B, MSG2B, MSG3B
+	ROUNDS4_X2	MSG0A, MSG0B, 0
+	ROUNDS4_X2	MSG1A, MSG1B, 1
+	ROUNDS4_X2	MSG2A, MSG2B, 2
+	ROUNDS4_X2	MSG3A, MSG3B, 3
+
+	; /* Rounds 16-79 */
+%assign g 4
+%rep 4
+	SCHED4		MSG0A, MSG1Ax, MSG2A, MSG3A
+	SCHED4		MSG0B, MSG1Bx, MSG2B, MSG3B
+	ROUNDS4_X2	MSG0A, MSG0B, g
+%assign g g+1
+	SCHED4		MSG1A, MSG2Ax, MSG3A, MSG0A
+	SCHED4		MSG1B, MSG2Bx, MSG3B, MSG0B
+	ROUNDS4_X2	MSG1A, MSG1B, g
+%assign g g+1
+	SCHED4		MSG2A, MSG3Ax, MSG0A, MSG1A
+	SCHED4		MSG2B, MSG3Bx, MSG0B, MSG1B
+	ROUNDS4_X2	MSG2A, MSG2B, g
+%assign g g+1
+	SCHED4		MSG3A, MSG0Ax, MSG1A, MSG2A
+	SCHED4		MSG3B, MSG0Bx, MSG1B, MSG2B
+	ROUNDS4_X2	MSG3A, MSG3B, g
+%assign g g+1
+%endrep
+
+	; /* Add current hash values with previously saved */
+	vpaddq		STATE0A, STATE0A, [rsp + _ABEF_SAVE_A]
+	vpaddq		STATE1A, STATE1A, [rsp + _CDGH_SAVE_A]
+	vpaddq		STATE0B, STATE0B, [rsp + _ABEF_SAVE_B]
+	vpaddq		STATE1B, STATE1B, [rsp + _CDGH_SAVE_B]
+
+	; Increment data offset and loop if more to process
+	add		IDX, 128
+	cmp		IDX, NBLK
+	jne		lloop
+
+	; write out digests
+	STORE_DIGEST	JOBA, STATE0A, STATE1A, WKA
+	STORE_DIGEST	JOBB, STATE0B, STATE1B, WKB
+
+	vzeroupper
+
+%ifidn __OUTPUT_FORMAT__, win64
+	vmovdqu	xmm6,  [rsp + _XMM_SAVE + 0*16]
+	vmovdqu	xmm7,  [rsp + _XMM_SAVE + 1*16]
+	vmovdqu	xmm8,  [rsp + _XMM_SAVE + 2*16]
+	vmovdqu	xmm9,  [rsp + _XMM_SAVE + 3*16]
+	vmovdqu	xmm10, [rsp + _XMM_SAVE + 4*16]
+	vmovdqu	xmm11, [rsp + _XMM_SAVE + 5*16]
+	vmovdqu	xmm12, [rsp + _XMM_SAVE + 6*16]
+	vmovdqu	xmm13, [rsp + _XMM_SAVE + 7*16]
+	vmovdqu	xmm14, [rsp + _XMM_SAVE + 8*16]
+	vmovdqu	xmm15, [rsp + _XMM_SAVE + 9*16]
+%endif
+	mov	rsp, [rsp + _RSP_SAVE]
+
+backto_mgr:
+	;;;;;;;;;;;;;;;;
+	;; Postamble
+
+	ret
+
+
+section .data align=32
+PSHUFFLE_BYTE_FLIP_MASK:
+	dq 0x0001020304050607, 0x08090a0b0c0d0e0f
+	dq 0x0001020304050607, 0x08090a0b0c0d0e0f
+TABLE:
+	dq	0x428a2f98d728ae22, 0x7137449123ef65cd
+	dq	0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc
+	dq	0x3956c25bf348b538, 0x59f111f1b605d019
+	dq	0x923f82a4af194f9b, 0xab1c5ed5da6d8118
+	dq	0xd807aa98a3030242, 0x12835b0145706fbe
+	dq	0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2
+	dq	0x72be5d74f27b896f, 0x80deb1fe3b1696b1
+	dq	0x9bdc06a725c71235, 0xc19bf174cf692694
+	dq	0xe49b69c19ef14ad2, 0xefbe4786384f25e3
+	dq	0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65
+	dq	0x2de92c6f592b0275, 0x4a7484aa6ea6e483
+	dq	0x5cb0a9dcbd41fbd4, 0x76f988da831153b5
+	dq	0x983e5152ee66dfab, 0xa831c66d2db43210
+	dq	0xb00327c898fb213f, 0xbf597fc7beef0ee4
+	dq	0xc6e00bf33da88fc2, 0xd5a79147930aa725
+	dq	0x06ca6351e003826f, 0x142929670a0e6e70
+	dq	0x27b70a8546d22ffc, 0x2e1b21385c26c926
+	dq	0x4d2c6dfc5ac42aed, 0x53380d139d95b3df
+	dq	0x650a73548baf63de, 0x766a0abb3c77b2a8
+	dq	0x81c2c92e47edaee6, 0x92722c851482353b
+	dq	0xa2bfe8a14cf10364, 0xa81a664bbc423001
+	dq	0xc24b8b70d0f89791, 0xc76c51a30654be30
+	dq	0xd192e819d6ef5218, 0xd69906245565a910
+	dq	0xf40e35855771202a, 0x106aa07032bbd1b8
+	dq	0x19a4c116b8d2d0c8, 0x1e376c085141ab53
+	dq	0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8
+	dq	0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb
+	dq	0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3
+	dq	0x748f82ee5defb2fc, 0x78a5636f43172f60
+	dq	0x84c87814a1f0ab72, 0x8cc702081a6439ec
+	dq	0x90befffa23631e28, 0xa4506cebde82bde9
+	dq	0xbef9a3f7b2c67915, 0xc67178f2e372532b
+	dq	0xca273eceea26619c, 0xd186b8c721c0c207
+	dq	0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178
+	dq	0x06f067aa72176fba, 0x0a637dc5a2c898a6
+	dq	0x113f9804bef90dae, 0x1b710b35131c471b
+	dq	0x28db77f523047d84, 0x32caab7b40c72493
+	dq	0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c
+	dq	0x4cc5d4becb3e42b6, 0x597f299cfc657e2a
+	dq	0x5fcb6fab3ad6faec, 0x6c44198c4a475817
+%else
+%ifidn __OUTPUT_FORMAT__, win64
+global no_sha512_ni_x2
+no_sha512_ni_x2:
+%endif
+%endif ; HAVE_AS_KNOWS_SHA512NI
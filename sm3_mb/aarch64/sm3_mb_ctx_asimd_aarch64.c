@@ -30,6 +30,7 @@
 #include <stdint.h>
 #include <string.h>
 #include "sm3_mb.h"
+#include "sm3_ctx_submit_64.h"
 #include "memcpy_inline.h"
 #include "endian_helper.h"
 #define SM3_LOG2_BLOCK_SIZE 6
@@ -79,6 +80,9 @@ SM3_HASH_CTX *sm3_ctx_mgr_submit_asimd(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX * ct
 	// If we made it here, there were no errors during this call to submit
 	ctx->error = HASH_CTX_ERROR_NONE;
 
+	// Only sm3_ctx_mgr_submit_64() leaves pieces pending, once this submit returns
+	ctx->pending_length = 0;
+
 	// Store buffer ptr info from user
 	ctx->incoming_buffer = buffer;
 	ctx->incoming_buffer_length = len;
@@ -201,6 +205,10 @@ static SM3_HASH_CTX *sm3_ctx_mgr_resubmit(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX *
 			continue;
 		}
 
+		// Take up the next piece of a sm3_ctx_mgr_submit_64() job in place
+		if (sm3_ctx_submit_64_next(ctx))
+			continue;
+
 		if (ctx)
 			ctx->status = HASH_CTX_STS_IDLE;
 		return ctx;
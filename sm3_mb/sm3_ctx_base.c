@@ -148,6 +148,9 @@ SM3_HASH_CTX *sm3_ctx_mgr_submit_base(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX * ctx
 		return ctx;
 	}
 
+	// Every piece is hashed before this submit returns, so none is left pending
+	ctx->pending_length = 0;
+
 	if (flags == HASH_FIRST) {
 		sm3_init(ctx, buffer, len);
 		sm3_update(ctx, buffer, len);
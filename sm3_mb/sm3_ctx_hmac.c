@@ -0,0 +1,153 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <string.h>
+#include "sm3_mb.h"
+
+// Digest words of a completed ctx in message byte order, which is how SM3 leaves them
+static void hmac_sm3_digest_bytes(SM3_WORD_T * out, const SM3_HASH_CTX * ctx)
+{
+	memcpy(out, ctx->job.result_digest, SM3_DIGEST_NWORDS * sizeof(*out));
+}
+
+// Run one job to completion on an otherwise idle manager
+static void hmac_sm3_hash_once(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX * ctx,
+				  const void *buffer, uint32_t len, HASH_CTX_FLAG flags)
+{
+	hash_ctx_init(ctx);
+	if (sm3_ctx_mgr_submit(mgr, ctx, buffer, len, flags) == NULL)
+		while (sm3_ctx_mgr_flush(mgr)) ;
+}
+
+void hmac_sm3_key_init(HMAC_SM3_KEY * key, const void *k, uint32_t len)
+{
+	DECLARE_ALIGNED(SM3_HASH_CTX_MGR mgr, 16);
+	SM3_HASH_CTX ctx;
+	SM3_WORD_T kdigest[SM3_DIGEST_NWORDS];
+	uint8_t pad[SM3_BLOCK_SIZE];
+	int i;
+
+	// Midstates come from the dispatched code so they match its digest layout
+	sm3_ctx_mgr_init(&mgr);
+
+	// Keys longer than a block are replaced by their digest
+	if (len > SM3_BLOCK_SIZE) {
+		hmac_sm3_hash_once(&mgr, &ctx, k, len, HASH_ENTIRE);
+		hmac_sm3_digest_bytes(kdigest, &ctx);
+		k = kdigest;
+		len = sizeof(kdigest);
+	}
+
+	memset(pad, 0, sizeof(pad));
+	memcpy(pad, k, len);
+
+	// The ipad and opad blocks are hashed once here rather than per message
+	for (i = 0; i < SM3_BLOCK_SIZE; i++)
+		pad[i] ^= 0x36;
+	hmac_sm3_hash_once(&mgr, &ctx, pad, SM3_BLOCK_SIZE, HASH_FIRST);
+	sm3_ctx_midstate_save(&ctx, &key->ipad);
+
+	for (i = 0; i < SM3_BLOCK_SIZE; i++)
+		pad[i] ^= 0x36 ^ 0x5c;
+	hmac_sm3_hash_once(&mgr, &ctx, pad, SM3_BLOCK_SIZE, HASH_FIRST);
+	sm3_ctx_midstate_save(&ctx, &key->opad);
+
+	memset(pad, 0, sizeof(pad));
+	memset(kdigest, 0, sizeof(kdigest));
+	memset(&ctx, 0, sizeof(ctx));
+}
+
+void hmac_sm3_ctx_mgr_init(HMAC_SM3_HASH_CTX_MGR * mgr)
+{
+	sm3_ctx_mgr_init(&mgr->mgr);
+}
+
+// Start the outer hash of any ctx whose inner hash is done
+static HMAC_SM3_HASH_CTX *hmac_sm3_retire(HMAC_SM3_HASH_CTX_MGR * mgr,
+						SM3_HASH_CTX * ctx)
+{
+	HMAC_SM3_HASH_CTX *hctx;
+
+	while (ctx && ctx->error == HASH_CTX_ERROR_NONE && hash_ctx_complete(ctx)) {
+		hctx = (HMAC_SM3_HASH_CTX *) ctx;
+		if (hctx->outer)
+			break;
+
+		hmac_sm3_digest_bytes(hctx->inner_digest, ctx);
+		sm3_ctx_midstate_restore(ctx, &hctx->key->opad);
+		hctx->outer = 1;
+
+		ctx = sm3_ctx_mgr_submit(&mgr->mgr, ctx, hctx->inner_digest,
+					    sizeof(hctx->inner_digest), HASH_LAST);
+	}
+
+	return (HMAC_SM3_HASH_CTX *) ctx;
+}
+
+HMAC_SM3_HASH_CTX *hmac_sm3_ctx_mgr_submit(HMAC_SM3_HASH_CTX_MGR * mgr,
+						 HMAC_SM3_HASH_CTX * hctx,
+						 const HMAC_SM3_KEY * key, const void *buffer,
+						 uint32_t len, HASH_CTX_FLAG flags)
+{
+	SM3_HASH_CTX *ctx = &hctx->ctx;
+
+	if (flags & (~HASH_ENTIRE)) {
+		ctx->error = HASH_CTX_ERROR_INVALID_FLAGS;
+		return hctx;
+	}
+
+	if (flags & HASH_FIRST) {
+		if (ctx->status & HASH_CTX_STS_PROCESSING) {
+			ctx->error = HASH_CTX_ERROR_ALREADY_PROCESSING;
+			return hctx;
+		}
+
+		hctx->key = key;
+		hctx->outer = 0;
+		sm3_ctx_midstate_restore(ctx, &key->ipad);
+	}
+
+	ctx = sm3_ctx_mgr_submit(&mgr->mgr, ctx, buffer, len, flags & ~HASH_FIRST);
+
+	return hmac_sm3_retire(mgr, ctx);
+}
+
+HMAC_SM3_HASH_CTX *hmac_sm3_ctx_mgr_flush(HMAC_SM3_HASH_CTX_MGR * mgr)
+{
+	SM3_HASH_CTX *ctx;
+	HMAC_SM3_HASH_CTX *hctx;
+
+	while ((ctx = sm3_ctx_mgr_flush(&mgr->mgr)) != NULL) {
+		hctx = hmac_sm3_retire(mgr, ctx);
+		if (hctx)
+			return hctx;
+	}
+
+	return NULL;
+}
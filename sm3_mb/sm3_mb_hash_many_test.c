@@ -0,0 +1,96 @@
+/**********************************************************************
+  Copyright(c) 2011-2019 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+#define ISAL_UNIT_TEST
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sm3_mb.h"
+#include "endian_helper.h"
+
+typedef uint32_t digest_sm3[SM3_DIGEST_NWORDS];
+
+#define MSGS 2
+#define NUM_JOBS 1000
+
+#define PSEUDO_RANDOM_NUM(seed) ((seed) * 5 + ((seed) * (seed)) / 64) % MSGS
+
+static uint8_t msg1[] = "abc";
+static uint8_t msg2[] = "abcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcd";
+
+/* small endian */
+static digest_sm3 exp_result_digest1 = { 0x66c7f0f4, 0x62eeedd9, 0xd1f2d46b, 0xdc10e4e2,
+	0x4167c487, 0x5cf2f7a2, 0x297da02b, 0x8f4ba8e0
+};
+
+/* small endian */
+static digest_sm3 exp_result_digest2 = { 0xdebe9ff9, 0x2275b8a1, 0x38604889, 0xc18e5a4d,
+	0x6fdb70e5, 0x387e5765, 0x293dcba3, 0x9c0c5732
+};
+
+static uint8_t *msgs[MSGS] = { msg1, msg2 };
+
+static uint32_t *exp_result_digest[MSGS] = {
+	exp_result_digest1, exp_result_digest2
+};
+
+static uint8_t digests[NUM_JOBS][SM3_DIGEST_NWORDS * 4];
+
+int main(void)
+{
+	const void *buf_ptrs[NUM_JOBS];
+	uint64_t lens[NUM_JOBS];
+	uint32_t i, j, k, w;
+	uint32_t *good;
+
+	for (i = 0; i < NUM_JOBS; i++) {
+		k = PSEUDO_RANDOM_NUM(i);
+		buf_ptrs[i] = msgs[k];
+		lens[i] = strlen((char *)msgs[k]);
+	}
+
+	if (sm3_mb_hash_many(buf_ptrs, lens, NUM_JOBS, digests) != 0) {
+		printf("sm3_mb_hash_many returned an error\n");
+		return -1;
+	}
+
+	for (i = 0; i < NUM_JOBS; i++) {
+		good = exp_result_digest[PSEUDO_RANDOM_NUM(i)];
+		for (j = 0; j < SM3_DIGEST_NWORDS; j++) {
+			w = to_be32(good[j]);
+			if (memcmp(&digests[i][4 * j], &w, sizeof(w))) {
+				printf("Test %d, digest %d should be %08X\n", i, j, good[j]);
+				return -1;
+			}
+		}
+	}
+
+	printf(" sm3_mb_hash_many test: Pass\n");
+
+	return 0;
+}
@@ -0,0 +1,122 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <string.h>
+#include "sm3_mb_pool.h"
+#include "endian_helper.h"
+
+/*
+ * Messages of one fixed length all share the same padding, so it is laid out
+ * once at the tail of a block buffer per lane and only the message bytes are
+ * copied in front of it. The manager then takes the one or two whole blocks
+ * straight into a lane, skipping partial_block_buffer and hash_pad().
+ */
+struct sm3_short_batch {
+	const void **msgs;
+	uint32_t len;
+	uint32_t nbytes;
+	uint8_t(*blocks)[2 * SM3_BLOCK_SIZE];
+	uint8_t(*digests)[SM3_DIGEST_NWORDS * 4];
+	int host_order;
+};
+
+/*
+ * Without HASH_LAST the ctx layer hands back the running digest as the bound
+ * kernel keeps it, host order words or, for some aarch64 kernels, words that
+ * already hold the big endian digest. Tell them apart by the initial digest.
+ */
+static int sm3_short_host_order(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX * ctx)
+{
+	sm3_ctx_mgr_submit(mgr, ctx, NULL, 0, HASH_FIRST);
+	return ctx->job.result_digest[0] == 0x7380166f;
+}
+
+// A ctx owns the block buffer of its lane while it is in the manager
+static SM3_HASH_CTX *sm3_short_start(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX * ctx,
+				     uint32_t i, uint32_t lane, void *arg)
+{
+	struct sm3_short_batch *batch = arg;
+
+	if (i == 0)
+		batch->host_order = sm3_short_host_order(mgr, ctx);
+
+	ctx->user_data = batch->digests[i];
+	memcpy(batch->blocks[lane], batch->msgs[i], batch->len);
+
+	return sm3_ctx_mgr_submit(mgr, ctx, batch->blocks[lane], batch->nbytes, HASH_FIRST);
+}
+
+// The message went in whole, so a ctx handed back is always done
+static int sm3_short_next(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX ** ctx, void *arg)
+{
+	struct sm3_short_batch *batch = arg;
+	uint8_t *digest = (*ctx)->user_data;
+	uint32_t j, w;
+
+	for (j = 0; j < SM3_DIGEST_NWORDS; j++) {
+		w = batch->host_order ? to_be32((*ctx)->job.result_digest[j]) :
+		    (*ctx)->job.result_digest[j];
+		memcpy(&digest[4 * j], &w, sizeof(w));
+	}
+
+	return 0;
+}
+
+int sm3_mb_hash_short(const void *msgs[], uint32_t len, uint32_t n,
+		      uint8_t(*digests)[SM3_DIGEST_NWORDS * 4])
+{
+	DECLARE_ALIGNED(uint8_t blocks[SM3_MAX_LANES][2 * SM3_BLOCK_SIZE], 16);
+	struct sm3_short_batch batch;
+	uint32_t i, nbytes;
+	uint64_t bits;
+
+	if (len > SM3_HASH_SHORT_MAX_LEN)
+		return -1;
+
+	if (n == 0)
+		return 0;
+
+	nbytes = (len + 1 + SM3_PADLENGTHFIELD_SIZE > SM3_BLOCK_SIZE) ?
+	    2 * SM3_BLOCK_SIZE : SM3_BLOCK_SIZE;
+	bits = to_be64((uint64_t) len << 3);
+
+	memset(blocks, 0, sizeof(blocks));
+	for (i = 0; i < SM3_MAX_LANES; i++) {
+		blocks[i][len] = 0x80;
+		memcpy(&blocks[i][nbytes - sizeof(bits)], &bits, sizeof(bits));
+	}
+
+	batch.msgs = msgs;
+	batch.len = len;
+	batch.nbytes = nbytes;
+	batch.blocks = blocks;
+	batch.digests = digests;
+
+	return sm3_mb_pool_run(n, sm3_short_start, sm3_short_next, &batch);
+}
@@ -0,0 +1,220 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sm3_mb.h"
+
+#define KEYS 4
+#define MSGS 4
+#define LONG_MSG_LEN 1000
+#define NUM_JOBS 1000
+
+static const uint32_t key_lens[KEYS] = { 0, 20, 64, 131 };
+
+static uint8_t msg1[] = "Hi There";
+static uint8_t msg2[] = "what do ya want for nothing?";
+static uint8_t msg3[50];
+static uint8_t msg4[LONG_MSG_LEN];
+
+static uint8_t *msgs[MSGS] = { msg1, msg2, msg3, msg4 };
+static const uint32_t msg_lens[MSGS] =
+    { sizeof(msg1) - 1, sizeof(msg2) - 1, sizeof(msg3), sizeof(msg4) };
+
+static uint8_t exp_mac[KEYS][MSGS][32] = {
+	{
+	 {0xfe, 0x08, 0x9b, 0xa6, 0x19, 0xa6, 0x02, 0x34, 0x7c, 0x9a,
+	  0x6c, 0x7d, 0xbd, 0x85, 0x5e, 0x7d, 0x82, 0x79, 0x9c, 0xbe,
+	  0xa9, 0x48, 0x23, 0xb2, 0xf0, 0x81, 0xb4, 0x7b, 0x3a, 0x9d,
+	  0xeb, 0x96},
+	 {0x59, 0x93, 0x50, 0x87, 0x63, 0x61, 0x6a, 0x9d, 0xa4, 0x24,
+	  0x3d, 0x30, 0x5d, 0xcc, 0xfc, 0xa8, 0x82, 0xd5, 0x3a, 0x95,
+	  0x9a, 0x1e, 0x39, 0x30, 0x87, 0x86, 0x86, 0xad, 0x3d, 0x26,
+	  0x14, 0xaa},
+	 {0x74, 0x51, 0x13, 0x86, 0xb2, 0xae, 0x80, 0x6b, 0x5e, 0x0c,
+	  0x37, 0x43, 0xf8, 0x29, 0xc3, 0x94, 0x5a, 0xc1, 0x4d, 0x75,
+	  0x56, 0x0b, 0x65, 0xdb, 0xf3, 0xba, 0x8b, 0x7b, 0x07, 0xae,
+	  0x9a, 0xc3},
+	 {0x5a, 0xe3, 0xfa, 0x11, 0xdc, 0x07, 0xc1, 0x1c, 0x14, 0x15,
+	  0x14, 0x52, 0x81, 0x33, 0xb5, 0x00, 0x8a, 0x25, 0xb7, 0x32,
+	  0x4a, 0xad, 0x90, 0x70, 0x4b, 0x3e, 0x94, 0x03, 0x42, 0x19,
+	  0x83, 0x9f},
+	 },
+	{
+	 {0xe7, 0x15, 0xb1, 0x52, 0xa9, 0x3b, 0x15, 0x9b, 0x70, 0xfe,
+	  0x52, 0x6b, 0xb5, 0xf1, 0x13, 0x8f, 0x3e, 0xff, 0xf0, 0xf1,
+	  0x04, 0x2d, 0xbb, 0xb5, 0xcc, 0xc0, 0xf5, 0xe8, 0xaa, 0x0c,
+	  0xe5, 0xb5},
+	 {0x29, 0x6e, 0x92, 0x87, 0x8f, 0x2d, 0xe6, 0x46, 0xce, 0x40,
+	  0x17, 0x11, 0x5e, 0x54, 0xc9, 0xe0, 0xc9, 0x1d, 0x99, 0x0b,
+	  0xbf, 0x4b, 0x9d, 0x27, 0x88, 0x3f, 0xcc, 0xe7, 0x9d, 0x57,
+	  0x92, 0xb2},
+	 {0xc6, 0xd0, 0x82, 0x53, 0x56, 0x61, 0x11, 0xe9, 0xe7, 0x27,
+	  0xcb, 0xc2, 0x96, 0x4c, 0x30, 0x19, 0x2f, 0xf6, 0xb6, 0x63,
+	  0x20, 0x6a, 0xb8, 0xb0, 0x7f, 0xfe, 0x9f, 0xe6, 0x4b, 0x06,
+	  0xe4, 0x12},
+	 {0xad, 0x44, 0xa6, 0xd6, 0xdf, 0x9c, 0x8f, 0x76, 0x19, 0xbf,
+	  0x2b, 0x09, 0xa2, 0xae, 0xe9, 0xe2, 0x52, 0xd9, 0x6b, 0x8f,
+	  0xb5, 0x6d, 0x5b, 0x81, 0xf9, 0xba, 0xc5, 0x47, 0x47, 0x74,
+	  0x0e, 0x26},
+	 },
+	{
+	 {0x67, 0x75, 0xb6, 0x6d, 0x05, 0x5c, 0x7e, 0x7a, 0x65, 0x05,
+	  0xa6, 0x52, 0x36, 0x32, 0xdd, 0x29, 0xc6, 0x20, 0x12, 0xc3,
+	  0x96, 0xd4, 0x84, 0x42, 0x39, 0x54, 0x5f, 0x61, 0x66, 0x6b,
+	  0x20, 0x1f},
+	 {0x21, 0x7b, 0xa1, 0x2a, 0x21, 0xcb, 0xe3, 0x5f, 0xf4, 0xa5,
+	  0xd7, 0xb2, 0x57, 0xe0, 0x70, 0xac, 0x89, 0xa1, 0xad, 0x1b,
+	  0x8c, 0x09, 0xdf, 0x29, 0x88, 0xd3, 0x45, 0x48, 0xd7, 0x22,
+	  0x96, 0x35},
+	 {0x1e, 0x22, 0x21, 0x92, 0x5a, 0xfa, 0x41, 0x49, 0x25, 0xc2,
+	  0x0e, 0x39, 0x85, 0x4e, 0x40, 0x06, 0x3b, 0x13, 0x47, 0x05,
+	  0x36, 0xdd, 0x53, 0xb8, 0x6b, 0x42, 0x0d, 0xe9, 0x5f, 0x95,
+	  0x07, 0x56},
+	 {0xac, 0x24, 0xd9, 0x1f, 0x89, 0xcb, 0x51, 0xa9, 0xf7, 0xe5,
+	  0x91, 0xe8, 0xf3, 0xf8, 0x8b, 0x4a, 0x0a, 0xaf, 0x63, 0x88,
+	  0xa7, 0x7c, 0x57, 0xd5, 0xc0, 0x6c, 0x80, 0x98, 0x60, 0x43,
+	  0xb2, 0x2d},
+	 },
+	{
+	 {0x25, 0x6a, 0xd7, 0x66, 0xaf, 0xdf, 0x6b, 0xa4, 0x70, 0x21,
+	  0x49, 0x00, 0x8e, 0x4e, 0x31, 0x42, 0xa8, 0x17, 0x6f, 0x0e,
+	  0x14, 0x2b, 0x49, 0x67, 0x13, 0x9d, 0x7c, 0x5e, 0x28, 0x07,
+	  0xa1, 0x8d},
+	 {0xbe, 0x1e, 0xe9, 0x2b, 0x41, 0x83, 0x9b, 0x3e, 0x7a, 0xb7,
+	  0xc4, 0xea, 0xaa, 0x74, 0x76, 0x0a, 0xab, 0xb5, 0x86, 0x11,
+	  0x37, 0x93, 0xd4, 0x82, 0xff, 0x9b, 0x69, 0x00, 0x16, 0x7d,
+	  0x63, 0x25},
+	 {0x05, 0x04, 0xec, 0xf4, 0xa8, 0x0a, 0x02, 0x03, 0x32, 0x0b,
+	  0x04, 0x9b, 0xa8, 0xee, 0xc5, 0x3c, 0xcd, 0x50, 0x67, 0x48,
+	  0x17, 0x2b, 0xd1, 0xa6, 0xfe, 0xcd, 0xc6, 0xb3, 0x12, 0x72,
+	  0x97, 0x75},
+	 {0x13, 0x01, 0x8c, 0xe5, 0xc8, 0x82, 0xcd, 0x48, 0x77, 0x65,
+	  0x3d, 0x50, 0xdc, 0xc5, 0x97, 0xf7, 0x85, 0x31, 0x0a, 0xdc,
+	  0x92, 0x12, 0x28, 0x30, 0x5f, 0x8f, 0xd3, 0x88, 0xd3, 0x2f,
+	  0xda, 0xa7},
+	 },
+};
+
+// MAC of a completed ctx in byte order, which is how SM3 leaves result_digest
+static void mac_bytes(uint8_t * out, HMAC_SM3_HASH_CTX * hctx)
+{
+	memcpy(out, hctx->ctx.job.result_digest, SM3_DIGEST_NWORDS * 4);
+}
+
+static int check_mac(HMAC_SM3_HASH_CTX * hctx, uint32_t job)
+{
+	uint8_t mac[sizeof(exp_mac[0][0])];
+
+	if (hctx->ctx.error || !hash_ctx_complete(&hctx->ctx))
+		return 1;
+
+	mac_bytes(mac, hctx);
+	return memcmp(mac, exp_mac[job % KEYS][job % MSGS], sizeof(mac));
+}
+
+int main(void)
+{
+	HMAC_SM3_HASH_CTX_MGR *mgr = NULL;
+	HMAC_SM3_HASH_CTX ctxpool[NUM_JOBS], *hctx;
+	HMAC_SM3_KEY keys[KEYS];
+	uint8_t key[256];
+	uint32_t i, k, len, checked = 0;
+	int ret;
+
+	printf("hmac_sm3_mb test, %d jobs: ", NUM_JOBS);
+
+	ret = posix_memalign((void *)&mgr, 16, sizeof(HMAC_SM3_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+
+	memset(msg3, 0xdd, sizeof(msg3));
+	for (i = 0; i < LONG_MSG_LEN; i++)
+		msg4[i] = i * 13 + 5;
+	for (i = 0; i < sizeof(key); i++)
+		key[i] = i * 7 + 1;
+	for (k = 0; k < KEYS; k++)
+		hmac_sm3_key_init(&keys[k], key, key_lens[k]);
+
+	hmac_sm3_ctx_mgr_init(mgr);
+
+	// Whole messages, all keys and lengths mixed in the same lanes
+	for (i = 0; i < NUM_JOBS; i++) {
+		hash_ctx_init(&ctxpool[i].ctx);
+		ctxpool[i].ctx.user_data = (void *)((uint64_t) i);
+
+		hctx = hmac_sm3_ctx_mgr_submit(mgr, &ctxpool[i], &keys[i % KEYS],
+						  msgs[i % MSGS], msg_lens[i % MSGS], HASH_ENTIRE);
+		if (hctx) {
+			if (check_mac(hctx, (uint64_t) hctx->ctx.user_data)) {
+				printf("Test failed, job %d\n", (int)(uint64_t) hctx->ctx.user_data);
+				return 1;
+			}
+			checked++;
+		}
+	}
+
+	while ((hctx = hmac_sm3_ctx_mgr_flush(mgr))) {
+		if (check_mac(hctx, (uint64_t) hctx->ctx.user_data)) {
+			printf("Test failed, job %d\n", (int)(uint64_t) hctx->ctx.user_data);
+			return 1;
+		}
+		checked++;
+	}
+
+	if (checked != NUM_JOBS) {
+		printf("only tested %d rather than %d\n", checked, NUM_JOBS);
+		return 1;
+	}
+
+	// Same ctxs rekeyed and fed in two parts
+	for (i = 0; i < KEYS * MSGS; i++) {
+		len = msg_lens[i % MSGS] / 3;
+
+		hmac_sm3_ctx_mgr_submit(mgr, &ctxpool[i], &keys[i % KEYS], msgs[i % MSGS], len,
+					   HASH_FIRST);
+		while (hmac_sm3_ctx_mgr_flush(mgr)) ;
+
+		hmac_sm3_ctx_mgr_submit(mgr, &ctxpool[i], NULL, msgs[i % MSGS] + len,
+					   msg_lens[i % MSGS] - len, HASH_LAST);
+		while (hmac_sm3_ctx_mgr_flush(mgr)) ;
+
+		if (check_mac(&ctxpool[i], i)) {
+			printf("Test failed, job %d in parts\n", i);
+			return 1;
+		}
+	}
+
+	printf("Pass\n");
+
+	return 0;
+}
@@ -0,0 +1,380 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "sm3_mb_pool.h"
+#include "endian_helper.h"
+
+#define MERKLE_SM3_DIGEST_BYTES	(SM3_DIGEST_NWORDS * sizeof(SM3_WORD_T))
+#define MERKLE_SM3_NODE_LEN		(1 + 2 * MERKLE_SM3_DIGEST_BYTES)
+
+// Leaves are hashed and reduced this many at a time when only the root is kept
+#define MERKLE_SM3_CHUNK		1024
+
+/*
+ * RFC 6962 tree hash: a leaf is hashed as 0x00 | leaf and an interior node as
+ * 0x01 | left | right, so leaves and nodes can never be confused. A node with
+ * no right sibling is promoted to the next level unchanged, which builds the
+ * same tree as the RFC's split at the largest power of two. All hashes of one
+ * level are independent and go through the manager as a single batch.
+ */
+enum merkle_sm3_kind { MERKLE_LEAF, MERKLE_NODE, MERKLE_EMPTY };
+
+struct merkle_sm3_job {
+	enum merkle_sm3_kind kind;
+	const void *leaf;
+	uint32_t leaf_len;
+	const uint8_t *left, *right;	// children of a node, copied in at submit
+	uint8_t *out;
+};
+
+static const uint8_t merkle_sm3_leaf_prefix = 0x00;
+
+static void merkle_sm3_store(uint8_t * out, const SM3_WORD_T * digest)
+{
+	SM3_WORD_T w;
+	int i;
+
+	for (i = 0; i < SM3_DIGEST_NWORDS; i++) {
+		w = to_le32(digest[i]);
+		memcpy(&out[i * sizeof(w)], &w, sizeof(w));
+	}
+}
+
+struct merkle_sm3_batch {
+	struct merkle_sm3_job *jobs;
+	uint8_t(*node)[MERKLE_SM3_NODE_LEN];	// one node message per lane
+};
+
+/*
+ * Node children are copied into the buffer of the lane when submitted, so a
+ * job may write its output over the children of a job submitted earlier.
+ */
+static SM3_HASH_CTX *merkle_sm3_start(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX * ctx,
+				      uint32_t i, uint32_t lane, void *arg)
+{
+	struct merkle_sm3_batch *batch = arg;
+	struct merkle_sm3_job *job = &batch->jobs[i];
+	uint8_t *msg;
+
+	ctx->user_data = job;
+
+	if (job->kind == MERKLE_NODE) {
+		msg = batch->node[lane];
+		msg[0] = 0x01;
+		memcpy(&msg[1], job->left, MERKLE_SM3_DIGEST_BYTES);
+		memcpy(&msg[1 + MERKLE_SM3_DIGEST_BYTES], job->right, MERKLE_SM3_DIGEST_BYTES);
+		return sm3_ctx_mgr_submit(mgr, ctx, msg, MERKLE_SM3_NODE_LEN, HASH_ENTIRE);
+	}
+
+	if (job->kind == MERKLE_LEAF)
+		return sm3_ctx_mgr_submit(mgr, ctx, &merkle_sm3_leaf_prefix, 1, HASH_FIRST);
+
+	return sm3_ctx_mgr_submit(mgr, ctx, NULL, 0, HASH_ENTIRE);
+}
+
+/*
+ * A leaf whose prefix has gone in is resubmitted with the leaf itself,
+ * finished hashes are stored.
+ */
+static int merkle_sm3_next(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX ** ctx, void *arg)
+{
+	struct merkle_sm3_job *job = (*ctx)->user_data;
+
+	if (!hash_ctx_complete(*ctx)) {
+		*ctx = sm3_ctx_mgr_submit(mgr, *ctx, job->leaf, job->leaf_len, HASH_LAST);
+		return 1;
+	}
+
+	merkle_sm3_store(job->out, (*ctx)->job.result_digest);
+	return 0;
+}
+
+// Hash a batch of independent jobs with every lane of the manager kept busy
+static int merkle_sm3_run(struct merkle_sm3_job *jobs, uint32_t n)
+{
+	uint8_t node[SM3_MAX_LANES][MERKLE_SM3_NODE_LEN];
+	struct merkle_sm3_batch batch;
+
+	if (n == 0)
+		return 0;
+
+	batch.jobs = jobs;
+	batch.node = node;
+	return sm3_mb_pool_run(n, merkle_sm3_start, merkle_sm3_next, &batch);
+}
+
+static void merkle_sm3_leaf_job(struct merkle_sm3_job *job, const void *leaves,
+				uint64_t i, uint32_t leaf_size, uint8_t * out)
+{
+	job->kind = MERKLE_LEAF;
+	job->leaf = (const uint8_t *)leaves + i * leaf_size;
+	job->leaf_len = leaf_size;
+	job->out = out;
+}
+
+static void merkle_sm3_node_job(struct merkle_sm3_job *job, const uint8_t * left,
+				const uint8_t * right, uint8_t * out)
+{
+	job->kind = MERKLE_NODE;
+	job->left = left;
+	job->right = right;
+	job->out = out;
+}
+
+uint64_t merkle_sm3_tree_nodes(uint32_t nleaves)
+{
+	uint64_t nodes = nleaves ? nleaves : 1;
+
+	while (nleaves > 1) {
+		nleaves = nleaves / 2 + (nleaves & 1);
+		nodes += nleaves;
+	}
+
+	return nodes;
+}
+
+int merkle_sm3_build(const void *leaves, uint32_t nleaves, uint32_t leaf_size,
+		     uint8_t(*tree)[SM3_DIGEST_NWORDS * 4])
+{
+	struct merkle_sm3_job *jobs;
+	uint64_t base = 0, next;
+	uint32_t i, m;
+	int ret = 0;
+
+	jobs = (struct merkle_sm3_job *)malloc((nleaves ? nleaves : 1) * sizeof(*jobs));
+	if (jobs == NULL)
+		return -1;
+
+	if (nleaves == 0) {
+		// The tree of no leaves is the hash of the empty string
+		jobs[0].kind = MERKLE_EMPTY;
+		jobs[0].out = tree[0];
+		ret = merkle_sm3_run(jobs, 1);
+		free(jobs);
+		return ret;
+	}
+
+	for (i = 0; i < nleaves; i++)
+		merkle_sm3_leaf_job(&jobs[i], leaves, i, leaf_size, tree[i]);
+	ret |= merkle_sm3_run(jobs, nleaves);
+
+	// Each level follows the previous one, the root is the last node
+	for (m = nleaves; m > 1; m = m / 2 + (m & 1)) {
+		next = base + m;
+		for (i = 0; i < m / 2; i++)
+			merkle_sm3_node_job(&jobs[i], tree[base + 2 * i],
+					    tree[base + 2 * i + 1], tree[next + i]);
+		if (m & 1)
+			memcpy(tree[next + m / 2], tree[base + m - 1],
+			       MERKLE_SM3_DIGEST_BYTES);
+
+		ret |= merkle_sm3_run(jobs, m / 2);
+		base = next;
+	}
+
+	free(jobs);
+	return ret;
+}
+
+static int merkle_sm3_idx_cmp(const void *a, const void *b)
+{
+	uint32_t ia = *(const uint32_t *)a, ib = *(const uint32_t *)b;
+
+	return (ia > ib) - (ia < ib);
+}
+
+int merkle_sm3_update(uint8_t(*tree)[SM3_DIGEST_NWORDS * 4], uint32_t nleaves,
+		      const void *leaves, uint32_t leaf_size, const uint32_t idx[],
+		      uint32_t nidx)
+{
+	struct merkle_sm3_job *jobs;
+	uint32_t *dirty, i, k, ndirty, m, p;
+	uint64_t base = 0, next;
+	int ret = 0;
+
+	if (nidx == 0)
+		return 0;
+
+	for (i = 0; i < nidx; i++)
+		if (idx[i] >= nleaves)
+			return -1;
+
+	dirty = (uint32_t *) malloc(nidx * sizeof(*dirty));
+	jobs = (struct merkle_sm3_job *)malloc(nidx * sizeof(*jobs));
+	if (dirty == NULL || jobs == NULL) {
+		free(dirty);
+		free(jobs);
+		return -1;
+	}
+
+	memcpy(dirty, idx, nidx * sizeof(*dirty));
+	qsort(dirty, nidx, sizeof(*dirty), merkle_sm3_idx_cmp);
+	for (i = 1, ndirty = 1; i < nidx; i++)
+		if (dirty[i] != dirty[ndirty - 1])
+			dirty[ndirty++] = dirty[i];
+
+	for (i = 0; i < ndirty; i++)
+		merkle_sm3_leaf_job(&jobs[i], leaves, dirty[i], leaf_size, tree[dirty[i]]);
+	ret |= merkle_sm3_run(jobs, ndirty);
+
+	// Recompute the parents of the changed nodes one level at a time
+	for (m = nleaves; m > 1; m = m / 2 + (m & 1)) {
+		next = base + m;
+		for (i = 0, p = 0, k = 0; i < ndirty; i++) {
+			if (p && dirty[i] / 2 == dirty[p - 1])
+				continue;
+			dirty[p] = dirty[i] / 2;
+			if (2 * dirty[p] + 1 < m)
+				merkle_sm3_node_job(&jobs[k++], tree[base + 2 * dirty[p]],
+						    tree[base + 2 * dirty[p] + 1],
+						    tree[next + dirty[p]]);
+			else	// promoted, a copy of its only child
+				memcpy(tree[next + dirty[p]], tree[base + 2 * dirty[p]],
+				       MERKLE_SM3_DIGEST_BYTES);
+			p++;
+		}
+		ndirty = p;
+
+		ret |= merkle_sm3_run(jobs, k);
+		base = next;
+	}
+
+	free(dirty);
+	free(jobs);
+	return ret;
+}
+
+void merkle_sm3_init(MERKLE_SM3_STATE * state)
+{
+	memset(state, 0, sizeof(*state));
+}
+
+int merkle_sm3_append(MERKLE_SM3_STATE * state, const void *leaves, uint32_t nleaves,
+		      uint32_t leaf_size)
+{
+	struct merkle_sm3_job *jobs;
+	uint8_t(*work)[MERKLE_SM3_DIGEST_BYTES];
+	uint64_t pos;
+	uint32_t c, h, i, k, m, done;
+	int ret = 0;
+
+	if (nleaves == 0)
+		return 0;
+
+	jobs = (struct merkle_sm3_job *)malloc(MERKLE_SM3_CHUNK * sizeof(*jobs));
+	work = (uint8_t(*)[MERKLE_SM3_DIGEST_BYTES])
+	    malloc(MERKLE_SM3_CHUNK * sizeof(*work));
+	if (jobs == NULL || work == NULL) {
+		free(jobs);
+		free(work);
+		return -1;
+	}
+
+	for (done = 0; done < nleaves; done += c) {
+		c = nleaves - done;
+		if (c > MERKLE_SM3_CHUNK)
+			c = MERKLE_SM3_CHUNK;
+
+		for (i = 0; i < c; i++)
+			merkle_sm3_leaf_job(&jobs[i], leaves, (uint64_t) done + i, leaf_size,
+					    work[i]);
+		ret |= merkle_sm3_run(jobs, c);
+
+		/*
+		 * Pair up the nodes of each level in place. A first node at an odd
+		 * position completes the pending left sibling of its level, and a
+		 * last node at an even position becomes the pending one.
+		 */
+		pos = state->nleaves;
+		for (h = 0, m = c; m > 0; h++, m = k, pos >>= 1) {
+			k = 0;
+			i = 0;
+			if (pos & 1) {
+				merkle_sm3_node_job(&jobs[k++], state->frontier[h], work[0],
+						    work[0]);
+				i = 1;
+			}
+			for (; i + 1 < m; i += 2, k++)
+				merkle_sm3_node_job(&jobs[k], work[i], work[i + 1], work[k]);
+
+			ret |= merkle_sm3_run(jobs, k);
+
+			if (i < m)
+				memcpy(state->frontier[h], work[i], MERKLE_SM3_DIGEST_BYTES);
+		}
+
+		state->nleaves += c;
+	}
+
+	free(jobs);
+	free(work);
+	return ret;
+}
+
+int merkle_sm3_final(const MERKLE_SM3_STATE * state,
+		     uint8_t root[SM3_DIGEST_NWORDS * 4])
+{
+	struct merkle_sm3_job job;
+	uint32_t h;
+	int ret = 0;
+
+	if (state->nleaves == 0) {
+		job.kind = MERKLE_EMPTY;
+		job.out = root;
+		return merkle_sm3_run(&job, 1);
+	}
+
+	// Fold the pending perfect subtrees from the smallest, rightmost one up
+	for (h = 0; !(state->nleaves >> h & 1); h++) ;
+	memcpy(root, state->frontier[h], MERKLE_SM3_DIGEST_BYTES);
+
+	for (h++; h < MERKLE_SM3_MAX_HEIGHT; h++) {
+		if (!(state->nleaves >> h & 1))
+			continue;
+		merkle_sm3_node_job(&job, state->frontier[h], root, root);
+		ret |= merkle_sm3_run(&job, 1);
+	}
+
+	return ret;
+}
+
+int merkle_sm3_root(const void *leaves, uint32_t nleaves, uint32_t leaf_size,
+		    uint8_t root[SM3_DIGEST_NWORDS * 4])
+{
+	MERKLE_SM3_STATE state;
+	int ret;
+
+	merkle_sm3_init(&state);
+	ret = merkle_sm3_append(&state, leaves, nleaves, leaf_size);
+	ret |= merkle_sm3_final(&state, root);
+
+	return ret;
+}
@@ -0,0 +1,169 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sm3_mb.h"
+
+#define DIGEST_BYTES (SM3_DIGEST_NWORDS * sizeof(SM3_WORD_T))
+#define MAX_LEAVES 2500
+#define MAX_LEAF_SIZE 100
+#define UPDATES 20
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+
+static const uint32_t test_leaves[] = { 0, 1, 2, 3, 5, 7, 8, 13, 64, 100, 1025, MAX_LEAVES };
+
+static uint8_t leaves[MAX_LEAVES * MAX_LEAF_SIZE];
+static uint8_t msg[1 + MAX_LEAF_SIZE];
+
+// Hash one message through the plain ctx manager path
+static void hash_one(const uint8_t * buf, uint64_t len, uint8_t * out)
+{
+	const void *bufs[1] = { buf };
+
+	sm3_mb_hash_many(bufs, &len, 1, (uint8_t(*)[DIGEST_BYTES]) out);
+}
+
+// RFC 6962 MTH, split at the largest power of two below n
+static void mth_ref(const uint8_t * d, uint32_t n, uint32_t leaf_size, uint8_t * out)
+{
+	uint8_t node[1 + 2 * DIGEST_BYTES];
+	uint32_t k;
+
+	if (n == 0) {
+		hash_one(NULL, 0, out);
+		return;
+	}
+
+	if (n == 1) {
+		msg[0] = 0x00;
+		memcpy(&msg[1], d, leaf_size);
+		hash_one(msg, 1 + leaf_size, out);
+		return;
+	}
+
+	for (k = 1; 2 * k < n; k *= 2) ;
+
+	node[0] = 0x01;
+	mth_ref(d, k, leaf_size, &node[1]);
+	mth_ref(d + k * leaf_size, n - k, leaf_size, &node[1 + DIGEST_BYTES]);
+	hash_one(node, sizeof(node), out);
+}
+
+int main(void)
+{
+	MERKLE_SM3_STATE state;
+	uint8_t(*tree)[DIGEST_BYTES], (*tree_ref)[DIGEST_BYTES];
+	uint8_t root[DIGEST_BYTES], root_ref[DIGEST_BYTES];
+	uint32_t i, t, n, leaf_size, done, c, idx[UPDATES];
+	uint64_t nodes;
+
+	printf("merkle_sm3 test: ");
+
+	tree = malloc(merkle_sm3_tree_nodes(MAX_LEAVES) * DIGEST_BYTES);
+	tree_ref = malloc(merkle_sm3_tree_nodes(MAX_LEAVES) * DIGEST_BYTES);
+	if (tree == NULL || tree_ref == NULL) {
+		printf("malloc failed test aborted\n");
+		return 1;
+	}
+
+	srand(TEST_SEED);
+
+	for (i = 0; i < sizeof(leaves); i++)
+		leaves[i] = rand();
+
+	for (t = 0; t < sizeof(test_leaves) / sizeof(test_leaves[0]); t++) {
+		n = test_leaves[t];
+		leaf_size = (t % 4 == 0) ? 0 : rand() % MAX_LEAF_SIZE + 1;
+		nodes = merkle_sm3_tree_nodes(n);
+		mth_ref(leaves, n, leaf_size, root_ref);
+
+		// Whole tree, root last
+		if (merkle_sm3_build(leaves, n, leaf_size, tree) ||
+		    memcmp(tree[nodes - 1], root_ref, DIGEST_BYTES)) {
+			printf("Test failed, build of %d leaves\n", n);
+			return 1;
+		}
+
+		// Root only
+		if (merkle_sm3_root(leaves, n, leaf_size, root) ||
+		    memcmp(root, root_ref, DIGEST_BYTES)) {
+			printf("Test failed, root of %d leaves\n", n);
+			return 1;
+		}
+
+		// Appended in random pieces, with the root taken along the way
+		merkle_sm3_init(&state);
+		for (done = 0; done < n; done += c) {
+			c = rand() % (n - done) + 1;
+			if (merkle_sm3_append(&state, leaves + done * leaf_size, c, leaf_size)
+			    || merkle_sm3_final(&state, root)) {
+				printf("Append returned an error\n");
+				return 1;
+			}
+			mth_ref(leaves, done + c, leaf_size, root_ref);
+			if (memcmp(root, root_ref, DIGEST_BYTES)) {
+				printf("Test failed, append of %d leaves\n", done + c);
+				return 1;
+			}
+		}
+
+		// Changed leaves, some of them repeated
+		if (n) {
+			for (i = 0; i < UPDATES; i++) {
+				idx[i] = (i % 5 == 4) ? idx[i - 1] : rand() % n;
+				if (leaf_size)
+					leaves[idx[i] * leaf_size] ^= 1 + i;
+			}
+			if (merkle_sm3_update(tree, n, leaves, leaf_size, idx, UPDATES) ||
+			    merkle_sm3_build(leaves, n, leaf_size, tree_ref) ||
+			    memcmp(tree, tree_ref, nodes * DIGEST_BYTES)) {
+				printf("Test failed, update of %d leaves\n", n);
+				return 1;
+			}
+			idx[0] = n;
+			if (merkle_sm3_update(tree, n, leaves, leaf_size, idx, 1) == 0) {
+				printf("Out of range leaf not rejected\n");
+				return 1;
+			}
+		}
+
+		putchar('.');
+		fflush(0);
+	}
+
+	free(tree);
+	free(tree_ref);
+	printf(" Pass\n");
+
+	return 0;
+}
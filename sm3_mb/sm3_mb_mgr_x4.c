@@ -0,0 +1,218 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stddef.h>
+#include <assert.h>
+#include "sm3_mb.h"
+
+#ifndef min
+#define min(a,b)            (((a) > (b)) ? (b) : (a))
+#endif
+
+/*
+ * Lane manager shared by the SSE and AVX x4 kernels. Lanes that are empty or
+ * already done are passed to the kernel as NULL, so a flush runs the
+ * remaining jobs together instead of one at a time.
+ */
+
+#define SM3_X4_MAX_LANES	4
+
+typedef void (*sm3_mb_x4_func) (SM3_JOB * jobs[SM3_X4_MAX_LANES], uint64_t len);
+
+void sm3_mb_x4_sse(SM3_JOB * jobs[SM3_X4_MAX_LANES], uint64_t len);
+void sm3_mb_x4_avx(SM3_JOB * jobs[SM3_X4_MAX_LANES], uint64_t len);
+
+void sm3_mb_mgr_init_sse(SM3_MB_JOB_MGR * state);
+SM3_JOB *sm3_mb_mgr_submit_sse(SM3_MB_JOB_MGR * state, SM3_JOB * job);
+SM3_JOB *sm3_mb_mgr_flush_sse(SM3_MB_JOB_MGR * state);
+void sm3_mb_mgr_init_avx(SM3_MB_JOB_MGR * state);
+SM3_JOB *sm3_mb_mgr_submit_avx(SM3_MB_JOB_MGR * state, SM3_JOB * job);
+SM3_JOB *sm3_mb_mgr_flush_avx(SM3_MB_JOB_MGR * state);
+
+#define LANE_IS_NOT_FINISHED(state,i)  	\
+	(((state->lens[i]&(~0xf))!=0) && state->ldata[i].job_in_lane!=NULL)
+#define LANE_IS_FINISHED(state,i)  	\
+	(((state->lens[i]&(~0xf))==0) && state->ldata[i].job_in_lane!=NULL)
+
+static void sm3_mb_mgr_init_x4(SM3_MB_JOB_MGR * state)
+{
+	unsigned int i;
+
+	state->unused_lanes = 0xf;
+	state->num_lanes_inuse = 0;
+	for (i = 0; i < SM3_X4_MAX_LANES; i++) {
+		state->unused_lanes <<= 4;
+		state->unused_lanes |= SM3_X4_MAX_LANES - 1 - i;
+		state->lens[i] = i;
+		state->ldata[i].job_in_lane = 0;
+	}
+
+	//lanes > SM3_X4_MAX_LANES is invalid lane
+	for (; i < SM3_MAX_LANES; i++) {
+		state->lens[i] = 0xf;
+		state->ldata[i].job_in_lane = 0;
+	}
+}
+
+static int sm3_mb_mgr_do_jobs(SM3_MB_JOB_MGR * state, sm3_mb_x4_func x4)
+{
+	SM3_JOB *jobs[SM3_X4_MAX_LANES];
+	uint32_t len = 0;
+	int i, lanes = 0, lane_idx = -1;
+
+	for (i = 0; i < SM3_X4_MAX_LANES; i++) {
+		jobs[i] = NULL;
+		if (LANE_IS_NOT_FINISHED(state, i)) {
+			if (lanes == 0 || state->lens[i] < len)
+				len = state->lens[i];
+			jobs[i] = state->ldata[i].job_in_lane;
+			lanes++;
+		}
+	}
+	if (lanes == 0)
+		return -1;
+
+	lane_idx = len & 0xf;
+	len &= ~0xf;
+	x4(jobs, len >> 4);
+
+	//only return the min length job
+	for (i = 0; i < SM3_X4_MAX_LANES; i++) {
+		if (jobs[i] != NULL) {
+			state->lens[i] -= len;
+			jobs[i]->len -= len >> 4;
+			jobs[i]->buffer += (len >> 4) * SM3_BLOCK_SIZE;
+		}
+	}
+
+	return lane_idx;
+}
+
+static SM3_JOB *sm3_mb_mgr_free_lane(SM3_MB_JOB_MGR * state)
+{
+	int i;
+	SM3_JOB *ret = NULL;
+
+	for (i = 0; i < SM3_X4_MAX_LANES; i++) {
+		if (LANE_IS_FINISHED(state, i)) {
+
+			state->unused_lanes <<= 4;
+			state->unused_lanes |= i;
+			state->num_lanes_inuse--;
+			ret = state->ldata[i].job_in_lane;
+			ret->status = STS_COMPLETED;
+			state->ldata[i].job_in_lane = NULL;
+			break;
+		}
+	}
+	return ret;
+}
+
+static void sm3_mb_mgr_insert_job(SM3_MB_JOB_MGR * state, SM3_JOB * job)
+{
+	int lane_idx;
+	//add job into lanes
+	lane_idx = state->unused_lanes & 0xf;
+	//fatal error
+	assert(lane_idx < SM3_X4_MAX_LANES);
+	state->lens[lane_idx] = (job->len << 4) | lane_idx;
+	state->ldata[lane_idx].job_in_lane = job;
+	state->unused_lanes >>= 4;
+	state->num_lanes_inuse++;
+}
+
+static SM3_JOB *sm3_mb_mgr_submit_x4(SM3_MB_JOB_MGR * state, SM3_JOB * job, sm3_mb_x4_func x4)
+{
+#ifndef NDEBUG
+	int lane_idx;
+#endif
+	SM3_JOB *ret;
+
+	//add job into lanes
+	sm3_mb_mgr_insert_job(state, job);
+
+	ret = sm3_mb_mgr_free_lane(state);
+	if (ret != NULL) {
+		return ret;
+	}
+	//submit will wait all lane has data
+	if (state->num_lanes_inuse < SM3_X4_MAX_LANES)
+		return NULL;
+#ifndef NDEBUG
+	lane_idx = sm3_mb_mgr_do_jobs(state, x4);
+	assert(lane_idx != -1);
+#else
+	sm3_mb_mgr_do_jobs(state, x4);
+#endif
+
+	ret = sm3_mb_mgr_free_lane(state);
+	return ret;
+}
+
+static SM3_JOB *sm3_mb_mgr_flush_x4(SM3_MB_JOB_MGR * state, sm3_mb_x4_func x4)
+{
+	SM3_JOB *ret;
+	ret = sm3_mb_mgr_free_lane(state);
+	if (ret) {
+		return ret;
+	}
+
+	sm3_mb_mgr_do_jobs(state, x4);
+	return sm3_mb_mgr_free_lane(state);
+}
+
+void sm3_mb_mgr_init_sse(SM3_MB_JOB_MGR * state)
+{
+	sm3_mb_mgr_init_x4(state);
+}
+
+SM3_JOB *sm3_mb_mgr_submit_sse(SM3_MB_JOB_MGR * state, SM3_JOB * job)
+{
+	return sm3_mb_mgr_submit_x4(state, job, sm3_mb_x4_sse);
+}
+
+SM3_JOB *sm3_mb_mgr_flush_sse(SM3_MB_JOB_MGR * state)
+{
+	return sm3_mb_mgr_flush_x4(state, sm3_mb_x4_sse);
+}
+
+void sm3_mb_mgr_init_avx(SM3_MB_JOB_MGR * state)
+{
+	sm3_mb_mgr_init_x4(state);
+}
+
+SM3_JOB *sm3_mb_mgr_submit_avx(SM3_MB_JOB_MGR * state, SM3_JOB * job)
+{
+	return sm3_mb_mgr_submit_x4(state, job, sm3_mb_x4_avx);
+}
+
+SM3_JOB *sm3_mb_mgr_flush_avx(SM3_MB_JOB_MGR * state)
+{
+	return sm3_mb_mgr_flush_x4(state, sm3_mb_x4_avx);
+}
@@ -0,0 +1,344 @@
+/**********************************************************************
+  Copyright(c) 2011-2020 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sm3_mb.h"
+#include "endian_helper.h"
+#include "isal_crypto_dispatch.h"
+
+#define TEST_LEN  (16*1024)
+#define TEST_BUFS 20
+#ifndef RANDOMS
+# define RANDOMS  10
+#endif
+#ifndef TEST_SEED
+# define TEST_SEED 0x1234
+#endif
+
+#define MAX_UPDATE_LEN	(4 * SM3_BLOCK_SIZE + 17)
+
+typedef uint32_t digest_sm3[SM3_DIGEST_NWORDS];
+
+extern void sm3_ctx_mgr_init_base(SM3_HASH_CTX_MGR * mgr);
+extern SM3_HASH_CTX *sm3_ctx_mgr_submit_base(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX * ctx,
+					     const void *buffer, uint32_t len,
+					     HASH_CTX_FLAG flags);
+extern SM3_HASH_CTX *sm3_ctx_mgr_flush_base(SM3_HASH_CTX_MGR * mgr);
+
+#if (!defined(NOARCH)) && (defined(__i386__) || defined(__x86_64__) \
+	|| defined( _M_X64) || defined(_M_IX86))
+extern void sm3_ctx_mgr_init_sse(SM3_HASH_CTX_MGR * mgr);
+extern SM3_HASH_CTX *sm3_ctx_mgr_submit_sse(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX * ctx,
+					    const void *buffer, uint32_t len,
+					    HASH_CTX_FLAG flags);
+extern SM3_HASH_CTX *sm3_ctx_mgr_flush_sse(SM3_HASH_CTX_MGR * mgr);
+extern void sm3_ctx_mgr_init_avx(SM3_HASH_CTX_MGR * mgr);
+extern SM3_HASH_CTX *sm3_ctx_mgr_submit_avx(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX * ctx,
+					    const void *buffer, uint32_t len,
+					    HASH_CTX_FLAG flags);
+extern SM3_HASH_CTX *sm3_ctx_mgr_flush_avx(SM3_HASH_CTX_MGR * mgr);
+# ifdef HAVE_AS_KNOWS_SM3NI
+extern void sm3_ctx_mgr_init_ni(SM3_HASH_CTX_MGR * mgr);
+extern SM3_HASH_CTX *sm3_ctx_mgr_submit_ni(SM3_HASH_CTX_MGR * mgr, SM3_HASH_CTX * ctx,
+					   const void *buffer, uint32_t len,
+					   HASH_CTX_FLAG flags);
+extern SM3_HASH_CTX *sm3_ctx_mgr_flush_ni(SM3_HASH_CTX_MGR * mgr);
+# endif
+#endif
+
+struct sm3_variant {
+	const char *name;
+	uint64_t cpu_features;	// ISAL_CPU_* needed to run it
+	void (*init)(SM3_HASH_CTX_MGR *);
+	SM3_HASH_CTX *(*submit)(SM3_HASH_CTX_MGR *, SM3_HASH_CTX *, const void *,
+				uint32_t, HASH_CTX_FLAG);
+	SM3_HASH_CTX *(*flush)(SM3_HASH_CTX_MGR *);
+};
+
+// Managers called directly, so they are tested whatever the dispatch picks
+static const struct sm3_variant variants[] = {
+#if (!defined(NOARCH)) && (defined(__i386__) || defined(__x86_64__) \
+	|| defined( _M_X64) || defined(_M_IX86))
+	{"sse", ISAL_CPU_X86_SSE4_1, sm3_ctx_mgr_init_sse,
+	 sm3_ctx_mgr_submit_sse, sm3_ctx_mgr_flush_sse},
+	{"avx", ISAL_CPU_X86_AVX, sm3_ctx_mgr_init_avx,
+	 sm3_ctx_mgr_submit_avx, sm3_ctx_mgr_flush_avx},
+# ifdef HAVE_AS_KNOWS_SM3NI
+	{"ni", ISAL_CPU_X86_AVX2 | ISAL_CPU_X86_SM3, sm3_ctx_mgr_init_ni,
+	 sm3_ctx_mgr_submit_ni, sm3_ctx_mgr_flush_ni},
+# endif
+#endif
+	{NULL, 0, NULL, NULL, NULL}
+};
+
+#define MSGS 2
+
+static uint8_t msg1[] = "abc";
+static uint8_t msg2[] = "abcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcdabcd";
+
+/* small endian */
+static digest_sm3 exp_result_digest1 = { 0x66c7f0f4, 0x62eeedd9, 0xd1f2d46b, 0xdc10e4e2,
+	0x4167c487, 0x5cf2f7a2, 0x297da02b, 0x8f4ba8e0
+};
+
+/* small endian */
+static digest_sm3 exp_result_digest2 = { 0xdebe9ff9, 0x2275b8a1, 0x38604889, 0xc18e5a4d,
+	0x6fdb70e5, 0x387e5765, 0x293dcba3, 0x9c0c5732
+};
+
+static uint8_t *msgs[MSGS] = { msg1, msg2 };
+
+static uint32_t *exp_result_digest[MSGS] = {
+	exp_result_digest1, exp_result_digest2
+};
+
+#define KAT_JOBS 40
+
+/* Reference digest global to reduce stack usage */
+static uint32_t digest_ref[TEST_BUFS][SM3_DIGEST_NWORDS];
+
+// Generates pseudo-random data
+static void rand_buffer(unsigned char *buf, const long buffer_size)
+{
+	long i;
+	for (i = 0; i < buffer_size; i++)
+		buf[i] = rand();
+}
+
+static int check_digest(const char *name, uint32_t job, const uint32_t * digest,
+			const uint32_t * good)
+{
+	uint32_t j;
+
+	for (j = 0; j < SM3_DIGEST_NWORDS; j++) {
+		if (digest[j] != good[j]) {
+			printf("\n%s: job %d, digest %d is %08X, should be %08X\n",
+			       name, job, j, digest[j], good[j]);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+// Reference digests from the base manager, one job at a time
+static int ref_digest(SM3_HASH_CTX_MGR * mgr, const unsigned char *buf, uint32_t len,
+		      uint32_t * digest)
+{
+	SM3_HASH_CTX ctx;
+
+	hash_ctx_init(&ctx);
+	if (sm3_ctx_mgr_submit_base(mgr, &ctx, buf, len, HASH_ENTIRE) == NULL)
+		while (sm3_ctx_mgr_flush_base(mgr) != NULL) ;
+	if (!hash_ctx_complete(&ctx) || ctx.error)
+		return -1;
+
+	memcpy(digest, ctx.job.result_digest, sizeof(ctx.job.result_digest));
+	return 0;
+}
+
+// Known answers, enough jobs in flight to fill the lanes several times
+static int kat_test(const struct sm3_variant *v, SM3_HASH_CTX_MGR * mgr)
+{
+	SM3_HASH_CTX ctxpool[KAT_JOBS], *ctx;
+	uint32_t good[SM3_DIGEST_NWORDS];
+	uint32_t i, j, returned = 0;
+
+	v->init(mgr);
+
+	for (i = 0; i < KAT_JOBS; i++) {
+		hash_ctx_init(&ctxpool[i]);
+		ctx = v->submit(mgr, &ctxpool[i], msgs[i % MSGS], strlen((char *)msgs[i % MSGS]),
+				HASH_ENTIRE);
+		if (ctx && ctx->error) {
+			printf("\n%s: submit error %d\n", v->name, ctx->error);
+			return -1;
+		}
+		if (ctx)
+			returned++;
+	}
+
+	while ((ctx = v->flush(mgr)) != NULL) {
+		if (ctx->error) {
+			printf("\n%s: flush error %d\n", v->name, ctx->error);
+			return -1;
+		}
+		returned++;
+	}
+
+	if (returned != KAT_JOBS) {
+		printf("\n%s: %d of %d jobs returned\n", v->name, returned, KAT_JOBS);
+		return -1;
+	}
+
+	for (i = 0; i < KAT_JOBS; i++) {
+		for (j = 0; j < SM3_DIGEST_NWORDS; j++)
+			good[j] = byteswap32(exp_result_digest[i % MSGS][j]);
+		if (check_digest(v->name, i, ctxpool[i].job.result_digest, good))
+			return -1;
+	}
+
+	return 0;
+}
+
+// Random length jobs fed in random size updates, checked against the base manager
+static int rand_update_test(const struct sm3_variant *v, SM3_HASH_CTX_MGR * mgr,
+			    SM3_HASH_CTX_MGR * ref_mgr, unsigned char **bufs)
+{
+	SM3_HASH_CTX ctxpool[TEST_BUFS], *ctx;
+	uint32_t lens[TEST_BUFS], done[TEST_BUFS], last[TEST_BUFS];
+	uint32_t i, t, jobs, len, pending, submitted;
+	HASH_CTX_FLAG flags;
+
+	for (t = 0; t < RANDOMS; t++) {
+		jobs = rand() % TEST_BUFS + 1;
+
+		for (i = 0; i < jobs; i++) {
+			lens[i] = rand() % TEST_LEN;
+			rand_buffer(bufs[i], lens[i]);
+			if (ref_digest(ref_mgr, bufs[i], lens[i], digest_ref[i])) {
+				printf("\nbase: job %d failed\n", i);
+				return -1;
+			}
+			hash_ctx_init(&ctxpool[i]);
+			done[i] = 0;
+			last[i] = 0;
+		}
+
+		v->init(mgr);
+
+		for (;;) {
+			pending = 0;
+			submitted = 0;
+			for (i = 0; i < jobs; i++) {
+				if (last[i])
+					continue;
+				pending++;
+				if (hash_ctx_processing(&ctxpool[i]))
+					continue;
+
+				len = rand() % MAX_UPDATE_LEN;
+				flags = (done[i] == 0) ? HASH_FIRST : HASH_UPDATE;
+				if (lens[i] - done[i] <= len) {
+					len = lens[i] - done[i];
+					flags |= HASH_LAST;
+					last[i] = 1;
+				}
+
+				ctx = v->submit(mgr, &ctxpool[i], bufs[i] + done[i], len, flags);
+				if (ctx && ctx->error) {
+					printf("\n%s: submit error %d\n", v->name, ctx->error);
+					return -1;
+				}
+				done[i] += len;
+				submitted++;
+			}
+			if (pending == 0)
+				break;
+
+			// Leave jobs in the lanes between rounds now and then
+			if (submitted == 0 || (rand() & 1))
+				while (v->flush(mgr) != NULL) ;
+		}
+
+		while (v->flush(mgr) != NULL) ;
+
+		for (i = 0; i < jobs; i++) {
+			if (!hash_ctx_complete(&ctxpool[i])) {
+				printf("\n%s: job %d not complete\n", v->name, i);
+				return -1;
+			}
+			if (check_digest(v->name, i, ctxpool[i].job.result_digest, digest_ref[i]))
+				return -1;
+		}
+		putchar('.');
+	}
+
+	return 0;
+}
+
+int main(void)
+{
+	struct isal_crypto_dispatch_info info;
+	SM3_HASH_CTX_MGR *mgr = NULL, *ref_mgr = NULL;
+	const struct sm3_variant *v;
+	unsigned char *bufs[TEST_BUFS];
+	int i, ret;
+
+	printf("sm3_mb_variants test:");
+
+	if (isal_crypto_dispatch_info(&info, NULL, 0) < 0) {
+		printf(" isal_crypto_dispatch_info failed\n");
+		return 1;
+	}
+
+	ret = posix_memalign((void *)&mgr, 16, sizeof(SM3_HASH_CTX_MGR));
+	if ((ret != 0) || (mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+	ret = posix_memalign((void *)&ref_mgr, 16, sizeof(SM3_HASH_CTX_MGR));
+	if ((ret != 0) || (ref_mgr == NULL)) {
+		printf("posix_memalign failed test aborted\n");
+		return 1;
+	}
+	sm3_ctx_mgr_init_base(ref_mgr);
+
+	for (i = 0; i < TEST_BUFS; i++) {
+		bufs[i] = (unsigned char *)malloc(TEST_LEN);
+		if (bufs[i] == NULL) {
+			printf("malloc failed test aborted\n");
+			return 1;
+		}
+	}
+
+	srand(TEST_SEED);
+
+	for (v = variants; v->name != NULL; v++) {
+		if ((info.cpu_features & v->cpu_features) != v->cpu_features) {
+			printf(" %s(skipped)", v->name);
+			continue;
+		}
+		printf(" %s", v->name);
+		if (kat_test(v, mgr) || rand_update_test(v, mgr, ref_mgr, bufs)) {
+			printf("Test failed function check\n");
+			return 1;
+		}
+		fflush(0);
+	}
+
+	for (i = 0; i < TEST_BUFS; i++)
+		free(bufs[i]);
+	free(ref_mgr);
+	free(mgr);
+
+	printf(" Pass\n");
+	return 0;
+}
@@ -0,0 +1,182 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+#ifndef SM3_MB_X4_FUNC
+# if defined(__clang__)
+#  pragma clang attribute push (__attribute__((target("sse4.1"))), apply_to=function)
+# elif defined(__ICC)
+#  pragma intel optimization_parameter target_arch=SSE4.1
+# elif defined(__ICL)
+#  pragma [intel] optimization_parameter target_arch=SSE4.1
+# elif (__GNUC__ >= 5)
+#  pragma GCC target("sse4.1")
+# endif
+# define SM3_MB_X4_FUNC	sm3_mb_x4_sse
+# define SM3_MB_X4_POP
+#endif
+
+#include <immintrin.h>
+#include "sm3_mb.h"
+
+/*
+ * Four lane SM3 block function, one message per 32-bit element. It is built
+ * as sm3_mb_x4_sse here and again with the AVX target by sm3_mb_x4_avx.c,
+ * where the same intrinsics get the VEX encoding.
+ */
+
+#define SM3_X4_LANES	4
+
+typedef __m128i VEC;
+
+#define ADD(a, b)	_mm_add_epi32(a, b)
+#define XOR(a, b)	_mm_xor_si128(a, b)
+#define AND(a, b)	_mm_and_si128(a, b)
+#define OR(a, b)	_mm_or_si128(a, b)
+#define ANDNOT(a, b)	_mm_andnot_si128(a, b)
+#define SET1(x)		_mm_set1_epi32((int)(x))
+#define ROL(a, n)	_mm_or_si128(_mm_slli_epi32(a, n), _mm_srli_epi32(a, 32 - (n)))
+
+#define P0(x)		XOR(XOR(x, ROL(x, 9)), ROL(x, 17))
+#define P1(x)		XOR(XOR(x, ROL(x, 15)), ROL(x, 23))
+
+static inline uint32_t rol32(uint32_t x, int r)
+{
+	r &= 31;
+	return r ? (x << r) | (x >> (32 - r)) : x;
+}
+
+// Round j, the caller renames the state words in between rounds
+#define ROUND(j, a, b, c, d, e, f, g, h) \
+	do { \
+		VEC a12 = ROL(a, 12); \
+		VEC ss1 = ROL(ADD(ADD(a12, e), SET1(rol32((j) < 16 ? 0x79cc4519 : \
+							  0x7a879d8a, j))), 7); \
+		VEC ss2 = XOR(ss1, a12); \
+		VEC tt1, tt2; \
+		if ((j) < 16) { \
+			tt1 = XOR(XOR(a, b), c); \
+			tt2 = XOR(XOR(e, f), g); \
+		} else { \
+			tt1 = OR(OR(AND(a, b), AND(a, c)), AND(b, c)); \
+			tt2 = OR(AND(e, f), ANDNOT(e, g)); \
+		} \
+		tt1 = ADD(ADD(tt1, d), ADD(ss2, XOR(w[j], w[(j) + 4]))); \
+		tt2 = ADD(ADD(tt2, h), ADD(ss1, w[j])); \
+		d = ROL(b, 9); \
+		h = ROL(f, 19); \
+		b = tt1; \
+		f = P0(tt2); \
+	} while (0)
+
+void SM3_MB_X4_FUNC(SM3_JOB * jobs[SM3_X4_LANES], uint64_t len)
+{
+	static const uint8_t zero_block[SM3_BLOCK_SIZE];
+	DECLARE_ALIGNED(uint32_t words[SM3_DIGEST_NWORDS][SM3_X4_LANES], 16);
+	const VEC bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+	const uint8_t *p[SM3_X4_LANES];
+	size_t step[SM3_X4_LANES];
+	VEC v[SM3_DIGEST_NWORDS], w[68];
+	VEC a, b, c, d, e, f, g, h;
+	uint64_t blk;
+	int i, j;
+
+	// An empty lane keeps hashing the zero block and is not written back
+	for (i = 0; i < SM3_X4_LANES; i++) {
+		p[i] = jobs[i] ? jobs[i]->buffer : zero_block;
+		step[i] = jobs[i] ? SM3_BLOCK_SIZE : 0;
+		for (j = 0; j < SM3_DIGEST_NWORDS; j++)
+			words[j][i] = jobs[i] ? jobs[i]->result_digest[j] : 0;
+	}
+	for (j = 0; j < SM3_DIGEST_NWORDS; j++)
+		v[j] = _mm_load_si128((const __m128i *)words[j]);
+
+	for (blk = 0; blk < len; blk++) {
+		// Load and transpose four words of each lane at a time
+		for (j = 0; j < 16; j += 4) {
+			VEC r0 = _mm_loadu_si128((const __m128i *)(p[0] + j * 4));
+			VEC r1 = _mm_loadu_si128((const __m128i *)(p[1] + j * 4));
+			VEC r2 = _mm_loadu_si128((const __m128i *)(p[2] + j * 4));
+			VEC r3 = _mm_loadu_si128((const __m128i *)(p[3] + j * 4));
+			VEC t0 = _mm_unpacklo_epi32(r0, r1);
+			VEC t1 = _mm_unpackhi_epi32(r0, r1);
+			VEC t2 = _mm_unpacklo_epi32(r2, r3);
+			VEC t3 = _mm_unpackhi_epi32(r2, r3);
+
+			w[j + 0] = _mm_shuffle_epi8(_mm_unpacklo_epi64(t0, t2), bswap);
+			w[j + 1] = _mm_shuffle_epi8(_mm_unpackhi_epi64(t0, t2), bswap);
+			w[j + 2] = _mm_shuffle_epi8(_mm_unpacklo_epi64(t1, t3), bswap);
+			w[j + 3] = _mm_shuffle_epi8(_mm_unpackhi_epi64(t1, t3), bswap);
+		}
+		for (i = 0; i < SM3_X4_LANES; i++)
+			p[i] += step[i];
+
+		for (j = 16; j < 68; j++) {
+			VEC t = XOR(XOR(w[j - 16], w[j - 9]), ROL(w[j - 3], 15));
+			w[j] = XOR(XOR(P1(t), ROL(w[j - 13], 7)), w[j - 6]);
+		}
+
+		a = v[0];
+		b = v[1];
+		c = v[2];
+		d = v[3];
+		e = v[4];
+		f = v[5];
+		g = v[6];
+		h = v[7];
+
+		// A round rewrites only b, d, f and h, swapping the names in
+		// pairs brings them back in place every second round
+		for (j = 0; j < 64; j += 2) {
+			ROUND(j + 0, a, b, c, d, e, f, g, h);
+			ROUND(j + 1, b, a, d, c, f, e, h, g);
+		}
+
+		v[0] = XOR(v[0], a);
+		v[1] = XOR(v[1], b);
+		v[2] = XOR(v[2], c);
+		v[3] = XOR(v[3], d);
+		v[4] = XOR(v[4], e);
+		v[5] = XOR(v[5], f);
+		v[6] = XOR(v[6], g);
+		v[7] = XOR(v[7], h);
+	}
+
+	for (j = 0; j < SM3_DIGEST_NWORDS; j++)
+		_mm_store_si128((__m128i *)words[j], v[j]);
+	for (i = 0; i < SM3_X4_LANES; i++) {
+		if (jobs[i] == NULL)
+			continue;
+		for (j = 0; j < SM3_DIGEST_NWORDS; j++)
+			jobs[i]->result_digest[j] = words[j][i];
+	}
+}
+
+#if defined(__clang__) && defined(SM3_MB_X4_POP)
+# pragma clang attribute pop
+#endif
@@ -36,6 +36,14 @@ extern sm3_ctx_mgr_init_base
 extern sm3_ctx_mgr_submit_base
 extern sm3_ctx_mgr_flush_base
 
+extern sm3_ctx_mgr_init_sse
+extern sm3_ctx_mgr_submit_sse
+extern sm3_ctx_mgr_flush_sse
+
+extern sm3_ctx_mgr_init_avx
+extern sm3_ctx_mgr_submit_avx
+extern sm3_ctx_mgr_flush_avx
+
 extern sm3_ctx_mgr_init_avx2
 extern sm3_ctx_mgr_submit_avx2
 extern sm3_ctx_mgr_flush_avx2
@@ -54,24 +62,23 @@ mbin_interface sm3_ctx_mgr_init
 mbin_interface sm3_ctx_mgr_submit
 mbin_interface sm3_ctx_mgr_flush
 
-;; have not imlement see/avx yet
 %ifdef HAVE_AS_KNOWS_AVX512
   mbin_dispatch_init6 sm3_ctx_mgr_init, sm3_ctx_mgr_init_base, \
-	sm3_ctx_mgr_init_base, sm3_ctx_mgr_init_base, sm3_ctx_mgr_init_avx2, \
+	sm3_ctx_mgr_init_sse, sm3_ctx_mgr_init_avx, sm3_ctx_mgr_init_avx2, \
 	sm3_ctx_mgr_init_avx512
   mbin_dispatch_init6 sm3_ctx_mgr_submit, sm3_ctx_mgr_submit_base, \
-	sm3_ctx_mgr_submit_base, sm3_ctx_mgr_submit_base, sm3_ctx_mgr_submit_avx2, \
+	sm3_ctx_mgr_submit_sse, sm3_ctx_mgr_submit_avx, sm3_ctx_mgr_submit_avx2, \
 	sm3_ctx_mgr_submit_avx512
   mbin_dispatch_init6 sm3_ctx_mgr_flush, sm3_ctx_mgr_flush_base, \
-	sm3_ctx_mgr_flush_base, sm3_ctx_mgr_flush_base, sm3_ctx_mgr_flush_avx2, \
+	sm3_ctx_mgr_flush_sse, sm3_ctx_mgr_flush_avx, sm3_ctx_mgr_flush_avx2, \
 	sm3_ctx_mgr_flush_avx512
 %else
-  mbin_dispatch_init sm3_ctx_mgr_init, sm3_ctx_mgr_init_base, \
-	sm3_ctx_mgr_init_base,sm3_ctx_mgr_init_avx2
-  mbin_dispatch_init sm3_ctx_mgr_submit, sm3_ctx_mgr_submit_base, \
-	sm3_ctx_mgr_submit_base,sm3_ctx_mgr_submit_avx2
-  mbin_dispatch_init sm3_ctx_mgr_flush, sm3_ctx_mgr_flush_base, \
-	sm3_ctx_mgr_flush_base,sm3_ctx_mgr_flush_avx2
+  mbin_dispatch_init5 sm3_ctx_mgr_init, sm3_ctx_mgr_init_base, \
+	sm3_ctx_mgr_init_sse, sm3_ctx_mgr_init_avx, sm3_ctx_mgr_init_avx2
+  mbin_dispatch_init5 sm3_ctx_mgr_submit, sm3_ctx_mgr_submit_base, \
+	sm3_ctx_mgr_submit_sse, sm3_ctx_mgr_submit_avx, sm3_ctx_mgr_submit_avx2
+  mbin_dispatch_init5 sm3_ctx_mgr_flush, sm3_ctx_mgr_flush_base, \
+	sm3_ctx_mgr_flush_sse, sm3_ctx_mgr_flush_avx, sm3_ctx_mgr_flush_avx2
 %endif
 
 ;;;       func  			core, ver, snum
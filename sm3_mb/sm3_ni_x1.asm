@@ -0,0 +1,217 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+%include "sm3_job.asm"
+%include "reg_sizes.asm"
+
+%ifdef HAVE_AS_KNOWS_SM3NI
+
+[bits 64]
+default rel
+section .text
+
+%ifidn __OUTPUT_FORMAT__, elf64
+ ; Linux
+ %define arg0  rdi
+ %define arg1  rsi
+%else
+ ; Windows
+ %define arg0   rcx
+ %define arg1   rdx
+%endif
+
+%define ABEF		xmm0	; A B E F, A in the top dword
+%define CDGH		xmm1	; C D G H, C in the top dword, C/D ror 9 and G/H ror 19
+%define W0		xmm2
+%define W1		xmm3
+%define W2		xmm4
+%define W3		xmm5
+%define TMP1		xmm6
+%define TMP2		xmm7
+%define TMP3		xmm8
+%define SHUF_MASK	xmm9
+%define ABEF_SAVE	xmm10
+%define CDGH_SAVE	xmm11
+
+%define JOB	arg0
+%define NBLK	arg1
+%define DPTR	r10
+
+;; W0..W3 hold W[j..j+15], move the window up by four words
+%macro ROTATE_W 0
+%xdefine W_TMP W0
+%xdefine W0 W1
+%xdefine W1 W2
+%xdefine W2 W3
+%xdefine W3 W_TMP
+%endmacro
+
+;; Rounds j..j+3 from W[j..j+3] in W0 and W[j+4..j+7] in W1, %1 = j
+%macro ROUNDS4 1
+	vpunpcklqdq	TMP1, W0, W1		; W[j], W[j+1], W[j+4], W[j+5]
+	vsm3rnds2	CDGH, ABEF, TMP1, %1
+	vpunpckhqdq	TMP1, W0, W1		; W[j+2], W[j+3], W[j+6], W[j+7]
+	vsm3rnds2	ABEF, CDGH, TMP1, %1 + 2
+%endmacro
+
+;; W[j+16..j+19] into W0
+%macro SCHED4 0
+	vpalignr	TMP1, W2, W1, 12	; W[j+7..j+10]
+	vpsrldq		TMP2, W3, 4		; W[j+13..j+15]
+	vsm3msg1	TMP1, TMP2, W0
+	vpalignr	TMP2, W1, W0, 12	; W[j+3..j+6]
+	vpalignr	TMP3, W3, W2, 8		; W[j+10..j+13]
+	vsm3msg2	TMP1, TMP2, TMP3
+	vmovdqa		W0, TMP1
+%endmacro
+
+;; digest of job %1 -> ABEF(%2), CDGH(%3), clobbers TMP1, TMP2
+%macro LOAD_DIGEST 3
+	vmovdqu		TMP1, [%1 + _result_digest + 0*16]	; a b c d
+	vmovdqu		TMP2, [%1 + _result_digest + 1*16]	; e f g h
+	vpunpcklqdq	%2, TMP2, TMP1				; e f a b
+	vpunpckhqdq	%3, TMP2, TMP1				; g h c d
+	vpshufd		%2, %2, 0xb1				; f e b a
+	vpshufd		%3, %3, 0xb1				; h g d c
+	vpsrlvd		TMP1, %3, [ROR_CDGH]
+	vpsllvd		%3, %3, [ROL_CDGH]
+	vpor		%3, %3, TMP1
+%endmacro
+
+;; ABEF(%2), CDGH(%3) -> digest of job %1, clobbers TMP1, TMP2
+%macro STORE_DIGEST 3
+	vpsllvd		TMP1, %3, [ROR_CDGH]
+	vpsrlvd		%3, %3, [ROL_CDGH]
+	vpor		%3, %3, TMP1
+	vpshufd		%2, %2, 0xb1				; e f a b
+	vpshufd		%3, %3, 0xb1				; g h c d
+	vpunpckhqdq	TMP1, %2, %3				; a b c d
+	vpunpcklqdq	TMP2, %2, %3				; e f g h
+	vmovdqu		[%1 + _result_digest + 0*16], TMP1
+	vmovdqu		[%1 + _result_digest + 1*16], TMP2
+%endmacro
+
+align 32
+
+; void sm3_ni_x1(SM3_JOB *job, uint64_t blocks);
+; arg 0 : JOB : job holding the digest and buffer of the lane
+; arg 1 : NBLK : size (in blocks) ;; assumed to be >= 1
+;
+; Clobbers registers: r10, xmm0-xmm11
+;
+mk_global sm3_ni_x1, function, internal
+sm3_ni_x1:
+	endbranch
+	shl	NBLK, 6		; transform blk amount into bytes
+	jz	backto_mgr
+
+%ifidn __OUTPUT_FORMAT__, win64
+	sub	rsp, 6*16 + 8
+	vmovdqu	[rsp + 0*16], xmm6
+	vmovdqu	[rsp + 1*16], xmm7
+	vmovdqu	[rsp + 2*16], xmm8
+	vmovdqu	[rsp + 3*16], xmm9
+	vmovdqu	[rsp + 4*16], xmm10
+	vmovdqu	[rsp + 5*16], xmm11
+%endif
+
+	LOAD_DIGEST	JOB, ABEF, CDGH
+
+	vmovdqa		SHUF_MASK, [PSHUFFLE_BYTE_FLIP_MASK]
+
+	mov		DPTR, [JOB + _buffer]
+	;; nblk is used to indicate data end
+	add		NBLK, DPTR
+
+lloop:
+	; /* Save hash values for xor after rounds */
+	vmovdqa		ABEF_SAVE, ABEF
+	vmovdqa		CDGH_SAVE, CDGH
+
+	vmovdqu		W0, [DPTR + 0*16]
+	vmovdqu		W1, [DPTR + 1*16]
+	vmovdqu		W2, [DPTR + 2*16]
+	vmovdqu		W3, [DPTR + 3*16]
+	vpshufb		W0, W0, SHUF_MASK
+	vpshufb		W1, W1, SHUF_MASK
+	vpshufb		W2, W2, SHUF_MASK
+	vpshufb		W3, W3, SHUF_MASK
+
+	; /* Rounds 0-63, the message is expanded up to W[67] */
+%assign g 0
+%rep 16
+	ROUNDS4		g*4
+%if g < 13
+	SCHED4
+%endif
+	ROTATE_W
+%assign g g+1
+%endrep
+
+	vpxor		ABEF, ABEF, ABEF_SAVE
+	vpxor		CDGH, CDGH, CDGH_SAVE
+
+	; Increment data pointer and loop if more to process
+	add		DPTR, 64
+	cmp		DPTR, NBLK
+	jne		lloop
+
+	STORE_DIGEST	JOB, ABEF, CDGH
+
+%ifidn __OUTPUT_FORMAT__, win64
+	vmovdqu	xmm6,  [rsp + 0*16]
+	vmovdqu	xmm7,  [rsp + 1*16]
+	vmovdqu	xmm8,  [rsp + 2*16]
+	vmovdqu	xmm9,  [rsp + 3*16]
+	vmovdqu	xmm10, [rsp + 4*16]
+	vmovdqu	xmm11, [rsp + 5*16]
+	add	rsp, 6*16 + 8
+%endif
+
+backto_mgr:
+	;;;;;;;;;;;;;;;;
+	;; Postamble
+
+	ret
+
+
+section .data align=16
+PSHUFFLE_BYTE_FLIP_MASK:
+	dq 0x0405060700010203, 0x0c0d0e0f08090a0b
+ROR_CDGH:
+	dd 19, 19, 9, 9
+ROL_CDGH:
+	dd 13, 13, 23, 23
+
+%else
+%ifidn __OUTPUT_FORMAT__, win64
+global no_sm3_ni_x1
+no_sm3_ni_x1:
+%endif
+%endif ; HAVE_AS_KNOWS_SM3NI
@@ -0,0 +1,274 @@
+/**********************************************************************
+  Copyright(c) 2011-2016 Intel Corporation All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in
+      the documentation and/or other materials provided with the
+      distribution.
+    * Neither the name of Intel Corporation nor the names of its
+      contributors may be used to endorse or promote products derived
+      from this software without specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+  OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+  LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+  THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**********************************************************************/
+
+%include "sm3_job.asm"
+%include "reg_sizes.asm"
+
+%ifdef HAVE_AS_KNOWS_SM3NI
+
+[bits 64]
+default rel
+section .text
+
+%ifidn __OUTPUT_FORMAT__, elf64
+ ; Linux
+ %define arg0  rdi
+ %define arg1  rsi
+ %define arg2  rdx
+%else
+ ; Windows
+ %define arg0   rcx
+ %define arg1   rdx
+ %define arg2   r8
+%endif
+
+;; Lane A
+%define ABEFA		xmm0	; A B E F, A in the top dword
+%define CDGHA		xmm1	; C D G H, C in the top dword, C/D ror 9 and G/H ror 19
+%define WA0		xmm2
+%define WA1		xmm3
+%define WA2		xmm4
+%define WA3		xmm5
+
+;; Lane B
+%define ABEFB		xmm6
+%define CDGHB		xmm7
+%define WB0		xmm8
+%define WB1		xmm9
+%define WB2		xmm10
+%define WB3		xmm11
+
+%define TMP1		xmm12
+%define TMP2		xmm13
+%define TMP3		xmm14
+%define SHUF_MASK	xmm15
+
+%define JOBA	arg0
+%define JOBB	arg1
+%define NBLK	arg2
+%define DPTRA	r10
+%define DPTRB	r11
+%define IDX	r9
+
+;; Stack frame, 16 byte aligned
+%define _ABEF_SAVE_A	0*16
+%define _CDGH_SAVE_A	1*16
+%define _ABEF_SAVE_B	2*16
+%define _CDGH_SAVE_B	3*16
+%define _XMM_SAVE	4*16
+%define _RSP_SAVE	_XMM_SAVE + 10*16
+%define FRAME_SIZE	_RSP_SAVE + 8 + 16
+
+;; WA0..WA3 and WB0..WB3 hold W[j..j+15], move both windows up by four words
+%macro ROTATE_W 0
+%xdefine W_TMP WA0
+%xdefine WA0 WA1
+%xdefine WA1 WA2
+%xdefine WA2 WA3
+%xdefine WA3 W_TMP
+%xdefine W_TMP WB0
+%xdefine WB0 WB1
+%xdefine WB1 WB2
+%xdefine WB2 WB3
+%xdefine WB3 W_TMP
+%endmacro
+
+;; Rounds j..j+3 of both lanes from W[j..j+7], %1 = j
+%macro ROUNDS4_X2 1
+	vpunpcklqdq	TMP1, WA0, WA1		; W[j], W[j+1], W[j+4], W[j+5]
+	vpunpcklqdq	TMP2, WB0, WB1
+	vsm3rnds2	CDGHA, ABEFA, TMP1, %1
+	vsm3rnds2	CDGHB, ABEFB, TMP2, %1
+	vpunpckhqdq	TMP1, WA0, WA1		; W[j+2], W[j+3], W[j+6], W[j+7]
+	vpunpckhqdq	TMP2, WB0, WB1
+	vsm3rnds2	ABEFA, CDGHA, TMP1, %1 + 2
+	vsm3rnds2	ABEFB, CDGHB, TMP2, %1 + 2
+%endmacro
+
+;; W[j+16..j+19] into %1, from %1..%4 = W[j..j+15]
+%macro SCHED4 4
+	vpalignr	TMP1, %3, %2, 12	; W[j+7..j+10]
+	vpsrldq		TMP2, %4, 4		; W[j+13..j+15]
+	vsm3msg1	TMP1, TMP2, %1
+	vpalignr	TMP2, %2, %1, 12	; W[j+3..j+6]
+	vpalignr	TMP3, %4, %3, 8		; W[j+10..j+13]
+	vsm3msg2	TMP1, TMP2, TMP3
+	vmovdqa		%1, TMP1
+%endmacro
+
+;; digest of job %1 -> ABEF(%2), CDGH(%3), clobbers TMP1, TMP2
+%macro LOAD_DIGEST 3
+	vmovdqu		TMP1, [%1 + _result_digest + 0*16]	; a b c d
+	vmovdqu		TMP2, [%1 + _result_digest + 1*16]	; e f g h
+	vpunpcklqdq	%2, TMP2, TMP1				; e f a b
+	vpunpckhqdq	%3, TMP2, TMP1				; g h c d
+	vpshufd		%2, %2, 0xb1				; f e b a
+	vpshufd		%3, %3, 0xb1				; h g d c
+	vpsrlvd		TMP1, %3, [ROR_CDGH]
+	vpsllvd		%3, %3, [ROL_CDGH]
+	vpor		%3, %3, TMP1
+%endmacro
+
+;; ABEF(%2), CDGH(%3) -> digest of job %1, clobbers TMP1, TMP2
+%macro STORE_DIGEST 3
+	vpsllvd		TMP1, %3, [ROR_CDGH]
+	vpsrlvd		%3, %3, [ROL_CDGH]
+	vpor		%3, %3, TMP1
+	vpshufd		%2, %2, 0xb1				; e f a b
+	vpshufd		%3, %3, 0xb1				; g h c d
+	vpunpckhqdq	TMP1, %2, %3				; a b c d
+	vpunpcklqdq	TMP2, %2, %3				; e f g h
+	vmovdqu		[%1 + _result_digest + 0*16], TMP1
+	vmovdqu		[%1 + _result_digest + 1*16], TMP2
+%endmacro
+
+;; block of lane at %1 + IDX -> %2..%5
+%macro LOAD_MSG 5
+	vmovdqu		%2, [%1 + IDX + 0*16]
+	vmovdqu		%3, [%1 + IDX + 1*16]
+	vmovdqu		%4, [%1 + IDX + 2*16]
+	vmovdqu		%5, [%1 + IDX + 3*16]
+	vpshufb		%2, %2, SHUF_MASK
+	vpshufb		%3, %3, SHUF_MASK
+	vpshufb		%4, %4, SHUF_MASK
+	vpshufb		%5, %5, SHUF_MASK
+%endmacro
+
+align 32
+
+; void sm3_ni_x2(SM3_JOB *job0, SM3_JOB *job1, uint64_t blocks);
+; arg 0 : JOBA : job of the first lane
+; arg 1 : JOBB : job of the second lane
+; arg 2 : NBLK : size (in blocks) of both lanes ;; assumed to be >= 1
+;
+; Clobbers registers: rax, r9-r11, xmm0-xmm15
+;
+mk_global sm3_ni_x2, function, internal
+sm3_ni_x2:
+	endbranch
+	shl	NBLK, 6		; transform blk amount into bytes
+	jz	backto_mgr
+
+	mov	rax, rsp
+	sub	rsp, FRAME_SIZE
+	and	rsp, ~15
+	mov	[rsp + _RSP_SAVE], rax
+
+%ifidn __OUTPUT_FORMAT__, win64
+	vmovdqa	[rsp + _XMM_SAVE + 0*16], xmm6
+	vmovdqa	[rsp + _XMM_SAVE + 1*16], xmm7
+	vmovdqa	[rsp + _XMM_SAVE + 2*16], xmm8
+	vmovdqa	[rsp + _XMM_SAVE + 3*16], xmm9
+	vmovdqa	[rsp + _XMM_SAVE + 4*16], xmm10
+	vmovdqa	[rsp + _XMM_SAVE + 5*16], xmm11
+	vmovdqa	[rsp + _XMM_SAVE + 6*16], xmm12
+	vmovdqa	[rsp + _XMM_SAVE + 7*16], xmm13
+	vmovdqa	[rsp + _XMM_SAVE + 8*16], xmm14
+	vmovdqa	[rsp + _XMM_SAVE + 9*16], xmm15
+%endif
+
+	LOAD_DIGEST	JOBA, ABEFA, CDGHA
+	LOAD_DIGEST	JOBB, ABEFB, CDGHB
+
+	vmovdqa		SHUF_MASK, [PSHUFFLE_BYTE_FLIP_MASK]
+
+	mov		DPTRA, [JOBA + _buffer]
+	mov		DPTRB, [JOBB + _buffer]
+	xor		IDX, IDX
+
+lloop:
+	; /* Save hash values for xor after rounds */
+	vmovdqa		[rsp + _ABEF_SAVE_A], ABEFA
+	vmovdqa		[rsp + _CDGH_SAVE_A], CDGHA
+	vmovdqa		[rsp + _ABEF_SAVE_B], ABEFB
+	vmovdqa		[rsp + _CDGH_SAVE_B], CDGHB
+
+	LOAD_MSG	DPTRA, WA0, WA1, WA2, WA3
+	LOAD_MSG	DPTRB, WB0, WB1, WB2, WB3
+
+	; /* Rounds 0-63, the message is expanded up to W[67] */
+%assign g 0
+%rep 16
+	ROUNDS4_X2	g*4
+%if g < 13
+	SCHED4		WA0, WA1, WA2, WA3
+	SCHED4		WB0, WB1, WB2, WB3
+%endif
+	ROTATE_W
+%assign g g+1
+%endrep
+
+	vpxor		ABEFA, ABEFA, [rsp + _ABEF_SAVE_A]
+	vpxor		CDGHA, CDGHA, [rsp + _CDGH_SAVE_A]
+	vpxor		ABEFB, ABEFB, [rsp + _ABEF_SAVE_B]
+	vpxor		CDGHB, CDGHB, [rsp + _CDGH_SAVE_B]
+
+	; Increment data offset and loop if more to process
+	add		IDX, 64
+	cmp		IDX, NBLK
+	jne		lloop
+
+	STORE_DIGEST	JOBA, ABEFA, CDGHA
+	STORE_DIGEST	JOBB, ABEFB, CDGHB
+
+%ifidn __OUTPUT_FORMAT__, win64
+	vmovdqa	xmm6,  [rsp + _XMM_SAVE + 0*16]
+	vmovdqa	xmm7,  [rsp + _XMM_SAVE + 1*16]
+	vmovdqa	xmm8,  [rsp + _XMM_SAVE + 2*16]
+	vmovdqa	xmm9,  [rsp + _XMM_SAVE + 3*16]
+	vmovdqa	xmm10, [rsp + _XMM_SAVE + 4*16]
+	vmovdqa	xmm11, [rsp + _XMM_SAVE + 5*16]
+	vmovdqa	xmm12, [rsp + _XMM_SAVE + 6*16]
+	vmovdqa	xmm13, [rsp + _XMM_SAVE + 7*16]
+	vmovdqa	xmm14, [rsp + _XMM_SAVE + 8*16]
+	vmovdqa	xmm15, [rsp + _XMM_SAVE + 9*16]
+%endif
+	mov	rsp, [rsp + _RSP_SAVE]
+
+backto_mgr:
+	;;;;;;;;;;;;;;;;
+	;; Postamble
+
+	ret
+
+
+section .data align=16
+PSHUFFLE_BYTE_FLIP_MASK:
+	dq 0x0405060700010203, 0x0c0d0e0f08090a0b
+ROR_CDGH:
+	dd 19, 19, 9, 9
+ROL_CDGH:
+	dd 13, 13, 23, 23
+
+%else
+%ifidn __OUTPUT_FORMAT__, win64
+global no_sm3_ni_x2
+no_sm3_ni_x2:
+%endif
+%endif ; HAVE_AS_KNOWS_SM3NI
@@ -65,7 +65,7 @@ endif
 	@echo ''			>> $@
 	@echo '# Check tests'		>> $@
 	@echo -n 'checks =' 		>> $@
-	@$(foreach check, $(notdir $(check_tests)), printf " %s\n\t%s.exe" \\ $(check) >> $@; )
+	@$(foreach check, $(notdir $(filter-out $(pthread_check_tests),$(check_tests))), printf " %s\n\t%s.exe" \\ $(check) >> $@; )
 	@echo ''			>> $@
 	@echo ''			>> $@
 	@echo 'checks: lib $$(checks)'	>> $@